@@ -0,0 +1,33 @@
+// map_compiler.cpp
+// Converts a map.json into the binary format read by CompiledMap::load.
+// Rooms without x/y in the json are laid out here so the app never has to.
+// Usage: map_compiler <map.json> <map.bin>
+
+#include <chrono>
+#include <iostream>
+#include "map/map.h"
+#include "map/CompiledMap.h"
+#include "MapLayout/MapLayout.h"
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <map.json> <map.bin>" << std::endl;
+        return 1;
+    }
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        Map map;
+        map.loadFromFile(argv[1]);
+        size_t placed = MapLayout::assignMissingPositions(map);
+        CompiledMap::write(map, argv[2]);
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+        std::cout << "Compiled " << map.getRooms().size() << " rooms to " << argv[2]
+                  << " (" << placed << " laid out) in " << elapsed.count() << " ms" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+// map_generator.cpp
+// Writes a synthetic building (map.json, or a compiled map when the output
+// ends in .bin) and optionally a matching fleet file. The same seed and
+// options always produce the same files.
+// Usage: map_generator [options] <map.json|map.bin>
+//   --seed N               random seed (default 1)
+//   --floors N             floors (default 1)
+//   --corridors N          corridors per floor (default 2)
+//   --rooms N              rooms per corridor (default 20)
+//   --sizes S,M,L          relative weights of small/medium/large rooms (default 0.4,0.4,0.2)
+//   --walls F              share of doors closed by a virtual wall (default 0.05)
+//   --dirty F              share of rooms that start dirty (default 0.5)
+//   --robots N             fleet size (default 9)
+//   --fleet <fleet.json>   also write the fleet definition
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "map/map.h"
+#include "map/CompiledMap.h"
+#include "MapGenerator/BuildingGenerator.h"
+
+namespace {
+    void usage(const char* program) {
+        std::cerr << "Usage: " << program << " [--seed N] [--floors N] [--corridors N] [--rooms N]"
+                  << " [--sizes S,M,L] [--walls F] [--dirty F] [--robots N] [--fleet fleet.json]"
+                  << " <map.json|map.bin>" << std::endl;
+    }
+
+    bool endsWith(const std::string& value, const std::string& suffix) {
+        return value.size() >= suffix.size() && value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    std::array<double, 3> parseWeights(const std::string& text) {
+        std::array<double, 3> weights{};
+        std::stringstream in(text);
+        std::string part;
+        for (double& weight : weights) {
+            if (!std::getline(in, part, ',')) throw std::runtime_error("--sizes needs three weights");
+            weight = std::stod(part);
+        }
+        return weights;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BuildingGenerator::Options options;
+    std::string output;
+    std::string fleetFile;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) throw std::runtime_error(arg + " needs a value");
+                return argv[++i];
+            };
+            if (arg == "--seed") options.seed = static_cast<uint32_t>(std::stoul(value()));
+            else if (arg == "--floors") options.floors = std::stoi(value());
+            else if (arg == "--corridors") options.corridorsPerFloor = std::stoi(value());
+            else if (arg == "--rooms") options.roomsPerCorridor = std::stoi(value());
+            else if (arg == "--sizes") options.sizeWeights = parseWeights(value());
+            else if (arg == "--walls") options.virtualWallFraction = std::stod(value());
+            else if (arg == "--dirty") options.dirtyFraction = std::stod(value());
+            else if (arg == "--robots") options.robots = std::stoi(value());
+            else if (arg == "--fleet") fleetFile = value();
+            else if (!arg.empty() && arg[0] != '-' && output.empty()) output = arg;
+            else {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+        if (output.empty()) {
+            usage(argv[0]);
+            return 1;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        auto building = BuildingGenerator::generate(options);
+        if (endsWith(output, ".bin")) {
+            CompiledMap::write(*building.map, output);
+        } else {
+            BuildingGenerator::writeMapJson(*building.map, output);
+        }
+        if (!fleetFile.empty()) {
+            BuildingGenerator::writeFleetJson(building.fleet, fleetFile);
+        }
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+        std::cout << "Generated " << building.map->getRooms().size() << " rooms on " << options.floors
+                  << " floors, " << building.map->getVirtualWalls().size() << " virtual walls and "
+                  << building.fleet.size() << " robots (seed " << options.seed << ") in "
+                  << elapsed.count() << " ms" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+#ifndef BENCHMARK_SUPPORT_H
+#define BENCHMARK_SUPPORT_H
+
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "map/map.h"
+#include "Room/Room.h"
+
+// Synthetic maps and helpers shared by the benchmark files. Every generator
+// takes a seed so runs compare like with like.
+namespace bench {
+
+    // Silences the simulator's debug output while a benchmark runs. With the
+    // fail bit set, operator<< returns before formatting anything.
+    class QuietOutput {
+    public:
+        QuietOutput() : state_(std::cout.rdstate()) { std::cout.setstate(std::ios::failbit); }
+        ~QuietOutput() { std::cout.clear(state_); }
+        QuietOutput(const QuietOutput&) = delete;
+        QuietOutput& operator=(const QuietOutput&) = delete;
+
+    private:
+        std::ios::iostate state_;
+    };
+
+    inline void addRooms(Map& map, int count) {
+        static const char* floors[] = {"tile", "wood", "carpet"};
+        static const char* sizes[] = {"small", "medium", "large"};
+        map.reserveRooms(count);
+        for (int id = 0; id < count; ++id) {
+            map.addRoom("Room " + std::to_string(id), id, floors[id % 3], sizes[(id / 3) % 3], false);
+        }
+        map.addCharger(0, 4);
+    }
+
+    // Walls on a share of the edges; never on the edges in keep, so the map stays connected
+    inline void addWalls(Map& map, const std::vector<std::pair<int, int>>& edges, double wallFraction,
+                         std::mt19937& rng, const std::vector<bool>& keep = {}) {
+        std::bernoulli_distribution wall(wallFraction);
+        for (size_t i = 0; i < edges.size(); ++i) {
+            if (i < keep.size() && keep[i]) continue;
+            if (wall(rng)) map.addVirtualWall(map.getRoomById(edges[i].first), map.getRoomById(edges[i].second));
+        }
+    }
+
+    inline void connect(Map& map, std::vector<std::pair<int, int>>& edges, int a, int b) {
+        map.connectRooms(map.getRoomById(a), map.getRoomById(b));
+        edges.emplace_back(a, b);
+    }
+
+    // width x height rooms joined to their right and lower neighbours; the first
+    // row and column stay wall-free so every room is reachable
+    inline std::shared_ptr<Map> gridMap(int width, int height, double wallFraction, unsigned seed = 1) {
+        auto map = std::make_shared<Map>();
+        addRooms(*map, width * height);
+        std::vector<std::pair<int, int>> edges;
+        std::vector<bool> keep;
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                int id = y * width + x;
+                if (x + 1 < width) { connect(*map, edges, id, id + 1); keep.push_back(y == 0); }
+                if (y + 1 < height) { connect(*map, edges, id, id + width); keep.push_back(true); }
+            }
+        }
+        std::mt19937 rng(seed);
+        addWalls(*map, edges, wallFraction, rng, keep);
+        map->publishSnapshot();
+        return map;
+    }
+
+    // Complete tree with the given branching factor; walls go on cross links between siblings
+    inline std::shared_ptr<Map> treeMap(int rooms, int branching, double wallFraction, unsigned seed = 1) {
+        auto map = std::make_shared<Map>();
+        addRooms(*map, rooms);
+        std::vector<std::pair<int, int>> edges;
+        std::vector<bool> keep;
+        for (int id = 1; id < rooms; ++id) {
+            connect(*map, edges, (id - 1) / branching, id);
+            keep.push_back(true);
+            if ((id - 1) % branching != 0) {
+                connect(*map, edges, id - 1, id);
+                keep.push_back(false);
+            }
+        }
+        std::mt19937 rng(seed);
+        addWalls(*map, edges, wallFraction, rng, keep);
+        map->publishSnapshot();
+        return map;
+    }
+
+    // A random spanning tree plus extraEdges random links; walls only on the extra links
+    inline std::shared_ptr<Map> randomMap(int rooms, int extraEdges, double wallFraction, unsigned seed = 1) {
+        auto map = std::make_shared<Map>();
+        addRooms(*map, rooms);
+        std::mt19937 rng(seed);
+        std::vector<std::pair<int, int>> edges;
+        std::vector<bool> keep;
+        for (int id = 1; id < rooms; ++id) {
+            connect(*map, edges, std::uniform_int_distribution<int>(0, id - 1)(rng), id);
+            keep.push_back(true);
+        }
+        std::uniform_int_distribution<int> any(0, rooms - 1);
+        for (int i = 0; i < extraEdges; ++i) {
+            int a = any(rng);
+            int b = any(rng);
+            if (a == b) continue;
+            connect(*map, edges, a, b);
+            keep.push_back(false);
+        }
+        addWalls(*map, edges, wallFraction, rng, keep);
+        map->publishSnapshot();
+        return map;
+    }
+}
+
+#endif // BENCHMARK_SUPPORT_H
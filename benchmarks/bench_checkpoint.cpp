@@ -0,0 +1,70 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "BenchmarkSupport.h"
+#include "Checkpoint/SimulationCheckpoint.h"
+#include "RobotSimulator/RobotSimulator.hpp"
+#include "Scheduler/Scheduler.hpp"
+#include "CleaningTask/cleaningTask.h"
+#include "Robot/Robot.h"
+#include "map/map.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    struct Fleet {
+        std::shared_ptr<Map> map = bench::gridMap(64, 64, 0.1);
+        std::shared_ptr<RobotSimulator> simulator = std::make_shared<RobotSimulator>(map, nullptr, nullptr, nullptr);
+        std::shared_ptr<Scheduler> scheduler = std::make_shared<Scheduler>(map.get(), &simulator->getRobots());
+
+        // With tasks, every other robot has one queued and restore sends it on its way
+        Fleet(int robots, bool withTasks) {
+            scheduler->setSimulator(simulator);
+            simulator->setScheduler(scheduler);
+            for (int i = 0; i < robots; ++i) {
+                simulator->addRobot("Robot " + std::to_string(i));
+            }
+            std::vector<std::shared_ptr<CleaningTask>> tasks;
+            for (int i = 0; withTasks && i < robots; i += 2) {
+                auto task = std::make_shared<CleaningTask>(i + 1, CleaningTask::MEDIUM, CleaningTask::VACUUM,
+                                                           map->getRoomById((i * 37) % 4096));
+                task->assignRobot(simulator->getRobots()[i]);
+                tasks.push_back(task);
+            }
+            scheduler->restoreTasks(tasks, robots);
+        }
+    };
+}
+
+// Warm restart cost against fleet size: capturing on the simulation thread,
+// and rebuilding the simulator and scheduler from a checkpoint at startup
+TEST_CASE("Checkpoint capture and restore", "[benchmark][checkpoint]") {
+    bench::QuietOutput quiet;
+    for (int robots : {10, 1000, 100000}) {
+        Fleet fleet(robots, true);
+        BENCHMARK("capture " + std::to_string(robots) + " robots") {
+            return SimulationCheckpoint::capture(*fleet.simulator, fleet.scheduler.get()).robots.size();
+        };
+
+        Fleet idle(robots, false);
+        SimulationCheckpoint checkpoint = SimulationCheckpoint::capture(*idle.simulator, idle.scheduler.get());
+        BENCHMARK("restore " + std::to_string(robots) + " idle robots") {
+            checkpoint.restore(*idle.simulator, *idle.scheduler);
+            return idle.simulator->getRobots().size();
+        };
+    }
+}
+
+// Restore with work in hand also plans one route per dispatched robot, the
+// same cost as dispatching those tasks live
+TEST_CASE("Checkpoint restore with queued tasks", "[benchmark][checkpoint]") {
+    bench::QuietOutput quiet;
+    for (int robots : {10, 1000}) {
+        Fleet fleet(robots, true);
+        SimulationCheckpoint checkpoint = SimulationCheckpoint::capture(*fleet.simulator, fleet.scheduler.get());
+        BENCHMARK("restore " + std::to_string(robots) + " robots, half dispatched") {
+            checkpoint.restore(*fleet.simulator, *fleet.scheduler);
+            return fleet.simulator->getRobots().size();
+        };
+    }
+}
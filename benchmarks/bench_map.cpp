@@ -0,0 +1,77 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "BenchmarkSupport.h"
+#include "MapGenerator/BuildingGenerator.h"
+#include "map/map.h"
+#include "Room/Room.h"
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    // Fixed random start/end pairs so every run routes the same queries
+    std::vector<std::pair<Room*, Room*>> queries(const Map& map, int count, unsigned seed = 7) {
+        const auto& rooms = map.getRooms();
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<size_t> any(0, rooms.size() - 1);
+        std::vector<std::pair<Room*, Room*>> result;
+        for (int i = 0; i < count; ++i) result.emplace_back(rooms[any(rng)], rooms[any(rng)]);
+        return result;
+    }
+
+    void routeBenchmarks(const std::string& shape, const Map& map) {
+        auto pairs = queries(map, 64);
+        size_t next = 0;
+        BENCHMARK("getRoute " + shape + " " + std::to_string(map.getRooms().size()) + " rooms") {
+            const auto& query = pairs[next++ % pairs.size()];
+            return map.getRoute(*query.first, *query.second).size();
+        };
+    }
+}
+
+TEST_CASE("Map routing", "[benchmark][routing]") {
+    bench::QuietOutput quiet;
+    for (int side : {16, 64, 256}) {
+        auto map = bench::gridMap(side, side, 0.2);
+        routeBenchmarks("grid", *map);
+    }
+    for (int rooms : {1000, 10000, 100000}) {
+        auto map = bench::treeMap(rooms, 4, 0.3);
+        routeBenchmarks("tree", *map);
+    }
+    for (int rooms : {1000, 10000, 100000}) {
+        auto map = bench::randomMap(rooms, rooms, 0.2);
+        routeBenchmarks("random", *map);
+    }
+}
+
+TEST_CASE("Map loading", "[benchmark][loading]") {
+    bench::QuietOutput quiet;
+    for (int side : {100, 300}) {
+        auto source = bench::gridMap(side, side, 0.1);
+        std::string path = "bench_map_" + std::to_string(side) + ".json";
+        BuildingGenerator::writeMapJson(*source, path);
+        BENCHMARK("loadFromFile " + std::to_string(side * side) + " rooms") {
+            Map map;
+            map.loadFromFile(path);
+            return map.getRooms().size();
+        };
+        std::remove(path.c_str());
+    }
+
+    // A 20-floor building: positions, zones and walls make each room record heavier
+    BuildingGenerator::Options options;
+    options.floors = 20;
+    options.corridorsPerFloor = 6;
+    options.roomsPerCorridor = 80;
+    auto building = BuildingGenerator::generate(options);
+    std::string path = "bench_building.json";
+    BuildingGenerator::writeMapJson(*building.map, path);
+    BENCHMARK("loadFromFile building " + std::to_string(building.map->getRooms().size()) + " rooms") {
+        Map map;
+        map.loadFromFile(path);
+        return map.getRooms().size();
+    };
+    std::remove(path.c_str());
+}
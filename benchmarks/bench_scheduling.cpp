@@ -0,0 +1,73 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "BenchmarkSupport.h"
+#include "TaskScheduler/TaskScheduler.h"
+#include "Scheduler/Scheduler.hpp"
+#include "CleaningTask/cleaningTask.h"
+#include "Robot/Robot.h"
+#include "map/map.h"
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("TaskScheduler queue", "[benchmark][scheduling]") {
+    bench::QuietOutput quiet;
+    auto map = bench::gridMap(8, 8, 0.0);
+    const int perThread = 2000;
+    std::vector<std::shared_ptr<CleaningTask>> tasks;
+    for (int i = 0; i < 8 * perThread; ++i) {
+        auto priority = static_cast<CleaningTask::Priority>(i % 3);
+        tasks.push_back(std::make_shared<CleaningTask>(i, priority, CleaningTask::VACUUM,
+                                                       map->getRoomById(i % 64)));
+    }
+    TaskScheduler& queue = TaskScheduler::getInstance();
+    while (queue.dequeueTask()) {}
+
+    for (int threads : {1, 2, 4, 8}) {
+        // Every thread pushes its share and pops as many back, contending on the one queue lock
+        BENCHMARK("enqueue/dequeue " + std::to_string(perThread) + " tasks x " + std::to_string(threads) + " threads") {
+            std::vector<std::thread> workers;
+            for (int t = 0; t < threads; ++t) {
+                workers.emplace_back([&queue, &tasks, t, perThread]() {
+                    for (int i = 0; i < perThread; ++i) queue.enqueueTask(tasks[t * perThread + i]);
+                    for (int i = 0; i < perThread; ++i) queue.dequeueTask();
+                });
+            }
+            for (auto& worker : workers) worker.join();
+            return queue.taskCount();
+        };
+    }
+}
+
+TEST_CASE("Scheduler backlog", "[benchmark][scheduling]") {
+    bench::QuietOutput quiet;
+    auto map = bench::gridMap(32, 32, 0.0);
+    std::vector<std::shared_ptr<Robot>> robots;
+    for (int i = 0; i < 16; ++i) {
+        robots.push_back(std::make_shared<Robot>("Robot " + std::to_string(i), 100.0, Robot::Size::MEDIUM,
+                                                 Robot::Strategy::VACUUM));
+        robots.back()->setCurrentRoom(map->getRoomById(0));
+    }
+
+    for (int backlog : {1000, 10000}) {
+        Scheduler scheduler(map.get(), &robots);
+        // The backlog belongs to the other robots; the one asking has a single task at the back
+        for (int i = 0; i < backlog; ++i) {
+            auto task = std::make_shared<CleaningTask>(i, CleaningTask::MEDIUM, CleaningTask::VACUUM,
+                                                       map->getRoomById(i % 1024));
+            task->assignRobot(robots[1 + i % 15]);
+            scheduler.addTask(task);
+        }
+        auto mine = std::make_shared<CleaningTask>(backlog, CleaningTask::HIGH, CleaningTask::VACUUM,
+                                                   map->getRoomById(5));
+        mine->assignRobot(robots[0]);
+        scheduler.addTask(mine);
+
+        BENCHMARK("getNextTaskForRobot with " + std::to_string(backlog) + " queued") {
+            auto task = scheduler.getNextTaskForRobot("Robot 0");
+            scheduler.requeueTask(task);
+            return task->getID();
+        };
+    }
+}
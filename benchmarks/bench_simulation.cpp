@@ -0,0 +1,28 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "BenchmarkSupport.h"
+#include "RobotSimulator/RobotSimulator.hpp"
+#include "Robot/Robot.h"
+#include "map/map.h"
+#include <memory>
+#include <string>
+
+TEST_CASE("Simulator tick", "[benchmark][simulation]") {
+    bench::QuietOutput quiet;
+    for (int fleet : {10, 1000, 100000}) {
+        auto map = bench::gridMap(64, 64, 0.1);
+        auto simulator = std::make_shared<RobotSimulator>(map, nullptr, nullptr, nullptr);
+        for (int i = 0; i < fleet; ++i) {
+            simulator->addRobot("Robot " + std::to_string(i));
+        }
+        // Half the fleet is on the move, the rest idles or charges
+        for (int i = 0; i < fleet; i += 2) {
+            simulator->moveRobotToRoom(simulator->getRobots()[i], (i * 37) % 4096);
+        }
+
+        BENCHMARK("update " + std::to_string(fleet) + " robots") {
+            simulator->update(1.0);
+            return simulator->getSimTime();
+        };
+    }
+}
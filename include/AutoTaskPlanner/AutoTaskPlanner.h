@@ -0,0 +1,93 @@
+#ifndef AUTO_TASK_PLANNER_H
+#define AUTO_TASK_PLANNER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "CleaningTask/cleaningTask.h"
+
+class Map;
+
+// Generates cleaning tasks for dirty rooms on a background thread. Callers
+// report which rooms changed; the planner re-checks only those against the
+// latest map snapshot and the shared room state table, so the live map is
+// never read here. Each room has at most one outstanding generated task until
+// it is clean again or that task is released. New tasks go to the sink in
+// batches, by default the shared TaskScheduler queue robots pull from; a
+// task whose room turned clean some other way is retracted from it.
+class AutoTaskPlanner {
+public:
+    using Sink = std::function<void(const std::vector<std::shared_ptr<CleaningTask>>&)>;
+    using Retract = std::function<void(const std::unordered_set<int>& taskIds)>;
+
+    static constexpr size_t kDefaultBatchSize = 64;
+    // Scheduler numbers its own tasks from 1; keep generated ids clear of them
+    static constexpr int kFirstTaskId = 1000000;
+
+    struct Stats {
+        long roomsEvaluated = 0;
+        long tasksGenerated = 0;
+        long batchesSubmitted = 0;
+        double lastPassMillis = 0.0;
+    };
+
+    // Without a sink, tasks go to TaskScheduler and are retracted from it
+    explicit AutoTaskPlanner(std::shared_ptr<Map> map, Sink sink = nullptr,
+                             size_t batchSize = kDefaultBatchSize);
+    ~AutoTaskPlanner();
+
+    void start();
+    void stop();
+    bool isRunning() const { return running_; }
+
+    void notifyRoomChanged(int roomId);
+    void notifyRoomsChanged(const std::vector<int>& roomIds);
+    // Queues every room on the map, e.g. once at startup
+    void notifyAllRooms();
+    // Replaces how queued tasks for rooms that turned clean are withdrawn
+    void setRetract(Retract retract) { retract_ = std::move(retract); }
+    // A task on the room finished. Only the room's own generated task frees
+    // the room: on completion it is evaluated again, on failure it waits for
+    // the next change report so an unreachable room is not retried forever.
+    // Any completed task re-checks the room, retracting a generated task
+    // that is no longer needed.
+    void releaseRoom(int roomId, int taskId, bool failed = false);
+
+    // Evaluates everything queued so far on the calling thread; returns tasks generated
+    size_t processPending();
+
+    bool hasOutstandingTask(int roomId) const;
+    int getNextTaskId() const;
+    // Warm restart: generated ids continue from nextTaskId, and rooms whose
+    // generated task came back (room id -> task id) do not get a second one
+    void restore(int nextTaskId, const std::unordered_map<int, int>& outstanding);
+    size_t pendingCount() const;
+    Stats getStats() const;
+
+private:
+    void run();
+
+    std::shared_ptr<Map> map_;
+    Sink sink_;
+    Retract retract_;
+    size_t batchSize_;
+    int nextTaskId_ = kFirstTaskId;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::unordered_set<int> pending_;
+    std::unordered_map<int, int> outstanding_;   // room id -> generated task id
+    Stats stats_;
+
+    std::mutex passMutex_;                       // one evaluation pass at a time
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+};
+
+#endif // AUTO_TASK_PLANNER_H
@@ -0,0 +1,76 @@
+#ifndef CHARGING_SCHEDULER_H
+#define CHARGING_SCHEDULER_H
+
+#include <deque>
+#include <memory>
+#include <vector>
+#include "map/map.h"
+
+class Robot;
+
+// Hands out charger slots declared on the map. A robot gets the nearest
+// charger with a free slot; when every charger is full it queues at the one
+// where it would be ready soonest and waits there until a slot opens.
+class ChargingScheduler {
+public:
+    struct Assignment {
+        int chargerRoomId = -1;
+        bool queued = false;        // true while waiting for a slot
+        double readyAt = 0.0;       // predicted sim time when fully charged
+    };
+
+    struct Stats {
+        long requests = 0;
+        long queuedRequests = 0;    // requests that found every charger full
+        double totalWaitSeconds = 0.0;
+        double maxWaitSeconds = 0.0;
+        size_t peakQueueLength = 0;
+    };
+
+    explicit ChargingScheduler(const Map& map);
+
+    // Returns the robot's existing assignment if it already has one
+    Assignment requestCharge(const std::shared_ptr<Robot>& robot, double now);
+    // Frees slots of robots that finished or left, then moves queued robots in
+    void update(double now);
+    void cancel(const Robot* robot);
+    // After a live map edit: picks up added chargers and new slot counts, and
+    // returns the robots that held or waited for a slot at a removed charger
+    std::vector<std::shared_ptr<Robot>> syncChargers();
+
+    bool hasAssignment(const Robot* robot) const;
+    Assignment getAssignment(const Robot* robot, double now) const;
+    int freeSlots(int chargerRoomId) const;
+    size_t queueLength(int chargerRoomId) const;
+    const Stats& getStats() const { return stats_; }
+
+    static double chargeSeconds(double batteryLevel);
+
+private:
+    struct Waiting {
+        std::shared_ptr<Robot> robot;
+        double requestedAt;
+    };
+    struct Charger {
+        ChargerSpec spec;
+        std::vector<std::shared_ptr<Robot>> occupants;
+        std::deque<Waiting> queue;
+
+        bool hasFreeSlot() const {
+            return spec.slots == ChargerSpec::kUnlimitedSlots ||
+                   static_cast<int>(occupants.size()) < spec.slots;
+        }
+    };
+
+    Charger* findCharger(int roomId);
+    const Charger* findCharger(int roomId) const;
+    double travelSeconds(const Robot& robot, const Charger& charger) const;
+    // Predicted sim time each waiting robot (in queue order) finishes charging
+    std::vector<double> predictQueue(const Charger& charger, double now) const;
+
+    const Map& map_;
+    std::vector<Charger> chargers_;
+    Stats stats_;
+};
+
+#endif // CHARGING_SCHEDULER_H
@@ -0,0 +1,119 @@
+#ifndef SIMULATION_CHECKPOINT_H
+#define SIMULATION_CHECKPOINT_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+class RobotSimulator;
+class Scheduler;
+class MongoDBAdapter;
+
+// Everything needed to bring the fleet back after a restart, as plain values
+// so it can be captured on the simulation thread and written from another.
+//
+// Robots come back idle in the room they were last in: a hop in progress is
+// dropped, and a robot that was cleaning keeps its remaining clean time on
+// the task and resumes it when it gets back to the room. Tasks keep their
+// ids; finished tasks are not kept.
+struct SimulationCheckpoint {
+    static constexpr int kVersion = 1;
+
+    struct RobotState {
+        std::string name;
+        int size = 0;               // Robot::Size
+        int strategy = 0;           // Robot::Strategy
+        double batteryLevel = 100.0;
+        double waterLevel = 100.0;
+        int roomId = -1;            // -1 when the robot was in no room
+        bool charging = false;
+        bool failed = false;
+        int errorCount = 0;
+        double totalWorkTime = 0.0;
+        bool lowBatteryAlertSent = false;
+        bool lowWaterAlertSent = false;
+        int currentTaskId = -1;     // task it was moving to or cleaning
+        int savedTaskId = -1;       // partly cleaned task it will come back to
+        double savedCleaningTimeRemaining = 0.0;
+    };
+
+    struct TaskState {
+        int id = 0;
+        int priority = 0;           // CleaningTask::Priority
+        int cleanType = 0;          // CleaningTask::CleanType
+        int roomId = -1;
+        std::string robot;          // empty when unassigned
+        bool queued = false;        // in the scheduler's queue, not only held by a robot
+    };
+
+    struct RoomState {
+        int roomId = -1;
+        bool clean = true;
+    };
+
+    int version = kVersion;
+    double simTime = 0.0;
+    int lastTaskId = 0;             // Scheduler's counter, below AutoTaskPlanner::kFirstTaskId
+    int nextGeneratedTaskId = 0;    // AutoTaskPlanner's next id; 0 when there was no planner
+    std::vector<RobotState> robots;
+    std::vector<TaskState> tasks;
+    std::vector<RoomState> rooms;
+
+    // Simulation thread only. scheduler may be null.
+    static SimulationCheckpoint capture(RobotSimulator& simulator, const Scheduler* scheduler);
+
+    // Replaces the simulator's robots, the scheduler's queue and room
+    // cleanliness, then sends robots back to their tasks or the charger.
+    // Rooms that no longer exist are skipped along with their tasks. When the
+    // simulator has an AutoTaskPlanner, its ids and outstanding rooms carry on
+    // from the checkpoint. Call before the first update. Throws
+    // std::runtime_error on a version it cannot read.
+    void restore(RobotSimulator& simulator, Scheduler& scheduler) const;
+};
+
+// Captures a checkpoint every intervalSeconds of simulated time and writes
+// it to MongoDB on a background thread. Only the latest capture waits to be
+// written; an older one that was not written yet is replaced.
+class Checkpointer {
+public:
+    explicit Checkpointer(std::shared_ptr<MongoDBAdapter> dbAdapter, double intervalSeconds = 10.0);
+    ~Checkpointer();
+
+    // Simulation thread: captures when the last capture is at least intervalSeconds old
+    void record(RobotSimulator& simulator, double now);
+
+    // The capture waiting to be written, if any. The write thread calls this; tests call it directly.
+    std::optional<SimulationCheckpoint> takePending();
+
+    void start();
+    // Writes the pending capture, then stops
+    void stop();
+    bool isRunning() const { return running_; }
+
+    uint64_t getCaptureCount() const { return captures_; }
+    uint64_t getWriteCount() const { return writes_; }
+
+private:
+    void run();
+    void flush();
+
+    std::shared_ptr<MongoDBAdapter> dbAdapter_;
+    double intervalSeconds_;
+    double lastCapture_ = -1.0;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::optional<SimulationCheckpoint> pending_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> captures_{0};
+    std::atomic<uint64_t> writes_{0};
+};
+
+#endif // SIMULATION_CHECKPOINT_H
@@ -0,0 +1,25 @@
+#ifndef CLEANING_RULES_H
+#define CLEANING_RULES_H
+
+#include <vector>
+#include "CleaningTask/cleaningTask.h"
+#include "Robot/Robot.h"
+#include "Room/Room.h"
+
+// Which robots and clean types suit a room. Carpet takes vacuum or shampoo,
+// hard floors take vacuum or scrub, anything else vacuum only, and the robot
+// size has to match the room size.
+class CleaningRules {
+public:
+    static std::vector<Robot::Strategy> acceptableStrategies(FloorType floor);
+    static Robot::Size robotSizeFor(RoomSize size);
+    static bool canClean(const Robot& robot, const Room& room);
+    // Same check from copied values, e.g. a fleet snapshot and a map snapshot room
+    static bool canClean(Robot::Size size, Robot::Strategy strategy, RoomSize roomSize, FloorType floor);
+
+    static CleaningTask::CleanType cleanTypeFor(Robot::Strategy strategy);
+    // The floor-specific clean for generated tasks: shampoo carpet, scrub hard floors
+    static CleaningTask::CleanType cleanTypeFor(FloorType floor);
+};
+
+#endif // CLEANING_RULES_H
@@ -32,6 +32,9 @@ public:
 
     std::shared_ptr<Robot> getRobot() const;
 
+    // Bumped whenever the status or assigned robot changes, so views can skip unchanged tasks
+    unsigned long getVersion() const { return version; }
+
     // Methods for assigning a task and marking task statuses
     void assignRobot(const std::shared_ptr<Robot>& robot);
     void markCompleted();
@@ -56,6 +59,7 @@ private:
     // std::shared_ptr<Room> room;
     Room* room;
     std::shared_ptr<Robot> robot;
+    unsigned long version = 0;
 };
 
 #endif // CLEANINGTASK_H
@@ -0,0 +1,97 @@
+#ifndef COMMAND_BUS_H
+#define COMMAND_BUS_H
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class RobotSimulator;
+class Robot;
+class Room;
+
+// Typed robot commands from the UI, applied in one batch at the next tick
+// boundary on the simulation thread. Robots are addressed by handle (their
+// index in RobotSimulator::getRobots(), which is also their row in the fleet
+// snapshot), so applying a command needs no search by name.
+//
+// submit() returns a future for the result. Redundant commands are coalesced
+// against the robot's latest pending command: repeating it shares its future,
+// and a new destination (move or return to charger) replaces a pending one in
+// its place in the queue, whose future reports it was superseded.
+class CommandBus {
+public:
+    using RobotHandle = size_t;
+
+    enum class CommandType {
+        START_CLEANING,
+        STOP_CLEANING,
+        RETURN_TO_CHARGER,
+        MOVE_TO_ROOM,
+        PICK_UP              // carry to a charger and repair
+    };
+
+    struct Command {
+        CommandType type = CommandType::START_CLEANING;
+        RobotHandle robot = 0;
+        int roomId = -1;     // MOVE_TO_ROOM only
+    };
+
+    struct Result {
+        bool ok = false;
+        std::string error;                // set when ok is false
+        std::shared_ptr<Robot> robot;
+        std::shared_ptr<Room> room;       // copy of the target or current room, for alerts
+    };
+
+    struct Ticket {
+        uint64_t id = 0;
+        std::shared_future<Result> result;
+        bool coalesced = false;           // joined a command that was already pending
+    };
+
+    struct Stats {
+        uint64_t submitted = 0;
+        uint64_t coalesced = 0;
+        uint64_t superseded = 0;
+        uint64_t applied = 0;
+        uint64_t failed = 0;
+        uint64_t batches = 0;
+    };
+
+    Ticket submit(const Command& command);
+
+    // Simulation thread: runs everything pending in submission order and
+    // resolves the futures. Returns the number of commands run.
+    size_t apply(RobotSimulator& simulator);
+
+    size_t pendingCount() const;
+    Stats getStats() const;
+
+    // Called after a new command is queued, outside the bus lock
+    void setWakeCallback(std::function<void()> wake);
+
+private:
+    struct Pending {
+        uint64_t id;
+        Command command;
+        std::promise<Result> promise;
+        std::shared_future<Result> future;
+    };
+
+    static bool isDestination(CommandType type) {
+        return type == CommandType::MOVE_TO_ROOM || type == CommandType::RETURN_TO_CHARGER;
+    }
+    Result execute(RobotSimulator& simulator, const Command& command);
+
+    mutable std::mutex mutex_;
+    std::vector<Pending> pending_;       // submission order
+    uint64_t nextId_ = 1;
+    Stats stats_;
+    std::function<void()> wake_;
+};
+
+#endif // COMMAND_BUS_H
@@ -0,0 +1,96 @@
+#ifndef DIRT_MODEL_H
+#define DIRT_MODEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+#include "Room/Room.h"
+
+class Map;
+
+// Per-room dirt that builds up between cleans. A room's level is a closed-form
+// line in time, min(kMaxDirt, intercept + rate * t), so nothing is touched per
+// tick: cleaning, robot visits and traffic changes only move the intercept or
+// rate of one room. Rooms with the same rate never change order, so each rate
+// keeps an indexed max-heap on intercept and top-K walks only the heads.
+// Rooms are marked dirty on the map when they cross the threshold.
+class DirtModel {
+public:
+    static constexpr double kMaxDirt = 100.0;
+    static constexpr double kDefaultDirtyThreshold = 30.0;
+    static constexpr double kVisitDirt = 1.0;        // tracked in by each robot entering a room
+
+    struct Ranked {
+        int roomId;
+        double dirt;
+    };
+
+    // Dirt per second on each floor type at normal traffic
+    static double baseRate(FloorType floor);
+
+    // Rooms the map already has dirty start at the threshold, clean ones at zero
+    DirtModel(const Map& map, double now = 0.0, double dirtyThreshold = kDefaultDirtyThreshold);
+
+    double dirtLevel(int roomId, double now) const;
+    bool isTracked(int roomId) const { return index_.count(roomId) > 0; }
+    size_t roomCount() const { return index_.size(); }
+    double getDirtyThreshold() const { return threshold_; }
+
+    void markCleaned(int roomId, double now);
+    void recordVisit(int roomId, double now, double amount = kVisitDirt);
+    // Scales the room's build-up rate, e.g. 2.0 for a hallway; default 1.0
+    void setTrafficMultiplier(int roomId, double multiplier, double now);
+
+    // Keeps the model in step with live map edits
+    void addRoom(Room* room, double now);
+    void removeRoom(int roomId);
+
+    // Marks rooms that crossed the threshold since the last call dirty and returns their ids
+    std::vector<int> update(double now);
+
+    // Dirtiest rooms first
+    std::vector<Ranked> topDirtiest(size_t k, double now) const;
+
+private:
+    struct Entry {
+        Room* room;
+        double intercept;
+        double baseRate;
+        double multiplier = 1.0;
+        size_t rateClass = 0;
+        size_t heapPos = 0;
+        uint64_t generation = 0;
+        bool dirty = false;
+        bool removed = false;
+    };
+    struct RateClass {
+        double rate;
+        std::vector<size_t> heap;   // entry indexes, max-heap on intercept
+    };
+    struct Crossing {
+        double time;
+        size_t entry;
+        uint64_t generation;
+        bool operator>(const Crossing& o) const { return time > o.time; }
+    };
+
+    double rateOf(const Entry& e) const { return classes_[e.rateClass].rate; }
+    double levelAt(const Entry& e, double now) const;
+    size_t classFor(double rate);
+    void heapInsert(size_t entry);
+    void heapErase(size_t entry);
+    void siftUp(RateClass& cls, size_t pos);
+    void siftDown(RateClass& cls, size_t pos);
+    void setLevel(size_t entry, double level, double now);
+    void scheduleCrossing(size_t entry);
+
+    double threshold_;
+    std::vector<Entry> entries_;
+    std::unordered_map<int, size_t> index_;     // room id -> entry
+    std::vector<RateClass> classes_;
+    std::priority_queue<Crossing, std::vector<Crossing>, std::greater<Crossing>> crossings_;
+};
+
+#endif // DIRT_MODEL_H
@@ -0,0 +1,55 @@
+#ifndef ENERGY_MODEL_H
+#define ENERGY_MODEL_H
+
+#include <vector>
+#include "CleaningTask/cleaningTask.h"
+
+class Map;
+class Room;
+class Robot;
+
+// Predicts whether a robot can reach a task room, clean it and still get back
+// to a charger, using the same drain rates the simulation applies in
+// Robot::updateState. Tasks that fail the check should not be dispatched.
+class EnergyModel {
+public:
+    struct Prediction {
+        bool reachable = false;         // a route to the room and back to a charger exists
+        bool feasible = false;          // reachable and resources stay above the abort thresholds
+        int routeHops = 0;              // current room -> task room
+        int returnHops = 0;             // task room -> nearest charger
+        double batteryNeeded = 0.0;
+        double waterNeeded = 0.0;
+        double batteryAfter = 0.0;      // predicted level when back at the charger
+        double waterAfter = 0.0;
+        double seconds = 0.0;           // travel + clean + return
+    };
+
+    // An empty charger list means the chargers declared on the map
+    explicit EnergyModel(const Map& map, std::vector<int> chargerRoomIds = {});
+
+    Prediction predict(const Robot& robot, const CleaningTask& task) const;
+    Prediction predict(Room* from, double batteryLevel, double waterLevel,
+                       Room* target, CleaningTask::CleanType cleanType) const;
+
+    // Resource cost of the clean itself, ignoring travel
+    static double cleaningBatteryCost(const Room& room);
+    static double cleaningWaterCost(const Room& room, CleaningTask::CleanType cleanType);
+    // True if cleaning the room would not trip the mid-clean low resource abort
+    static bool fitsCleaning(double batteryLevel, double waterLevel, const Room& room,
+                             CleaningTask::CleanType cleanType);
+
+    // Robot::needsCharging / needsWaterRefill thresholds
+    static constexpr double kMinimumBattery = 20.0;
+    static constexpr double kMinimumWater = 20.0;
+    // Movement advances 10% per second, so one hop takes 10 seconds
+    static constexpr double kTravelSecondsPerHop = 10.0;
+    // Robots do not drain battery while moving in the simulation
+    static constexpr double kTravelBatteryPerHop = 0.0;
+
+private:
+    const Map& map_;
+    std::vector<int> chargerRoomIds_;
+};
+
+#endif // ENERGY_MODEL_H
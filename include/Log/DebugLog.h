@@ -0,0 +1,31 @@
+#ifndef DEBUG_LOG_H
+#define DEBUG_LOG_H
+
+#include <iostream>
+#include <ostream>
+
+// Debug output for code that can run on the simulation's zone workers. A
+// worker points its own thread at a buffer, and the simulator prints the
+// buffers in order once the workers are joined; every other thread writes
+// straight to std::cout.
+namespace DebugLog {
+    inline thread_local std::ostream* threadSink = nullptr;
+
+    inline std::ostream& out() {
+        return threadSink ? *threadSink : std::cout;
+    }
+
+    // Sends this thread's debug output to sink until the scope ends
+    class Redirect {
+    public:
+        explicit Redirect(std::ostream& sink) : previous_(threadSink) { threadSink = &sink; }
+        ~Redirect() { threadSink = previous_; }
+        Redirect(const Redirect&) = delete;
+        Redirect& operator=(const Redirect&) = delete;
+
+    private:
+        std::ostream* previous_;
+    };
+}
+
+#endif // DEBUG_LOG_H
@@ -0,0 +1,71 @@
+#ifndef BUILDING_GENERATOR_H
+#define BUILDING_GENERATOR_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Robot/Robot.h"
+
+class Map;
+
+// Generates large synthetic buildings and fleets for benchmarks and load
+// tests. Each floor has a lobby with a charging station and corridors running
+// off it; rooms open onto corridor segments, some neighbouring rooms share a
+// door, and a share of doors are closed by virtual walls. Lobbies are linked
+// floor to floor. Rooms carry x/y/floor positions and each floor is a zone.
+//
+// The same options and seed always give the same building and fleet, on any
+// platform: draws come straight from std::mt19937 rather than the standard
+// distributions, whose output is implementation-defined.
+class BuildingGenerator {
+public:
+    struct Options {
+        uint32_t seed = 1;
+        int floors = 1;
+        int corridorsPerFloor = 2;
+        int roomsPerCorridor = 20;                        // split over both sides
+        std::array<double, 3> sizeWeights{0.4, 0.4, 0.2}; // small, medium, large
+        std::vector<std::pair<std::string, double>> flooringWeights{
+            {"tile", 0.3}, {"wood", 0.3}, {"carpet", 0.4}};
+        double adjacentDoorFraction = 0.2;   // rooms that also open into the next room along
+        double virtualWallFraction = 0.05;   // room doors closed by a virtual wall, never a room's only way in
+        double dirtyFraction = 0.5;
+        int chargerSlots = 3;
+        int robots = 9;                      // sizes and strategies cycle as in the app's fleet
+    };
+
+    struct FleetEntry {
+        std::string name;
+        Robot::Size size;
+        Robot::Strategy strategy;
+        int homeRoomId;                      // charging station the robot starts at
+    };
+
+    struct Building {
+        std::shared_ptr<Map> map;
+        std::vector<FleetEntry> fleet;
+    };
+
+    static Building generate(const Options& options);
+
+    // map.json layout, including positions, zones and chargers
+    static void writeMapJson(const Map& map, const std::string& filename);
+    static std::string mapJson(const Map& map);
+
+    // {"robots": [{"name", "size", "strategy", "homeRoomId"}]} with sizes and
+    // strategies spelled as in the app ("Large", "Vacuum", ...)
+    static void writeFleetJson(const std::vector<FleetEntry>& fleet, const std::string& filename);
+    static std::vector<FleetEntry> readFleetJson(const std::string& filename);
+    // Robots at their home rooms, full battery and water
+    static std::vector<std::shared_ptr<Robot>> createRobots(const std::vector<FleetEntry>& fleet, Map& map);
+
+    static std::string sizeName(Robot::Size size);
+    static std::string strategyName(Robot::Strategy strategy);
+    static Robot::Size parseSize(const std::string& name);
+    static Robot::Strategy parseStrategy(const std::string& name);
+};
+
+#endif // BUILDING_GENERATOR_H
@@ -0,0 +1,36 @@
+#ifndef MAP_LAYOUT_H
+#define MAP_LAYOUT_H
+
+#include <cstddef>
+#include <vector>
+#include "Room/Room.h"
+
+class Map;
+class MapSnapshot;
+
+// Force-directed placement for rooms that have no position in map.json.
+// Connected rooms pull towards kSpacing apart and nearby rooms push each
+// other away; rooms with a declared position stay put and only act on the
+// others. Repulsion is cut off past two spacings and found through a grid,
+// so a pass is linear in the number of rooms. The result is deterministic.
+// map_compiler runs this once and bakes the positions into map.bin.
+class MapLayout {
+public:
+    static constexpr double kSpacing = 120.0;
+
+    struct Node {
+        RoomPosition position;
+        bool pinned = false;
+        std::vector<size_t> neighbors;   // indexes into the node list
+    };
+
+    // Places every unpinned node; iterations <= 0 picks a count by graph size
+    static void layout(std::vector<Node>& nodes, int iterations = 0);
+
+    // Gives each room without a position one; returns how many were placed
+    static size_t assignMissingPositions(Map& map);
+    // Positions for every room of the snapshot, declared ones unchanged
+    static std::vector<RoomPosition> positionsFor(const MapSnapshot& snapshot);
+};
+
+#endif // MAP_LAYOUT_H
@@ -0,0 +1,60 @@
+#ifndef MAP_WATCHER_H
+#define MAP_WATCHER_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "map/MapDiff.h"
+
+class Map;
+
+// Watches a map file (inotify on Linux, mtime polling elsewhere) and turns
+// each edit into a MapDiff against the previous version of the file. Parsing
+// and diffing happen on the watcher thread against the watcher's own copy,
+// so the live map is never read here; the simulator takes the queued diffs
+// and applies them between ticks.
+class MapWatcher {
+public:
+    struct Stats {
+        long reloads = 0;
+        long failedReloads = 0;     // unreadable or half-written files, retried on the next change
+        long diffsQueued = 0;
+        double lastReloadMillis = 0.0;
+    };
+
+    // Loads path as the baseline for the first diff; throws if it cannot be read
+    explicit MapWatcher(const std::string& path);
+    ~MapWatcher();
+
+    void start();
+    void stop();
+    bool isRunning() const { return running_; }
+
+    // Re-reads the file now and queues a diff if the topology changed.
+    // Returns false when the file could not be parsed.
+    bool reload();
+
+    // Diffs queued since the last call, oldest first
+    std::vector<MapDiff> takePendingDiffs();
+    bool hasPendingDiffs() const;
+    Stats getStats() const;
+
+private:
+    void run();
+
+    std::string path_;
+    std::unique_ptr<Map> baseline_;     // last version read from disk
+    std::mutex reloadMutex_;
+    mutable std::mutex pendingMutex_;
+    std::vector<MapDiff> pending_;
+    Stats stats_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    int wakePipe_[2] = {-1, -1};        // written by stop() to interrupt poll()
+    int inotifyFd_ = -1;                // watch is set up in start() so no edit after it is missed
+};
+
+#endif // MAP_WATCHER_H
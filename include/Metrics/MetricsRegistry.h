@@ -0,0 +1,131 @@
+#ifndef METRICS_REGISTRY_H
+#define METRICS_REGISTRY_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Monotonic count. Increments land in one of kShards cache-line sized slots
+// picked per thread, so threads bumping the same counter never share a line;
+// value() adds the slots up.
+class Counter {
+public:
+    static constexpr size_t kShards = 16;
+
+    void inc(uint64_t n = 1) { shards_[shardIndex()].value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const;
+
+    // Slot for the calling thread, assigned round robin on first use
+    static size_t shardIndex();
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Shard, kShards> shards_{};
+};
+
+// Value that goes up and down: queue depths, robots per status
+class Gauge {
+public:
+    void set(double value) { value_.store(value, std::memory_order_relaxed); }
+    void add(double delta);
+    double value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> value_{0.0};
+};
+
+// Prometheus histogram: counts per upper bound ("le"), plus sum and count.
+// Bounds are fixed at registration; observations past the last bound count
+// only towards +Inf.
+class Histogram {
+public:
+    explicit Histogram(std::vector<double> bounds);
+
+    void observe(double value);
+    void observeSince(std::chrono::steady_clock::time_point start);
+
+    const std::vector<double>& bounds() const { return bounds_; }
+    // Per bucket, not cumulative; the last entry is the +Inf overflow
+    std::vector<uint64_t> bucketCounts() const;
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    double sum() const { return sum_.load(std::memory_order_relaxed); }
+
+    // 0.5ms to 10s, for ticks and database writes
+    static std::vector<double> latencyBounds();
+
+    // Observes the time since construction when it goes out of scope
+    class Timer {
+    public:
+        explicit Timer(Histogram& histogram) : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+        ~Timer() { histogram_.observeSince(start_); }
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+    private:
+        Histogram& histogram_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+private:
+    std::vector<double> bounds_;
+    std::unique_ptr<std::atomic<uint64_t>[]> buckets_;
+    std::atomic<uint64_t> count_{0};
+    std::atomic<double> sum_{0.0};
+};
+
+// In-process metrics, rendered in the Prometheus text exposition format
+// (version 0.0.4) for scraping through MetricsServer.
+//
+// Look a metric up once and keep the reference: lookups take a lock, updates
+// never do. References stay valid for the registry's lifetime.
+//
+//     static Counter& saved = MetricsRegistry::global().counter("robot_alerts_saved_total", "Alerts saved");
+//     saved.inc();
+class MetricsRegistry {
+public:
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+
+    // The registry the simulator, database adapter and metrics endpoint share
+    static MetricsRegistry& global();
+
+    // Registering a name again with other labels adds a series to the same
+    // family; registering it as another type throws std::runtime_error.
+    Counter& counter(const std::string& name, const std::string& help, const Labels& labels = {});
+    Gauge& gauge(const std::string& name, const std::string& help, const Labels& labels = {});
+    // The first registration of a family fixes its bounds
+    Histogram& histogram(const std::string& name, const std::string& help,
+                         const Labels& labels = {},
+                         const std::vector<double>& bounds = Histogram::latencyBounds());
+
+    std::string exposition() const;
+
+private:
+    enum class Type { COUNTER, GAUGE, HISTOGRAM };
+
+    struct Family {
+        Type type;
+        std::string help;
+        std::vector<double> bounds;
+        // Keyed by the rendered label set, so series print in a stable order
+        std::map<std::string, std::unique_ptr<Counter>> counters;
+        std::map<std::string, std::unique_ptr<Gauge>> gauges;
+        std::map<std::string, std::unique_ptr<Histogram>> histograms;
+    };
+
+    Family& family(const std::string& name, const std::string& help, Type type);
+    static const char* typeName(Type type);
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Family> families_;
+};
+
+#endif // METRICS_REGISTRY_H
@@ -0,0 +1,42 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+class MetricsRegistry;
+
+// Minimal HTTP/1.0 endpoint answering GET /metrics with the registry's text
+// exposition, for a Prometheus scraper or curl. Listens on the loopback
+// interface only and serves one connection at a time on its own thread.
+class MetricsServer {
+public:
+    static constexpr uint16_t kDefaultPort = 9464;
+
+    // Port 0 picks a free port; read it back with getPort() after start()
+    explicit MetricsServer(MetricsRegistry& registry, uint16_t port = kDefaultPort);
+    ~MetricsServer();
+
+    // Throws std::runtime_error if the port cannot be bound
+    void start();
+    void stop();
+    bool isRunning() const { return running_; }
+    uint16_t getPort() const { return port_; }
+
+    uint64_t getScrapeCount() const { return scrapes_; }
+
+private:
+    void run();
+    void serve(int client);
+
+    MetricsRegistry& registry_;
+    uint16_t port_;
+    int listenFd_ = -1;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> scrapes_{0};
+};
+
+#endif // METRICS_SERVER_H
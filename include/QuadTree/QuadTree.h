@@ -0,0 +1,58 @@
+#ifndef QUAD_TREE_H
+#define QUAD_TREE_H
+
+#include <cstddef>
+#include <vector>
+
+// Static point quadtree, bulk-built from a list of ids with positions. Items
+// are reordered so every node owns a contiguous range, which keeps queries to
+// a few cache-friendly scans. Used by the map panel for viewport culling and
+// click hit-testing.
+class QuadTree {
+public:
+    static constexpr size_t kLeafSize = 8;
+    static constexpr int kMaxDepth = 20;
+
+    struct Item {
+        double x;
+        double y;
+        int id;
+    };
+
+    struct Box {
+        double minX;
+        double minY;
+        double maxX;
+        double maxY;
+        bool contains(double x, double y) const { return x >= minX && x <= maxX && y >= minY && y <= maxY; }
+        bool contains(const Box& o) const { return o.minX >= minX && o.maxX <= maxX && o.minY >= minY && o.maxY <= maxY; }
+        bool intersects(const Box& o) const { return o.minX <= maxX && o.maxX >= minX && o.minY <= maxY && o.maxY >= minY; }
+    };
+
+    QuadTree() = default;
+    explicit QuadTree(std::vector<Item> items);
+
+    size_t size() const { return items_.size(); }
+    bool empty() const { return items_.empty(); }
+    Box bounds() const;
+
+    // Appends the ids of items inside area
+    void query(const Box& area, std::vector<int>& out) const;
+    // Closest item no further than maxDistance from (x, y); -1 if there is none
+    int nearest(double x, double y, double maxDistance) const;
+
+private:
+    struct Node {
+        Box bounds;
+        size_t begin;
+        size_t end;
+        int firstChild = -1;    // the four children are stored next to each other
+    };
+
+    void split(size_t node, int depth);
+
+    std::vector<Item> items_;
+    std::vector<Node> nodes_;
+};
+
+#endif // QUAD_TREE_H
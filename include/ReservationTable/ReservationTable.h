@@ -0,0 +1,74 @@
+#ifndef RESERVATION_TABLE_H
+#define RESERVATION_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class Map;
+class Room;
+class Robot;
+
+// Space-time reservation table for cooperative A* routing. Time is split into
+// slots of one hop each; a plan reserves every (room, slot) and (edge, slot)
+// it uses so robots planned later route or wait around it.
+class ReservationTable {
+public:
+    struct Stats {
+        long plans = 0;
+        long fallbacks = 0;          // searches that hit the horizon and used Map::getRoute
+        double planningMicros = 0.0; // total time spent in planRoute
+        long waitSlots = 0;          // total slots robots were told to wait
+    };
+
+    // Movement advances 10% per second, so one hop takes 10 seconds
+    static constexpr double kSecondsPerSlot = 10.0;
+
+    // Rooms in unlimitedRoomIds are never reserved; empty means the map's chargers
+    ReservationTable(const Map& map, std::unordered_set<int> unlimitedRoomIds = {});
+
+    // Plans from `from` to `to` starting at `startSlot`, reserves the result and
+    // returns it as one room id per slot (a repeated id means wait in place).
+    // dwellSlots keeps the destination reserved while the robot works there.
+    std::vector<int> planRoute(const Robot* owner, Room* from, Room* to, long startSlot, int dwellSlots = 0);
+
+    void release(const Robot* owner);
+    void advanceTo(long slot);           // drops reservations older than slot
+    void setRoomCapacity(int roomId, int capacity);
+
+    const Stats& getStats() const { return stats_; }
+    size_t reservationCount() const { return vertexCount_.size(); }
+
+private:
+    struct Key {
+        int from;
+        int to;      // equal to from for room reservations
+        long slot;
+        bool operator==(const Key& o) const { return from == o.from && to == o.to && slot == o.slot; }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const {
+            uint64_t h = static_cast<uint64_t>(k.slot) * 0x9E3779B97F4A7C15ULL;
+            h ^= (static_cast<uint64_t>(static_cast<uint32_t>(k.from)) << 32) | static_cast<uint32_t>(k.to);
+            return static_cast<size_t>(h ^ (h >> 29));
+        }
+    };
+
+    bool roomFree(int roomId, long slot) const;
+    bool edgeFree(int from, int to, long slot) const;
+    void reserve(const Robot* owner, const std::vector<int>& path, long startSlot, int dwellSlots);
+
+    const Map& map_;
+    std::unordered_set<int> unlimitedRoomIds_;
+    std::unordered_map<int, int> capacity_;
+    std::unordered_map<Key, int, KeyHash> vertexCount_;
+    std::unordered_map<Key, int, KeyHash> edgeCount_;
+    std::unordered_map<const Robot*, std::vector<Key>> ownerVertices_;
+    std::unordered_map<const Robot*, std::vector<Key>> ownerEdges_;
+    long oldestSlot_;
+    Stats stats_;
+};
+
+#endif // RESERVATION_TABLE_H
@@ -4,6 +4,7 @@
 #include <string>
 #include <memory>
 #include <queue>
+#include <random>
 #include "CleaningTask/cleaningTask.h"
 #include "Room/Room.h"
 #include "map/map.h"
@@ -17,7 +18,9 @@ public:
     // Modified constructor to accept size and strategy
     Robot(const std::string& name, double batteryLevel, Size size, Strategy strategy, double waterLevel = 100.0);
 
-    void updateState(double deltaTime);
+    // requestTask false skips taking work from the TaskScheduler, which can move
+    // the robot anywhere; zone workers leave that to the simulator's serial pass
+    void updateState(double deltaTime, bool requestTask = true);
     void startCleaning(CleaningTask::CleanType cleaningType);
     void stopCleaning();
     void setMovementPath(const std::vector<int>& roomIds, const Map& map);
@@ -38,6 +41,9 @@ public:
     void fullyRecharge();
 
     bool isCharging() const;
+    // Set while the robot is queued at a charger with no free slot
+    void setWaitingForCharger(bool waiting) { waitingForCharger_ = waiting; }
+    bool isWaitingForCharger() const { return waitingForCharger_; }
     double getMovementProgress() const;
     bool needsMaintenance() const;
     bool isLowBatteryAlertSent() const;
@@ -49,11 +55,30 @@ public:
     void setCurrentTask(std::shared_ptr<CleaningTask> task);
     std::shared_ptr<CleaningTask> getCurrentTask() const;
     void setTargetRoom(Room* room);
+    // Next room followed by the queued rooms, empty when not moving
+    std::vector<Room*> getRemainingPath() const;
+    // Drops the hop in progress and the queued path; the robot stays where it is
+    void abandonHop();
 
-    void saveCurrentTask();
+    // True when a clean in progress was saved to resume later
+    bool saveCurrentTask();
     bool resumeSavedTask();
+    std::shared_ptr<CleaningTask> getSavedTask() const { return savedTask_; }
+    double getSavedCleaningTimeRemaining() const { return savedCleaningTimeRemaining_; }
+    double getCleaningTimeRemaining() const { return cleaningTimeRemaining_; }
+
+    // Warm restart: puts back a partly cleaned task
+    void restoreSavedTask(std::shared_ptr<CleaningTask> task, double cleaningTimeRemaining);
     void setMap(Map* m) { robotMap_ = m; }
 
+    // Seconds needed to clean a room, based on its size
+    static double cleaningTimeForRoom(const Room& room);
+
+    // Resource rates shared by the simulation and the planners (percent per second)
+    static constexpr double kCleaningBatteryDrainPerSecond = 5.0;
+    static constexpr double kShampooWaterDrainPerSecond = 5.0;
+    static constexpr double kChargeRatePerSecond = 20.0;
+
     // Getters for size and strategy if needed
     Size getSize() const { return size_; }
     Strategy getStrategy() const { return strategy_; }
@@ -72,12 +97,26 @@ public:
     bool requestNextTask();
     bool canAcceptTask() const;
 
+    // Energy thrash counters: dispatches refused up front, tasks aborted after
+    // arriving, and the hops spent travelling to those aborted tasks
+    void recordPreemptiveAbort() { preemptiveAborts_++; }
+    int getPreemptiveAborts() const { return preemptiveAborts_; }
+    int getMidTaskAborts() const { return midTaskAborts_; }
+    int getWastedTravelHops() const { return wastedTravelHops_; }
+    // Set when the robot declined queued work for lack of charge; the simulator
+    // sends it to a charger and clears it
+    bool takeChargeRequest() { bool requested = chargeRequested_; chargeRequested_ = false; return requested; }
+    // A scheduler-assigned task given back after arriving without the resources
+    // to clean; the simulator requeues it on the robot's scheduler
+    std::shared_ptr<CleaningTask> takeReturnedTask() { return std::move(returnedTask_); }
+
 private:
     std::string name_;
     double batteryLevel_;
     double waterLevel_;
     bool cleaning_;
     bool isCharging_;
+    bool waitingForCharger_ = false;
     double cleaningProgress_;
     double movementProgress_;
     Room* currentRoom_;
@@ -96,6 +135,18 @@ private:
 
     Size size_;
     Strategy strategy_;
+
+    int hopsTowardTask_;
+    int preemptiveAborts_;
+    int midTaskAborts_;
+    int wastedTravelHops_;
+    int declinedTaskId_ = -1;       // last task declined, so each one is counted once
+    bool chargeRequested_ = false;
+    std::shared_ptr<CleaningTask> returnedTask_;
+    std::minstd_rand rng_;          // per robot, so zone workers never share one
+
+    void recordMidTaskAbort();
+    void giveBackCurrentTask();
 };
 
 #endif // ROBOT_H
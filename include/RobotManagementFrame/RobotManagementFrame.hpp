@@ -22,6 +22,10 @@
 
 class LoginDialog;
 class AlertDialog;
+class RobotStatusTable;
+class TickProfilePanel;
+class SimulationThread;
+class MetricsServer;
 
 enum {
     ALERT_TIMER_ID = wxID_HIGHEST + 1,
@@ -71,10 +75,14 @@ private:
     std::shared_ptr<MongoDBAdapter> dbAdapter;
     std::shared_ptr<AlertSystem> alertSystem;    // Changed to shared_ptr
     std::shared_ptr<RobotSimulator> simulator_;  // Changed to shared_ptr
+    std::shared_ptr<SimulationThread> simulation_;
+    std::shared_ptr<MetricsServer> metricsServer_;
     std::shared_ptr<Scheduler> scheduler_;       // Changed to shared_ptr
     std::shared_ptr<User> currentUser;
 
     wxGrid* robotGrid;
+    RobotStatusTable* robotStatusTable_;   // owned by robotGrid
+    TickProfilePanel* tickProfilePanel_;
     wxTimer* statusUpdateTimer;
     wxTimer* alertCheckTimer;
     MapPanel* mapPanel_;  
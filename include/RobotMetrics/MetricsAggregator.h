@@ -0,0 +1,121 @@
+#ifndef METRICS_AGGREGATOR_H
+#define METRICS_AGGREGATOR_H
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "RobotMetrics/robot_metrics.h"
+
+class Robot;
+
+// Rolling RobotMetrics per robot and for the whole fleet over the last
+// minute, hour and day of simulated time.
+//
+// The simulator calls observe() once per tick. For each robot, the time
+// since its last sample is charged to the state it was in. So are the
+// battery and water it used. A move into ERROR counts as one error. Every
+// window is a ring of kBuckets buckets with a running total. Reading a
+// window is O(1). A write adds to one bucket; each bucket rollover rebuilds
+// the total from the buckets, so it never drifts. Windows are as of the
+// last observe().
+//
+// Metrics mean:
+//   utilization     share of observed time spent moving or cleaning
+//   errorRate       errors per hour (per robot-hour for the fleet)
+//   timeEfficiency  share of busy time spent cleaning rather than travelling
+//   costEfficiency  share of battery used while cleaning
+//   batteryUsage    battery percent used per hour
+//   waterUsage      water percent used per hour
+// Ratios with nothing to divide by are 0.
+//
+// Thread-safe: the simulation thread writes, panels read.
+class MetricsAggregator {
+public:
+    enum class Window { MINUTE, HOUR, DAY };
+    static constexpr size_t kWindowCount = 3;
+    static constexpr size_t kBuckets = 60;
+
+    enum class State { IDLE, MOVING, CLEANING, CHARGING, ERROR };
+    static constexpr size_t kStateCount = 5;
+
+    struct Totals {
+        std::array<double, kStateCount> seconds{};
+        double batteryUsed = 0.0;           // percent points
+        double waterUsed = 0.0;
+        double cleaningBatteryUsed = 0.0;
+        double errors = 0.0;
+
+        void add(const Totals& other);
+        double observedSeconds() const;
+        double busySeconds() const;
+    };
+
+    // Samples every robot at simulated time now. Robots are identified by
+    // their index in the list, as in RobotSimulator::getRobots().
+    void observe(const std::vector<std::shared_ptr<Robot>>& robots, double now);
+    // Charges one interval directly, for callers that track transitions themselves
+    void record(size_t robot, State state, double seconds, double batteryUsed, double waterUsed,
+                bool errorEntered, double now);
+
+    RobotMetrics robotMetrics(size_t robot, Window window) const;
+    RobotMetrics fleetMetrics(Window window) const;
+    Totals robotTotals(size_t robot, Window window) const;
+    Totals fleetTotals(Window window) const;
+
+    size_t robotCount() const;
+    // Name seen at the robot's last observe(); empty for robots only fed through record()
+    std::string robotName(size_t robot) const;
+    void reset();
+
+    static State stateOf(const Robot& robot);
+    static RobotMetrics toMetrics(const Totals& totals);
+    static double windowSeconds(Window window);
+    static const char* windowName(Window window);
+
+private:
+    class Ring {
+    public:
+        explicit Ring(double bucketSeconds) : bucketSeconds_(bucketSeconds) {}
+        void add(double now, const Totals& delta);
+        const Totals& total() const { return total_; }
+
+    private:
+        double bucketSeconds_;
+        long head_ = -1;                    // bucket number of the newest bucket
+        std::array<Totals, kBuckets> buckets_{};
+        Totals total_;
+    };
+
+    struct Windows {
+        Windows();
+        void add(double now, const Totals& delta);
+        std::array<Ring, kWindowCount> rings;
+    };
+
+    struct Sample {
+        bool seen = false;
+        State state = State::IDLE;
+        double battery = 0.0;
+        double water = 0.0;
+        double time = 0.0;
+    };
+
+    struct RobotEntry {
+        std::string name;
+        Sample last;
+        Windows windows;
+    };
+
+    RobotEntry& entry(size_t robot);
+    void recordLocked(size_t robot, State state, double seconds, double batteryUsed, double waterUsed,
+                      bool errorEntered, double now);
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<RobotEntry>> robots_;
+    Windows fleet_;
+};
+
+#endif // METRICS_AGGREGATOR_H
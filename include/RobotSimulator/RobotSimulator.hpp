@@ -2,8 +2,14 @@
 #define ROBOT_SIMULATOR_HPP
 
 #include <vector>
+#include <deque>
 #include <memory>
 #include <string>
+#include <cstdint>
+#include <unordered_map>
+#include "ReservationTable/ReservationTable.h"
+#include "ChargingScheduler/ChargingScheduler.h"
+#include "TickProfiler/TickProfiler.h"
 
 class Robot;
 class Scheduler;
@@ -11,6 +17,17 @@ class AlertSystem;
 class Map;
 class CleaningTask;
 class MongoDBAdapter;
+class Room;
+class ZonePartition;
+class ZoneDispatcher;
+class MapWatcher;
+class MapSnapshot;
+class DirtModel;
+class AutoTaskPlanner;
+class MetricsAggregator;
+class TelemetryWriter;
+class Checkpointer;
+struct MapDiff;
 
 class RobotSimulator {
 public:
@@ -25,7 +42,15 @@ public:
     void stopRobotCleaning(const std::string& robotName);
     void manuallyPickUpRobot(const std::string& robotName);
     void requestReturnToCharger(const std::string& robotName);
+    // Same operations on a robot already in hand, skipping the lookup by name
+    void moveRobotToRoom(const std::shared_ptr<Robot>& robot, int roomId);
+    void startRobotCleaning(const std::shared_ptr<Robot>& robot);
+    void stopRobotCleaning(const std::shared_ptr<Robot>& robot);
+    void manuallyPickUpRobot(const std::shared_ptr<Robot>& robot);
+    void requestReturnToCharger(const std::shared_ptr<Robot>& robot);
     void addRobot(const std::string& robotName);
+    // Puts a robot built elsewhere on the simulator's map; one without a room starts at the first charger
+    void addRobot(std::shared_ptr<Robot> robot);
 
     // Now return a non-const reference so we can modify the vector
     std::vector<std::shared_ptr<Robot>>& getRobots();
@@ -41,23 +66,127 @@ public:
     };
 
     std::vector<RobotStatus> getRobotStatuses() const;
+    RobotStatus getRobotStatus(size_t index) const;
+
+    // Status change feed for views. Each update() ends with
+    // collectStatusChanges(), which bumps the status version once if any
+    // robot's displayed status moved (levels at 0.1% resolution). Views keep
+    // the last version they drew and ask only for the robots changed since.
+    uint64_t collectStatusChanges();
+    uint64_t getStatusVersion() const { return statusVersion_; }
+    // Indexes into getRobots(), ascending; every robot if sinceVersion is
+    // older than the retained change log
+    std::vector<size_t> getChangedRobots(uint64_t sinceVersion) const;
+
+    // Fleet-wide totals of the per-robot energy thrash counters
+    struct EnergyStats {
+        int preemptiveAborts;
+        int midTaskAborts;
+        int wastedTravelHops;
+    };
+    EnergyStats getEnergyStats() const;
     const Map& getMap() const;  
+    // Latest published topology, safe to read from any thread
+    std::shared_ptr<const MapSnapshot> getMapSnapshot() const;
     std::shared_ptr<AlertSystem> getAlertSystem() const;
 
+    // Optional space-time reservations so robots route around each other
+    void enableTrafficReservation(bool enabled);
+    bool isTrafficReservationEnabled() const { return reservations_ != nullptr; }
+    ReservationTable::Stats getTrafficStats() const;
+
+    // Charger slot assignment and queueing
+    ChargingScheduler::Assignment getChargerAssignment(const std::string& robotName);
+    ChargingScheduler::Stats getChargingStats() const;
+
+    // With zones set, robots in different zones advance on separate workers and
+    // routes are stitched zone by zone; a dispatcher replaces the single scheduler
+    void setZonePartition(std::shared_ptr<ZonePartition> zones) { zones_ = zones; }
+    void setZoneDispatcher(std::shared_ptr<ZoneDispatcher> dispatcher) { zoneDispatcher_ = dispatcher; }
+
+    // Edits picked up by the watcher are applied at the start of the next update
+    void setMapWatcher(std::shared_ptr<MapWatcher> watcher) { mapWatcher_ = watcher; }
+    // Applies a live map edit and re-routes only robots whose remaining path it
+    // broke or whose room it removed; returns how many robots were re-routed
+    int applyMapDiff(const MapDiff& diff);
+
+    // Rooms get dirty again over time; finished cleans and robot visits feed the model
+    void enableDirtModel(double dirtyThreshold);
+    std::shared_ptr<DirtModel> getDirtModel() const { return dirtModel_; }
+    double getSimTime() const { return simTime_; }
+    // Warm restart only, before the first update
+    void setSimTime(double simTime) { simTime_ = simTime; }
+
+    // Rooms that turn dirty, finish a task or change on a map edit are reported to the planner
+    void setAutoTaskPlanner(std::shared_ptr<AutoTaskPlanner> planner) { autoTaskPlanner_ = planner; }
+    std::shared_ptr<AutoTaskPlanner> getAutoTaskPlanner() const { return autoTaskPlanner_; }
+
+    // Sampled at the end of every tick; the analytics panel and analytics saves read its windows
+    void setMetricsAggregator(std::shared_ptr<MetricsAggregator> aggregator) { metricsAggregator_ = aggregator; }
+    std::shared_ptr<MetricsAggregator> getMetricsAggregator() const { return metricsAggregator_; }
+    // Robot battery, water, room and state history; sampled at the end of every tick
+    void setTelemetryWriter(std::shared_ptr<TelemetryWriter> writer) { telemetry_ = writer; }
+    std::shared_ptr<TelemetryWriter> getTelemetryWriter() const { return telemetry_; }
+    // Captures warm restart state every few simulated seconds; written off the simulation thread
+    void setCheckpointer(std::shared_ptr<Checkpointer> checkpointer) { checkpointer_ = checkpointer; }
+    std::shared_ptr<Checkpointer> getCheckpointer() const { return checkpointer_; }
+
+    // Per-phase tick timings; off until enabled, safe to read from any thread
+    TickProfiler& getProfiler() { return profiler_; }
+
     void assignTaskToRobot(std::shared_ptr<CleaningTask> task);
+    void setScheduler(std::shared_ptr<Scheduler> scheduler) { scheduler_ = scheduler; }
+    std::shared_ptr<Scheduler> getScheduler() const { return scheduler_; }
     std::shared_ptr<MongoDBAdapter> getDbAdapter() const {
         return dbAdapter_;
     }
 
 private:
     std::vector<std::shared_ptr<Robot>> robots_;
+    TickProfiler profiler_;
     std::shared_ptr<Map> map_;
     std::shared_ptr<Scheduler> scheduler_;
     std::shared_ptr<AlertSystem> alertSystem_;
     std::shared_ptr<MongoDBAdapter> dbAdapter_;
+    std::shared_ptr<ReservationTable> reservations_;
+    std::shared_ptr<ChargingScheduler> chargingScheduler_;
+    std::shared_ptr<ZonePartition> zones_;
+    std::shared_ptr<ZoneDispatcher> zoneDispatcher_;
+    std::shared_ptr<MapWatcher> mapWatcher_;
+    std::shared_ptr<DirtModel> dirtModel_;
+    std::shared_ptr<AutoTaskPlanner> autoTaskPlanner_;
+    std::shared_ptr<MetricsAggregator> metricsAggregator_;
+    std::shared_ptr<TelemetryWriter> telemetry_;
+    std::shared_ptr<Checkpointer> checkpointer_;
+    double simTime_ = 0.0;
+    std::unordered_map<const Robot*, Room*> occupiedRooms_;   // room each robot is counted in
+
+    // What a status row shows, kept compact so comparing it is cheap
+    struct StatusKey {
+        const Robot* robot;
+        long battery;       // tenths of a percent
+        long water;
+        int state;
+        const Room* room;
+        bool operator==(const StatusKey& other) const;
+    };
+    std::vector<StatusKey> statusKeys_;                       // per robot, as of the last collect
+    std::deque<std::pair<uint64_t, size_t>> statusLog_;       // (version, robot index), ascending
+    uint64_t statusLogFloor_ = 0;                             // changes at or below this were trimmed
+    uint64_t statusVersion_ = 0;
 
     void checkRobotStatesAndSendAlerts();
+    void advanceRobots(double deltaTime);
+    void updateOccupancy();
+    std::shared_ptr<Scheduler> schedulerFor(const std::shared_ptr<Robot>& robot) const;
+    bool hopOpen(Room* from, Room* to) const;
+    std::vector<int> planRoute(const std::shared_ptr<Robot>& robot, Room* from, Room* to, int dwellSlots = 0);
     void handleNoTaskAndReturnToChargerIfNeeded(std::shared_ptr<Robot> robot);
+    void dispatchNextTask(std::shared_ptr<Robot> robot);
+    // Stops a robot whose room was removed and puts it back in a live room
+    void evacuateRemovedRoom(const std::shared_ptr<Robot>& robot);
+    // Where new and displaced robots are put: a charger when one is left
+    Room* homeRoom() const;
     std::shared_ptr<Robot> getRobotByName(const std::string& name);
 };
 
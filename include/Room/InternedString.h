@@ -0,0 +1,39 @@
+#ifndef INTERNED_STRING_H
+#define INTERNED_STRING_H
+
+#include <ostream>
+#include <string>
+
+// Handle to a string stored once in a process-wide pool. Rooms use it for
+// flooring type and size, which only take a handful of distinct values, so
+// copies and comparisons are pointer-sized and a map of thousands of rooms
+// holds each value once.
+class InternedString {
+public:
+    InternedString();
+    InternedString(const std::string& value);
+    InternedString(const char* value);
+
+    const std::string& str() const { return *value_; }
+    operator const std::string&() const { return *value_; }
+    bool empty() const { return value_->empty(); }
+
+    bool operator==(const InternedString& other) const { return value_ == other.value_; }
+    bool operator!=(const InternedString& other) const { return value_ != other.value_; }
+
+private:
+    const std::string* value_;
+};
+
+inline bool operator==(const InternedString& a, const std::string& b) { return a.str() == b; }
+inline bool operator==(const std::string& a, const InternedString& b) { return a == b.str(); }
+inline bool operator==(const InternedString& a, const char* b) { return a.str() == b; }
+inline bool operator==(const char* a, const InternedString& b) { return b.str() == a; }
+inline bool operator!=(const InternedString& a, const std::string& b) { return !(a == b); }
+inline bool operator!=(const std::string& a, const InternedString& b) { return !(a == b); }
+inline bool operator!=(const InternedString& a, const char* b) { return !(a == b); }
+inline bool operator!=(const char* a, const InternedString& b) { return !(a == b); }
+
+inline std::ostream& operator<<(std::ostream& os, const InternedString& s) { return os << s.str(); }
+
+#endif // INTERNED_STRING_H
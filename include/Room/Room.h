@@ -2,19 +2,44 @@
 #define ROOM_H
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include "Room/InternedString.h"
 
 // Forward declaration
 class Map;
+class RoomStateTable;
+
+// Parsed once when a room is built so hot paths never touch the strings.
+// Unknown sizes count as large, matching the old cleaning-time fallback.
+enum class RoomSize { SMALL, MEDIUM, LARGE };
+enum class FloorType { CARPET, WOOD, HARDWOOD, TILE, OTHER };
+
+RoomSize parseRoomSize(std::string_view size);         // case-insensitive
+FloorType parseFloorType(std::string_view flooring);   // case-insensitive
+inline bool isHardFloor(FloorType type) {
+    return type == FloorType::WOOD || type == FloorType::HARDWOOD || type == FloorType::TILE;
+}
+
+// Where a room is drawn, in map units; level is the building floor.
+// Rooms without a declared position get one from MapLayout.
+struct RoomPosition {
+    double x = 0.0;
+    double y = 0.0;
+    int level = 0;
+    bool operator==(const RoomPosition& o) const { return x == o.x && y == o.y && level == o.level; }
+    bool operator!=(const RoomPosition& o) const { return !(*this == o); }
+};
 
 class Room {
 public:
     // Attributes
     std::string roomName;
     int roomId;
-    std::string flooringType;   // Hardwood, carpet, etc.
-    bool isRoomClean;           // true when clean, false when dirty (default to true)
-    std::string size;           // small, medium, or large
+    InternedString flooringType;    // Hardwood, carpet, etc.
+    InternedString size;            // small, medium, or large
+    RoomSize roomSize;              // parsed from size
+    FloorType floorType;            // parsed from flooringType
     std::vector<Room*> neighbors;
     Map* map;  // Pointer to the map this room belongs to
 
@@ -24,11 +49,16 @@ public:
          const std::vector<Room*>& neighbors = std::vector<Room*>());
 
     // Getter methods
-    std::string getRoomName() const;
+    const std::string& getRoomName() const;
     int getRoomId() const;
-    std::string getSize() const;
-    std::string getFlooringType() const;
+    const std::string& getSize() const;
+    const std::string& getFlooringType() const;
+    RoomSize getRoomSize() const { return roomSize; }
+    FloorType getFloorType() const { return floorType; }
     Map* getMap() const { return map; }
+    // Reads the map's state table, so any thread may call it; detached copies
+    // answer with the value they were copied with
+    bool isClean() const;
 
     // Methods
     void getRoomInfo() const;
@@ -36,9 +66,40 @@ public:
     void markDirty();   // Mark a room as dirty
     void addNeighbor(Room* neighbor);       // Add a neighbor room
     void setMap(Map* m) { map = m; }
+    // Keep the parsed enums in step with the strings
+    void setSize(const std::string& newSize);
+    void setFlooringType(const std::string& newFlooringType);
+
+    // Optional x/y/floor from map.json or the compiled map
+    bool hasPosition() const { return hasPosition_; }
+    const RoomPosition& getPosition() const { return position_; }
+    void setPosition(const RoomPosition& position);
+    void clearPosition();
+
+    // Rooms owned by a Map mirror their cleanliness into the map's lock-free
+    // state table; copies start detached so they never write into it
+    void attachState(RoomStateTable* table, size_t slot);
+    bool hasStateSlot() const { return state_.table != nullptr; }
+    size_t getStateSlot() const { return state_.slot; }
+    void addOccupant(int delta);
 
     // Destructor (optional)
     ~Room() = default;
+
+private:
+    // Cleanliness lives in the table once attached; clean is only used while detached
+    struct StateLink {
+        RoomStateTable* table = nullptr;
+        size_t slot = 0;
+        bool clean = true;
+        StateLink() = default;
+        StateLink(const StateLink& other);
+        StateLink& operator=(const StateLink& other);
+        bool isClean() const;
+    };
+    StateLink state_;
+    RoomPosition position_;
+    bool hasPosition_ = false;
 };
 
 #endif // ROOM_H
\ No newline at end of file
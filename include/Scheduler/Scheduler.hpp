@@ -4,7 +4,10 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <unordered_set>
 #include "CleaningTask/cleaningTask.h"
+#include "TourPlanner/TourPlanner.h"
 
 class Map;
 class Robot;
@@ -35,6 +38,20 @@ public:
     void assignCleaningTask(const std::string& robotName, int targetRoomId, const std::string& strategy);
     const std::vector<std::shared_ptr<CleaningTask>>& getAllTasks() const;
     void removeTask(int taskId);
+    int getLastTaskId() const { return taskIdCounter_; }
+    // Warm restart: replaces the queue in one go; new ids continue after lastTaskId
+    // and the queue's own ids, leaving AutoTaskPlanner's range alone
+    void restoreTasks(std::vector<std::shared_ptr<CleaningTask>> tasks, int lastTaskId);
+
+    // Reorders the robot's pending tasks into a travel-minimizing tour
+    TourPlanner::Tour planTourForRobot(const std::string& robotName);
+    // Route cached by the last tour for this task, if it starts at fromRoomId.
+    // The entry is dropped either way, since the task is being handed out.
+    std::vector<int> takePlannedRoute(int taskId, int fromRoomId);
+    // A finished task no longer needs its cached leg
+    void forgetPlannedRoute(int taskId) { plannedRoutes_.erase(taskId); }
+    // After a live map edit: forget cached legs and drop tasks for removed rooms
+    void onMapChanged();
 
     // Add a method to print tasks
     void printTasks() const;
@@ -50,6 +67,9 @@ private:
     std::shared_ptr<RobotSimulator> simulator_;
     std::shared_ptr<AlertSystem> alertSystem_;
     std::shared_ptr<MongoDBAdapter> dbAdapter_;
+
+    std::unordered_set<std::string> staleTours_;              // robots whose task batch changed
+    std::unordered_map<int, std::vector<int>> plannedRoutes_; // task id -> leg from the tour
 };
 
 #endif // SCHEDULER_HPP
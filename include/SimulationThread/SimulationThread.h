@@ -0,0 +1,135 @@
+#ifndef SIMULATION_THREAD_H
+#define SIMULATION_THREAD_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "RobotSimulator/RobotSimulator.hpp"
+#include "SimulationThread/TripleBuffer.h"
+#include "CommandBus/CommandBus.h"
+#include "CleaningTask/cleaningTask.h"
+#include "Robot/Robot.h"
+
+class Scheduler;
+class MapSnapshot;
+class Counter;
+class Gauge;
+class Histogram;
+
+// What the GUI shows of the fleet after one tick. Built on the simulation
+// thread and never changed once published.
+struct FleetSnapshot {
+    struct RobotState {
+        RobotSimulator::RobotStatus status;
+        uint64_t version = 0;           // no older than the status version this row last changed at
+        Robot::Size size = Robot::Size::MEDIUM;
+        Robot::Strategy strategy = Robot::Strategy::VACUUM;
+        int currentRoomId = -1;
+        int nextRoomId = -1;
+        double movementProgress = 0.0;  // percent of the hop to nextRoomId
+        bool failed = false;
+    };
+
+    struct TaskState {
+        int id = -1;
+        unsigned long version = 0;      // CleaningTask::getVersion when captured
+        int roomId = -1;
+        std::string roomName;
+        CleaningTask::CleanType cleanType = CleaningTask::VACUUM;
+        std::string robotName;          // empty when unassigned
+        std::string status;
+    };
+
+    uint64_t tick = 0;
+    double simTime = 0.0;
+    std::shared_ptr<const MapSnapshot> map;
+    uint64_t statusVersion = 0;
+    // Rows whose status moved between the previously published snapshot and this one;
+    // readers that missed a snapshot compare RobotState::version instead
+    uint64_t previousStatusVersion = 0;
+    std::vector<size_t> changedRobots;
+    std::vector<RobotState> robots;
+    std::vector<TaskState> tasks;
+};
+
+// Runs the simulator on its own thread so slow ticks (database writes, alert
+// saves) never block the UI. Each tick first applies queued commands, then
+// advances the simulation and publishes a FleetSnapshot through a triple
+// buffer. The UI thread is the only reader: it calls refresh() and reads
+// latest() without locks. Nothing else may touch the simulator, its robots or
+// the scheduler while the thread runs; go through post() or the command bus.
+//
+// Tick duration, command queue depths and robots and tasks per status are
+// reported to MetricsRegistry::global().
+class SimulationThread {
+public:
+    using Command = std::function<void(RobotSimulator&)>;
+
+    SimulationThread(std::shared_ptr<RobotSimulator> simulator, std::shared_ptr<Scheduler> scheduler,
+                     double tickSeconds = 1.0);
+    ~SimulationThread();
+
+    void start();
+    void stop();
+    bool isRunning() const { return running_; }
+    // Wall-clock time between ticks; defaults to the simulated tick length. Takes effect from the next tick.
+    void setTickInterval(std::chrono::milliseconds interval) { interval_ = interval; }
+
+    // Queues a command for the simulation thread. Commands run in order before
+    // the next tick, or right away with a fresh snapshot when the thread is idle.
+    void post(Command command);
+    size_t pendingCommands() const;
+
+    // Typed robot commands, applied in a batch after posted commands
+    CommandBus& getCommandBus() { return commandBus_; }
+
+    // One tick on the calling thread, for tests and when the thread is not running
+    void step();
+
+    // Reader side, UI thread only
+    bool refresh() { return snapshots_.refresh(); }
+    const FleetSnapshot& latest() const { return snapshots_.read(); }
+
+    uint64_t getTickCount() const { return ticks_; }
+    std::shared_ptr<RobotSimulator> getSimulator() const { return simulator_; }
+
+private:
+    void run();
+    bool applyCommands();
+    void publish();
+    void updateStatusGauges(const FleetSnapshot& snapshot);
+
+    std::shared_ptr<RobotSimulator> simulator_;
+    std::shared_ptr<Scheduler> scheduler_;
+    double tickSeconds_;
+    std::atomic<std::chrono::milliseconds> interval_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::vector<Command> commands_;
+    CommandBus commandBus_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> ticks_{0};
+
+    TripleBuffer<FleetSnapshot> snapshots_;
+    uint64_t publishedStatusVersion_ = 0;
+
+    Histogram* tickDuration_;
+    Counter* tickCounter_;
+    Gauge* postedDepth_;
+    Gauge* typedDepth_;
+    // Every status seen so far, so one that empties reads 0 rather than its last count
+    std::map<std::string, Gauge*> robotStatusGauges_;
+    std::map<std::string, Gauge*> taskStatusGauges_;
+};
+
+#endif // SIMULATION_THREAD_H
@@ -0,0 +1,41 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free hand-off of the latest value from one writer thread to one reader
+// thread. The writer fills writeBuffer() and publish()es it; the reader calls
+// refresh() to take the newest published value and then reads read() until
+// its next refresh. Neither side ever waits, and slots are reused, so values
+// keep their allocations from one publish to the next.
+template <typename T>
+class TripleBuffer {
+public:
+    T& writeBuffer() { return slots_[back_]; }
+
+    // Makes the write buffer the newest value; the writer gets a spare slot back
+    void publish() {
+        back_ = middle_.exchange(static_cast<uint8_t>(back_ | kFresh), std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    // Swaps in the newest published value; false if nothing new since the last call
+    bool refresh() {
+        if (!(middle_.load(std::memory_order_relaxed) & kFresh)) return false;
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+        return true;
+    }
+
+    const T& read() const { return slots_[front_]; }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4;
+
+    T slots_[3];
+    uint8_t back_ = 0;                   // writer only
+    std::atomic<uint8_t> middle_{1};     // slot index, plus kFresh when not yet taken
+    uint8_t front_ = 2;                  // reader only
+};
+
+#endif // TRIPLE_BUFFER_H
@@ -1,9 +1,11 @@
 #ifndef TASKSCHEDULER_H
 #define TASKSCHEDULER_H
 
+#include <functional>
 #include <queue>
 #include <memory>
 #include <mutex>
+#include <vector>
 #include "CleaningTask/cleaningTask.h"
 
 class TaskScheduler {
@@ -18,9 +20,18 @@ public:
     // Enqueue a new task with priority
     void enqueueTask(std::shared_ptr<CleaningTask> task);
 
+    // Enqueue several tasks under one lock
+    void enqueueTasks(const std::vector<std::shared_ptr<CleaningTask>>& tasks);
+
     // Dequeue the highest priority task
     std::shared_ptr<CleaningTask> dequeueTask();
 
+    // Dequeue the highest priority task only if accept approves it; otherwise it stays queued
+    std::shared_ptr<CleaningTask> dequeueTaskIf(const std::function<bool(const CleaningTask&)>& accept);
+
+    // Removes every queued task match approves and returns them, e.g. after a map edit
+    std::vector<std::shared_ptr<CleaningTask>> removeIf(const std::function<bool(const CleaningTask&)>& match);
+
     // Check if there are any tasks in the queue
     bool hasTasks() const;
 
@@ -0,0 +1,145 @@
+#ifndef TELEMETRY_WRITER_H
+#define TELEMETRY_WRITER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+class Robot;
+class MongoDBAdapter;
+
+// One robot reading. State is a MetricsAggregator::State code.
+struct TelemetrySample {
+    double time = 0.0;          // simulated seconds
+    float battery = 0.0f;
+    float water = 0.0f;
+    int32_t roomId = -1;
+    uint8_t state = 0;
+};
+
+// Samples as parallel arrays, oldest first; what range queries return
+struct TelemetrySeries {
+    std::vector<double> time;
+    std::vector<float> battery;
+    std::vector<float> water;
+    std::vector<int32_t> roomId;
+    std::vector<uint8_t> state;
+
+    void append(const TelemetrySample& sample);
+    // Appends other's samples with from <= time < to
+    void appendRange(const TelemetrySeries& other, double from, double to);
+    TelemetrySample at(size_t i) const;
+    size_t size() const { return time.size(); }
+    bool empty() const { return time.empty(); }
+};
+
+// Samples for one robot at one resolution that fall in [start, start + length)
+struct TelemetryBucket {
+    std::string robot;
+    int resolution = 0;         // seconds per point; 0 for raw samples
+    double start = 0.0;
+    double length = 0.0;
+    TelemetrySeries samples;
+};
+
+// What one flush writes: points to append to their buckets, and for each
+// resolution the time before which whole buckets are dropped
+struct TelemetryBatch {
+    std::vector<TelemetryBucket> appends;
+    std::vector<std::pair<int, double>> expireBefore;
+
+    bool empty() const { return appends.empty() && expireBefore.empty(); }
+};
+
+// Robot telemetry history in time-bucketed documents, one per robot, tier
+// and bucket, each holding its points as arrays.
+//
+// Raw samples go in tier 0. The writer rolls them up as they arrive into
+// 1-minute and 15-minute averages: battery and water are averaged, and room
+// and state are taken from the interval's last sample. Each tier is kept
+// only for its retention, so old data survives only in downsampled form.
+//
+//     tier   point      bucket    kept
+//     raw    sample     10 min    24 h
+//     1m     60 s       6 h       30 days
+//     15m    900 s      7 days    forever
+//
+// record() is called by the simulator and only queues samples. A
+// background thread flushes them to MongoDB: one upsert per bucket, plus
+// one delete per tier for expired buckets. Reads go through
+// MongoDBAdapter::retrieveTelemetry.
+class TelemetryWriter {
+public:
+    struct Tier {
+        int resolution;
+        double bucketSeconds;
+        double retentionSeconds;   // 0 keeps the tier forever
+    };
+    static constexpr size_t kTierCount = 3;
+    static const std::array<Tier, kTierCount>& tiers();
+    // Finest tier still holding data from `from`, judged at `now`
+    static int resolutionFor(double from, double now);
+
+    explicit TelemetryWriter(std::shared_ptr<MongoDBAdapter> dbAdapter, double sampleSeconds = 1.0);
+    ~TelemetryWriter();
+
+    // Simulation thread: samples every robot unless the last sample is under sampleSeconds old
+    void record(const std::vector<std::shared_ptr<Robot>>& robots, double now);
+    void record(const std::string& robot, const TelemetrySample& sample);
+
+    // Turns everything queued so far into bucket appends and expiries. The
+    // flush thread calls this; tests call it directly.
+    TelemetryBatch takeBatch();
+
+    void start(std::chrono::milliseconds flushInterval = std::chrono::milliseconds(5000));
+    // Flushes whatever is queued, then stops
+    void stop();
+    bool isRunning() const { return running_; }
+
+    size_t pendingSamples() const;
+
+private:
+    struct Rollup {
+        bool open = false;
+        double intervalStart = 0.0;
+        int count = 0;
+        double battery = 0.0;
+        double water = 0.0;
+        TelemetrySample last;
+    };
+
+    struct RobotState {
+        std::vector<TelemetrySample> pending;
+        std::array<Rollup, kTierCount> rollups;   // index 0 unused: raw samples are not rolled up
+        double lastSample = -1.0;
+    };
+
+    void run();
+    void flush();
+    using BucketIndex = std::map<std::tuple<std::string, int, double>, size_t>;
+    static void appendTo(std::vector<TelemetryBucket>& appends, BucketIndex& index,
+                         const std::string& robot, const Tier& tier, const TelemetrySample& point);
+
+    std::shared_ptr<MongoDBAdapter> dbAdapter_;
+    double sampleSeconds_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::map<std::string, RobotState> robots_;
+    double latest_ = 0.0;
+    std::array<double, kTierCount> expiredBefore_{};   // last expiry sent per tier
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::chrono::milliseconds flushInterval_{5000};
+};
+
+#endif // TELEMETRY_WRITER_H
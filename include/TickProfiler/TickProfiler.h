@@ -0,0 +1,112 @@
+#ifndef TICK_PROFILER_H
+#define TICK_PROFILER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Latency histogram with HDR-style log-linear buckets: exact below 16ns,
+// then 16 buckets per power of two, so any value is reported within 1/16 of
+// its true size. Recording is a handful of relaxed atomic adds and never
+// locks, so any thread may record while another reads.
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 4;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kMaxExponent = 40;   // values past ~18 minutes land in the last bucket
+    static constexpr size_t kBucketCount = (kMaxExponent - kSubBucketBits + 2) * kSubBuckets;
+
+    void record(uint64_t nanos);
+    void reset();
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+    double mean() const;
+    // Upper edge of the bucket holding the q-th quantile (0..1), capped at max()
+    uint64_t percentile(double q) const;
+
+    static size_t bucketFor(uint64_t nanos);
+    static uint64_t bucketLowerBound(size_t bucket);
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+// Per-phase timing of simulation ticks. Off by default; while off a Scope
+// costs one relaxed load and never reads the clock.
+//
+//     TickProfiler::Scope scope(profiler_, TickProfiler::Phase::STATE_ALERTS);
+class TickProfiler {
+public:
+    enum class Phase {
+        TICK,                 // all of RobotSimulator::update
+        MAP_UPDATES,          // map edits and reservation table advance
+        ROBOT_UPDATES,        // robot state and room occupancy
+        DIRT_MODEL,
+        ANALYTICS_SAVE,       // per robot
+        RETURN_TO_CHARGER,    // per request, including route planning
+        TASK_DISPATCH,        // per robot
+        CHARGING_SCHEDULER,
+        STATE_ALERTS,
+        STATUS_FEED,
+        ROBOT_METRICS,        // rolling analytics windows
+        TELEMETRY,            // queueing history samples
+        CHECKPOINT,           // capturing warm restart state
+        COMMANDS,             // SimulationThread: queued UI commands
+        PUBLISH,              // SimulationThread: fleet snapshot
+        COUNT
+    };
+    static constexpr size_t kPhaseCount = static_cast<size_t>(Phase::COUNT);
+
+    class Scope {
+    public:
+        Scope(TickProfiler& profiler, Phase phase)
+            : profiler_(profiler.isEnabled() ? &profiler : nullptr), phase_(phase) {
+            if (profiler_) start_ = std::chrono::steady_clock::now();
+        }
+        ~Scope() {
+            if (profiler_) profiler_->record(phase_, std::chrono::steady_clock::now() - start_);
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        TickProfiler* profiler_;
+        Phase phase_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    struct PhaseSummary {
+        std::string phase;
+        uint64_t count = 0;
+        double p50Micros = 0.0;
+        double p99Micros = 0.0;
+        double maxMicros = 0.0;
+        double meanMicros = 0.0;
+    };
+
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    void record(Phase phase, std::chrono::nanoseconds elapsed);
+    void reset();
+
+    const LatencyHistogram& histogram(Phase phase) const { return histograms_[static_cast<size_t>(phase)]; }
+    std::vector<PhaseSummary> summarize() const;
+    std::string toJson(int indent = 2) const;
+    void dumpJson(const std::string& filename) const;
+
+    static const char* phaseName(Phase phase);
+
+private:
+    std::atomic<bool> enabled_{false};
+    std::array<LatencyHistogram, kPhaseCount> histograms_;
+};
+
+#endif // TICK_PROFILER_H
@@ -0,0 +1,57 @@
+#ifndef TOUR_PLANNER_H
+#define TOUR_PLANNER_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "CleaningTask/cleaningTask.h"
+
+class Map;
+class Room;
+class Robot;
+
+// Orders one robot's batch of tasks to minimize travel between rooms.
+// The order is seeded with nearest-neighbor and refined with 2-opt over
+// hop distances precomputed between the start room, task rooms and chargers.
+class TourPlanner {
+public:
+    // A single visit in the tour: either a task room or a charger detour
+    struct Stop {
+        std::shared_ptr<CleaningTask> task; // nullptr for charger visits
+        int roomId;
+        bool isCharger;
+        double predictedBattery;            // battery level on arrival
+        std::vector<int> leg;               // room path from the previous stop, inclusive
+    };
+
+    struct Tour {
+        std::vector<Stop> stops;
+        std::vector<int> roomSequence;      // full room-by-room path for setMovementPath
+        std::vector<std::shared_ptr<CleaningTask>> unreachable;
+        int totalHops = 0;
+        int chargerVisits = 0;
+    };
+
+    // An empty charger list means the chargers declared on the map
+    explicit TourPlanner(const Map& map, std::vector<int> chargerRoomIds = {});
+
+    Tour planTour(const Robot& robot, const std::vector<std::shared_ptr<CleaningTask>>& tasks) const;
+    Tour planTour(Room* startRoom, double batteryLevel, double waterLevel,
+                  const std::vector<std::shared_ptr<CleaningTask>>& tasks) const;
+
+private:
+    // Hop distances and BFS parents from one source room, honoring virtual walls
+    struct DistanceRow {
+        std::unordered_map<Room*, int> hops;
+        std::unordered_map<Room*, Room*> parent;
+    };
+
+    DistanceRow computeDistances(Room* source) const;
+    std::vector<int> buildLeg(const DistanceRow& row, Room* from, Room* to) const;
+    Room* nearestCharger(const DistanceRow& row) const;
+
+    const Map& map_;
+    std::vector<int> chargerRoomIds_;
+};
+
+#endif // TOUR_PLANNER_H
@@ -0,0 +1,63 @@
+#ifndef ZONE_DISPATCHER_H
+#define ZONE_DISPATCHER_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "CleaningTask/cleaningTask.h"
+
+class Map;
+class Robot;
+class Scheduler;
+class ZonePartition;
+class RobotSimulator;
+class AlertSystem;
+class MongoDBAdapter;
+
+// One Scheduler shard per zone. A robot belongs to the shard of the zone it
+// was added in, and its tasks live in that shard, so shards never share
+// state and can plan in parallel.
+class ZoneDispatcher {
+public:
+    ZoneDispatcher(Map* map, std::shared_ptr<ZonePartition> zones);
+
+    void addRobot(std::shared_ptr<Robot> robot);
+    void setSimulator(std::shared_ptr<RobotSimulator> simulator);
+    void setAlertSystem(std::shared_ptr<AlertSystem> alertSystem);
+    void setDbAdapter(std::shared_ptr<MongoDBAdapter> dbAdapter);
+
+    std::shared_ptr<Scheduler> getShardForZone(int zoneId) const;
+    std::shared_ptr<Scheduler> getShardForRobot(const std::string& robotName) const;
+    int getHomeZone(const std::string& robotName) const;
+    size_t shardCount() const { return shards_.size(); }
+
+    // Tasks go to the shard of their robot, or of their room when unassigned
+    void addTask(std::shared_ptr<CleaningTask> task);
+    std::shared_ptr<CleaningTask> getNextTaskForRobot(const std::string& robotName);
+    void requeueTask(std::shared_ptr<CleaningTask> task);
+
+    // Replans every robot's tour, one worker thread per shard
+    void planAllTours();
+    // Forwards a live map edit to every shard
+    void onMapChanged();
+
+private:
+    struct Shard {
+        std::vector<std::shared_ptr<Robot>> robots;   // Scheduler keeps a pointer to this
+        std::shared_ptr<Scheduler> scheduler;
+    };
+
+    Shard& shardFor(int zoneId);
+
+    Map* map_;
+    std::shared_ptr<ZonePartition> zones_;
+    std::map<int, std::unique_ptr<Shard>> shards_;
+    std::unordered_map<std::string, int> homeZone_;
+    std::shared_ptr<RobotSimulator> simulator_;
+    std::shared_ptr<AlertSystem> alertSystem_;
+    std::shared_ptr<MongoDBAdapter> dbAdapter_;
+};
+
+#endif // ZONE_DISPATCHER_H
@@ -0,0 +1,52 @@
+#ifndef ZONE_PARTITION_H
+#define ZONE_PARTITION_H
+
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+class Map;
+class Room;
+
+// Splits a map into zones of connected rooms. Zones declared in map.json are
+// kept as they are; any room without one is grouped by growing breadth-first
+// regions over the connection graph. Routes between zones are stitched
+// together zone by zone through border rooms.
+class ZonePartition {
+public:
+    explicit ZonePartition(const Map& map, size_t roomsPerZone = 16);
+
+    int zoneOf(int roomId) const;               // -1 for unknown rooms
+    int zoneOf(const Room* room) const;
+    std::vector<int> getZoneIds() const;
+    const std::vector<Room*>& getRoomsInZone(int zoneId) const;
+    // Rooms with an open connection into another zone
+    const std::vector<Room*>& getBorderRooms(int zoneId) const;
+    size_t zoneCount() const { return zones_.size(); }
+
+    // Zone-level route first, then a search inside each zone on that route.
+    // Falls back to Map::getRoute when the zones cannot be stitched together.
+    std::vector<int> getRoute(Room& start, Room& end) const;
+
+private:
+    struct Zone {
+        std::vector<Room*> rooms;
+        std::vector<Room*> borderRooms;
+        std::vector<int> neighborZones;
+    };
+
+    void growZones(size_t roomsPerZone, int firstZoneId);
+    void buildZones();
+    bool openEdge(Room* a, Room* b) const;
+    std::vector<int> zonePath(int fromZone, int toZone) const;
+    // Breadth-first search that stays inside one zone; returns the path to the
+    // first room accepted by isGoal, or an empty path
+    std::vector<Room*> searchInZone(Room* from, int zoneId, const std::function<bool(Room*)>& isGoal) const;
+
+    const Map& map_;
+    std::unordered_map<int, int> zoneOfRoom_;
+    std::map<int, Zone> zones_;
+};
+
+#endif // ZONE_PARTITION_H
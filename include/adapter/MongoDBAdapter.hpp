@@ -15,12 +15,23 @@
 #include <optional>
 #include <memory>
 #include "Room/Room.h"
+#include "RobotMetrics/robot_metrics.h"
+#include "adapter/StatusChangeTracker.hpp"
+
+struct TelemetryBatch;
+struct TelemetrySeries;
+struct SimulationCheckpoint;
 
 class MongoDBAdapter {
 public:
+    // Collections are kept across runs; call clearCollections() for a cold start
     MongoDBAdapter(const std::string& uri, const std::string& dbName);
     ~MongoDBAdapter();
 
+    // Drops alerts, robot statuses, rooms, the warm restart checkpoint, and the
+    // telemetry and analytics history, whose simulated timestamps restart at 0
+    void clearCollections();
+
     // Alert methods
     void saveAlert(const Alert& alert);
     void saveAlertAsync(const Alert& alert);  // Async version
@@ -30,13 +41,15 @@ public:
     void dropRoomsCollection();
 
 
-    // Robot status methods
+    // Robot status methods. Saves skip robots whose state has not changed since
+    // the last write and otherwise $set only the changed fields.
     void saveRobotStatus(std::shared_ptr<Robot> robot);
     void saveRobotStatusAsync(std::shared_ptr<Robot> robot);  // Async version
     void deleteRobotStatus(const std::string& robotName);
     std::vector<std::shared_ptr<Robot>> retrieveRobotStatuses();
     void deleteAllRobotStatuses();
     void dropRobotStatusCollection();
+    StatusChangeTracker::Stats getStatusWriteStats();
 
     // Room methods
     void saveRoomStatus(const Room& room);
@@ -49,8 +62,24 @@ public:
     void stopRobotStatusThread();  // Stop robot status monitoring thread
     
     void saveRobotAnalytics(std::shared_ptr<Robot> robot);
+    // Also stores the robot's rolling last-hour metrics under "metrics_1h"
+    void saveRobotAnalytics(std::shared_ptr<Robot> robot, const RobotMetrics& lastHour);
     std::vector<std::tuple<std::string,int,double>> retrieveRobotAnalytics(); 
 
+    // Telemetry history, one document per robot, resolution and time bucket
+    // (see TelemetryWriter). Appends upsert their bucket and push onto its arrays,
+    // all in one unordered bulk write.
+    void writeTelemetry(const TelemetryBatch& batch);
+    // Points with from <= time < to at one resolution, oldest first
+    TelemetrySeries retrieveTelemetry(const std::string& robotName, int resolution, double from, double to);
+
+    // Warm restart state. Each save replaces the last; a load reads it back in one query.
+    void saveCheckpoint(const SimulationCheckpoint& checkpoint);
+    std::optional<SimulationCheckpoint> loadCheckpoint();
+    void dropCheckpoint();
+    // Telemetry and analytics history
+    void dropHistoryCollections();
+
 private:
     std::string dbName_;
     mongocxx::client client_;
@@ -70,9 +99,18 @@ private:
     std::queue<std::shared_ptr<Room>> roomQueue_; // New queue for room operations
 
     // Helper methods
+    void createIndexes();
     void processAlertQueue();
     void processRobotStatusQueue();
     void processRoomQueue(); // New helper method for processing room queue
+    void writeRobotAnalytics(const Robot& robot, const RobotMetrics* lastHour);
+    // One unordered bulk of upserts for the robots whose status changed
+    void writeRobotStatuses(const std::vector<std::shared_ptr<Robot>>& robots);
+
+    StatusChangeTracker statusTracker_;   // guarded by mutex_
+
+    static constexpr size_t kCheckpointChunkSize = 1000;   // robots, tasks and rooms per document
+    int64_t checkpointGeneration_ = 0;                      // last checkpoint written or loaded
 };
 
 #endif // MONGODB_ADAPTER_HPP
@@ -0,0 +1,76 @@
+#ifndef STATUS_CHANGE_TRACKER_HPP
+#define STATUS_CHANGE_TRACKER_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+class Robot;
+
+// The robot_status document fields, captured from a robot
+struct RobotStatusRecord {
+    enum Field : uint32_t {
+        BATTERY_LEVEL = 1u << 0,
+        WATER_LEVEL = 1u << 1,
+        STATUS = 1u << 2,
+        CURRENT_ROOM = 1u << 3,
+        MOVEMENT_PROGRESS = 1u << 4,
+        IS_CLEANING = 1u << 5,
+        IS_CHARGING = 1u << 6,
+        NEEDS_MAINTENANCE = 1u << 7,
+        LOW_BATTERY_ALERT_SENT = 1u << 8,
+        LOW_WATER_ALERT_SENT = 1u << 9,
+        ALL_FIELDS = (1u << 10) - 1
+    };
+
+    std::string name;
+    double batteryLevel = 0.0;
+    double waterLevel = 0.0;
+    std::string status;
+    std::string currentRoom;
+    double movementProgress = 0.0;
+    bool isCleaning = false;
+    bool isCharging = false;
+    bool needsMaintenance = false;
+    bool lowBatteryAlertSent = false;
+    bool lowWaterAlertSent = false;
+
+    static RobotStatusRecord from(const Robot& robot);
+    // Levels and progress count at 0.1% resolution, so drift below that is not a change
+    uint64_t hash() const;
+    // Fields of this record that differ from other
+    uint32_t changedFrom(const RobotStatusRecord& other) const;
+};
+
+// Remembers what was last written for each robot, so a save can skip a
+// robot whose state has not moved and send only the fields that did. A
+// robot with nothing on record gets every field. Not thread-safe: the
+// adapter calls it under its own lock.
+class StatusChangeTracker {
+public:
+    struct Stats {
+        uint64_t written = 0;        // documents sent
+        uint64_t skipped = 0;        // saves dropped as unchanged
+        uint64_t fieldsWritten = 0;
+    };
+
+    // Fields to send for this record; 0 means skip. Counts the save as skipped when 0.
+    uint32_t fieldsToWrite(const RobotStatusRecord& record);
+    // Call once the write is acknowledged
+    void markWritten(const RobotStatusRecord& record, uint32_t fields);
+    // After a document is deleted outside the tracker, its next save writes everything
+    void forget(const std::string& name);
+    void clear();
+
+    const Stats& getStats() const { return stats_; }
+
+private:
+    struct Written {
+        uint64_t hash;
+        RobotStatusRecord record;
+    };
+    std::unordered_map<std::string, Written> written_;
+    Stats stats_;
+};
+
+#endif // STATUS_CHANGE_TRACKER_HPP
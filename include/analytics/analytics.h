@@ -3,26 +3,31 @@
 
 #include <wx/wx.h>
 #include <wx/grid.h>
+#include <wx/timer.h>
 #include <memory>
 #include <vector>
 #include <string>
 
-class MongoDBAdapter;
-class RobotSimulator;
+class MetricsAggregator;
 
+// Rolling metrics per robot plus a fleet row, read from the aggregator the
+// simulator feeds every tick; nothing is queried or recomputed on refresh.
 class RobotAnalyticsPanel : public wxPanel {
 public:
-    RobotAnalyticsPanel(wxWindow* parent, std::shared_ptr<MongoDBAdapter> dbAdapter, std::shared_ptr<RobotSimulator> simulator);
-    ~RobotAnalyticsPanel() {}
+    RobotAnalyticsPanel(wxWindow* parent, std::shared_ptr<MetricsAggregator> aggregator);
+    ~RobotAnalyticsPanel();
 
 private:
     void RefreshAnalytics();
     void OnRefreshClicked(wxCommandEvent& event);
+    void OnWindowChanged(wxCommandEvent& event);
+    void OnRefreshTimer(wxTimerEvent& event);
 
     wxGrid* analyticsGrid_;
+    wxChoice* windowChoice_;
     wxButton* refreshBtn_;
-    std::shared_ptr<MongoDBAdapter> dbAdapter_;
-    std::shared_ptr<RobotSimulator> simulator_;
+    wxTimer refreshTimer_;
+    std::shared_ptr<MetricsAggregator> aggregator_;
 
     wxDECLARE_EVENT_TABLE();
 };
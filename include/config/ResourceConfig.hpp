@@ -9,9 +9,11 @@ namespace config {
         static bool initialize(const std::string& resourceDir = "");
         static std::string getResourcePath(const std::string& resourceName);
         static std::string getMapPath();
+        static std::string getCompiledMapPath();
         
     private:
         static std::string resourceDir_;
         static const std::string DEFAULT_MAP_NAME;
+        static const std::string COMPILED_MAP_NAME;
     };
 }
@@ -0,0 +1,54 @@
+#ifndef COMPILED_MAP_H
+#define COMPILED_MAP_H
+
+#include <cstdint>
+#include <string>
+
+class Map;
+
+// Binary form of a map for fast startup. The file is a header followed by
+// flat sections that are read straight out of an mmap:
+//   RoomRecord[roomCount]          ids, clean flag, position, offsets into the string pool
+//   uint32 edgeOffsets[roomCount+1] CSR row starts into edgeTargets
+//   uint32 edgeTargets[edgeCount]   neighbor indexes into the room table
+//   uint32 walls[wallCount * 2]     room index pairs
+//   int32 chargers[chargerCount * 2] room id, slots
+//   int32 zones[zoneCount * 2]      room id, zone id
+//   char strings[stringBytes]
+class CompiledMap {
+public:
+    static constexpr char kMagic[8] = {'R', 'M', 'A', 'P', 'B', 'I', 'N', '1'};
+    static constexpr uint32_t kVersion = 2;      // 2: room positions
+
+    static void write(const Map& map, const std::string& filename);
+    static void load(Map& map, const std::string& filename);
+    static bool isCompiledMap(const std::string& filename);
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t roomCount;
+        uint32_t edgeCount;
+        uint32_t wallCount;
+        uint32_t chargerCount;
+        uint32_t zoneCount;
+        uint64_t stringBytes;
+    };
+
+    struct RoomRecord {
+        int32_t id;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t flooringOffset;
+        uint32_t flooringLength;
+        uint32_t sizeOffset;
+        uint32_t sizeLength;
+        uint32_t isRoomClean;
+        double x;
+        double y;
+        int32_t level;
+        uint32_t hasPosition;
+    };
+};
+
+#endif // COMPILED_MAP_H
@@ -0,0 +1,45 @@
+#ifndef MAP_DIFF_H
+#define MAP_DIFF_H
+
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "Room/Room.h"
+#include "map/map.h"
+
+// Topology and charger difference between two versions of a map file. Connections and
+// walls are unordered room id pairs stored as (smaller id, larger id).
+// Cleanliness is runtime state and is never part of a diff.
+struct MapDiff {
+    struct RoomSpec {
+        int id;
+        std::string name;
+        std::string flooringType;
+        std::string size;
+        bool isRoomClean;
+        bool hasPosition;
+        RoomPosition position;
+    };
+    using Edge = std::pair<int, int>;
+
+    std::vector<RoomSpec> addedRooms;
+    std::vector<RoomSpec> changedRooms;     // same id, new name, flooring, size or declared position
+    std::vector<int> removedRooms;
+    std::vector<Edge> addedConnections;
+    std::vector<Edge> removedConnections;
+    std::vector<Edge> addedWalls;
+    std::vector<Edge> removedWalls;
+    std::vector<ChargerSpec> addedChargers;    // new chargers and ones whose slot count changed
+    std::vector<int> removedChargers;
+
+    static MapDiff between(const Map& before, const Map& after);
+
+    bool empty() const;
+    size_t changeCount() const;
+
+    // Applies the diff in place and returns the ids of rooms whose edges changed
+    std::unordered_set<int> applyTo(Map& map) const;
+};
+
+#endif // MAP_DIFF_H
@@ -0,0 +1,61 @@
+#ifndef MAP_SNAPSHOT_H
+#define MAP_SNAPSHOT_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "Room/Room.h"
+#include "map/RoomStateTable.h"
+
+// Immutable, versioned copy of a map's topology. The map publishes a new one
+// after each change; readers on any thread take a shared_ptr and keep using
+// it for as long as they like without locks. Cleanliness and occupancy are
+// not copied: they are read live from the shared RoomStateTable.
+class MapSnapshot {
+public:
+    struct RoomView {
+        int id;
+        std::string name;
+        std::string flooringType;
+        std::string sizeLabel;
+        RoomSize size;
+        FloorType floor;
+        bool isCharger;
+        size_t stateSlot;
+        std::vector<size_t> neighbors;   // indexes into rooms()
+        bool hasPosition;
+        RoomPosition position;
+        Room* room;                      // stable handle for the simulation thread; do not read through it
+    };
+
+    MapSnapshot() = default;
+    static std::shared_ptr<const MapSnapshot> capture(const Map& map, uint64_t version,
+                                                      std::shared_ptr<RoomStateTable> states);
+
+    uint64_t version() const { return version_; }
+    const std::vector<RoomView>& rooms() const { return rooms_; }
+    const RoomView* findRoom(int id) const;
+    const std::vector<std::pair<int, int>>& virtualWalls() const { return walls_; }
+    bool isVirtualWallBetween(int roomId1, int roomId2) const;
+
+    // Same breadth-first search as Map::getRoute, on the frozen topology
+    std::vector<int> getRoute(int fromId, int toId) const;
+
+    bool isClean(const RoomView& room) const;
+    int occupancy(const RoomView& room) const;
+
+private:
+    static uint64_t wallKey(int a, int b);
+
+    uint64_t version_ = 0;
+    std::vector<RoomView> rooms_;
+    std::unordered_map<int, size_t> indexById_;
+    std::vector<std::pair<int, int>> walls_;
+    std::unordered_set<uint64_t> wallKeys_;
+    std::shared_ptr<RoomStateTable> states_;
+};
+
+#endif // MAP_SNAPSHOT_H
@@ -0,0 +1,47 @@
+#ifndef ROOM_STATE_TABLE_H
+#define ROOM_STATE_TABLE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Dynamic per-room state kept apart from the topology so any thread can read
+// it without locks. Slots are handed out by the map's writer and never move:
+// storage grows in fixed-size chunks that are published once and never freed
+// while the table lives.
+class RoomStateTable {
+public:
+    static constexpr size_t kChunkSize = 1024;
+    static constexpr size_t kMaxChunks = 1024;
+
+    RoomStateTable() = default;
+    ~RoomStateTable();
+    RoomStateTable(const RoomStateTable&) = delete;
+    RoomStateTable& operator=(const RoomStateTable&) = delete;
+
+    // Writer only; throws once kChunkSize * kMaxChunks rooms have been allocated
+    size_t allocateSlot(bool isClean);
+    size_t size() const { return size_.load(std::memory_order_acquire); }
+
+    bool isClean(size_t slot) const;
+    void setClean(size_t slot, bool clean);
+    int occupancy(size_t slot) const;
+    void addOccupant(size_t slot, int delta);
+
+private:
+    struct Entry {
+        std::atomic<bool> clean{true};
+        std::atomic<int> occupancy{0};
+    };
+    struct Chunk {
+        Entry entries[kChunkSize];
+    };
+
+    Entry& entry(size_t slot) const;
+
+    std::array<std::atomic<Chunk*>, kMaxChunks> chunks_{};
+    std::atomic<size_t> size_{0};
+};
+
+#endif // ROOM_STATE_TABLE_H
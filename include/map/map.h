@@ -3,23 +3,73 @@
 
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <memory>
+#include <memory_resource>
 #include "Room/Room.h"
 #include "virtual_wall/virtual_wall.h"
+#include "map/RoomStateTable.h"
+
+class MapSnapshot;
+
+// A charging station room and how many robots it can charge at once
+struct ChargerSpec {
+    static constexpr int kUnlimitedSlots = -1;
+
+    int roomId;
+    int slots;
+};
 
 class Map {
 private:
+    // Unordered room pair, so a wall blocks both directions
+    struct WallKey {
+        const Room* a;
+        const Room* b;
+        static WallKey of(const Room* r1, const Room* r2) { return r1 < r2 ? WallKey{r1, r2} : WallKey{r2, r1}; }
+        bool operator==(const WallKey& o) const { return a == o.a && b == o.b; }
+    };
+    struct WallKeyHash {
+        size_t operator()(const WallKey& k) const {
+            return std::hash<const Room*>()(k.a) * 31 ^ std::hash<const Room*>()(k.b);
+        }
+    };
+
+    // Rooms are placement-constructed in the arena so addresses stay stable and a
+    // large map costs a few block allocations; ~Map runs the destructors
+    std::pmr::monotonic_buffer_resource roomArena;
     std::vector<Room*> roomMap;
+    std::vector<Room*> retiredRooms;            // removed rooms, kept alive for robots and tasks still pointing at them
+    std::unordered_map<int, Room*> roomIndex;   // room id -> room
     std::vector<VirtualWall> virtualWallMap;
+    std::unordered_set<WallKey, WallKeyHash> wallSet;
+    std::vector<ChargerSpec> chargers;
+    std::unordered_map<int, int> roomZones;     // room id -> declared zone id
+    std::shared_ptr<RoomStateTable> roomStates = std::make_shared<RoomStateTable>();
+    std::shared_ptr<const MapSnapshot> snapshot;    // read and written with std::atomic_load/store
+    uint64_t snapshotVersion = 0;
 
   public:
     // Constructor and destructor
     Map(bool loadDefaultMap = false);
     ~Map();
+    Map(const Map&) = delete;
+    Map& operator=(const Map&) = delete;
 
     // Setting up or making changes to the map
     void addRoom(const std::string& roomName, int id, const std::string& flooringType, const std::string& size, bool isRoomClean);
+    void reserveRooms(size_t count);
     void connectRooms(Room* room1, Room* room2);
     void addVirtualWall(Room* room1, Room* room2);
+    // Live edits applied by MapDiff; removed rooms stay allocated until the map is destroyed
+    void disconnectRooms(Room* room1, Room* room2);
+    void removeVirtualWall(Room* room1, Room* room2);
+    void removeRoom(int id);     // also drops its charger
+    void addCharger(int roomId, int slots = ChargerSpec::kUnlimitedSlots);
+    void removeCharger(int roomId);
+    // Accepts map.json or a compiled map written by CompiledMap::write
     void loadFromFile(const std::string& filename);
     
     // Marked as const
@@ -27,6 +77,23 @@ private:
     const std::vector<Room*>& getRooms() const;
     const std::vector<VirtualWall>& getVirtualWalls() const;
 
+    // Maps that declare no chargers get room 0 with unlimited slots
+    std::vector<ChargerSpec> getChargers() const;
+    std::vector<int> getChargerRoomIds() const;
+    bool isChargerRoom(int roomId) const;
+
+    // Zones declared in map.json; ZonePartition fills in the rest
+    void setRoomZone(int roomId, int zoneId);
+    int getRoomZone(int roomId) const;          // -1 when the room has no declared zone
+    bool hasZones() const { return !roomZones.empty(); }
+
+    // The mutators above are for the thread that owns the map. After a batch of
+    // changes that thread publishes a snapshot; other threads read the latest
+    // published one and the room state table without taking locks.
+    void publishSnapshot();
+    std::shared_ptr<const MapSnapshot> getSnapshot() const;
+    std::shared_ptr<RoomStateTable> getRoomStates() const { return roomStates; }
+
     // Marked as const
     std::vector<int> getRoute(Room& start, Room& end) const;
 
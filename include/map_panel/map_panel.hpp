@@ -4,17 +4,87 @@
 #include <wx/wx.h>
 #include <wx/panel.h>
 #include <memory>
-#include "RobotSimulator/RobotSimulator.hpp"
+#include <unordered_map>
+#include <vector>
+#include "SimulationThread/SimulationThread.h"
+#include "map/MapSnapshot.h"
+#include "QuadTree/QuadTree.h"
 
+// Draws one building floor of the map at the rooms' x/y positions (laid out
+// by MapLayout when map.json has none). Drag to pan, wheel to zoom, Page
+// Up/Down to change floor, Home to fit. A quadtree per floor limits drawing
+// to the viewport and answers clicks.
+//
+// Rooms, connections, walls and labels are drawn once into a cached bitmap
+// that is rebuilt only when a new map snapshot is published, the panel is
+// resized or the view moves. Robots are an overlay on top of it, drawn from
+// the latest fleet snapshot, and each tick repaints only the areas robots
+// left or entered.
 class MapPanel : public wxPanel {
 public:
-    MapPanel(wxWindow* parent, std::shared_ptr<RobotSimulator> simulator);
+    MapPanel(wxWindow* parent, std::shared_ptr<SimulationThread> simulation);
 
     void OnPaint(wxPaintEvent& event);
     void OnMouseClick(wxMouseEvent& event);
+    void OnMouseUp(wxMouseEvent& event);
+    void OnMouseMove(wxMouseEvent& event);
+    void OnMouseWheel(wxMouseEvent& event);
+    void OnKeyDown(wxKeyEvent& event);
+    void OnSize(wxSizeEvent& event);
+
+    // Call once per simulation tick instead of Refresh()
+    void RefreshChanged();
+
+    int getSelectedRoomId() const { return selectedRoomId_; }
 
 private:
-    std::shared_ptr<RobotSimulator> simulator_;
+    struct RobotOverlay {
+        wxRect rect;
+        bool failed;
+    };
+
+    // Positions and spatial index, rebuilt once per snapshot
+    void updateSpatialIndex(const std::shared_ptr<const MapSnapshot>& snapshot);
+    void fitView();
+    void viewChanged();
+    QuadTree::Box visibleArea(double margin) const;
+    wxPoint toScreen(const RoomPosition& position) const;
+    RoomPosition toWorld(const wxPoint& point) const;
+
+    bool layerIsCurrent(const std::shared_ptr<const MapSnapshot>& snapshot) const;
+    void rebuildStaticLayer(const std::shared_ptr<const MapSnapshot>& snapshot);
+    void drawRoom(wxDC& dc, size_t index, bool clean);
+    bool robotPosition(const FleetSnapshot::RobotState& robot, wxPoint& pos) const;
+    wxRect robotRect(size_t index, const FleetSnapshot::RobotState& robot, const wxPoint& pos);
+    std::unordered_map<size_t, RobotOverlay> currentOverlays();   // keyed by fleet snapshot row
+
+    std::shared_ptr<SimulationThread> simulation_;
+
+    std::shared_ptr<const MapSnapshot> spatialSnapshot_;
+    std::vector<RoomPosition> positions_;                    // per snapshot room
+    std::unordered_map<int, QuadTree> roomIndex_;            // floor -> room indexes on it
+    std::vector<int> levels_;                                // floors present, ascending
+    double maxEdgeLength_ = 0.0;
+
+    double scale_ = 1.0;                                     // screen pixels per map unit
+    double offsetX_ = 0.0;
+    double offsetY_ = 0.0;
+    int currentLevel_ = 0;
+    bool viewFitted_ = false;
+    unsigned long viewGeneration_ = 0;
+    int selectedRoomId_ = -1;
+    bool dragging_ = false;
+    wxPoint dragLast_;
+
+    std::shared_ptr<const MapSnapshot> layerSnapshot_;      // snapshot the cached layer shows
+    wxBitmap staticLayer_;
+    wxSize layerSize_;
+    unsigned long layerViewGeneration_ = 0;
+    std::vector<size_t> visibleRooms_;                       // rooms drawn into the layer
+    std::unordered_map<size_t, wxRect> roomRects_;           // circle and label of each visible room
+    std::vector<char> roomClean_;                            // clean flag as last drawn into the layer
+    std::unordered_map<size_t, RobotOverlay> overlays_;
+    std::unordered_map<size_t, wxSize> labelSizes_;
 
     wxDECLARE_EVENT_TABLE();
 };
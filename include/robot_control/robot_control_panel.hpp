@@ -3,17 +3,28 @@
 
 #include <wx/wx.h>
 #include <memory>
+#include <string>
+#include <vector>
+#include "CommandBus/CommandBus.h"
+#include "alert/Alert.h"
 
-class RobotSimulator;
+class SimulationThread;
 class Scheduler;
 class Room;
+class Robot;
+class AlertSystem;
 
 class RobotControlPanel : public wxPanel {
 public:
-    RobotControlPanel(wxWindow* parent, std::shared_ptr<RobotSimulator> simulator, std::shared_ptr<Scheduler> scheduler);
+    RobotControlPanel(wxWindow* parent, std::shared_ptr<SimulationThread> simulation, std::shared_ptr<Scheduler> scheduler);
     ~RobotControlPanel();
 
 private:
+    struct PendingCommand {
+        std::shared_future<CommandBus::Result> result;
+        std::string message;     // Info alert to raise once it succeeds
+    };
+
     void CreateControls();
     void UpdateRobotList();
     void UpdateRoomList();
@@ -24,14 +35,24 @@ private:
     void OnReturnToCharger(wxCommandEvent& event);
     void OnMoveToRoom(wxCommandEvent& event);
     void OnPickUpRobot(wxCommandEvent& event);
-
-    std::shared_ptr<RobotSimulator> simulator_;
+    void OnResultTimer(wxTimerEvent& event);
+    // Queues a command for the selected robot; message is reported once it has run
+    void submitCommand(CommandBus::CommandType type, const std::string& message, int roomId = -1);
+    bool requireSelectedRobot();
+    void reportAlert(const std::string& type, const std::string& message, Alert::Severity severity,
+                     std::shared_ptr<Robot> robot = nullptr, std::shared_ptr<Room> room = nullptr);
+
+    std::shared_ptr<SimulationThread> simulation_;
+    std::shared_ptr<AlertSystem> alertSystem_;
     std::shared_ptr<Scheduler> scheduler_;
     wxChoice* robotChoice_;
     wxChoice* roomChoice_;
+    std::vector<int> roomIds_;   // room id per roomChoice_ entry
     wxButton* moveButton_;
     wxButton* pickUpButton_;
-    std::string selectedRobotName_;
+    int selectedRobot_ = -1;    // fleet snapshot row, which is also the robot's command bus handle
+    std::vector<PendingCommand> pendingCommands_;
+    wxTimer resultTimer_;
 
     wxDECLARE_EVENT_TABLE();
 };
@@ -0,0 +1,45 @@
+#ifndef ROBOT_STATUS_TABLE_HPP
+#define ROBOT_STATUS_TABLE_HPP
+
+#include <wx/grid.h>
+#include <cstdint>
+#include <memory>
+
+class SimulationThread;
+struct FleetSnapshot;
+
+// Virtual table behind the dashboard robot grid. Cells are formatted on
+// demand from the latest fleet snapshot, and Sync() repaints only the rows
+// whose status changed since the snapshot it last showed, so a tick costs
+// the number of changes rather than the fleet size.
+class RobotStatusTable : public wxGridTableBase {
+public:
+    enum Column { NAME, BATTERY, WATER, STATUS, ROOM, COLUMN_COUNT };
+
+    explicit RobotStatusTable(std::shared_ptr<SimulationThread> simulation);
+    ~RobotStatusTable() override;
+
+    int GetNumberRows() override { return rows_; }
+    int GetNumberCols() override { return COLUMN_COUNT; }
+    wxString GetValue(int row, int col) override;
+    void SetValue(int row, int col, const wxString& value) override {}
+    bool IsEmptyCell(int row, int col) override { return false; }
+    wxString GetColLabelValue(int col) override;
+    bool CanHaveAttributes() override { return true; }
+    wxGridCellAttr* GetAttr(int row, int col, wxGridCellAttr::wxAttrKind kind) override;
+
+    // Call on the UI thread after SimulationThread::refresh(), once the table is attached to grid
+    void Sync(wxGrid* grid);
+
+private:
+    void resizeRows(wxGrid* grid, int count);
+    void refreshRow(wxGrid* grid, size_t row);
+
+    std::shared_ptr<SimulationThread> simulation_;
+    int rows_ = 0;
+    uint64_t seenVersion_ = 0;
+    wxGridCellAttr* lowAttr_;
+    wxGridCellAttr* okAttr_;
+};
+
+#endif // ROBOT_STATUS_TABLE_HPP
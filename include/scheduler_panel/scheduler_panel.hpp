@@ -7,19 +7,39 @@
 #include <memory>
 #include <vector>
 
-class RobotSimulator;
 class Scheduler;
-class Room;
 class MongoDBAdapter;
 class AlertSystem;
-class Robot;
 
 #include "CleaningTask/cleaningTask.h"
+#include "SimulationThread/SimulationThread.h"
+#include "map/MapSnapshot.h"
+
+// Virtual report list of the scheduler's tasks. Text comes from a per-row
+// cache; Sync() rebuilds and repaints only rows whose task id or version
+// changed since the last call.
+class TaskListCtrl : public wxListCtrl {
+public:
+    TaskListCtrl(wxWindow* parent);
+
+    void Sync(const std::vector<FleetSnapshot::TaskState>& tasks);
+
+protected:
+    wxString OnGetItemText(long item, long column) const override;
+
+private:
+    struct Row {
+        int id = -1;
+        unsigned long version = 0;
+        wxString cells[5];
+    };
+    std::vector<Row> rows_;
+};
 
 class SchedulerPanel : public wxPanel {
 public:
     SchedulerPanel(wxWindow* parent, 
-                   std::shared_ptr<RobotSimulator> simulator, 
+                   std::shared_ptr<SimulationThread> simulation,
                    std::shared_ptr<Scheduler> scheduler,
                    std::shared_ptr<AlertSystem> alertSystem,
                    std::shared_ptr<MongoDBAdapter> dbAdapter);
@@ -36,22 +56,23 @@ private:
     void OnTimer(wxTimerEvent& event);
 
     void UpdateRoomSelection();
-    void UpdateRobotListForRoom(Room* room);
-
-    // Method to find a single suitable robot (not used if we return multiple)
-    std::shared_ptr<Robot> findSuitableRobotForRoom(Room* room);
+    void UpdateRobotListForRoom(const MapSnapshot::RoomView& room);
+    const MapSnapshot::RoomView* selectedRoom() const;
 
-    // Method to find all suitable robots for a given room
-    std::vector<std::shared_ptr<Robot>> findSuitableRobotsForRoom(Room* room);
+    // Fleet snapshot rows of every robot that can clean the room
+    std::vector<size_t> findSuitableRobotsForRoom(const MapSnapshot::RoomView& room) const;
 
-    std::shared_ptr<RobotSimulator> simulator_;
+    // Everything shown comes from the latest fleet snapshot; changes are posted as commands
+    std::shared_ptr<SimulationThread> simulation_;
     std::shared_ptr<Scheduler> scheduler_;
     std::shared_ptr<AlertSystem> alertSystem_;
     std::shared_ptr<MongoDBAdapter> dbAdapter_;
 
     wxChoice* roomChoice_;
     wxChoice* robotChoice_; // New choice for selecting the robot
-    wxListCtrl* taskListCtrl_;
+    std::vector<int> roomIds_;       // room id per roomChoice_ entry
+    std::vector<size_t> robotRows_;  // fleet snapshot row per robotChoice_ entry
+    TaskListCtrl* taskListCtrl_;
     wxTimer* updateTimer_;
     wxButton* assignTaskBtn_;
 
@@ -0,0 +1,30 @@
+#ifndef TICK_PROFILE_PANEL_HPP
+#define TICK_PROFILE_PANEL_HPP
+
+#include <wx/wx.h>
+#include <wx/listctrl.h>
+#include <memory>
+
+class SimulationThread;
+
+// Dashboard view of the simulator's TickProfiler: one row per tick phase with
+// sample count and p50/p99/max/mean in microseconds. Profiling is switched on
+// from here, and the current figures can be saved as JSON.
+class TickProfilePanel : public wxPanel {
+public:
+    TickProfilePanel(wxWindow* parent, std::shared_ptr<SimulationThread> simulation);
+
+    // Re-reads the histograms; cheap enough to call every tick
+    void UpdateProfile();
+
+private:
+    void OnToggle(wxCommandEvent& event);
+    void OnReset(wxCommandEvent& event);
+    void OnSave(wxCommandEvent& event);
+
+    std::shared_ptr<SimulationThread> simulation_;
+    wxCheckBox* enableBox_;
+    wxListCtrl* phaseList_;
+};
+
+#endif // TICK_PROFILE_PANEL_HPP
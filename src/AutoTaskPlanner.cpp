@@ -0,0 +1,193 @@
+#include "AutoTaskPlanner/AutoTaskPlanner.h"
+#include "CleaningRules/CleaningRules.h"
+#include "TaskScheduler/TaskScheduler.h"
+#include "map/map.h"
+#include "map/MapSnapshot.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+AutoTaskPlanner::AutoTaskPlanner(std::shared_ptr<Map> map, Sink sink, size_t batchSize)
+    : map_(map), sink_(sink), batchSize_(batchSize == 0 ? 1 : batchSize) {
+    if (!map_) {
+        throw std::runtime_error("AutoTaskPlanner needs a map");
+    }
+    if (!sink_) {
+        sink_ = [](const std::vector<std::shared_ptr<CleaningTask>>& batch) {
+            TaskScheduler::getInstance().enqueueTasks(batch);
+        };
+        retract_ = [](const std::unordered_set<int>& taskIds) {
+            TaskScheduler::getInstance().removeIf(
+                [&taskIds](const CleaningTask& task) { return taskIds.count(task.getID()) > 0; });
+        };
+    }
+}
+
+AutoTaskPlanner::~AutoTaskPlanner() {
+    stop();
+}
+
+void AutoTaskPlanner::start() {
+    if (running_) return;
+    running_ = true;
+    thread_ = std::thread(&AutoTaskPlanner::run, this);
+}
+
+void AutoTaskPlanner::stop() {
+    if (!running_) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+void AutoTaskPlanner::notifyRoomChanged(int roomId) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.insert(roomId);
+    }
+    wake_.notify_one();
+}
+
+void AutoTaskPlanner::notifyRoomsChanged(const std::vector<int>& roomIds) {
+    if (roomIds.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.insert(roomIds.begin(), roomIds.end());
+    }
+    wake_.notify_one();
+}
+
+void AutoTaskPlanner::notifyAllRooms() {
+    auto snapshot = map_->getSnapshot();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.reserve(pending_.size() + snapshot->rooms().size());
+        for (const auto& view : snapshot->rooms()) {
+            pending_.insert(view.id);
+        }
+    }
+    wake_.notify_one();
+}
+
+void AutoTaskPlanner::releaseRoom(int roomId, int taskId, bool failed) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = outstanding_.find(roomId);
+        bool own = it != outstanding_.end() && it->second == taskId;
+        if (own) outstanding_.erase(it);
+        if (failed) return;
+        pending_.insert(roomId);
+    }
+    wake_.notify_one();
+}
+
+size_t AutoTaskPlanner::processPending() {
+    std::lock_guard<std::mutex> passLock(passMutex_);
+    auto begin = std::chrono::steady_clock::now();
+
+    std::unordered_set<int> rooms;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rooms.swap(pending_);
+    }
+    if (rooms.empty()) return 0;
+
+    auto snapshot = map_->getSnapshot();
+    std::vector<std::shared_ptr<CleaningTask>> batch;
+    std::unordered_set<int> retracted;
+    size_t generated = 0;
+    long batches = 0;
+
+    auto flush = [&]() {
+        if (batch.empty()) return;
+        sink_(batch);
+        generated += batch.size();
+        ++batches;
+        batch.clear();
+    };
+
+    for (int roomId : rooms) {
+        const MapSnapshot::RoomView* view = snapshot->findRoom(roomId);
+        bool needsTask = view && !view->isCharger && !snapshot->isClean(*view);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!needsTask) {
+            // Clean or gone: its queued task is no longer needed, and a later
+            // dirty report may generate again
+            auto it = outstanding_.find(roomId);
+            if (it != outstanding_.end()) {
+                retracted.insert(it->second);
+                outstanding_.erase(it);
+            }
+            continue;
+        }
+        if (outstanding_.count(roomId)) continue;
+        int taskId = nextTaskId_++;
+        outstanding_[roomId] = taskId;
+        lock.unlock();
+
+        batch.push_back(std::make_shared<CleaningTask>(taskId, CleaningTask::LOW,
+                                                       CleaningRules::cleanTypeFor(view->floor), view->room));
+        if (batch.size() >= batchSize_) flush();
+    }
+    flush();
+    if (!retracted.empty() && retract_) retract_(retracted);
+
+    double millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.roomsEvaluated += static_cast<long>(rooms.size());
+        stats_.tasksGenerated += static_cast<long>(generated);
+        stats_.batchesSubmitted += batches;
+        stats_.lastPassMillis = millis;
+    }
+    if (generated > 0) {
+        std::cout << "[DEBUG] AutoTaskPlanner: evaluated " << rooms.size() << " rooms, generated "
+                  << generated << " tasks in " << millis << " ms\n";
+    }
+    return generated;
+}
+
+bool AutoTaskPlanner::hasOutstandingTask(int roomId) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return outstanding_.count(roomId) > 0;
+}
+
+int AutoTaskPlanner::getNextTaskId() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return nextTaskId_;
+}
+
+void AutoTaskPlanner::restore(int nextTaskId, const std::unordered_map<int, int>& outstanding) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    nextTaskId_ = std::max({nextTaskId_, nextTaskId, kFirstTaskId});
+    for (const auto& [roomId, taskId] : outstanding) {
+        outstanding_[roomId] = taskId;
+        nextTaskId_ = std::max(nextTaskId_, taskId + 1);
+    }
+}
+
+size_t AutoTaskPlanner::pendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+AutoTaskPlanner::Stats AutoTaskPlanner::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void AutoTaskPlanner::run() {
+    while (running_) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() { return !running_ || !pending_.empty(); });
+            if (!running_) break;
+        }
+        processPending();
+    }
+}
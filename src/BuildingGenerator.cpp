@@ -0,0 +1,278 @@
+#include "MapGenerator/BuildingGenerator.h"
+#include "map/map.h"
+#include "Room/Room.h"
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace {
+    // Seeded draws that come out the same with every standard library
+    class Draw {
+    public:
+        explicit Draw(uint32_t seed) : rng_(seed) {}
+
+        double unit() { return rng_() / 4294967296.0; }
+        bool chance(double p) { return unit() < p; }
+
+        template <typename Weights>
+        size_t pick(const Weights& weights) {
+            double total = 0.0;
+            for (double w : weights) total += std::max(w, 0.0);
+            if (total <= 0.0) return 0;
+            double r = unit() * total;
+            size_t last = 0;
+            for (size_t i = 0; i < weights.size(); ++i) {
+                if (weights[i] <= 0.0) continue;
+                last = i;
+                if (r < weights[i]) return i;
+                r -= weights[i];
+            }
+            return last;
+        }
+
+    private:
+        std::mt19937 rng_;
+    };
+
+    const char* kSizes[] = {"small", "medium", "large"};
+
+    // Corridors are this far apart, rooms sit this far off their corridor and segments this far along it
+    constexpr double kCorridorSpacing = 30.0;
+    constexpr double kRoomOffset = 8.0;
+    constexpr double kSegmentLength = 10.0;
+}
+
+BuildingGenerator::Building BuildingGenerator::generate(const Options& options) {
+    if (options.floors < 1 || options.corridorsPerFloor < 1 || options.roomsPerCorridor < 0 || options.robots < 0) {
+        throw std::runtime_error("Building needs at least one floor and one corridor");
+    }
+
+    Building building;
+    building.map = std::make_shared<Map>();
+    Map& map = *building.map;
+    Draw draw(options.seed);
+
+    std::vector<double> flooringWeights;
+    for (const auto& entry : options.flooringWeights) flooringWeights.push_back(entry.second);
+    if (flooringWeights.empty()) {
+        throw std::runtime_error("Building needs at least one flooring type");
+    }
+
+    int segments = (options.roomsPerCorridor + 1) / 2;
+    size_t perFloor = 2 + static_cast<size_t>(options.corridorsPerFloor) * (segments + options.roomsPerCorridor);
+    map.reserveRooms(perFloor * options.floors);
+
+    int nextId = 0;
+    auto addRoom = [&](const std::string& name, const std::string& flooring, const std::string& size, bool clean,
+                       double x, double y, int floor) {
+        int id = nextId++;
+        map.addRoom(name, id, flooring, size, clean);
+        Room* room = map.getRooms().back();
+        room->setPosition(RoomPosition{x, y, floor});
+        map.setRoomZone(id, floor);
+        return room;
+    };
+    // Returns true when the door is left open
+    auto door = [&](Room* a, Room* b) {
+        map.connectRooms(a, b);
+        if (!draw.chance(options.virtualWallFraction)) return true;
+        map.addVirtualWall(a, b);
+        return false;
+    };
+
+    std::vector<int> chargerIds;
+    Room* previousLobby = nullptr;
+    for (int floor = 0; floor < options.floors; ++floor) {
+        std::string prefix = "Floor " + std::to_string(floor) + " ";
+        Room* charger = addRoom(prefix + "Charging Station", "tile", "small", true, 0.0, 0.0, floor);
+        Room* lobby = addRoom(prefix + "Lobby", "tile", "large", true, kSegmentLength, 0.0, floor);
+        map.connectRooms(charger, lobby);
+        map.addCharger(charger->getRoomId(), options.chargerSlots);
+        chargerIds.push_back(charger->getRoomId());
+        // Lifts between lobbies; never walled so every floor stays reachable
+        if (previousLobby) map.connectRooms(previousLobby, lobby);
+        previousLobby = lobby;
+
+        int roomNumber = 0;
+        for (int corridor = 0; corridor < options.corridorsPerFloor; ++corridor) {
+            double corridorY = (corridor - (options.corridorsPerFloor - 1) / 2.0) * kCorridorSpacing;
+            std::string corridorName = prefix + "Corridor " + std::to_string(corridor) + "-";
+            std::vector<Room*> hall;
+            for (int k = 0; k < segments; ++k) {
+                Room* segment = addRoom(corridorName + std::to_string(k), "tile", "large", true,
+                                        2 * kSegmentLength + k * kSegmentLength, corridorY, floor);
+                map.connectRooms(hall.empty() ? lobby : hall.back(), segment);
+                hall.push_back(segment);
+            }
+
+            std::array<Room*, 2> previous{nullptr, nullptr};   // last room on each side
+            for (int i = 0; i < options.roomsPerCorridor; ++i) {
+                int side = i % 2;
+                Room* segment = hall[i / 2];
+                const auto& flooring = options.flooringWeights[draw.pick(flooringWeights)].first;
+                const char* size = kSizes[draw.pick(options.sizeWeights)];
+                bool clean = !draw.chance(options.dirtyFraction);
+                double y = corridorY + (side ? kRoomOffset : -kRoomOffset);
+                Room* room = addRoom(prefix + "Room " + std::to_string(roomNumber++), flooring, size, clean,
+                                     segment->getPosition().x, y, floor);
+                map.connectRooms(room, segment);
+                bool sideDoorOpen = previous[side] && draw.chance(options.adjacentDoorFraction) &&
+                                    door(previous[side], room);
+                // The corridor door is only walled when the room can still be reached through
+                // the previous one, whose own corridor door was decided the same way
+                if (sideDoorOpen && draw.chance(options.virtualWallFraction)) map.addVirtualWall(room, segment);
+                previous[side] = room;
+            }
+        }
+    }
+
+    // Same mix as the app's fleet: each size runs vacuum, scrub and shampoo
+    const Robot::Size sizes[] = {Robot::Size::LARGE, Robot::Size::MEDIUM, Robot::Size::SMALL};
+    const Robot::Strategy strategies[] = {Robot::Strategy::VACUUM, Robot::Strategy::SCRUB, Robot::Strategy::SHAMPOO};
+    for (int i = 0; i < options.robots; ++i) {
+        FleetEntry entry;
+        entry.size = sizes[(i / 3) % 3];
+        entry.strategy = strategies[i % 3];
+        entry.name = "Robot_" + sizeName(entry.size) + "_" + strategyName(entry.strategy) + "_" + std::to_string(i / 9);
+        entry.homeRoomId = chargerIds[i % chargerIds.size()];
+        building.fleet.push_back(entry);
+    }
+
+    map.publishSnapshot();
+    return building;
+}
+
+std::string BuildingGenerator::mapJson(const Map& map) {
+    json rooms = json::array();
+    json connections = json::array();
+    std::map<int, std::vector<int>> zones;
+    for (const Room* room : map.getRooms()) {
+        json entry = {{"name", room->getRoomName()}, {"id", room->getRoomId()},
+                      {"flooringType", room->getFlooringType()}, {"isRoomClean", room->isClean()},
+                      {"size", room->getSize()}, {"isRestricted", false}};
+        if (room->hasPosition()) {
+            entry["x"] = room->getPosition().x;
+            entry["y"] = room->getPosition().y;
+            entry["floor"] = room->getPosition().level;
+        }
+        rooms.push_back(entry);
+        for (const Room* neighbor : room->neighbors) {
+            if (room->getRoomId() < neighbor->getRoomId()) {
+                connections.push_back({{"from", room->getRoomId()}, {"to", neighbor->getRoomId()}});
+            }
+        }
+        int zone = map.getRoomZone(room->getRoomId());
+        if (zone >= 0) zones[zone].push_back(room->getRoomId());
+    }
+
+    json walls = json::array();
+    for (const auto& wall : map.getVirtualWalls()) {
+        walls.push_back({{"room1", wall.getRoom1()->getRoomId()}, {"room2", wall.getRoom2()->getRoomId()}});
+    }
+    json chargers = json::array();
+    for (const auto& charger : map.getChargers()) {
+        chargers.push_back({{"roomId", charger.roomId}, {"slots", charger.slots}});
+    }
+    json zoneList = json::array();
+    for (const auto& [id, roomIds] : zones) {
+        zoneList.push_back({{"id", id}, {"rooms", roomIds}});
+    }
+
+    json root = {{"rooms", rooms}, {"connections", connections}, {"virtualWalls", walls}, {"chargers", chargers}};
+    if (!zoneList.empty()) root["zones"] = zoneList;
+    return root.dump(2);
+}
+
+void BuildingGenerator::writeMapJson(const Map& map, const std::string& filename) {
+    std::ofstream out(filename, std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to open map file for writing: " + filename);
+    }
+    out << mapJson(map) << "\n";
+}
+
+void BuildingGenerator::writeFleetJson(const std::vector<FleetEntry>& fleet, const std::string& filename) {
+    json robots = json::array();
+    for (const auto& entry : fleet) {
+        robots.push_back({{"name", entry.name}, {"size", sizeName(entry.size)},
+                          {"strategy", strategyName(entry.strategy)}, {"homeRoomId", entry.homeRoomId}});
+    }
+    std::ofstream out(filename, std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to open fleet file for writing: " + filename);
+    }
+    out << json{{"robots", robots}}.dump(2) << "\n";
+}
+
+std::vector<BuildingGenerator::FleetEntry> BuildingGenerator::readFleetJson(const std::string& filename) {
+    std::ifstream in(filename);
+    if (!in.is_open()) {
+        throw std::runtime_error("Failed to open fleet file: " + filename);
+    }
+    std::vector<FleetEntry> fleet;
+    try {
+        json root = json::parse(in);
+        for (const auto& robot : root.at("robots")) {
+            FleetEntry entry;
+            entry.name = robot.at("name").get<std::string>();
+            entry.size = parseSize(robot.at("size").get<std::string>());
+            entry.strategy = parseStrategy(robot.at("strategy").get<std::string>());
+            entry.homeRoomId = robot.value("homeRoomId", -1);
+            fleet.push_back(entry);
+        }
+    } catch (const json::exception& e) {
+        throw std::runtime_error("Invalid fleet file " + filename + ": " + e.what());
+    }
+    return fleet;
+}
+
+std::vector<std::shared_ptr<Robot>> BuildingGenerator::createRobots(const std::vector<FleetEntry>& fleet, Map& map) {
+    std::vector<std::shared_ptr<Robot>> robots;
+    robots.reserve(fleet.size());
+    for (const auto& entry : fleet) {
+        auto robot = std::make_shared<Robot>(entry.name, 100.0, entry.size, entry.strategy, 100.0);
+        Room* home = map.getRoomById(entry.homeRoomId);
+        if (!home && !map.getChargers().empty()) home = map.getRoomById(map.getChargers().front().roomId);
+        if (home) robot->setCurrentRoom(home);
+        robot->setMap(&map);
+        robots.push_back(robot);
+    }
+    return robots;
+}
+
+std::string BuildingGenerator::sizeName(Robot::Size size) {
+    switch (size) {
+        case Robot::Size::SMALL: return "Small";
+        case Robot::Size::MEDIUM: return "Medium";
+        case Robot::Size::LARGE: return "Large";
+    }
+    return "Medium";
+}
+
+std::string BuildingGenerator::strategyName(Robot::Strategy strategy) {
+    switch (strategy) {
+        case Robot::Strategy::VACUUM: return "Vacuum";
+        case Robot::Strategy::SCRUB: return "Scrub";
+        case Robot::Strategy::SHAMPOO: return "Shampoo";
+    }
+    return "Vacuum";
+}
+
+Robot::Size BuildingGenerator::parseSize(const std::string& name) {
+    if (name == "Small") return Robot::Size::SMALL;
+    if (name == "Medium") return Robot::Size::MEDIUM;
+    if (name == "Large") return Robot::Size::LARGE;
+    throw std::runtime_error("Unknown robot size: " + name);
+}
+
+Robot::Strategy BuildingGenerator::parseStrategy(const std::string& name) {
+    if (name == "Vacuum") return Robot::Strategy::VACUUM;
+    if (name == "Scrub") return Robot::Strategy::SCRUB;
+    if (name == "Shampoo") return Robot::Strategy::SHAMPOO;
+    throw std::runtime_error("Unknown cleaning strategy: " + name);
+}
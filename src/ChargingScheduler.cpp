@@ -0,0 +1,245 @@
+#include "ChargingScheduler/ChargingScheduler.h"
+#include "Robot/Robot.h"
+#include "Room/Room.h"
+#include "EnergyModel/EnergyModel.h"
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <iostream>
+#include <queue>
+
+ChargingScheduler::ChargingScheduler(const Map& map) : map_(map) {
+    for (const auto& spec : map.getChargers()) {
+        chargers_.push_back(Charger{spec, {}, {}});
+    }
+}
+
+double ChargingScheduler::chargeSeconds(double batteryLevel) {
+    return std::max(0.0, 100.0 - batteryLevel) / Robot::kChargeRatePerSecond;
+}
+
+ChargingScheduler::Charger* ChargingScheduler::findCharger(int roomId) {
+    for (auto& charger : chargers_) {
+        if (charger.spec.roomId == roomId) return &charger;
+    }
+    return nullptr;
+}
+
+const ChargingScheduler::Charger* ChargingScheduler::findCharger(int roomId) const {
+    for (const auto& charger : chargers_) {
+        if (charger.spec.roomId == roomId) return &charger;
+    }
+    return nullptr;
+}
+
+namespace {
+    // Hops from the robot to the charger room; -1 if there is no route
+    int hopsTo(const Map& map, const Robot& robot, int chargerRoomId) {
+        Room* from = robot.getCurrentRoom();
+        Room* to = map.getRoomById(chargerRoomId);
+        if (!to) return -1;
+        if (!from || from == to) return 0;
+        auto route = map.getRoute(*from, *to);
+        return route.empty() ? -1 : static_cast<int>(route.size()) - 1;
+    }
+}
+
+double ChargingScheduler::travelSeconds(const Robot& robot, const Charger& charger) const {
+    int hops = hopsTo(map_, robot, charger.spec.roomId);
+    return std::max(0, hops) * EnergyModel::kTravelSecondsPerHop;
+}
+
+std::vector<double> ChargingScheduler::predictQueue(const Charger& charger, double now) const {
+    std::vector<double> finishTimes;
+    std::priority_queue<double, std::vector<double>, std::greater<double>> slotFreeAt;
+    for (const auto& robot : charger.occupants) {
+        slotFreeAt.push(now + travelSeconds(*robot, charger) + chargeSeconds(robot->getBatteryLevel()));
+    }
+    if (charger.spec.slots != ChargerSpec::kUnlimitedSlots) {
+        for (int i = static_cast<int>(charger.occupants.size()); i < charger.spec.slots; ++i) {
+            slotFreeAt.push(now);
+        }
+    }
+
+    for (const auto& waiting : charger.queue) {
+        double arrival = now + travelSeconds(*waiting.robot, charger);
+        double start = arrival;
+        if (!slotFreeAt.empty()) {
+            start = std::max(arrival, slotFreeAt.top());
+            slotFreeAt.pop();
+        }
+        double finish = start + chargeSeconds(waiting.robot->getBatteryLevel());
+        slotFreeAt.push(finish);
+        finishTimes.push_back(finish);
+    }
+    return finishTimes;
+}
+
+ChargingScheduler::Assignment ChargingScheduler::requestCharge(const std::shared_ptr<Robot>& robot, double now) {
+    if (!robot || chargers_.empty()) return Assignment{};
+    if (hasAssignment(robot.get())) {
+        return getAssignment(robot.get(), now);
+    }
+    stats_.requests++;
+
+    // Nearest reachable charger first; unreachable ones only as a last resort
+    std::vector<std::pair<int, Charger*>> byDistance;
+    for (auto& charger : chargers_) {
+        int hops = hopsTo(map_, *robot, charger.spec.roomId);
+        byDistance.emplace_back(hops < 0 ? INT_MAX : hops, &charger);
+    }
+    std::stable_sort(byDistance.begin(), byDistance.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    // A full robot is only parking, so it does not need a slot
+    if (robot->getBatteryLevel() >= 100.0) {
+        Charger* nearest = byDistance.front().second;
+        return Assignment{nearest->spec.roomId, false, now + travelSeconds(*robot, *nearest)};
+    }
+
+    for (auto& [hops, charger] : byDistance) {
+        if (!charger->hasFreeSlot()) continue;
+        charger->occupants.push_back(robot);
+        robot->setWaitingForCharger(false);
+        return Assignment{charger->spec.roomId, false,
+                          now + travelSeconds(*robot, *charger) + chargeSeconds(robot->getBatteryLevel())};
+    }
+
+    // Every charger is full: queue where this robot would be ready soonest
+    Charger* best = nullptr;
+    double bestReady = 0.0;
+    for (auto& [hops, charger] : byDistance) {
+        if (hops == INT_MAX && best) continue;
+        charger->queue.push_back(Waiting{robot, now});
+        double ready = predictQueue(*charger, now).back();
+        charger->queue.pop_back();
+        if (!best || ready < bestReady) {
+            best = charger;
+            bestReady = ready;
+        }
+    }
+
+    best->queue.push_back(Waiting{robot, now});
+    robot->setWaitingForCharger(true);
+    stats_.queuedRequests++;
+    stats_.peakQueueLength = std::max(stats_.peakQueueLength, best->queue.size());
+    std::cout << "[DEBUG] Robot " << robot->getName() << " queued for charger in room "
+              << best->spec.roomId << ", ready at " << bestReady << "s\n";
+    return Assignment{best->spec.roomId, true, bestReady};
+}
+
+void ChargingScheduler::update(double now) {
+    for (auto& charger : chargers_) {
+        Room* room = map_.getRoomById(charger.spec.roomId);
+
+        // A slot is done once its robot is charged and idle at the charger, has gone back
+        // to work or has failed
+        charger.occupants.erase(
+            std::remove_if(charger.occupants.begin(), charger.occupants.end(),
+                           [room](const std::shared_ptr<Robot>& robot) {
+                               if (robot->getCurrentTask() || robot->isFailed()) return true;
+                               return robot->getCurrentRoom() == room && !robot->isCharging() &&
+                                      !robot->isMoving() && robot->getBatteryLevel() >= 100.0;
+                           }),
+            charger.occupants.end());
+
+        // Robots that picked up a task or failed while queued no longer need a slot
+        for (auto it = charger.queue.begin(); it != charger.queue.end();) {
+            if (it->robot->getCurrentTask() || it->robot->isFailed()) {
+                it->robot->setWaitingForCharger(false);
+                it = charger.queue.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        while (charger.hasFreeSlot() && !charger.queue.empty()) {
+            Waiting next = charger.queue.front();
+            charger.queue.pop_front();
+            double waited = now - next.requestedAt;
+            stats_.totalWaitSeconds += waited;
+            stats_.maxWaitSeconds = std::max(stats_.maxWaitSeconds, waited);
+            charger.occupants.push_back(next.robot);
+            next.robot->setWaitingForCharger(false);
+        }
+    }
+}
+
+void ChargingScheduler::cancel(const Robot* robot) {
+    for (auto& charger : chargers_) {
+        charger.occupants.erase(
+            std::remove_if(charger.occupants.begin(), charger.occupants.end(),
+                           [robot](const std::shared_ptr<Robot>& r) { return r.get() == robot; }),
+            charger.occupants.end());
+        for (auto it = charger.queue.begin(); it != charger.queue.end(); ++it) {
+            if (it->robot.get() == robot) {
+                it->robot->setWaitingForCharger(false);
+                charger.queue.erase(it);
+                break;
+            }
+        }
+    }
+}
+
+std::vector<std::shared_ptr<Robot>> ChargingScheduler::syncChargers() {
+    std::vector<Charger> chargers;
+    for (const auto& spec : map_.getChargers()) {
+        Charger* existing = findCharger(spec.roomId);
+        chargers.push_back(existing ? std::move(*existing) : Charger{spec, {}, {}});
+        chargers.back().spec = spec;
+        if (existing) existing->spec.roomId = -1;   // moved from; the loop below skips it
+    }
+
+    std::vector<std::shared_ptr<Robot>> displaced;
+    for (auto& charger : chargers_) {
+        if (charger.spec.roomId == -1) continue;
+        displaced.insert(displaced.end(), charger.occupants.begin(), charger.occupants.end());
+        for (auto& waiting : charger.queue) {
+            waiting.robot->setWaitingForCharger(false);
+            displaced.push_back(waiting.robot);
+        }
+    }
+    chargers_ = std::move(chargers);
+    return displaced;
+}
+
+bool ChargingScheduler::hasAssignment(const Robot* robot) const {
+    for (const auto& charger : chargers_) {
+        for (const auto& r : charger.occupants) {
+            if (r.get() == robot) return true;
+        }
+        for (const auto& w : charger.queue) {
+            if (w.robot.get() == robot) return true;
+        }
+    }
+    return false;
+}
+
+ChargingScheduler::Assignment ChargingScheduler::getAssignment(const Robot* robot, double now) const {
+    for (const auto& charger : chargers_) {
+        for (const auto& r : charger.occupants) {
+            if (r.get() == robot) {
+                return Assignment{charger.spec.roomId, false,
+                                  now + travelSeconds(*r, charger) + chargeSeconds(r->getBatteryLevel())};
+            }
+        }
+        for (size_t i = 0; i < charger.queue.size(); ++i) {
+            if (charger.queue[i].robot.get() == robot) {
+                return Assignment{charger.spec.roomId, true, predictQueue(charger, now)[i]};
+            }
+        }
+    }
+    return Assignment{};
+}
+
+int ChargingScheduler::freeSlots(int chargerRoomId) const {
+    const Charger* charger = findCharger(chargerRoomId);
+    if (!charger) return 0;
+    if (charger->spec.slots == ChargerSpec::kUnlimitedSlots) return ChargerSpec::kUnlimitedSlots;
+    return std::max(0, charger->spec.slots - static_cast<int>(charger->occupants.size()));
+}
+
+size_t ChargingScheduler::queueLength(int chargerRoomId) const {
+    const Charger* charger = findCharger(chargerRoomId);
+    return charger ? charger->queue.size() : 0;
+}
@@ -0,0 +1,42 @@
+#include "CleaningRules/CleaningRules.h"
+#include <algorithm>
+
+std::vector<Robot::Strategy> CleaningRules::acceptableStrategies(FloorType floor) {
+    if (floor == FloorType::CARPET) {
+        return {Robot::Strategy::VACUUM, Robot::Strategy::SHAMPOO};
+    }
+    if (isHardFloor(floor)) {
+        return {Robot::Strategy::VACUUM, Robot::Strategy::SCRUB};
+    }
+    return {Robot::Strategy::VACUUM};
+}
+
+Robot::Size CleaningRules::robotSizeFor(RoomSize size) {
+    switch (size) {
+        case RoomSize::SMALL: return Robot::Size::SMALL;
+        case RoomSize::MEDIUM: return Robot::Size::MEDIUM;
+        default: return Robot::Size::LARGE;
+    }
+}
+
+bool CleaningRules::canClean(const Robot& robot, const Room& room) {
+    return canClean(robot.getSize(), robot.getStrategy(), room.getRoomSize(), room.getFloorType());
+}
+
+bool CleaningRules::canClean(Robot::Size size, Robot::Strategy strategy, RoomSize roomSize, FloorType floor) {
+    if (size != robotSizeFor(roomSize)) return false;
+    auto strategies = acceptableStrategies(floor);
+    return std::find(strategies.begin(), strategies.end(), strategy) != strategies.end();
+}
+
+CleaningTask::CleanType CleaningRules::cleanTypeFor(Robot::Strategy strategy) {
+    switch (strategy) {
+        case Robot::Strategy::SCRUB: return CleaningTask::SCRUB;
+        case Robot::Strategy::SHAMPOO: return CleaningTask::SHAMPOO;
+        default: return CleaningTask::VACUUM;
+    }
+}
+
+CleaningTask::CleanType CleaningRules::cleanTypeFor(FloorType floor) {
+    return cleanTypeFor(acceptableStrategies(floor).back());
+}
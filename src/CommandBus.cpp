@@ -0,0 +1,142 @@
+#include "CommandBus/CommandBus.h"
+#include "RobotSimulator/RobotSimulator.hpp"
+#include "Robot/Robot.h"
+#include "Room/Room.h"
+#include "map/map.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    std::shared_ptr<Room> roomCopy(const Room* room) {
+        return room ? std::make_shared<Room>(*room) : nullptr;
+    }
+}
+
+CommandBus::Ticket CommandBus::submit(const Command& command) {
+    Ticket ticket;
+    std::function<void()> wake;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.submitted;
+
+        // Only the robot's latest pending command is compared, so an earlier one
+        // never jumps ahead of what was queued after it
+        auto latest = std::find_if(pending_.rbegin(), pending_.rend(),
+                                   [&command](const Pending& p) { return p.command.robot == command.robot; });
+        if (latest != pending_.rend()) {
+            const Command& queued = latest->command;
+            if (queued.type == command.type && queued.roomId == command.roomId) {
+                ++stats_.coalesced;
+                ticket.id = latest->id;
+                ticket.result = latest->future;
+                ticket.coalesced = true;
+                return ticket;
+            }
+        }
+
+        Pending entry{nextId_++, command, std::promise<Result>(), {}};
+        entry.future = entry.promise.get_future().share();
+        ticket.id = entry.id;
+        ticket.result = entry.future;
+        if (latest != pending_.rend() && isDestination(latest->command.type) && isDestination(command.type)) {
+            // Only the latest destination matters; the robot never heads for the old one
+            Result superseded;
+            superseded.error = "Superseded by a later command";
+            latest->promise.set_value(superseded);
+            ++stats_.superseded;
+            *latest = std::move(entry);
+        } else {
+            pending_.push_back(std::move(entry));
+        }
+        wake = wake_;
+    }
+    if (wake) wake();
+    return ticket;
+}
+
+size_t CommandBus::apply(RobotSimulator& simulator) {
+    std::vector<Pending> batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_.empty()) return 0;
+        batch.swap(pending_);
+    }
+
+    size_t failed = 0;
+    for (auto& entry : batch) {
+        Result result;
+        try {
+            result = execute(simulator, entry.command);
+        } catch (const std::exception& e) {
+            result.ok = false;
+            result.error = e.what();
+        }
+        if (!result.ok) {
+            ++failed;
+            std::cout << "[DEBUG] CommandBus: command " << entry.id << " failed: " << result.error << "\n";
+        }
+        entry.promise.set_value(std::move(result));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.batches;
+    stats_.applied += batch.size();
+    stats_.failed += failed;
+    return batch.size();
+}
+
+CommandBus::Result CommandBus::execute(RobotSimulator& simulator, const Command& command) {
+    Result result;
+    auto& robots = simulator.getRobots();
+    if (command.robot >= robots.size()) {
+        result.error = "Unknown robot handle " + std::to_string(command.robot);
+        return result;
+    }
+    result.robot = robots[command.robot];
+    const auto& robot = result.robot;
+
+    switch (command.type) {
+        case CommandType::START_CLEANING:
+            simulator.startRobotCleaning(robot);
+            break;
+        case CommandType::STOP_CLEANING:
+            simulator.stopRobotCleaning(robot);
+            break;
+        case CommandType::RETURN_TO_CHARGER:
+            simulator.requestReturnToCharger(robot);
+            break;
+        case CommandType::MOVE_TO_ROOM: {
+            Room* target = simulator.getMap().getRoomById(command.roomId);
+            if (!target) {
+                result.error = "Unknown room " + std::to_string(command.roomId);
+                return result;
+            }
+            simulator.moveRobotToRoom(robot, command.roomId);
+            result.room = roomCopy(target);
+            result.ok = true;
+            return result;
+        }
+        case CommandType::PICK_UP:
+            simulator.manuallyPickUpRobot(robot);
+            robot->repair();
+            break;
+    }
+    result.room = roomCopy(robot->getCurrentRoom());
+    result.ok = true;
+    return result;
+}
+
+size_t CommandBus::pendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+CommandBus::Stats CommandBus::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void CommandBus::setWakeCallback(std::function<void()> wake) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    wake_ = std::move(wake);
+}
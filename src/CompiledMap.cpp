@@ -0,0 +1,230 @@
+#include "map/CompiledMap.h"
+#include "map/map.h"
+#include "Room/Room.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    template <typename T>
+    void writeArray(std::ofstream& out, const std::vector<T>& values) {
+        if (!values.empty()) {
+            out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+        }
+    }
+
+    // Read-only mapping of a whole file, unmapped on scope exit
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& filename) {
+            int fd = ::open(filename.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw std::runtime_error("Failed to open map file: " + filename);
+            }
+            struct stat info;
+            if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+                ::close(fd);
+                throw std::runtime_error("Failed to read map file: " + filename);
+            }
+            size_ = static_cast<size_t>(info.st_size);
+            void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (data == MAP_FAILED) {
+                throw std::runtime_error("Failed to map file: " + filename);
+            }
+            data_ = static_cast<const char*>(data);
+        }
+        ~MappedFile() { ::munmap(const_cast<char*>(data_), size_); }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* data() const { return data_; }
+        size_t size() const { return size_; }
+
+    private:
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+    };
+}
+
+bool CompiledMap::isCompiledMap(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    char magic[sizeof(kMagic)] = {};
+    if (!in.read(magic, sizeof(magic))) return false;
+    return std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+void CompiledMap::write(const Map& map, const std::string& filename) {
+    const auto& rooms = map.getRooms();
+    std::unordered_map<const Room*, uint32_t> indexOf;
+    for (uint32_t i = 0; i < rooms.size(); ++i) {
+        indexOf[rooms[i]] = i;
+    }
+
+    std::string strings;
+    auto intern = [&strings](const std::string& value, uint32_t& offset, uint32_t& length) {
+        offset = static_cast<uint32_t>(strings.size());
+        length = static_cast<uint32_t>(value.size());
+        strings += value;
+    };
+
+    std::vector<RoomRecord> roomTable(rooms.size());
+    std::vector<uint32_t> edgeOffsets(rooms.size() + 1, 0);
+    std::vector<uint32_t> edgeTargets;
+    std::vector<int32_t> zones;
+    for (uint32_t i = 0; i < rooms.size(); ++i) {
+        const Room* room = rooms[i];
+        RoomRecord& record = roomTable[i];
+        record.id = room->getRoomId();
+        record.isRoomClean = room->isClean() ? 1 : 0;
+        record.x = room->getPosition().x;
+        record.y = room->getPosition().y;
+        record.level = room->getPosition().level;
+        record.hasPosition = room->hasPosition() ? 1 : 0;
+        intern(room->roomName, record.nameOffset, record.nameLength);
+        intern(room->flooringType, record.flooringOffset, record.flooringLength);
+        intern(room->size, record.sizeOffset, record.sizeLength);
+
+        // Keep neighbor order so routes come out the same as from json
+        for (const Room* neighbor : room->neighbors) {
+            auto it = indexOf.find(neighbor);
+            if (it != indexOf.end()) edgeTargets.push_back(it->second);
+        }
+        edgeOffsets[i + 1] = static_cast<uint32_t>(edgeTargets.size());
+
+        int zone = map.getRoomZone(room->getRoomId());
+        if (zone >= 0) {
+            zones.push_back(room->getRoomId());
+            zones.push_back(zone);
+        }
+    }
+
+    std::vector<uint32_t> walls;
+    for (const auto& wall : map.getVirtualWalls()) {
+        auto a = indexOf.find(wall.getRoom1());
+        auto b = indexOf.find(wall.getRoom2());
+        if (a == indexOf.end() || b == indexOf.end()) continue;
+        walls.push_back(a->second);
+        walls.push_back(b->second);
+    }
+
+    std::vector<int32_t> chargers;
+    for (const auto& charger : map.getChargers()) {
+        chargers.push_back(charger.roomId);
+        chargers.push_back(charger.slots);
+    }
+
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.roomCount = static_cast<uint32_t>(roomTable.size());
+    header.edgeCount = static_cast<uint32_t>(edgeTargets.size());
+    header.wallCount = static_cast<uint32_t>(walls.size() / 2);
+    header.chargerCount = static_cast<uint32_t>(chargers.size() / 2);
+    header.zoneCount = static_cast<uint32_t>(zones.size() / 2);
+    header.stringBytes = strings.size();
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to open compiled map for writing: " + filename);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeArray(out, roomTable);
+    writeArray(out, edgeOffsets);
+    writeArray(out, edgeTargets);
+    writeArray(out, walls);
+    writeArray(out, chargers);
+    writeArray(out, zones);
+    out.write(strings.data(), strings.size());
+    if (!out) {
+        throw std::runtime_error("Failed to write compiled map: " + filename);
+    }
+}
+
+void CompiledMap::load(Map& map, const std::string& filename) {
+    MappedFile file(filename);
+    const char* base = file.data();
+    size_t offset = 0;
+
+    auto take = [&](size_t bytes) {
+        // Sizes come from the file, so compare against what is left rather than let offset + bytes wrap
+        if (bytes > file.size() - offset) {
+            throw std::runtime_error("Compiled map is truncated: " + filename);
+        }
+        const char* at = base + offset;
+        offset += bytes;
+        return at;
+    };
+
+    Header header;
+    std::memcpy(&header, take(sizeof(Header)), sizeof(Header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+        throw std::runtime_error("Unsupported compiled map: " + filename);
+    }
+
+    // Room records are 8-byte aligned and the sections after them 4-byte aligned, so they can be read in place
+    auto rooms = reinterpret_cast<const RoomRecord*>(take(sizeof(RoomRecord) * header.roomCount));
+    auto edgeOffsets = reinterpret_cast<const uint32_t*>(take(sizeof(uint32_t) * (size_t{header.roomCount} + 1)));
+    auto edgeTargets = reinterpret_cast<const uint32_t*>(take(sizeof(uint32_t) * header.edgeCount));
+    auto walls = reinterpret_cast<const uint32_t*>(take(sizeof(uint32_t) * 2 * header.wallCount));
+    auto chargers = reinterpret_cast<const int32_t*>(take(sizeof(int32_t) * 2 * header.chargerCount));
+    auto zones = reinterpret_cast<const int32_t*>(take(sizeof(int32_t) * 2 * header.zoneCount));
+    const char* strings = take(header.stringBytes);
+
+    auto text = [&](uint32_t at, uint32_t length) {
+        if (static_cast<uint64_t>(at) + length > header.stringBytes) {
+            throw std::runtime_error("Compiled map has a bad string reference: " + filename);
+        }
+        return std::string(strings + at, length);
+    };
+
+    size_t firstRoom = map.getRooms().size();
+    map.reserveRooms(header.roomCount);
+    for (uint32_t i = 0; i < header.roomCount; ++i) {
+        const RoomRecord& r = rooms[i];
+        map.addRoom(text(r.nameOffset, r.nameLength), r.id, text(r.flooringOffset, r.flooringLength),
+                    text(r.sizeOffset, r.sizeLength), r.isRoomClean != 0);
+        if (r.hasPosition) map.getRooms().back()->setPosition(RoomPosition{r.x, r.y, r.level});
+    }
+    const auto& created = map.getRooms();
+
+    auto roomAt = [&](uint32_t index) {
+        if (index >= header.roomCount) {
+            throw std::runtime_error("Compiled map has a bad room index: " + filename);
+        }
+        return created[firstRoom + index];
+    };
+
+    // Each row already holds both directions of every connection
+    for (uint32_t i = 0; i < header.roomCount; ++i) {
+        if (edgeOffsets[i] > edgeOffsets[i + 1] || edgeOffsets[i + 1] > header.edgeCount) {
+            throw std::runtime_error("Compiled map has a bad edge table: " + filename);
+        }
+        Room* room = roomAt(i);
+        room->neighbors.reserve(edgeOffsets[i + 1] - edgeOffsets[i]);
+        for (uint32_t e = edgeOffsets[i]; e < edgeOffsets[i + 1]; ++e) {
+            room->neighbors.push_back(roomAt(edgeTargets[e]));
+        }
+    }
+
+    for (uint32_t i = 0; i < header.wallCount; ++i) {
+        map.addVirtualWall(roomAt(walls[2 * i]), roomAt(walls[2 * i + 1]));
+    }
+    for (uint32_t i = 0; i < header.chargerCount; ++i) {
+        map.addCharger(chargers[2 * i], chargers[2 * i + 1]);
+    }
+    for (uint32_t i = 0; i < header.zoneCount; ++i) {
+        map.setRoomZone(zones[2 * i], zones[2 * i + 1]);
+    }
+
+    map.publishSnapshot();
+    std::cout << "Loaded compiled map " << filename << ": " << header.roomCount << " rooms, "
+              << header.edgeCount / 2 << " connections, " << header.wallCount << " virtual walls" << std::endl;
+}
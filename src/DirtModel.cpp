@@ -0,0 +1,206 @@
+#include "DirtModel/DirtModel.h"
+#include "map/map.h"
+#include <algorithm>
+#include <iostream>
+
+double DirtModel::baseRate(FloorType floor) {
+    // Carpet holds dirt and shows it; hard floors build up slower
+    switch (floor) {
+        case FloorType::CARPET: return 0.05;
+        case FloorType::TILE: return 0.02;
+        case FloorType::WOOD:
+        case FloorType::HARDWOOD: return 0.03;
+        default: return 0.03;
+    }
+}
+
+DirtModel::DirtModel(const Map& map, double now, double dirtyThreshold) : threshold_(dirtyThreshold) {
+    entries_.reserve(map.getRooms().size());
+    for (Room* room : map.getRooms()) {
+        addRoom(room, now);
+    }
+}
+
+double DirtModel::levelAt(const Entry& e, double now) const {
+    return std::clamp(e.intercept + rateOf(e) * now, 0.0, kMaxDirt);
+}
+
+size_t DirtModel::classFor(double rate) {
+    for (size_t i = 0; i < classes_.size(); ++i) {
+        if (classes_[i].rate == rate) return i;
+    }
+    classes_.push_back(RateClass{rate, {}});
+    return classes_.size() - 1;
+}
+
+void DirtModel::siftUp(RateClass& cls, size_t pos) {
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (entries_[cls.heap[parent]].intercept >= entries_[cls.heap[pos]].intercept) break;
+        std::swap(cls.heap[parent], cls.heap[pos]);
+        entries_[cls.heap[parent]].heapPos = parent;
+        entries_[cls.heap[pos]].heapPos = pos;
+        pos = parent;
+    }
+}
+
+void DirtModel::siftDown(RateClass& cls, size_t pos) {
+    size_t n = cls.heap.size();
+    while (true) {
+        size_t largest = pos;
+        for (size_t child = 2 * pos + 1; child <= 2 * pos + 2 && child < n; ++child) {
+            if (entries_[cls.heap[child]].intercept > entries_[cls.heap[largest]].intercept) largest = child;
+        }
+        if (largest == pos) return;
+        std::swap(cls.heap[largest], cls.heap[pos]);
+        entries_[cls.heap[largest]].heapPos = largest;
+        entries_[cls.heap[pos]].heapPos = pos;
+        pos = largest;
+    }
+}
+
+void DirtModel::heapInsert(size_t entry) {
+    Entry& e = entries_[entry];
+    e.rateClass = classFor(e.baseRate * e.multiplier);
+    RateClass& cls = classes_[e.rateClass];
+    e.heapPos = cls.heap.size();
+    cls.heap.push_back(entry);
+    siftUp(cls, e.heapPos);
+}
+
+void DirtModel::heapErase(size_t entry) {
+    RateClass& cls = classes_[entries_[entry].rateClass];
+    size_t pos = entries_[entry].heapPos;
+    size_t last = cls.heap.back();
+    cls.heap.pop_back();
+    if (last == entry) return;
+    cls.heap[pos] = last;
+    entries_[last].heapPos = pos;
+    siftUp(cls, pos);
+    siftDown(cls, entries_[last].heapPos);
+}
+
+void DirtModel::setLevel(size_t entry, double level, double now) {
+    Entry& e = entries_[entry];
+    e.intercept = level - rateOf(e) * now;
+    RateClass& cls = classes_[e.rateClass];
+    siftUp(cls, e.heapPos);
+    siftDown(cls, e.heapPos);
+    e.generation++;
+}
+
+void DirtModel::scheduleCrossing(size_t entry) {
+    const Entry& e = entries_[entry];
+    if (e.dirty || e.removed) return;
+    double rate = rateOf(e);
+    if (rate > 0.0) {
+        crossings_.push(Crossing{(threshold_ - e.intercept) / rate, entry, e.generation});
+    } else if (e.intercept >= threshold_) {
+        crossings_.push(Crossing{0.0, entry, e.generation});   // not growing, but already over
+    }
+}
+
+void DirtModel::addRoom(Room* room, double now) {
+    if (!room || isTracked(room->getRoomId())) return;
+    size_t entry = entries_.size();
+    entries_.push_back(Entry{room, 0.0, baseRate(room->getFloorType())});
+    index_[room->getRoomId()] = entry;
+    heapInsert(entry);
+
+    bool dirty = !room->isClean();
+    setLevel(entry, dirty ? threshold_ : 0.0, now);
+    entries_[entry].dirty = dirty;
+    scheduleCrossing(entry);
+}
+
+void DirtModel::removeRoom(int roomId) {
+    auto it = index_.find(roomId);
+    if (it == index_.end()) return;
+    heapErase(it->second);
+    entries_[it->second].removed = true;
+    entries_[it->second].generation++;
+    index_.erase(it);
+}
+
+double DirtModel::dirtLevel(int roomId, double now) const {
+    auto it = index_.find(roomId);
+    return it == index_.end() ? 0.0 : levelAt(entries_[it->second], now);
+}
+
+void DirtModel::markCleaned(int roomId, double now) {
+    auto it = index_.find(roomId);
+    if (it == index_.end()) return;
+    Entry& e = entries_[it->second];
+    setLevel(it->second, 0.0, now);
+    e.dirty = false;
+    e.room->markClean();
+    scheduleCrossing(it->second);
+}
+
+void DirtModel::recordVisit(int roomId, double now, double amount) {
+    auto it = index_.find(roomId);
+    if (it == index_.end()) return;
+    const Entry& e = entries_[it->second];
+    setLevel(it->second, std::min(kMaxDirt, levelAt(e, now) + amount), now);
+    scheduleCrossing(it->second);
+}
+
+void DirtModel::setTrafficMultiplier(int roomId, double multiplier, double now) {
+    auto it = index_.find(roomId);
+    if (it == index_.end()) return;
+    size_t entry = it->second;
+    double level = levelAt(entries_[entry], now);
+    heapErase(entry);
+    entries_[entry].multiplier = std::max(0.0, multiplier);
+    heapInsert(entry);
+    setLevel(entry, level, now);
+    scheduleCrossing(entry);
+}
+
+std::vector<int> DirtModel::update(double now) {
+    std::vector<int> newlyDirty;
+    while (!crossings_.empty() && crossings_.top().time <= now) {
+        Crossing crossing = crossings_.top();
+        crossings_.pop();
+        Entry& e = entries_[crossing.entry];
+        if (e.removed || e.dirty || crossing.generation != e.generation) continue;
+        e.dirty = true;
+        e.room->markDirty();
+        newlyDirty.push_back(e.room->getRoomId());
+    }
+    if (!newlyDirty.empty()) {
+        std::cout << "[DEBUG] DirtModel: " << newlyDirty.size() << " rooms became dirty\n";
+    }
+    return newlyDirty;
+}
+
+std::vector<DirtModel::Ranked> DirtModel::topDirtiest(size_t k, double now) const {
+    std::vector<Ranked> candidates;
+    if (k == 0) return candidates;
+
+    // Within a rate class the heap order is the dirt order at any time, so the
+    // k best of each class are found by a best-first walk from its root
+    for (const auto& cls : classes_) {
+        if (cls.heap.empty()) continue;
+        auto lower = [&](size_t a, size_t b) {
+            return entries_[cls.heap[a]].intercept < entries_[cls.heap[b]].intercept;
+        };
+        std::priority_queue<size_t, std::vector<size_t>, decltype(lower)> frontier(lower);
+        frontier.push(0);
+        for (size_t taken = 0; taken < k && !frontier.empty(); ++taken) {
+            size_t pos = frontier.top();
+            frontier.pop();
+            const Entry& e = entries_[cls.heap[pos]];
+            candidates.push_back(Ranked{e.room->getRoomId(), levelAt(e, now)});
+            for (size_t child = 2 * pos + 1; child <= 2 * pos + 2 && child < cls.heap.size(); ++child) {
+                frontier.push(child);
+            }
+        }
+    }
+
+    size_t count = std::min(k, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+                      [](const Ranked& a, const Ranked& b) { return a.dirt > b.dirt; });
+    candidates.resize(count);
+    return candidates;
+}
@@ -0,0 +1,67 @@
+#include "EnergyModel/EnergyModel.h"
+#include "map/map.h"
+#include "Room/Room.h"
+#include "Robot/Robot.h"
+#include <climits>
+
+EnergyModel::EnergyModel(const Map& map, std::vector<int> chargerRoomIds)
+    : map_(map), chargerRoomIds_(chargerRoomIds.empty() ? map.getChargerRoomIds() : std::move(chargerRoomIds)) {}
+
+double EnergyModel::cleaningBatteryCost(const Room& room) {
+    return Robot::kCleaningBatteryDrainPerSecond * Robot::cleaningTimeForRoom(room);
+}
+
+double EnergyModel::cleaningWaterCost(const Room& room, CleaningTask::CleanType cleanType) {
+    if (cleanType != CleaningTask::SHAMPOO) return 0.0;
+    return Robot::kShampooWaterDrainPerSecond * Robot::cleaningTimeForRoom(room);
+}
+
+bool EnergyModel::fitsCleaning(double batteryLevel, double waterLevel, const Room& room,
+                               CleaningTask::CleanType cleanType) {
+    return batteryLevel - cleaningBatteryCost(room) >= kMinimumBattery &&
+           waterLevel - cleaningWaterCost(room, cleanType) >= kMinimumWater;
+}
+
+EnergyModel::Prediction EnergyModel::predict(const Robot& robot, const CleaningTask& task) const {
+    return predict(robot.getCurrentRoom(), robot.getBatteryLevel(), robot.getWaterLevel(),
+                   task.getRoom(), task.getCleanType());
+}
+
+EnergyModel::Prediction EnergyModel::predict(Room* from, double batteryLevel, double waterLevel,
+                                             Room* target, CleaningTask::CleanType cleanType) const {
+    Prediction p;
+    if (!from || !target) return p;
+
+    auto route = map_.getRoute(*from, *target);
+    if (route.empty()) return p;
+    p.routeHops = static_cast<int>(route.size()) - 1;
+
+    // Nearest reachable charger from the task room
+    int bestReturn = INT_MAX;
+    for (int id : chargerRoomIds_) {
+        Room* charger = map_.getRoomById(id);
+        if (!charger) continue;
+        auto back = map_.getRoute(*target, *charger);
+        if (!back.empty() && static_cast<int>(back.size()) - 1 < bestReturn) {
+            bestReturn = static_cast<int>(back.size()) - 1;
+        }
+    }
+    if (bestReturn == INT_MAX) return p;
+    p.returnHops = bestReturn;
+    p.reachable = true;
+
+    double cleanSeconds = Robot::cleaningTimeForRoom(*target);
+    int hops = p.routeHops + p.returnHops;
+    p.batteryNeeded = cleaningBatteryCost(*target) + hops * kTravelBatteryPerHop;
+    p.waterNeeded = cleaningWaterCost(*target, cleanType);
+    p.batteryAfter = batteryLevel - p.batteryNeeded;
+    p.waterAfter = waterLevel - p.waterNeeded;
+    p.seconds = hops * kTravelSecondsPerHop + cleanSeconds;
+
+    // The clean aborts as soon as either level drops under its threshold, so
+    // both must still hold once the clean and the trip home are paid for
+    double batteryAtCleanEnd = batteryLevel - p.routeHops * kTravelBatteryPerHop - cleaningBatteryCost(*target);
+    p.feasible = batteryAtCleanEnd >= kMinimumBattery && p.batteryAfter > 0.0 &&
+                 p.waterAfter >= kMinimumWater;
+    return p;
+}
@@ -0,0 +1,19 @@
+#include "Room/InternedString.h"
+#include <mutex>
+#include <unordered_set>
+
+namespace {
+    // Set nodes never move, so handed-out pointers stay valid for the process lifetime
+    const std::string* intern(const std::string& value) {
+        static std::mutex mutex;
+        static std::unordered_set<std::string> pool;
+        std::lock_guard<std::mutex> lock(mutex);
+        return &*pool.insert(value).first;
+    }
+}
+
+InternedString::InternedString() : value_(intern(std::string())) {}
+
+InternedString::InternedString(const std::string& value) : value_(intern(value)) {}
+
+InternedString::InternedString(const char* value) : value_(intern(value ? value : "")) {}
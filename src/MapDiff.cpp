@@ -0,0 +1,173 @@
+#include "map/MapDiff.h"
+#include "map/map.h"
+#include "Room/Room.h"
+#include <algorithm>
+#include <iterator>
+#include <set>
+
+namespace {
+    using Edge = MapDiff::Edge;
+
+    Edge edgeOf(const Room* a, const Room* b) {
+        int x = a->getRoomId();
+        int y = b->getRoomId();
+        return x < y ? Edge{x, y} : Edge{y, x};
+    }
+
+    std::set<Edge> connectionsOf(const Map& map) {
+        std::set<Edge> edges;
+        for (const Room* room : map.getRooms()) {
+            for (const Room* neighbor : room->neighbors) {
+                edges.insert(edgeOf(room, neighbor));
+            }
+        }
+        return edges;
+    }
+
+    std::set<Edge> wallsOf(const Map& map) {
+        std::set<Edge> edges;
+        for (const auto& wall : map.getVirtualWalls()) {
+            edges.insert(edgeOf(wall.getRoom1(), wall.getRoom2()));
+        }
+        return edges;
+    }
+
+    void difference(const std::set<Edge>& a, const std::set<Edge>& b, std::vector<Edge>& out) {
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+    }
+
+    MapDiff::RoomSpec specOf(const Room* room) {
+        return {room->getRoomId(), room->getRoomName(), room->getFlooringType(), room->getSize(), room->isClean(),
+                room->hasPosition(), room->getPosition()};
+    }
+
+    void placeRoom(Room* room, const MapDiff::RoomSpec& spec) {
+        if (spec.hasPosition) {
+            room->setPosition(spec.position);
+        } else {
+            room->clearPosition();
+        }
+    }
+}
+
+MapDiff MapDiff::between(const Map& before, const Map& after) {
+    MapDiff diff;
+    for (const Room* room : after.getRooms()) {
+        const Room* old = before.getRoomById(room->getRoomId());
+        if (!old) {
+            diff.addedRooms.push_back(specOf(room));
+        } else if (old->getRoomName() != room->getRoomName() || old->flooringType != room->flooringType ||
+                   old->size != room->size || old->hasPosition() != room->hasPosition() ||
+                   old->getPosition() != room->getPosition()) {
+            diff.changedRooms.push_back(specOf(room));
+        }
+    }
+    for (const Room* room : before.getRooms()) {
+        if (!after.getRoomById(room->getRoomId())) {
+            diff.removedRooms.push_back(room->getRoomId());
+        }
+    }
+
+    auto oldConnections = connectionsOf(before);
+    auto newConnections = connectionsOf(after);
+    difference(newConnections, oldConnections, diff.addedConnections);
+    difference(oldConnections, newConnections, diff.removedConnections);
+
+    auto oldWalls = wallsOf(before);
+    auto newWalls = wallsOf(after);
+    difference(newWalls, oldWalls, diff.addedWalls);
+    difference(oldWalls, newWalls, diff.removedWalls);
+
+    auto oldChargers = before.getChargers();
+    auto newChargers = after.getChargers();
+    for (const auto& charger : newChargers) {
+        auto old = std::find_if(oldChargers.begin(), oldChargers.end(),
+                                [&charger](const ChargerSpec& c) { return c.roomId == charger.roomId; });
+        if (old == oldChargers.end() || old->slots != charger.slots) {
+            diff.addedChargers.push_back(charger);
+        }
+    }
+    for (const auto& charger : oldChargers) {
+        if (!after.isChargerRoom(charger.roomId)) diff.removedChargers.push_back(charger.roomId);
+    }
+    return diff;
+}
+
+bool MapDiff::empty() const {
+    return changeCount() == 0;
+}
+
+size_t MapDiff::changeCount() const {
+    return addedRooms.size() + changedRooms.size() + removedRooms.size() + addedConnections.size() +
+           removedConnections.size() + addedWalls.size() + removedWalls.size() + addedChargers.size() +
+           removedChargers.size();
+}
+
+std::unordered_set<int> MapDiff::applyTo(Map& map) const {
+    std::unordered_set<int> touched;
+    auto touch = [&touched](const Edge& edge) {
+        touched.insert(edge.first);
+        touched.insert(edge.second);
+    };
+
+    // Removals first, so a room that was removed and re-added comes back fresh
+    for (int id : removedRooms) {
+        if (Room* room = map.getRoomById(id)) {
+            for (const Room* neighbor : room->neighbors) touched.insert(neighbor->getRoomId());
+        }
+        map.removeRoom(id);
+        touched.insert(id);
+    }
+    for (const auto& edge : removedConnections) {
+        Room* a = map.getRoomById(edge.first);
+        Room* b = map.getRoomById(edge.second);
+        if (a && b) map.disconnectRooms(a, b);
+        touch(edge);
+    }
+    for (const auto& edge : removedWalls) {
+        Room* a = map.getRoomById(edge.first);
+        Room* b = map.getRoomById(edge.second);
+        if (a && b) map.removeVirtualWall(a, b);
+        touch(edge);
+    }
+
+    for (const auto& spec : addedRooms) {
+        if (!map.getRoomById(spec.id)) {
+            map.addRoom(spec.name, spec.id, spec.flooringType, spec.size, spec.isRoomClean);
+            placeRoom(map.getRoomById(spec.id), spec);
+        }
+    }
+    for (const auto& spec : changedRooms) {
+        if (Room* room = map.getRoomById(spec.id)) {
+            room->roomName = spec.name;
+            room->setFlooringType(spec.flooringType);
+            room->setSize(spec.size);
+            placeRoom(room, spec);
+        }
+    }
+    for (const auto& edge : addedConnections) {
+        Room* a = map.getRoomById(edge.first);
+        Room* b = map.getRoomById(edge.second);
+        if (!a || !b) continue;
+        if (std::find(a->neighbors.begin(), a->neighbors.end(), b) == a->neighbors.end()) {
+            map.connectRooms(a, b);
+        }
+        touch(edge);
+    }
+    for (const auto& edge : addedWalls) {
+        Room* a = map.getRoomById(edge.first);
+        Room* b = map.getRoomById(edge.second);
+        if (!a || !b || map.isVirtualWallBetween(a, b)) continue;
+        map.addVirtualWall(a, b);
+        touch(edge);
+    }
+
+    // Chargers only change where robots go to charge, not which edges exist
+    for (int id : removedChargers) {
+        map.removeCharger(id);
+    }
+    for (const auto& charger : addedChargers) {
+        if (map.getRoomById(charger.roomId)) map.addCharger(charger.roomId, charger.slots);
+    }
+    return touched;
+}
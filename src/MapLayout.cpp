@@ -0,0 +1,226 @@
+#include "MapLayout/MapLayout.h"
+#include "map/map.h"
+#include "map/MapSnapshot.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+namespace {
+    constexpr double kGoldenAngle = 2.39996322972865332;   // spreads coincident rooms apart
+
+    uint64_t cellKey(int level, long cx, long cy) {
+        return (static_cast<uint64_t>(static_cast<uint16_t>(level)) << 48) ^
+               (static_cast<uint64_t>(static_cast<uint32_t>(cx) & 0xFFFFFF) << 24) ^
+               (static_cast<uint64_t>(static_cast<uint32_t>(cy) & 0xFFFFFF));
+    }
+
+    int defaultIterations(size_t n) {
+        if (n <= 1000) return 300;
+        if (n <= 20000) return 100;
+        return 50;
+    }
+
+    // Radial tree start: each unplaced room hangs off its breadth-first parent,
+    // at its depth times kSpacing from the tree's root, inside an angular wedge
+    // sized by its subtree. Trees grow from declared rooms; components without
+    // one are started in a row to the right. The forces then only have to relax
+    // the layout instead of untangle it.
+    void seed(std::vector<MapLayout::Node>& nodes) {
+        const double k = MapLayout::kSpacing;
+        size_t n = nodes.size();
+        std::vector<long> parent(n, -1);
+        std::vector<size_t> rootOf(n);
+        std::vector<int> depth(n, 0);
+        std::vector<char> reached(n, 0);
+        std::vector<size_t> order;
+        order.reserve(n);
+
+        auto grow = [&](size_t from) {
+            int deepest = 0;
+            for (size_t head = from; head < order.size(); ++head) {
+                size_t u = order[head];
+                for (size_t v : nodes[u].neighbors) {
+                    if (v >= n || reached[v]) continue;
+                    reached[v] = 1;
+                    parent[v] = static_cast<long>(u);
+                    rootOf[v] = rootOf[u];
+                    depth[v] = depth[u] + 1;
+                    deepest = std::max(deepest, depth[v]);
+                    order.push_back(v);
+                }
+            }
+            return deepest;
+        };
+
+        bool anyPinned = false;
+        double pinnedMaxX = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            if (!nodes[i].pinned) continue;
+            reached[i] = 1;
+            rootOf[i] = i;
+            order.push_back(i);
+            pinnedMaxX = anyPinned ? std::max(pinnedMaxX, nodes[i].position.x) : nodes[i].position.x;
+            anyPinned = true;
+        }
+        int pinnedDepth = grow(0);
+
+        double nextX = anyPinned ? pinnedMaxX + (pinnedDepth + 4) * k : 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            if (reached[i]) continue;
+            reached[i] = 1;
+            rootOf[i] = i;
+            size_t from = order.size();
+            order.push_back(i);
+            int deepest = grow(from);
+            nodes[i].position = RoomPosition{nextX + deepest * k, 0.0, 0};
+            nextX += (2 * deepest + 4) * k;
+        }
+
+        std::vector<size_t> subtree(n, 1);
+        for (size_t idx = order.size(); idx-- > 0;) {
+            size_t u = order[idx];
+            if (parent[u] >= 0) subtree[parent[u]] += subtree[u];
+        }
+
+        // Children take consecutive slices of their parent's wedge, in discovery order
+        std::vector<double> wedgeStart(n, 0.0);
+        std::vector<double> wedgeSpan(n, 2 * M_PI);
+        std::vector<double> nextStart(n, 0.0);
+        for (size_t u : order) {
+            if (parent[u] < 0) continue;
+            size_t p = static_cast<size_t>(parent[u]);
+            double span = wedgeSpan[p] * subtree[u] / static_cast<double>(subtree[p] - 1);
+            wedgeStart[u] = nextStart[p];
+            wedgeSpan[u] = span;
+            nextStart[p] += span;
+            nextStart[u] = wedgeStart[u];
+
+            double angle = wedgeStart[u] + span / 2;
+            const RoomPosition& root = nodes[rootOf[u]].position;
+            nodes[u].position = RoomPosition{root.x + depth[u] * k * std::cos(angle),
+                                             root.y + depth[u] * k * std::sin(angle), root.level};
+        }
+    }
+}
+
+void MapLayout::layout(std::vector<Node>& nodes, int iterations) {
+    size_t freeCount = std::count_if(nodes.begin(), nodes.end(), [](const Node& n) { return !n.pinned; });
+    if (freeCount == 0) return;
+    seed(nodes);
+    if (iterations <= 0) iterations = defaultIterations(nodes.size());
+
+    const double k = kSpacing;
+    const double cutoff = 2 * k;
+    const double cell = cutoff;
+    std::vector<double> dx(nodes.size());
+    std::vector<double> dy(nodes.size());
+    std::unordered_map<uint64_t, std::vector<size_t>> grid;
+
+    for (int step = 0; step < iterations; ++step) {
+        // Largest move allowed this step, cooling linearly
+        double temperature = k * (1.0 - static_cast<double>(step) / iterations) + k * 0.01;
+        std::fill(dx.begin(), dx.end(), 0.0);
+        std::fill(dy.begin(), dy.end(), 0.0);
+
+        grid.clear();
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            const auto& p = nodes[i].position;
+            grid[cellKey(p.level, std::lround(std::floor(p.x / cell)), std::lround(std::floor(p.y / cell)))].push_back(i);
+        }
+
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            const auto& p = nodes[i].position;
+            long cx = std::lround(std::floor(p.x / cell));
+            long cy = std::lround(std::floor(p.y / cell));
+            for (long ox = -1; ox <= 1; ++ox) {
+                for (long oy = -1; oy <= 1; ++oy) {
+                    auto it = grid.find(cellKey(p.level, cx + ox, cy + oy));
+                    if (it == grid.end()) continue;
+                    for (size_t j : it->second) {
+                        if (j <= i) continue;
+                        double ddx = p.x - nodes[j].position.x;
+                        double ddy = p.y - nodes[j].position.y;
+                        double dist = std::sqrt(ddx * ddx + ddy * ddy);
+                        if (dist >= cutoff) continue;
+                        if (dist < 1e-6) {
+                            // Coincident rooms: push apart in a direction fixed by their indexes
+                            double angle = kGoldenAngle * static_cast<double>(i + j);
+                            ddx = std::cos(angle);
+                            ddy = std::sin(angle);
+                            dist = 1e-3;
+                        }
+                        double force = k * k / dist;
+                        dx[i] += ddx / dist * force;
+                        dy[i] += ddy / dist * force;
+                        dx[j] -= ddx / dist * force;
+                        dy[j] -= ddy / dist * force;
+                    }
+                }
+            }
+            for (size_t j : nodes[i].neighbors) {
+                if (j <= i || j >= nodes.size() || nodes[j].position.level != p.level) continue;
+                double ddx = p.x - nodes[j].position.x;
+                double ddy = p.y - nodes[j].position.y;
+                double dist = std::sqrt(ddx * ddx + ddy * ddy);
+                if (dist < 1e-6) continue;
+                double force = dist * dist / k;
+                dx[i] -= ddx / dist * force;
+                dy[i] -= ddy / dist * force;
+                dx[j] += ddx / dist * force;
+                dy[j] += ddy / dist * force;
+            }
+        }
+
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            if (nodes[i].pinned) continue;
+            double length = std::sqrt(dx[i] * dx[i] + dy[i] * dy[i]);
+            if (length < 1e-9) continue;
+            double move = std::min(length, temperature);
+            nodes[i].position.x += dx[i] / length * move;
+            nodes[i].position.y += dy[i] / length * move;
+        }
+    }
+}
+
+size_t MapLayout::assignMissingPositions(Map& map) {
+    const auto& rooms = map.getRooms();
+    std::unordered_map<const Room*, size_t> indexOf;
+    indexOf.reserve(rooms.size());
+    for (size_t i = 0; i < rooms.size(); ++i) indexOf.emplace(rooms[i], i);
+
+    std::vector<Node> nodes(rooms.size());
+    for (size_t i = 0; i < rooms.size(); ++i) {
+        nodes[i].pinned = rooms[i]->hasPosition();
+        nodes[i].position = rooms[i]->getPosition();
+        for (const Room* neighbor : rooms[i]->neighbors) {
+            auto it = indexOf.find(neighbor);
+            if (it != indexOf.end()) nodes[i].neighbors.push_back(it->second);
+        }
+    }
+    layout(nodes);
+
+    size_t placed = 0;
+    for (size_t i = 0; i < rooms.size(); ++i) {
+        if (nodes[i].pinned) continue;
+        rooms[i]->setPosition(nodes[i].position);
+        ++placed;
+    }
+    return placed;
+}
+
+std::vector<RoomPosition> MapLayout::positionsFor(const MapSnapshot& snapshot) {
+    const auto& rooms = snapshot.rooms();
+    std::vector<Node> nodes(rooms.size());
+    for (size_t i = 0; i < rooms.size(); ++i) {
+        nodes[i].pinned = rooms[i].hasPosition;
+        nodes[i].position = rooms[i].position;
+        nodes[i].neighbors = rooms[i].neighbors;
+    }
+    layout(nodes);
+
+    std::vector<RoomPosition> positions;
+    positions.reserve(nodes.size());
+    for (const auto& node : nodes) positions.push_back(node.position);
+    return positions;
+}
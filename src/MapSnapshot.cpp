@@ -0,0 +1,96 @@
+#include "map/MapSnapshot.h"
+#include "map/map.h"
+#include <algorithm>
+#include <queue>
+
+uint64_t MapSnapshot::wallKey(int a, int b) {
+    if (a > b) std::swap(a, b);
+    return (static_cast<uint64_t>(static_cast<uint32_t>(a)) << 32) | static_cast<uint32_t>(b);
+}
+
+std::shared_ptr<const MapSnapshot> MapSnapshot::capture(const Map& map, uint64_t version,
+                                                         std::shared_ptr<RoomStateTable> states) {
+    auto snapshot = std::make_shared<MapSnapshot>();
+    snapshot->version_ = version;
+    snapshot->states_ = std::move(states);
+
+    const auto& rooms = map.getRooms();
+    snapshot->rooms_.reserve(rooms.size());
+    snapshot->indexById_.reserve(rooms.size());
+    std::unordered_map<const Room*, size_t> indexOf;
+    for (size_t i = 0; i < rooms.size(); ++i) {
+        const Room* room = rooms[i];
+        indexOf.emplace(room, i);
+        snapshot->indexById_.emplace(room->getRoomId(), i);
+        snapshot->rooms_.push_back(RoomView{room->getRoomId(), room->getRoomName(), room->getFlooringType(),
+                                            room->getSize(), room->getRoomSize(), room->getFloorType(),
+                                            map.isChargerRoom(room->getRoomId()), room->getStateSlot(), {},
+                                            room->hasPosition(), room->getPosition(), rooms[i]});
+    }
+    for (size_t i = 0; i < rooms.size(); ++i) {
+        auto& neighbors = snapshot->rooms_[i].neighbors;
+        neighbors.reserve(rooms[i]->neighbors.size());
+        for (const Room* neighbor : rooms[i]->neighbors) {
+            auto it = indexOf.find(neighbor);
+            if (it != indexOf.end()) neighbors.push_back(it->second);
+        }
+    }
+    for (const auto& wall : map.getVirtualWalls()) {
+        int a = wall.getRoom1()->getRoomId();
+        int b = wall.getRoom2()->getRoomId();
+        snapshot->walls_.emplace_back(a, b);
+        snapshot->wallKeys_.insert(wallKey(a, b));
+    }
+    return snapshot;
+}
+
+const MapSnapshot::RoomView* MapSnapshot::findRoom(int id) const {
+    auto it = indexById_.find(id);
+    return it == indexById_.end() ? nullptr : &rooms_[it->second];
+}
+
+bool MapSnapshot::isVirtualWallBetween(int roomId1, int roomId2) const {
+    return wallKeys_.count(wallKey(roomId1, roomId2)) > 0;
+}
+
+std::vector<int> MapSnapshot::getRoute(int fromId, int toId) const {
+    auto from = indexById_.find(fromId);
+    auto to = indexById_.find(toId);
+    if (from == indexById_.end() || to == indexById_.end()) return {};
+
+    constexpr size_t kUnvisited = static_cast<size_t>(-1);
+    std::vector<size_t> cameFrom(rooms_.size(), kUnvisited);
+    std::queue<size_t> queue;
+    queue.push(from->second);
+    cameFrom[from->second] = from->second;
+
+    while (!queue.empty()) {
+        size_t current = queue.front();
+        queue.pop();
+        if (current == to->second) {
+            std::vector<int> route;
+            for (size_t at = current; ; at = cameFrom[at]) {
+                route.push_back(rooms_[at].id);
+                if (at == from->second) break;
+            }
+            std::reverse(route.begin(), route.end());
+            return route;
+        }
+        for (size_t neighbor : rooms_[current].neighbors) {
+            if (cameFrom[neighbor] == kUnvisited &&
+                !isVirtualWallBetween(rooms_[current].id, rooms_[neighbor].id)) {
+                cameFrom[neighbor] = current;
+                queue.push(neighbor);
+            }
+        }
+    }
+    return {};
+}
+
+bool MapSnapshot::isClean(const RoomView& room) const {
+    return states_ ? states_->isClean(room.stateSlot) : true;
+}
+
+int MapSnapshot::occupancy(const RoomView& room) const {
+    return states_ ? states_->occupancy(room.stateSlot) : 0;
+}
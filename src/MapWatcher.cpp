@@ -0,0 +1,158 @@
+#include "MapWatcher/MapWatcher.h"
+#include "map/map.h"
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <poll.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+namespace {
+    // Editors often write in several steps; wait for the burst to settle
+    constexpr int kSettleMillis = 50;
+    constexpr int kPollMillis = 500;
+}
+
+MapWatcher::MapWatcher(const std::string& path) : path_(path), baseline_(std::make_unique<Map>()) {
+    baseline_->loadFromFile(path_);
+}
+
+MapWatcher::~MapWatcher() {
+    stop();
+}
+
+void MapWatcher::start() {
+    if (running_) return;
+    if (::pipe(wakePipe_) != 0) {
+        throw std::runtime_error("MapWatcher: failed to create wake pipe");
+    }
+#ifdef __linux__
+    // Watch the directory: editors and deploy scripts usually replace the file by rename
+    std::filesystem::path file(path_);
+    std::string dir = file.has_parent_path() ? file.parent_path().string() : ".";
+    inotifyFd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ >= 0 && ::inotify_add_watch(inotifyFd_, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+        ::close(inotifyFd_);
+        inotifyFd_ = -1;
+    }
+    if (inotifyFd_ < 0) {
+        std::cout << "[DEBUG] MapWatcher: inotify unavailable for " << dir << ", watcher idle\n";
+    }
+#endif
+    running_ = true;
+    thread_ = std::thread(&MapWatcher::run, this);
+}
+
+void MapWatcher::stop() {
+    if (!running_) return;
+    running_ = false;
+    char byte = 0;
+    ssize_t written = ::write(wakePipe_[1], &byte, 1);
+    (void)written;
+    if (thread_.joinable()) thread_.join();
+    ::close(wakePipe_[0]);
+    ::close(wakePipe_[1]);
+    wakePipe_[0] = wakePipe_[1] = -1;
+    if (inotifyFd_ >= 0) {
+        ::close(inotifyFd_);
+        inotifyFd_ = -1;
+    }
+}
+
+bool MapWatcher::reload() {
+    std::lock_guard<std::mutex> reloadLock(reloadMutex_);
+    auto begin = std::chrono::steady_clock::now();
+
+    auto next = std::make_unique<Map>();
+    try {
+        next->loadFromFile(path_);
+    } catch (const std::exception& e) {
+        std::cout << "[DEBUG] MapWatcher: keeping previous map, reload failed: " << e.what() << "\n";
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        stats_.failedReloads++;
+        return false;
+    }
+
+    MapDiff diff = MapDiff::between(*baseline_, *next);
+    baseline_ = std::move(next);
+    double millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    stats_.reloads++;
+    stats_.lastReloadMillis = millis;
+    if (!diff.empty()) {
+        std::cout << "[DEBUG] MapWatcher: " << path_ << " changed, " << diff.changeCount() << " edits queued\n";
+        pending_.push_back(std::move(diff));
+        stats_.diffsQueued++;
+    }
+    return true;
+}
+
+std::vector<MapDiff> MapWatcher::takePendingDiffs() {
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    std::vector<MapDiff> diffs;
+    diffs.swap(pending_);
+    return diffs;
+}
+
+bool MapWatcher::hasPendingDiffs() const {
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    return !pending_.empty();
+}
+
+MapWatcher::Stats MapWatcher::getStats() const {
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    return stats_;
+}
+
+void MapWatcher::run() {
+    std::filesystem::path file(path_);
+    std::string name = file.filename().string();
+
+#ifdef __linux__
+    int inotifyFd = inotifyFd_;
+    if (inotifyFd < 0) return;
+
+    // Returns true when any queued event names the watched file
+    auto drain = [&]() {
+        alignas(inotify_event) char buffer[4096];
+        bool ours = false;
+        ssize_t length;
+        while ((length = ::read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+            for (char* at = buffer; at < buffer + length;) {
+                auto* event = reinterpret_cast<inotify_event*>(at);
+                if (event->len > 0 && name == event->name) ours = true;
+                at += sizeof(inotify_event) + event->len;
+            }
+        }
+        return ours;
+    };
+
+    pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {wakePipe_[0], POLLIN, 0}};
+    while (running_) {
+        if (::poll(fds, 2, -1) <= 0) continue;
+        if (fds[1].revents & POLLIN) break;
+        if (!drain()) continue;
+        ::poll(&fds[1], 1, kSettleMillis);
+        drain();
+        if (running_) reload();
+    }
+#else
+    std::error_code ec;
+    auto lastWrite = std::filesystem::last_write_time(file, ec);
+    pollfd wake{wakePipe_[0], POLLIN, 0};
+    while (running_) {
+        if (::poll(&wake, 1, kPollMillis) > 0) break;
+        auto writeTime = std::filesystem::last_write_time(file, ec);
+        if (!ec && writeTime != lastWrite) {
+            lastWrite = writeTime;
+            ::poll(&wake, 1, kSettleMillis);
+            if (running_) reload();
+        }
+    }
+    (void)name;
+#endif
+}
@@ -0,0 +1,185 @@
+#include "RobotMetrics/MetricsAggregator.h"
+#include "Robot/Robot.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr size_t kCleaning = static_cast<size_t>(MetricsAggregator::State::CLEANING);
+    constexpr size_t kMoving = static_cast<size_t>(MetricsAggregator::State::MOVING);
+
+    double ratio(double part, double whole) {
+        return whole > 0.0 ? part / whole : 0.0;
+    }
+}
+
+void MetricsAggregator::Totals::add(const Totals& other) {
+    for (size_t i = 0; i < kStateCount; ++i) seconds[i] += other.seconds[i];
+    batteryUsed += other.batteryUsed;
+    waterUsed += other.waterUsed;
+    cleaningBatteryUsed += other.cleaningBatteryUsed;
+    errors += other.errors;
+}
+
+double MetricsAggregator::Totals::observedSeconds() const {
+    double total = 0.0;
+    for (double s : seconds) total += s;
+    return total;
+}
+
+double MetricsAggregator::Totals::busySeconds() const {
+    return seconds[kMoving] + seconds[kCleaning];
+}
+
+void MetricsAggregator::Ring::add(double now, const Totals& delta) {
+    long bucket = static_cast<long>(std::floor(now / bucketSeconds_));
+    if (bucket > head_) {
+        // Clear the buckets that fell out of the window, then re-add the rest
+        long stale = std::min<long>(bucket - head_, static_cast<long>(kBuckets));
+        if (head_ < 0) stale = kBuckets;
+        for (long k = 1; k <= stale; ++k) {
+            buckets_[static_cast<size_t>(head_ + k) % kBuckets] = Totals{};
+        }
+        head_ = bucket;
+        total_ = Totals{};
+        for (const auto& entry : buckets_) total_.add(entry);
+    } else if (bucket <= head_ - static_cast<long>(kBuckets)) {
+        return;   // older than the window
+    }
+    // A late sample within the window lands in its own bucket
+    buckets_[static_cast<size_t>(std::max(bucket, 0L)) % kBuckets].add(delta);
+    total_.add(delta);
+}
+
+MetricsAggregator::Windows::Windows()
+    : rings{Ring(windowSeconds(Window::MINUTE) / kBuckets),
+            Ring(windowSeconds(Window::HOUR) / kBuckets),
+            Ring(windowSeconds(Window::DAY) / kBuckets)} {
+}
+
+void MetricsAggregator::Windows::add(double now, const Totals& delta) {
+    for (auto& ring : rings) ring.add(now, delta);
+}
+
+MetricsAggregator::RobotEntry& MetricsAggregator::entry(size_t robot) {
+    while (robots_.size() <= robot) robots_.push_back(std::make_unique<RobotEntry>());
+    return *robots_[robot];
+}
+
+void MetricsAggregator::observe(const std::vector<std::shared_ptr<Robot>>& robots, double now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < robots.size(); ++i) {
+        if (!robots[i]) continue;
+        const Robot& robot = *robots[i];
+        RobotEntry& current = entry(i);
+        State state = stateOf(robot);
+        double battery = robot.getBatteryLevel();
+        double water = robot.getWaterLevel();
+        if (current.name != robot.getName()) {
+            // A different robot now sits at this index; start its history afresh
+            current.name = robot.getName();
+            current.last.seen = false;
+            current.windows = Windows();
+        }
+
+        Sample& last = current.last;
+        if (last.seen && now > last.time) {
+            recordLocked(i, last.state, now - last.time,
+                         std::max(0.0, last.battery - battery),   // charging is not usage
+                         std::max(0.0, last.water - water),
+                         state == State::ERROR && last.state != State::ERROR, now);
+        }
+        last = Sample{true, state, battery, water, now};
+    }
+}
+
+void MetricsAggregator::record(size_t robot, State state, double seconds, double batteryUsed, double waterUsed,
+                               bool errorEntered, double now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    recordLocked(robot, state, seconds, batteryUsed, waterUsed, errorEntered, now);
+}
+
+void MetricsAggregator::recordLocked(size_t robot, State state, double seconds, double batteryUsed,
+                                     double waterUsed, bool errorEntered, double now) {
+    Totals delta;
+    delta.seconds[static_cast<size_t>(state)] = std::max(0.0, seconds);
+    delta.batteryUsed = batteryUsed;
+    delta.waterUsed = waterUsed;
+    if (state == State::CLEANING) delta.cleaningBatteryUsed = batteryUsed;
+    delta.errors = errorEntered ? 1.0 : 0.0;
+    entry(robot).windows.add(now, delta);
+    fleet_.add(now, delta);
+}
+
+MetricsAggregator::Totals MetricsAggregator::robotTotals(size_t robot, Window window) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (robot >= robots_.size()) return Totals{};
+    return robots_[robot]->windows.rings[static_cast<size_t>(window)].total();
+}
+
+MetricsAggregator::Totals MetricsAggregator::fleetTotals(Window window) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fleet_.rings[static_cast<size_t>(window)].total();
+}
+
+RobotMetrics MetricsAggregator::robotMetrics(size_t robot, Window window) const {
+    return toMetrics(robotTotals(robot, window));
+}
+
+RobotMetrics MetricsAggregator::fleetMetrics(Window window) const {
+    return toMetrics(fleetTotals(window));
+}
+
+size_t MetricsAggregator::robotCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return robots_.size();
+}
+
+std::string MetricsAggregator::robotName(size_t robot) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return robot < robots_.size() ? robots_[robot]->name : "";
+}
+
+void MetricsAggregator::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    robots_.clear();
+    fleet_ = Windows();
+}
+
+MetricsAggregator::State MetricsAggregator::stateOf(const Robot& robot) {
+    // Same precedence as Robot::getStatus; a flat battery counts as an error
+    if (robot.isFailed() || robot.getBatteryLevel() <= 0.0) return State::ERROR;
+    if (robot.isCharging()) return State::CHARGING;
+    if (robot.isCleaning()) return State::CLEANING;
+    if (robot.isMoving()) return State::MOVING;
+    return State::IDLE;
+}
+
+RobotMetrics MetricsAggregator::toMetrics(const Totals& totals) {
+    double hours = totals.observedSeconds() / 3600.0;
+    double busy = totals.busySeconds();
+    return RobotMetrics(
+        static_cast<float>(ratio(busy, totals.observedSeconds())),
+        static_cast<float>(ratio(totals.errors, hours)),
+        static_cast<float>(ratio(totals.cleaningBatteryUsed, totals.batteryUsed)),
+        static_cast<float>(ratio(totals.seconds[kCleaning], busy)),
+        static_cast<float>(ratio(totals.batteryUsed, hours)),
+        static_cast<float>(ratio(totals.waterUsed, hours)));
+}
+
+double MetricsAggregator::windowSeconds(Window window) {
+    switch (window) {
+        case Window::MINUTE: return 60.0;
+        case Window::HOUR: return 3600.0;
+        case Window::DAY: return 86400.0;
+    }
+    return 60.0;
+}
+
+const char* MetricsAggregator::windowName(Window window) {
+    switch (window) {
+        case Window::MINUTE: return "1m";
+        case Window::HOUR: return "1h";
+        case Window::DAY: return "24h";
+    }
+    return "1m";
+}
@@ -0,0 +1,204 @@
+#include "Metrics/MetricsRegistry.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    std::atomic<size_t> nextShard{0};
+
+    std::string formatValue(double value) {
+        if (std::isnan(value)) return "NaN";
+        if (std::isinf(value)) return value > 0 ? "+Inf" : "-Inf";
+        char buffer[32];
+        if (value == std::floor(value) && std::fabs(value) < 1e15) {
+            std::snprintf(buffer, sizeof(buffer), "%.0f", value);
+        } else {
+            std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+        }
+        return buffer;
+    }
+
+    std::string escapeLabel(const std::string& value) {
+        std::string escaped;
+        escaped.reserve(value.size());
+        for (char c : value) {
+            if (c == '\\') escaped += "\\\\";
+            else if (c == '"') escaped += "\\\"";
+            else if (c == '\n') escaped += "\\n";
+            else escaped += c;
+        }
+        return escaped;
+    }
+
+    std::string escapeHelp(const std::string& help) {
+        std::string escaped;
+        for (char c : help) {
+            if (c == '\\') escaped += "\\\\";
+            else if (c == '\n') escaped += "\\n";
+            else escaped += c;
+        }
+        return escaped;
+    }
+
+    bool validName(const std::string& name) {
+        if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0]))) return false;
+        return std::all_of(name.begin(), name.end(), [](char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == ':';
+        });
+    }
+
+    // a="x",b="y" -- the series key and the text between the braces
+    std::string renderLabels(const MetricsRegistry::Labels& labels) {
+        std::string rendered;
+        for (const auto& [name, value] : labels) {
+            if (!validName(name) || name.find(':') != std::string::npos) {
+                throw std::runtime_error("Invalid metric label name: " + name);
+            }
+            if (!rendered.empty()) rendered += ",";
+            rendered += name + "=\"" + escapeLabel(value) + "\"";
+        }
+        return rendered;
+    }
+
+    std::string series(const std::string& name, const std::string& labels, const std::string& extra = "") {
+        std::string joined = labels;
+        if (!extra.empty()) joined += (joined.empty() ? "" : ",") + extra;
+        return joined.empty() ? name : name + "{" + joined + "}";
+    }
+}
+
+size_t Counter::shardIndex() {
+    thread_local size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % kShards;
+    return shard;
+}
+
+uint64_t Counter::value() const {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) total += shard.value.load(std::memory_order_relaxed);
+    return total;
+}
+
+void Gauge::add(double delta) {
+    double seen = value_.load(std::memory_order_relaxed);
+    while (!value_.compare_exchange_weak(seen, seen + delta, std::memory_order_relaxed)) {
+    }
+}
+
+Histogram::Histogram(std::vector<double> bounds) : bounds_(std::move(bounds)) {
+    std::sort(bounds_.begin(), bounds_.end());
+    bounds_.erase(std::unique(bounds_.begin(), bounds_.end()), bounds_.end());
+    buckets_.reset(new std::atomic<uint64_t>[bounds_.size() + 1]);
+    for (size_t i = 0; i <= bounds_.size(); ++i) buckets_[i].store(0, std::memory_order_relaxed);
+}
+
+void Histogram::observe(double value) {
+    // "le" bounds are inclusive
+    size_t bucket = std::lower_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin();
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    double seen = sum_.load(std::memory_order_relaxed);
+    while (!sum_.compare_exchange_weak(seen, seen + value, std::memory_order_relaxed)) {
+    }
+}
+
+void Histogram::observeSince(std::chrono::steady_clock::time_point start) {
+    observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+}
+
+std::vector<uint64_t> Histogram::bucketCounts() const {
+    std::vector<uint64_t> counts(bounds_.size() + 1);
+    for (size_t i = 0; i < counts.size(); ++i) counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    return counts;
+}
+
+std::vector<double> Histogram::latencyBounds() {
+    return {0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0};
+}
+
+const char* MetricsRegistry::typeName(Type type) {
+    switch (type) {
+        case Type::COUNTER: return "counter";
+        case Type::GAUGE: return "gauge";
+        case Type::HISTOGRAM: return "histogram";
+    }
+    return "untyped";
+}
+
+MetricsRegistry& MetricsRegistry::global() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::Family& MetricsRegistry::family(const std::string& name, const std::string& help, Type type) {
+    if (!validName(name)) {
+        throw std::runtime_error("Invalid metric name: " + name);
+    }
+    auto it = families_.find(name);
+    if (it == families_.end()) {
+        it = families_.emplace(name, Family{type, help, {}, {}, {}, {}}).first;
+    } else if (it->second.type != type) {
+        throw std::runtime_error("Metric " + name + " is already registered as a " +
+                                 typeName(it->second.type));
+    }
+    return it->second;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const Labels& labels) {
+    std::string key = renderLabels(labels);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = family(name, help, Type::COUNTER).counters[key];
+    if (!slot) slot = std::make_unique<Counter>();
+    return *slot;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const Labels& labels) {
+    std::string key = renderLabels(labels);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = family(name, help, Type::GAUGE).gauges[key];
+    if (!slot) slot = std::make_unique<Gauge>();
+    return *slot;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, const Labels& labels,
+                                      const std::vector<double>& bounds) {
+    std::string key = renderLabels(labels);
+    std::lock_guard<std::mutex> lock(mutex_);
+    Family& entry = family(name, help, Type::HISTOGRAM);
+    if (entry.histograms.empty()) entry.bounds = bounds;
+    auto& slot = entry.histograms[key];
+    if (!slot) slot = std::make_unique<Histogram>(entry.bounds);
+    return *slot;
+}
+
+std::string MetricsRegistry::exposition() const {
+    std::ostringstream out;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [name, entry] : families_) {
+        out << "# HELP " << name << " " << escapeHelp(entry.help) << "\n";
+        out << "# TYPE " << name << " " << typeName(entry.type) << "\n";
+        for (const auto& [labels, counter] : entry.counters) {
+            out << series(name, labels) << " " << counter->value() << "\n";
+        }
+        for (const auto& [labels, gauge] : entry.gauges) {
+            out << series(name, labels) << " " << formatValue(gauge->value()) << "\n";
+        }
+        for (const auto& [labels, histogram] : entry.histograms) {
+            std::vector<uint64_t> counts = histogram->bucketCounts();
+            uint64_t cumulative = 0;
+            for (size_t i = 0; i < histogram->bounds().size(); ++i) {
+                cumulative += counts[i];
+                out << series(name + "_bucket", labels, "le=\"" + formatValue(histogram->bounds()[i]) + "\"")
+                    << " " << cumulative << "\n";
+            }
+            // Bucket totals rather than count(), so +Inf never trails the finite buckets mid-observe
+            cumulative += counts.back();
+            out << series(name + "_bucket", labels, "le=\"+Inf\"") << " " << cumulative << "\n";
+            out << series(name + "_sum", labels) << " " << formatValue(histogram->sum()) << "\n";
+            out << series(name + "_count", labels) << " " << cumulative << "\n";
+        }
+    }
+    return out.str();
+}
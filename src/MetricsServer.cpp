@@ -0,0 +1,132 @@
+#include "Metrics/MetricsServer.h"
+#include "Metrics/MetricsRegistry.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+    constexpr int kPollMillis = 200;        // how often the accept loop checks for stop()
+    constexpr size_t kMaxRequest = 8192;
+
+    void sendAll(int fd, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return;
+            sent += static_cast<size_t>(n);
+        }
+    }
+
+    std::string response(const std::string& status, const std::string& contentType, const std::string& body) {
+        return "HTTP/1.0 " + status + "\r\n"
+               "Content-Type: " + contentType + "\r\n"
+               "Content-Length: " + std::to_string(body.size()) + "\r\n"
+               "Connection: close\r\n\r\n" + body;
+    }
+}
+
+MetricsServer::MetricsServer(MetricsRegistry& registry, uint16_t port)
+    : registry_(registry), port_(port) {
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+void MetricsServer::start() {
+    if (running_) return;
+
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::runtime_error(std::string("Metrics server socket failed: ") + std::strerror(errno));
+    }
+    int reuse = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port_);
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(fd, 8) < 0) {
+        std::string reason = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error("Metrics server cannot listen on 127.0.0.1:" + std::to_string(port_) + ": " + reason);
+    }
+    socklen_t length = sizeof(address);
+    if (::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) == 0) {
+        port_ = ntohs(address.sin_port);
+    }
+
+    listenFd_ = fd;
+    running_ = true;
+    thread_ = std::thread(&MetricsServer::run, this);
+    std::cout << "[DEBUG] MetricsServer: serving http://127.0.0.1:" << port_ << "/metrics\n";
+}
+
+void MetricsServer::stop() {
+    if (!running_) return;
+    running_ = false;
+    if (thread_.joinable()) thread_.join();
+    ::close(listenFd_);
+    listenFd_ = -1;
+}
+
+void MetricsServer::run() {
+    while (running_) {
+        pollfd listening{listenFd_, POLLIN, 0};
+        int ready = ::poll(&listening, 1, kPollMillis);
+        if (ready <= 0 || !(listening.revents & POLLIN)) continue;
+        int client = ::accept(listenFd_, nullptr, nullptr);
+        if (client < 0) continue;
+        // A client that connects and never sends must not hold up stop()
+        timeval timeout{1, 0};
+        ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        serve(client);
+        ::close(client);
+    }
+}
+
+void MetricsServer::serve(int client) {
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.find("\n\n") == std::string::npos &&
+           request.size() < kMaxRequest) {
+        ssize_t n = ::recv(client, buffer, sizeof(buffer), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        request.append(buffer, static_cast<size_t>(n));
+    }
+
+    // Only the request line matters: METHOD PATH VERSION
+    std::string line = request.substr(0, request.find_first_of("\r\n"));
+    size_t methodEnd = line.find(' ');
+    size_t pathEnd = line.find(' ', methodEnd + 1);
+    if (methodEnd == std::string::npos) {
+        sendAll(client, response("400 Bad Request", "text/plain", "Bad request\n"));
+        return;
+    }
+    std::string method = line.substr(0, methodEnd);
+    std::string path = line.substr(methodEnd + 1, pathEnd == std::string::npos ? std::string::npos : pathEnd - methodEnd - 1);
+    path = path.substr(0, path.find('?'));
+
+    if (method != "GET" && method != "HEAD") {
+        sendAll(client, response("405 Method Not Allowed", "text/plain", "Only GET is supported\n"));
+        return;
+    }
+    if (path != "/metrics") {
+        sendAll(client, response("404 Not Found", "text/plain", "Metrics are at /metrics\n"));
+        return;
+    }
+    ++scrapes_;
+    std::string reply = response("200 OK", "text/plain; version=0.0.4; charset=utf-8", registry_.exposition());
+    if (method == "HEAD") reply = reply.substr(0, reply.find("\r\n\r\n") + 4);
+    sendAll(client, reply);
+}
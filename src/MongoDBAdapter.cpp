@@ -1,22 +1,49 @@
 #include "adapter/MongoDBAdapter.hpp"
+#include "Metrics/MetricsRegistry.h"
+#include "Telemetry/TelemetryWriter.h"
+#include "Checkpoint/SimulationCheckpoint.h"
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/json.hpp>
 #include <mongocxx/exception/exception.hpp>
+#include <mongocxx/model/update_one.hpp>
+#include <mongocxx/options/bulk_write.hpp>
+#include <mongocxx/options/index.hpp>
+#include <mongocxx/options/insert.hpp>
+#include <mongocxx/options/replace.hpp>
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <unordered_map>
 
 // Using declarations
 using bsoncxx::builder::basic::kvp;
 using bsoncxx::builder::basic::make_document;
+using bsoncxx::builder::basic::sub_array;
+
+namespace {
+    Histogram& writeLatency(const std::string& operation) {
+        return MetricsRegistry::global().histogram("robot_db_write_seconds", "MongoDB write latency",
+                                                   {{"operation", operation}});
+    }
+
+    Counter& writeErrors(const std::string& operation) {
+        return MetricsRegistry::global().counter("robot_db_write_errors_total", "MongoDB writes that threw",
+                                                 {{"operation", operation}});
+    }
+
+    // Items queued for the async writers, including a batch being drained
+    Gauge& queueDepth(const std::string& queue) {
+        return MetricsRegistry::global().gauge("robot_db_queue_depth", "Writes waiting for a database thread",
+                                               {{"queue", queue}});
+    }
+}
 
 // Constructor
 MongoDBAdapter::MongoDBAdapter(const std::string& uri, const std::string& dbName)
     : dbName_(dbName), client_(mongocxx::uri{uri}), db_(client_[dbName]), running_(true) {
 
-    // Clear existing collections on startup
-    dropAlertCollection();
-    dropRobotStatusCollection();
-    dropRoomsCollection(); 
-    std::cout << "MongoDB adapter initialized. Database cleared." << std::endl;
+    std::cout << "MongoDB adapter initialized." << std::endl;
+    createIndexes();
     
     // Start background threads
     robotStatusThread_ = std::thread(&MongoDBAdapter::processRobotStatusQueue, this);
@@ -30,6 +57,47 @@ MongoDBAdapter::~MongoDBAdapter() {
     stop();
 }
 
+void MongoDBAdapter::clearCollections() {
+    dropAlertCollection();
+    dropRobotStatusCollection();
+    dropRoomsCollection();
+    dropCheckpoint();
+    dropHistoryCollections();
+    std::cout << "Database cleared." << std::endl;
+}
+
+// Indexes for the per-document upserts and range queries. Creating an index
+// that already exists is a no-op, so this runs at startup and after a drop;
+// callers hold mutex_ once the background threads are running.
+void MongoDBAdapter::createIndexes() {
+    try {
+        // Status upserts filter on the robot's name, one document per robot
+        mongocxx::options::index unique;
+        unique.unique(true);
+        db_["robot_status"].create_index(make_document(kvp("name", 1)), unique);
+    } catch (const mongocxx::exception& e) {
+        std::cerr << "Error creating robot status index in MongoDB: " << e.what() << std::endl;
+    }
+    try {
+        db_["robot_telemetry"].create_index(make_document(
+            kvp("robot", 1), kvp("resolution", 1), kvp("start", 1)));
+    } catch (const mongocxx::exception& e) {
+        std::cerr << "Error creating telemetry index in MongoDB: " << e.what() << std::endl;
+    }
+}
+
+void MongoDBAdapter::dropHistoryCollections() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    try {
+        db_["robot_telemetry"].drop();
+        db_["robot_analytics"].drop();
+        std::cout << "Telemetry and analytics collections dropped from MongoDB" << std::endl;
+    } catch (const mongocxx::exception& e) {
+        std::cerr << "Error dropping telemetry and analytics collections from MongoDB: " << e.what() << std::endl;
+    }
+    createIndexes();
+}
+
 // Stop all background threads
 void MongoDBAdapter::stop() {
     if (!running_) return;
@@ -66,7 +134,10 @@ void MongoDBAdapter::stopRobotStatusThread() {
 
 // Alert methods implementation
 void MongoDBAdapter::saveAlert(const Alert& alert) {
+    static Histogram& latency = writeLatency("alert");
+    static Counter& errors = writeErrors("alert");
     std::lock_guard<std::mutex> lock(mutex_);
+    Histogram::Timer timer(latency);
     auto alertCollection = db_["alerts"];
 
     // Convert Alert to BSON and save to MongoDB
@@ -82,6 +153,7 @@ void MongoDBAdapter::saveAlert(const Alert& alert) {
         alertCollection.insert_one(alert_doc.view());
         std::cout << "Alert saved to MongoDB: " << alert.getTitle() << std::endl;
     } catch (const mongocxx::exception& e) {
+        errors.inc();
         std::cerr << "Error inserting alert into MongoDB: " << e.what() << std::endl;
     }
 }
@@ -95,6 +167,8 @@ void MongoDBAdapter::saveAlertAsync(const Alert& alert) {
     auto clonedAlert = std::make_shared<Alert>(alert);
     std::cout << "saveAlertAsync: Pushing alert into queue" << std::endl;
     alertQueue_.push(clonedAlert);
+    static Gauge& depth = queueDepth("alerts");
+    depth.add(1);
     cv_.notify_one();
 }
 
@@ -171,40 +245,94 @@ void MongoDBAdapter::saveRobotStatus(std::shared_ptr<Robot> robot) {
         std::cerr << "Attempted to save null robot status" << std::endl;
         return;
     }
+    writeRobotStatuses({robot});
+}
+
+void MongoDBAdapter::writeRobotStatuses(const std::vector<std::shared_ptr<Robot>>& robots) {
+    static Histogram& latency = writeLatency("robot_status");
+    static Counter& errors = writeErrors("robot_status");
+    static Counter& written = MetricsRegistry::global().counter(
+        "robot_db_status_saves_total", "Robot status saves by outcome", {{"result", "written"}});
+    static Counter& skipped = MetricsRegistry::global().counter(
+        "robot_db_status_saves_total", "Robot status saves by outcome", {{"result", "skipped"}});
+
+    // Only the latest state of each robot matters
+    std::vector<RobotStatusRecord> records;
+    std::unordered_map<std::string, size_t> byName;
+    for (const auto& robot : robots) {
+        if (!robot) continue;
+        RobotStatusRecord record = RobotStatusRecord::from(*robot);
+        auto it = byName.find(record.name);
+        if (it != byName.end()) {
+            records[it->second] = std::move(record);
+        } else {
+            byName.emplace(record.name, records.size());
+            records.push_back(std::move(record));
+        }
+    }
+    if (records.empty()) return;
 
     std::lock_guard<std::mutex> lock(mutex_);
-    auto robotCollection = db_["robot_status"];
+    std::vector<std::pair<const RobotStatusRecord*, uint32_t>> pending;
+    for (const auto& record : records) {
+        uint32_t fields = statusTracker_.fieldsToWrite(record);
+        if (fields == 0) {
+            skipped.inc();
+        } else {
+            pending.emplace_back(&record, fields);
+        }
+    }
+    if (pending.empty()) return;
 
+    Histogram::Timer timer(latency);
+    auto robotCollection = db_["robot_status"];
     try {
-        // First, delete any existing status for this robot
-        robotCollection.delete_one(make_document(kvp("name", robot->getName())));
-
-        // Create BSON document with robot status
-        auto status_doc = make_document(
-            kvp("name", robot->getName()),
-            kvp("battery_level", static_cast<double>(robot->getBatteryLevel())),
-            kvp("water_level", static_cast<double>(robot->getWaterLevel())),
-            kvp("status", robot->getStatus()),
-            kvp("current_room", robot->getCurrentRoom() ? robot->getCurrentRoom()->getRoomName() : "Unknown"),
-            kvp("movement_progress", static_cast<double>(robot->getMovementProgress())),
-            kvp("is_cleaning", robot->isCleaning()),
-            kvp("is_charging", robot->isCharging()),
-            kvp("needs_maintenance", robot->needsMaintenance()),
-            kvp("low_battery_alert_sent", robot->isLowBatteryAlertSent()),
-            kvp("low_water_alert_sent", robot->isLowWaterAlertSent())
-        );
+        // Upserts touch different documents, so the server may apply them in any order
+        mongocxx::options::bulk_write options;
+        options.ordered(false);
+        auto bulk = robotCollection.create_bulk_write(options);
+        for (const auto& [record, fields] : pending) {
+            bsoncxx::builder::basic::document set;
+            if (fields & RobotStatusRecord::BATTERY_LEVEL) set.append(kvp("battery_level", record->batteryLevel));
+            if (fields & RobotStatusRecord::WATER_LEVEL) set.append(kvp("water_level", record->waterLevel));
+            if (fields & RobotStatusRecord::STATUS) set.append(kvp("status", record->status));
+            if (fields & RobotStatusRecord::CURRENT_ROOM) set.append(kvp("current_room", record->currentRoom));
+            if (fields & RobotStatusRecord::MOVEMENT_PROGRESS) set.append(kvp("movement_progress", record->movementProgress));
+            if (fields & RobotStatusRecord::IS_CLEANING) set.append(kvp("is_cleaning", record->isCleaning));
+            if (fields & RobotStatusRecord::IS_CHARGING) set.append(kvp("is_charging", record->isCharging));
+            if (fields & RobotStatusRecord::NEEDS_MAINTENANCE) set.append(kvp("needs_maintenance", record->needsMaintenance));
+            if (fields & RobotStatusRecord::LOW_BATTERY_ALERT_SENT) set.append(kvp("low_battery_alert_sent", record->lowBatteryAlertSent));
+            if (fields & RobotStatusRecord::LOW_WATER_ALERT_SENT) set.append(kvp("low_water_alert_sent", record->lowWaterAlertSent));
+
+            mongocxx::model::update_one op{make_document(kvp("name", record->name)),
+                                           make_document(kvp("$set", set.view()))};
+            op.upsert(true);
+            bulk.append(op);
+        }
+        bulk.execute();
 
-        robotCollection.insert_one(status_doc.view());
-        std::cout << "Robot status saved to MongoDB: " << robot->getName() << std::endl;
+        for (const auto& [record, fields] : pending) {
+            statusTracker_.markWritten(*record, fields);
+            written.inc();
+        }
     } catch (const mongocxx::exception& e) {
+        // Nothing is marked, so the next save sends these fields again
+        errors.inc();
         std::cerr << "Error saving robot status to MongoDB: " << e.what() << std::endl;
     }
 }
 
+StatusChangeTracker::Stats MongoDBAdapter::getStatusWriteStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statusTracker_.getStats();
+}
+
 void MongoDBAdapter::saveRobotStatusAsync(std::shared_ptr<Robot> robot) {
     if (!robot) return;
     std::lock_guard<std::mutex> lock(mutex_);
     robotStatusQueue_.push(robot);
+    static Gauge& depth = queueDepth("robot_status");
+    depth.add(1);
     cv_.notify_one();
 }
 
@@ -250,6 +378,7 @@ void MongoDBAdapter::deleteRobotStatus(const std::string& robotName) {
     auto robotCollection = db_["robot_status"];
     try {
         robotCollection.delete_one(make_document(kvp("name", robotName)));
+        statusTracker_.forget(robotName);
         std::cout << "Robot status deleted from MongoDB: " << robotName << std::endl;
     } catch (const mongocxx::exception& e) {
         std::cerr << "Error deleting robot status from MongoDB: " << e.what() << std::endl;
@@ -261,6 +390,7 @@ void MongoDBAdapter::deleteAllRobotStatuses() {
     auto robotCollection = db_["robot_status"];
     try {
         robotCollection.delete_many({});
+        statusTracker_.clear();
         std::cout << "All robot statuses deleted from MongoDB" << std::endl;
     } catch (const mongocxx::exception& e) {
         std::cerr << "Error deleting all robot statuses from MongoDB: " << e.what() << std::endl;
@@ -271,15 +401,20 @@ void MongoDBAdapter::dropRobotStatusCollection() {
     std::lock_guard<std::mutex> lock(mutex_);
     try {
         db_["robot_status"].drop();
+        statusTracker_.clear();
         std::cout << "Robot status collection dropped from MongoDB" << std::endl;
     } catch (const mongocxx::exception& e) {
         std::cerr << "Error dropping robot status collection from MongoDB: " << e.what() << std::endl;
     }
+    createIndexes();
 }
 
 // Room methods implementation
 void MongoDBAdapter::saveRoomStatus(const Room& room) {
+    static Histogram& latency = writeLatency("room_status");
+    static Counter& errors = writeErrors("room_status");
     std::lock_guard<std::mutex> lock(mutex_);
+    Histogram::Timer timer(latency);
     auto roomsCollection = db_["rooms"];
     
     // Create BSON document
@@ -288,7 +423,7 @@ void MongoDBAdapter::saveRoomStatus(const Room& room) {
         kvp("roomName", room.getRoomName()),
         kvp("flooringType", room.getFlooringType()),
         kvp("size", room.getSize()),
-        kvp("isRoomClean", room.isRoomClean)
+        kvp("isRoomClean", room.isClean())
     );
     
     try {
@@ -300,6 +435,7 @@ void MongoDBAdapter::saveRoomStatus(const Room& room) {
         );
         std::cout << "Room status saved to MongoDB: " << room.getRoomName() << std::endl;
     } catch (const mongocxx::exception& e) {
+        errors.inc();
         std::cerr << "Error saving room status to MongoDB: " << e.what() << std::endl;
     }
 }
@@ -309,6 +445,8 @@ void MongoDBAdapter::saveRoomStatusAsync(const Room& room) {
     std::lock_guard<std::mutex> lock(mutex_);
     auto clonedRoom = std::make_shared<Room>(*const_cast<Room*>(&room));
     roomQueue_.push(clonedRoom);
+    static Gauge& depth = queueDepth("rooms");
+    depth.add(1);
     cv_.notify_one();
 }
 
@@ -337,7 +475,11 @@ void MongoDBAdapter::loadRoomStatuses(std::vector<Room*>& rooms) {
             // Update room status
             for (auto& room : rooms) {
                 if (room->getRoomId() == roomId) {
-                    room->isRoomClean = isRoomClean;
+                    if (isRoomClean) {
+                        room->markClean();
+                    } else {
+                        room->markDirty();
+                    }
                     std::cout << "Room " << room->getRoomName() << " loaded as "
                               << (isRoomClean ? "clean" : "dirty") << " from database." << std::endl;
                     break;
@@ -363,7 +505,7 @@ void MongoDBAdapter::initializeRooms(const std::vector<Room*>& rooms) {
                     kvp("roomName", room->getRoomName()),
                     kvp("flooringType", room->getFlooringType()),
                     kvp("size", room->getSize()),
-                    kvp("isRoomClean", room->isRoomClean)
+                    kvp("isRoomClean", room->isClean())
                 );
                 roomsCollection.insert_one(room_doc.view());
                 std::cout << "Room inserted into MongoDB: " << room->getRoomName() << std::endl;
@@ -379,6 +521,7 @@ void MongoDBAdapter::initializeRooms(const std::vector<Room*>& rooms) {
 
 // Process room queue for asynchronous operations
 void MongoDBAdapter::processRoomQueue() {
+    static Gauge& depth = queueDepth("rooms");
     std::queue<std::shared_ptr<Room>> localQueue;
     
     while (running_) {
@@ -396,11 +539,13 @@ void MongoDBAdapter::processRoomQueue() {
             if (room) {
                 saveRoomStatus(*room);
             }
+            depth.add(-1);
         }
     }
 }
 
 void MongoDBAdapter::processAlertQueue() {
+    static Gauge& depth = queueDepth("alerts");
     std::queue<std::shared_ptr<Alert>> localQueue; // Only define once outside the loop
 
     while (running_) {
@@ -420,11 +565,13 @@ void MongoDBAdapter::processAlertQueue() {
                 std::cout << "processAlertQueue: Saving alert..." << std::endl;
                 saveAlert(*alert);
             }
+            depth.add(-1);
         }
     }
 }
 
 void MongoDBAdapter::processRobotStatusQueue() {
+    static Gauge& depth = queueDepth("robot_status");
     std::queue<std::shared_ptr<Robot>> localQueue;
     
     while (running_) {
@@ -436,35 +583,61 @@ void MongoDBAdapter::processRobotStatusQueue() {
         std::swap(localQueue, robotStatusQueue_);
         lock.unlock();
         
+        // One bulk write for everything queued since the last wake-up
+        std::vector<std::shared_ptr<Robot>> batch;
+        batch.reserve(localQueue.size());
         while (!localQueue.empty()) {
-            auto robot = localQueue.front();
+            batch.push_back(localQueue.front());
             localQueue.pop();
-            if (robot) {
-                saveRobotStatus(robot);
-            }
         }
+        writeRobotStatuses(batch);
+        depth.add(-static_cast<double>(batch.size()));
     }
 }
 
 
 
 void MongoDBAdapter::saveRobotAnalytics(std::shared_ptr<Robot> robot) {
-    if (!robot) return;
+    if (robot) writeRobotAnalytics(*robot, nullptr);
+}
+
+void MongoDBAdapter::saveRobotAnalytics(std::shared_ptr<Robot> robot, const RobotMetrics& lastHour) {
+    if (robot) writeRobotAnalytics(*robot, &lastHour);
+}
+
+void MongoDBAdapter::writeRobotAnalytics(const Robot& robot, const RobotMetrics* lastHour) {
+    static Histogram& latency = writeLatency("robot_analytics");
+    static Counter& errors = writeErrors("robot_analytics");
     std::lock_guard<std::mutex> lock(mutex_);
+    Histogram::Timer timer(latency);
     auto analyticsCollection = db_["robot_analytics"];
 
+    bsoncxx::builder::basic::document doc;
+    doc.append(
+        kvp("name", robot.getName()),
+        kvp("error_count", robot.getErrorCount()),
+        kvp("total_work_time", robot.getTotalWorkTime())
+    );
+    if (lastHour) {
+        doc.append(kvp("metrics_1h", make_document(
+            kvp("utilization", static_cast<double>(lastHour->utilization)),
+            kvp("error_rate", static_cast<double>(lastHour->errorRate)),
+            kvp("cost_efficiency", static_cast<double>(lastHour->costEfficiency)),
+            kvp("time_efficiency", static_cast<double>(lastHour->timeEfficiency)),
+            kvp("battery_usage", static_cast<double>(lastHour->batteryUsage)),
+            kvp("water_usage", static_cast<double>(lastHour->waterUsage))
+        )));
+    }
+
     try {
         // Upsert document by robot name
         analyticsCollection.replace_one(
-            make_document(kvp("name", robot->getName())),
-            make_document(
-                kvp("name", robot->getName()),
-                kvp("error_count", robot->getErrorCount()),
-                kvp("total_work_time", robot->getTotalWorkTime())
-            ),
+            make_document(kvp("name", robot.getName())),
+            doc.view(),
             mongocxx::options::replace{}.upsert(true)
         );
     } catch (const mongocxx::exception& e) {
+        errors.inc();
         std::cerr << "Error saving robot analytics to MongoDB: " << e.what() << std::endl;
     }
 }
@@ -487,3 +660,305 @@ std::vector<std::tuple<std::string,int,double>> MongoDBAdapter::retrieveRobotAna
 
     return result;
 }
+
+void MongoDBAdapter::writeTelemetry(const TelemetryBatch& batch) {
+    static Histogram& latency = writeLatency("telemetry");
+    static Counter& errors = writeErrors("telemetry");
+    std::lock_guard<std::mutex> lock(mutex_);
+    Histogram::Timer timer(latency);
+    auto telemetryCollection = db_["robot_telemetry"];
+
+    try {
+        if (!batch.appends.empty()) {
+            // Each append targets its own bucket document, so the server may apply them in any order
+            mongocxx::options::bulk_write options;
+            options.ordered(false);
+            auto bulk = telemetryCollection.create_bulk_write(options);
+            for (const auto& bucket : batch.appends) {
+                const TelemetrySeries& points = bucket.samples;
+                auto each = [](const auto& values) {
+                    return make_document(kvp("$each", [&values](sub_array array) {
+                        for (const auto& value : values) array.append(value);
+                    }));
+                };
+                std::vector<int32_t> states(points.state.begin(), points.state.end());
+                mongocxx::model::update_one op{
+                    make_document(
+                        kvp("robot", bucket.robot),
+                        kvp("resolution", bucket.resolution),
+                        kvp("start", bucket.start)
+                    ),
+                    make_document(
+                        kvp("$setOnInsert", make_document(kvp("end", bucket.start + bucket.length))),
+                        kvp("$inc", make_document(kvp("count", static_cast<int32_t>(points.size())))),
+                        kvp("$push", make_document(
+                            kvp("t", each(points.time)),
+                            kvp("battery", each(points.battery)),
+                            kvp("water", each(points.water)),
+                            kvp("room", each(points.roomId)),
+                            kvp("state", each(states))
+                        ))
+                    )
+                };
+                op.upsert(true);
+                bulk.append(op);
+            }
+            bulk.execute();
+        }
+        // Downsampled copies already exist, so expired buckets are simply dropped
+        for (const auto& [resolution, before] : batch.expireBefore) {
+            telemetryCollection.delete_many(make_document(
+                kvp("resolution", resolution),
+                kvp("end", make_document(kvp("$lte", before)))
+            ));
+        }
+    } catch (const mongocxx::exception& e) {
+        errors.inc();
+        std::cerr << "Error writing telemetry to MongoDB: " << e.what() << std::endl;
+    }
+}
+
+TelemetrySeries MongoDBAdapter::retrieveTelemetry(const std::string& robotName, int resolution, double from, double to) {
+    TelemetrySeries series;
+    auto telemetryCollection = db_["robot_telemetry"];
+
+    try {
+        mongocxx::options::find options;
+        options.sort(make_document(kvp("start", 1)));
+        auto cursor = telemetryCollection.find(
+            make_document(
+                kvp("robot", robotName),
+                kvp("resolution", resolution),
+                kvp("start", make_document(kvp("$lt", to))),
+                kvp("end", make_document(kvp("$gt", from)))
+            ),
+            options
+        );
+        for (auto&& doc : cursor) {
+            TelemetrySeries bucket;
+            auto times = doc["t"].get_array().value;
+            auto battery = doc["battery"].get_array().value;
+            auto water = doc["water"].get_array().value;
+            auto rooms = doc["room"].get_array().value;
+            auto states = doc["state"].get_array().value;
+            auto b = battery.begin(), w = water.begin(), r = rooms.begin(), s = states.begin();
+            for (auto t = times.begin(); t != times.end() && b != battery.end() && w != water.end() &&
+                                         r != rooms.end() && s != states.end(); ++t, ++b, ++w, ++r, ++s) {
+                TelemetrySample sample;
+                sample.time = t->get_double().value;
+                sample.battery = static_cast<float>(b->get_double().value);
+                sample.water = static_cast<float>(w->get_double().value);
+                sample.roomId = r->get_int32().value;
+                sample.state = static_cast<uint8_t>(s->get_int32().value);
+                bucket.append(sample);
+            }
+            series.appendRange(bucket, from, to);
+        }
+    } catch (const mongocxx::exception& e) {
+        std::cerr << "Error retrieving telemetry from MongoDB: " << e.what() << std::endl;
+    }
+
+    return series;
+}
+
+void MongoDBAdapter::saveCheckpoint(const SimulationCheckpoint& checkpoint) {
+    static Histogram& latency = writeLatency("checkpoint");
+    static Counter& errors = writeErrors("checkpoint");
+    using bsoncxx::builder::basic::array;
+
+    // Documents are capped at 16MB, so robots, tasks and rooms are split over
+    // chunk documents. Each save writes a new generation of chunks, then points
+    // the header at it; a crash in between leaves the previous generation whole.
+    const size_t chunkCount = std::max<size_t>(1, (std::max({checkpoint.robots.size(), checkpoint.tasks.size(),
+                                                             checkpoint.rooms.size()}) + kCheckpointChunkSize - 1) /
+                                                      kCheckpointChunkSize);
+    int64_t generation = std::max(checkpointGeneration_ + 1, static_cast<int64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count()));
+
+    // Built before taking the lock; with a large fleet this is the slow part
+    std::vector<bsoncxx::document::value> chunks;
+    chunks.reserve(chunkCount);
+    for (size_t c = 0; c < chunkCount; ++c) {
+        size_t first = c * kCheckpointChunkSize;
+        array robots;
+        for (size_t i = first; i < std::min(first + kCheckpointChunkSize, checkpoint.robots.size()); ++i) {
+            const auto& robot = checkpoint.robots[i];
+            robots.append(make_document(
+                kvp("name", robot.name),
+                kvp("size", robot.size),
+                kvp("strategy", robot.strategy),
+                kvp("battery_level", robot.batteryLevel),
+                kvp("water_level", robot.waterLevel),
+                kvp("room", robot.roomId),
+                kvp("is_charging", robot.charging),
+                kvp("failed", robot.failed),
+                kvp("error_count", robot.errorCount),
+                kvp("total_work_time", robot.totalWorkTime),
+                kvp("low_battery_alert_sent", robot.lowBatteryAlertSent),
+                kvp("low_water_alert_sent", robot.lowWaterAlertSent),
+                kvp("current_task", robot.currentTaskId),
+                kvp("saved_task", robot.savedTaskId),
+                kvp("saved_time_remaining", robot.savedCleaningTimeRemaining)
+            ));
+        }
+        array tasks;
+        for (size_t i = first; i < std::min(first + kCheckpointChunkSize, checkpoint.tasks.size()); ++i) {
+            const auto& task = checkpoint.tasks[i];
+            tasks.append(make_document(
+                kvp("id", task.id),
+                kvp("priority", task.priority),
+                kvp("clean_type", task.cleanType),
+                kvp("room", task.roomId),
+                kvp("robot", task.robot),
+                kvp("queued", task.queued)
+            ));
+        }
+        array roomIds;
+        array roomClean;
+        for (size_t i = first; i < std::min(first + kCheckpointChunkSize, checkpoint.rooms.size()); ++i) {
+            roomIds.append(checkpoint.rooms[i].roomId);
+            roomClean.append(checkpoint.rooms[i].clean);
+        }
+        chunks.push_back(make_document(
+            kvp("generation", generation),
+            kvp("index", static_cast<int32_t>(c)),
+            kvp("robots", robots.view()),
+            kvp("tasks", tasks.view()),
+            kvp("room_ids", roomIds.view()),
+            kvp("room_clean", roomClean.view())
+        ));
+    }
+    auto header = make_document(
+        kvp("_id", "header"),
+        kvp("generation", generation),
+        kvp("chunks", static_cast<int32_t>(chunkCount)),
+        kvp("version", checkpoint.version),
+        kvp("sim_time", checkpoint.simTime),
+        kvp("last_task_id", checkpoint.lastTaskId),
+        kvp("next_generated_task_id", checkpoint.nextGeneratedTaskId)
+    );
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Histogram::Timer timer(latency);
+    auto checkpoints = db_["checkpoints"];
+    try {
+        mongocxx::options::insert insertOptions;
+        insertOptions.ordered(false);
+        std::vector<bsoncxx::document::view> views(chunks.begin(), chunks.end());
+        checkpoints.insert_many(views, insertOptions);
+
+        mongocxx::options::replace replaceOptions;
+        replaceOptions.upsert(true);
+        checkpoints.replace_one(make_document(kvp("_id", "header")), header.view(), replaceOptions);
+        checkpointGeneration_ = generation;
+
+        checkpoints.delete_many(make_document(
+            kvp("_id", make_document(kvp("$ne", "header"))),
+            kvp("generation", make_document(kvp("$ne", generation)))
+        ));
+    } catch (const mongocxx::exception& e) {
+        errors.inc();
+        std::cerr << "Error saving checkpoint to MongoDB: " << e.what() << std::endl;
+    }
+}
+
+std::optional<SimulationCheckpoint> MongoDBAdapter::loadCheckpoint() {
+    try {
+        // Header and chunks in one query; chunks of an unfinished save are skipped below
+        std::optional<bsoncxx::document::value> header;
+        std::vector<bsoncxx::document::value> chunks;
+        for (auto&& doc : db_["checkpoints"].find({})) {
+            if (doc["_id"].type() == bsoncxx::type::k_string) {
+                header = bsoncxx::document::value(doc);
+            } else {
+                chunks.emplace_back(doc);
+            }
+        }
+        if (!header) return std::nullopt;
+
+        auto head = header->view();
+        SimulationCheckpoint checkpoint;
+        checkpoint.version = head["version"].get_int32().value;
+        if (checkpoint.version != SimulationCheckpoint::kVersion) {
+            std::cerr << "Ignoring checkpoint with unsupported version " << checkpoint.version << std::endl;
+            return std::nullopt;
+        }
+        int64_t generation = head["generation"].get_int64().value;
+        int32_t chunkCount = head["chunks"].get_int32().value;
+        checkpoint.simTime = head["sim_time"].get_double().value;
+        checkpoint.lastTaskId = head["last_task_id"].get_int32().value;
+        if (auto next = head["next_generated_task_id"]) {
+            checkpoint.nextGeneratedTaskId = next.get_int32().value;
+        }
+
+        std::vector<bsoncxx::document::view> ordered(chunkCount);
+        int32_t found = 0;
+        for (const auto& chunk : chunks) {
+            auto view = chunk.view();
+            if (view["generation"].get_int64().value != generation) continue;
+            int32_t index = view["index"].get_int32().value;
+            if (index < 0 || index >= chunkCount || !ordered[index].empty()) continue;
+            ordered[index] = view;
+            ++found;
+        }
+        if (found != chunkCount) {
+            std::cerr << "Ignoring incomplete checkpoint: " << found << " of " << chunkCount << " chunks" << std::endl;
+            return std::nullopt;
+        }
+
+        for (const auto& chunk : ordered) {
+            for (auto&& element : chunk["robots"].get_array().value) {
+                auto robot = element.get_document().value;
+                SimulationCheckpoint::RobotState state;
+                state.name = robot["name"].get_string().value.to_string();
+                state.size = robot["size"].get_int32().value;
+                state.strategy = robot["strategy"].get_int32().value;
+                state.batteryLevel = robot["battery_level"].get_double().value;
+                state.waterLevel = robot["water_level"].get_double().value;
+                state.roomId = robot["room"].get_int32().value;
+                state.charging = robot["is_charging"].get_bool().value;
+                state.failed = robot["failed"].get_bool().value;
+                state.errorCount = robot["error_count"].get_int32().value;
+                state.totalWorkTime = robot["total_work_time"].get_double().value;
+                state.lowBatteryAlertSent = robot["low_battery_alert_sent"].get_bool().value;
+                state.lowWaterAlertSent = robot["low_water_alert_sent"].get_bool().value;
+                state.currentTaskId = robot["current_task"].get_int32().value;
+                state.savedTaskId = robot["saved_task"].get_int32().value;
+                state.savedCleaningTimeRemaining = robot["saved_time_remaining"].get_double().value;
+                checkpoint.robots.push_back(std::move(state));
+            }
+            for (auto&& element : chunk["tasks"].get_array().value) {
+                auto task = element.get_document().value;
+                SimulationCheckpoint::TaskState state;
+                state.id = task["id"].get_int32().value;
+                state.priority = task["priority"].get_int32().value;
+                state.cleanType = task["clean_type"].get_int32().value;
+                state.roomId = task["room"].get_int32().value;
+                state.robot = task["robot"].get_string().value.to_string();
+                state.queued = task["queued"].get_bool().value;
+                checkpoint.tasks.push_back(std::move(state));
+            }
+            auto roomIds = chunk["room_ids"].get_array().value;
+            auto roomClean = chunk["room_clean"].get_array().value;
+            auto clean = roomClean.begin();
+            for (auto id = roomIds.begin(); id != roomIds.end() && clean != roomClean.end(); ++id, ++clean) {
+                checkpoint.rooms.push_back(SimulationCheckpoint::RoomState{id->get_int32().value, clean->get_bool().value});
+            }
+        }
+        checkpointGeneration_ = generation;
+        return checkpoint;
+    } catch (const std::exception& e) {
+        // A checkpoint that cannot be read means a cold start, not a failed one
+        std::cerr << "Error loading checkpoint from MongoDB: " << e.what() << std::endl;
+        return std::nullopt;
+    }
+}
+
+void MongoDBAdapter::dropCheckpoint() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    try {
+        db_["checkpoints"].drop();
+    } catch (const mongocxx::exception& e) {
+        std::cerr << "Error dropping checkpoint collection from MongoDB: " << e.what() << std::endl;
+    }
+}
@@ -0,0 +1,103 @@
+#include "QuadTree/QuadTree.h"
+#include <algorithm>
+
+QuadTree::QuadTree(std::vector<Item> items) : items_(std::move(items)) {
+    if (items_.empty()) return;
+
+    Box box{items_[0].x, items_[0].y, items_[0].x, items_[0].y};
+    for (const auto& item : items_) {
+        box.minX = std::min(box.minX, item.x);
+        box.minY = std::min(box.minY, item.y);
+        box.maxX = std::max(box.maxX, item.x);
+        box.maxY = std::max(box.maxY, item.y);
+    }
+    // Square cells split more evenly than long thin ones
+    double side = std::max(box.maxX - box.minX, box.maxY - box.minY);
+    box.maxX = box.minX + side;
+    box.maxY = box.minY + side;
+
+    nodes_.reserve(2 * items_.size() / kLeafSize + 1);
+    nodes_.push_back(Node{box, 0, items_.size()});
+    split(0, 0);
+}
+
+void QuadTree::split(size_t node, int depth) {
+    Node current = nodes_[node];
+    if (current.end - current.begin <= kLeafSize || depth >= kMaxDepth) return;
+
+    double midX = (current.bounds.minX + current.bounds.maxX) / 2;
+    double midY = (current.bounds.minY + current.bounds.maxY) / 2;
+    auto first = items_.begin() + current.begin;
+    auto last = items_.begin() + current.end;
+    auto west = std::partition(first, last, [midX](const Item& item) { return item.x < midX; });
+    auto northWest = std::partition(first, west, [midY](const Item& item) { return item.y < midY; });
+    auto northEast = std::partition(west, last, [midY](const Item& item) { return item.y < midY; });
+
+    const Box& b = current.bounds;
+    size_t cuts[5] = {current.begin, static_cast<size_t>(northWest - items_.begin()),
+                      static_cast<size_t>(west - items_.begin()), static_cast<size_t>(northEast - items_.begin()),
+                      current.end};
+    Box quadrants[4] = {{b.minX, b.minY, midX, midY}, {b.minX, midY, midX, b.maxY},
+                        {midX, b.minY, b.maxX, midY}, {midX, midY, b.maxX, b.maxY}};
+
+    int firstChild = static_cast<int>(nodes_.size());
+    nodes_[node].firstChild = firstChild;
+    for (int i = 0; i < 4; ++i) {
+        nodes_.push_back(Node{quadrants[i], cuts[i], cuts[i + 1]});
+    }
+    for (int i = 0; i < 4; ++i) {
+        split(firstChild + i, depth + 1);
+    }
+}
+
+QuadTree::Box QuadTree::bounds() const {
+    return nodes_.empty() ? Box{0, 0, 0, 0} : nodes_[0].bounds;
+}
+
+void QuadTree::query(const Box& area, std::vector<int>& out) const {
+    if (nodes_.empty()) return;
+    std::vector<size_t> stack{0};
+    while (!stack.empty()) {
+        const Node& node = nodes_[stack.back()];
+        stack.pop_back();
+        if (!area.intersects(node.bounds)) continue;
+
+        if (area.contains(node.bounds)) {
+            for (size_t i = node.begin; i < node.end; ++i) out.push_back(items_[i].id);
+        } else if (node.firstChild < 0) {
+            for (size_t i = node.begin; i < node.end; ++i) {
+                if (area.contains(items_[i].x, items_[i].y)) out.push_back(items_[i].id);
+            }
+        } else {
+            for (int c = 0; c < 4; ++c) stack.push_back(node.firstChild + c);
+        }
+    }
+}
+
+int QuadTree::nearest(double x, double y, double maxDistance) const {
+    if (nodes_.empty()) return -1;
+    Box area{x - maxDistance, y - maxDistance, x + maxDistance, y + maxDistance};
+    double best = maxDistance * maxDistance;
+    int bestId = -1;
+
+    std::vector<size_t> stack{0};
+    while (!stack.empty()) {
+        const Node& node = nodes_[stack.back()];
+        stack.pop_back();
+        if (!area.intersects(node.bounds)) continue;
+        if (node.firstChild >= 0) {
+            for (int c = 0; c < 4; ++c) stack.push_back(node.firstChild + c);
+            continue;
+        }
+        for (size_t i = node.begin; i < node.end; ++i) {
+            double dx = items_[i].x - x;
+            double dy = items_[i].y - y;
+            double d = dx * dx + dy * dy;
+            if (d <= best) {
+                best = d;
+                bestId = items_[i].id;
+            }
+        }
+    }
+    return bestId;
+}
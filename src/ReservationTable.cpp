@@ -0,0 +1,199 @@
+#include "ReservationTable/ReservationTable.h"
+#include "map/map.h"
+#include "Room/Room.h"
+#include <algorithm>
+#include <chrono>
+#include <queue>
+
+namespace {
+    // Extra slots of waiting the search may add on top of twice the shortest path
+    constexpr int kHorizonPadding = 32;
+}
+
+ReservationTable::ReservationTable(const Map& map, std::unordered_set<int> unlimitedRoomIds)
+    : map_(map), unlimitedRoomIds_(std::move(unlimitedRoomIds)), oldestSlot_(0) {
+    if (unlimitedRoomIds_.empty()) {
+        for (int id : map.getChargerRoomIds()) unlimitedRoomIds_.insert(id);
+    }
+}
+
+void ReservationTable::setRoomCapacity(int roomId, int capacity) {
+    capacity_[roomId] = capacity;
+}
+
+bool ReservationTable::roomFree(int roomId, long slot) const {
+    if (unlimitedRoomIds_.count(roomId)) return true;
+    auto it = vertexCount_.find(Key{roomId, roomId, slot});
+    if (it == vertexCount_.end()) return true;
+    auto cap = capacity_.find(roomId);
+    return it->second < (cap != capacity_.end() ? cap->second : 1);
+}
+
+bool ReservationTable::edgeFree(int from, int to, long slot) const {
+    return edgeCount_.find(Key{from, to, slot}) == edgeCount_.end();
+}
+
+std::vector<int> ReservationTable::planRoute(const Robot* owner, Room* from, Room* to, long startSlot,
+                                             int dwellSlots) {
+    auto begin = std::chrono::steady_clock::now();
+    auto finish = [&](std::vector<int> path) {
+        stats_.planningMicros += std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - begin).count();
+        return path;
+    };
+
+    release(owner);
+    stats_.plans++;
+    if (!from || !to) return finish({});
+
+    // True hop distance to the goal is an admissible heuristic
+    std::unordered_map<Room*, int> h;
+    std::queue<Room*> bfs;
+    h[to] = 0;
+    bfs.push(to);
+    while (!bfs.empty()) {
+        Room* current = bfs.front();
+        bfs.pop();
+        for (Room* neighbor : current->neighbors) {
+            if (h.count(neighbor) || map_.isVirtualWallBetween(current, neighbor)) continue;
+            h[neighbor] = h[current] + 1;
+            bfs.push(neighbor);
+        }
+    }
+    if (!h.count(from)) return finish({});
+
+    struct Node {
+        int f;
+        int g;
+        Room* room;
+        long slot;
+    };
+    auto worse = [](const Node& a, const Node& b) { return a.f != b.f ? a.f > b.f : a.g < b.g; };
+    std::priority_queue<Node, std::vector<Node>, decltype(worse)> open(worse);
+    std::unordered_map<Key, Key, KeyHash> parent;
+
+    int horizon = 2 * h[from] + kHorizonPadding;
+    Key startKey{from->getRoomId(), from->getRoomId(), startSlot};
+    parent[startKey] = startKey;
+    open.push(Node{h[from], 0, from, startSlot});
+
+    auto canHoldGoal = [&](long arrival) {
+        for (int d = 1; d <= dwellSlots; ++d) {
+            if (!roomFree(to->getRoomId(), arrival + d)) return false;
+        }
+        return true;
+    };
+
+    while (!open.empty()) {
+        Node node = open.top();
+        open.pop();
+        Key key{node.room->getRoomId(), node.room->getRoomId(), node.slot};
+
+        if (node.room == to && canHoldGoal(node.slot)) {
+            std::vector<int> path;
+            for (Key at = key;; at = parent[at]) {
+                path.push_back(at.from);
+                if (at == startKey) break;
+            }
+            std::reverse(path.begin(), path.end());
+            for (size_t i = 1; i < path.size(); ++i) {
+                if (path[i] == path[i - 1]) stats_.waitSlots++;
+            }
+            reserve(owner, path, startSlot, dwellSlots);
+            return finish(path);
+        }
+        if (node.g >= horizon) continue;
+
+        auto tryPush = [&](Room* next) {
+            Key nextKey{next->getRoomId(), next->getRoomId(), node.slot + 1};
+            if (parent.count(nextKey)) return;
+            parent[nextKey] = key;
+            open.push(Node{node.g + 1 + h[next], node.g + 1, next, node.slot + 1});
+        };
+
+        // Wait in place
+        if (roomFree(key.from, node.slot + 1)) {
+            tryPush(node.room);
+        }
+        for (Room* neighbor : node.room->neighbors) {
+            if (!h.count(neighbor) || map_.isVirtualWallBetween(node.room, neighbor)) continue;
+            int nid = neighbor->getRoomId();
+            // Reject moves into a full room and head-on swaps with another robot
+            if (!roomFree(nid, node.slot + 1) || !edgeFree(nid, key.from, node.slot)) continue;
+            tryPush(neighbor);
+        }
+    }
+
+    // Nothing fits inside the horizon: take the plain shortest route and
+    // still reserve it so later plans see this robot
+    stats_.fallbacks++;
+    std::vector<int> path = map_.getRoute(*from, *to);
+    reserve(owner, path, startSlot, dwellSlots);
+    return finish(path);
+}
+
+void ReservationTable::reserve(const Robot* owner, const std::vector<int>& path, long startSlot, int dwellSlots) {
+    if (path.empty()) return;
+    auto& vertices = ownerVertices_[owner];
+    auto& edges = ownerEdges_[owner];
+
+    auto reserveRoom = [&](int roomId, long slot) {
+        if (unlimitedRoomIds_.count(roomId)) return;
+        Key key{roomId, roomId, slot};
+        vertexCount_[key]++;
+        vertices.push_back(key);
+    };
+
+    for (size_t i = 0; i < path.size(); ++i) {
+        long slot = startSlot + static_cast<long>(i);
+        reserveRoom(path[i], slot);
+        if (i + 1 < path.size() && path[i] != path[i + 1]) {
+            Key key{path[i], path[i + 1], slot};
+            edgeCount_[key]++;
+            edges.push_back(key);
+        }
+    }
+    long arrival = startSlot + static_cast<long>(path.size()) - 1;
+    for (int d = 1; d <= dwellSlots; ++d) {
+        reserveRoom(path.back(), arrival + d);
+    }
+}
+
+void ReservationTable::release(const Robot* owner) {
+    auto dropAll = [](std::unordered_map<Key, int, KeyHash>& counts, std::vector<Key>& keys) {
+        for (const auto& key : keys) {
+            auto it = counts.find(key);
+            if (it != counts.end() && --it->second <= 0) counts.erase(it);
+        }
+        keys.clear();
+    };
+
+    auto v = ownerVertices_.find(owner);
+    if (v != ownerVertices_.end()) {
+        dropAll(vertexCount_, v->second);
+        ownerVertices_.erase(v);
+    }
+    auto e = ownerEdges_.find(owner);
+    if (e != ownerEdges_.end()) {
+        dropAll(edgeCount_, e->second);
+        ownerEdges_.erase(e);
+    }
+}
+
+void ReservationTable::advanceTo(long slot) {
+    if (slot <= oldestSlot_) return;
+    oldestSlot_ = slot;
+
+    auto prune = [slot](std::unordered_map<Key, int, KeyHash>& counts, std::vector<Key>& keys) {
+        auto expired = std::remove_if(keys.begin(), keys.end(), [&](const Key& key) {
+            if (key.slot >= slot) return false;
+            auto it = counts.find(key);
+            if (it != counts.end() && --it->second <= 0) counts.erase(it);
+            return true;
+        });
+        keys.erase(expired, keys.end());
+    };
+
+    for (auto& entry : ownerVertices_) prune(vertexCount_, entry.second);
+    for (auto& entry : ownerEdges_) prune(edgeCount_, entry.second);
+}
@@ -3,8 +3,10 @@
 #include "Room/Room.h"
 #include "map/map.h"
 #include "TaskScheduler/TaskScheduler.h"
+#include "EnergyModel/EnergyModel.h"
+#include "Log/DebugLog.h"
 #include <algorithm>
-#include <iostream>
+#include <functional>
 
 Robot::Robot(const std::string& name, double batteryLevel, Size size, Strategy strategy, double waterLevel)
     : name_(name), batteryLevel_(batteryLevel), waterLevel_(waterLevel),
@@ -13,26 +15,27 @@ Robot::Robot(const std::string& name, double batteryLevel, Size size, Strategy s
       targetRoom_(nullptr), lowBatteryAlertSent_(false), lowWaterAlertSent_(false),
       currentTask_(nullptr), savedTask_(nullptr), savedCleaningTimeRemaining_(0.0),
       size_(size), strategy_(strategy), robotMap_(nullptr),
-      errorCount_(0), totalWorkTime_(0.0), failed_(false) {}
+      errorCount_(0), totalWorkTime_(0.0), failed_(false),
+      hopsTowardTask_(0), preemptiveAborts_(0), midTaskAborts_(0), wastedTravelHops_(0),
+      rng_(static_cast<std::minstd_rand::result_type>(std::hash<std::string>{}(name))) {}
 
-void Robot::updateState(double deltaTime) {
-    std::cout << "[DEBUG] Robot " << name_ << " updateState: Battery=" << batteryLevel_
+void Robot::updateState(double deltaTime, bool requestTask) {
+    DebugLog::out() << "[DEBUG] Robot " << name_ << " updateState: Battery=" << batteryLevel_
               << "%, Water=" << waterLevel_ << "%, CurrentTask=" 
               << (currentTask_ ? std::to_string(currentTask_->getID()) : "None")
               << ", Status=" << getStatus() << "\n";
 
     if (failed_) {
-        std::cout << "[DEBUG] Robot " << name_ << " is failed, no operation.\n";
+        DebugLog::out() << "[DEBUG] Robot " << name_ << " is failed, no operation.\n";
         return;
     }
 
     if (cleaning_) {
-        double failChance = 0.01;
-        double rnd = (double)rand() / RAND_MAX;
-        if (rnd < failChance && !failed_) {
+        std::bernoulli_distribution failChance(0.01);
+        if (failChance(rng_) && !failed_) {
             failed_ = true;
             errorCount_++;
-            std::cout << "[DEBUG] Robot " << name_ << " failed during cleaning!\n";
+            DebugLog::out() << "[DEBUG] Robot " << name_ << " failed during cleaning!\n";
             return;
         }
     }
@@ -48,7 +51,7 @@ void Robot::updateState(double deltaTime) {
     }
 
     if (isCharging_) {
-        batteryLevel_ = std::min(100.0, batteryLevel_ + deltaTime * 20.0);
+        batteryLevel_ = std::min(100.0, batteryLevel_ + deltaTime * kChargeRatePerSecond);
         if (batteryLevel_ >= 100.0) {
             isCharging_ = false;
             if (waterLevel_ < 100.0) {
@@ -58,15 +61,16 @@ void Robot::updateState(double deltaTime) {
         }
     } else {
         if (cleaning_ && currentTask_) {
-            double batteryDepletion = 5.0 * deltaTime;
+            double batteryDepletion = kCleaningBatteryDrainPerSecond * deltaTime;
             batteryLevel_ = std::max(0.0, batteryLevel_ - batteryDepletion);
             if (currentTask_->getCleanType() == CleaningTask::SHAMPOO) {
-                double waterDepletion = 5.0 * deltaTime;
+                double waterDepletion = kShampooWaterDrainPerSecond * deltaTime;
                 waterLevel_ = std::max(0.0, waterLevel_ - waterDepletion);
             }
 
             if ((needsCharging() || needsWaterRefill()) && cleaning_) {
-                std::cout << "[DEBUG] Robot " << name_ << " resources low mid-cleaning, saving task.\n";
+                DebugLog::out() << "[DEBUG] Robot " << name_ << " resources low mid-cleaning, saving task.\n";
+                recordMidTaskAbort();
                 saveCurrentTask();
                 stopCleaning();
             }
@@ -79,6 +83,7 @@ void Robot::updateState(double deltaTime) {
             currentRoom_ = nextRoom_;
             nextRoom_ = nullptr;
             movementProgress_ = 0.0;
+            if (currentTask_) hopsTowardTask_++;
 
             if (!movementQueue_.empty()) {
                 nextRoom_ = movementQueue_.front();
@@ -94,14 +99,14 @@ void Robot::updateState(double deltaTime) {
     if (cleaning_ && currentTask_) {
         cleaningTimeRemaining_ -= deltaTime;
         if (cleaningTimeRemaining_ <= 0) {
-            std::cout << "[DEBUG] Robot " << name_ << " finished cleaning task " << currentTask_->getID() << ".\n";
+            DebugLog::out() << "[DEBUG] Robot " << name_ << " finished cleaning task " << currentTask_->getID() << ".\n";
             cleaning_ = false;
             currentTask_->markCompleted();
             currentTask_.reset();
             cleaningProgress_ = 0.0;
             if (currentRoom_) {
                 currentRoom_->markClean();
-                std::cout << "[DEBUG] Room " << currentRoom_->getRoomName() << " is now clean.\n";
+                DebugLog::out() << "[DEBUG] Room " << currentRoom_->getRoomName() << " is now clean.\n";
             }
         }
     }
@@ -113,26 +118,30 @@ void Robot::updateState(double deltaTime) {
     //     lowWaterAlertSent_ = true;
     // }
 
-    if (currentRoom_ && currentRoom_->getRoomId() == 0 && batteryLevel_ < 100.0 && !isCharging_) {
-        std::cout << "[DEBUG] Robot " << name_ << " at charger, starting charge.\n";
+    bool atCharger = currentRoom_ && !isMoving() &&
+                     (robotMap_ ? robotMap_->isChargerRoom(currentRoom_->getRoomId())
+                                : currentRoom_->getRoomId() == 0);
+    if (atCharger && !waitingForCharger_ && batteryLevel_ < 100.0 && !isCharging_) {
+        DebugLog::out() << "[DEBUG] Robot " << name_ << " at charger, starting charge.\n";
         setCharging(true);
     }
 
     // Check if we can request a new task
-    if (!currentTask_ && canAcceptTask()) {
+    if (requestTask && !currentTask_ && canAcceptTask()) {
         requestNextTask();
     }
 }
 
 void Robot::startCleaning(CleaningTask::CleanType cleaningType) {
-    std::cout << "[DEBUG] Robot " << name_ << " attempting to start cleaning.\n";
+    DebugLog::out() << "[DEBUG] Robot " << name_ << " attempting to start cleaning.\n";
     if (isCleaning() || !currentRoom_ || !currentTask_) {
-        std::cout << "[DEBUG] Robot " << name_ << " cannot start cleaning now.\n";
+        DebugLog::out() << "[DEBUG] Robot " << name_ << " cannot start cleaning now.\n";
         return;
     }
     if (batteryLevel_ < 20.0 || waterLevel_ <= 0.0) {
-        std::cout << "[DEBUG] Robot " << name_ << " not enough resources to start cleaning.\n";
-        saveCurrentTask();
+        DebugLog::out() << "[DEBUG] Robot " << name_ << " not enough resources to start cleaning.\n";
+        recordMidTaskAbort();
+        giveBackCurrentTask();
         return;
     }
     cleaning_ = true;
@@ -140,25 +149,25 @@ void Robot::startCleaning(CleaningTask::CleanType cleaningType) {
         currentTask_->setStatus("In Progress");
     }
 
-    double baseTime = 15.0;
-    std::string size = currentRoom_->getSize();
-    std::transform(size.begin(), size.end(), size.begin(), ::tolower);
-
-    if (size == "small") baseTime = 5.0;
-    else if (size == "medium") baseTime = 10.0;
-    else if (size == "large") baseTime = 15.0;
-
-    cleaningTimeRemaining_ = baseTime;
+    cleaningTimeRemaining_ = cleaningTimeForRoom(*currentRoom_);
     if (savedTask_ && savedTask_ == currentTask_) {
         cleaningTimeRemaining_ = savedCleaningTimeRemaining_;
         savedTask_.reset();
         savedCleaningTimeRemaining_ = 0.0;
     }
 
-    std::cout << "[DEBUG] Robot " << name_ << " started cleaning task " 
+    DebugLog::out() << "[DEBUG] Robot " << name_ << " started cleaning task " 
               << currentTask_->getID() << " now In Progress.\n";
 }
 
+double Robot::cleaningTimeForRoom(const Room& room) {
+    switch (room.getRoomSize()) {
+        case RoomSize::SMALL: return 5.0;
+        case RoomSize::MEDIUM: return 10.0;
+        default: return 15.0;
+    }
+}
+
 void Robot::stopCleaning() {
     if (cleaning_) {
         cleaning_ = false;
@@ -205,6 +214,24 @@ void Robot::setTargetRoom(Room* room) {
     targetRoom_ = room;
 }
 
+std::vector<Room*> Robot::getRemainingPath() const {
+    std::vector<Room*> path;
+    if (!nextRoom_) return path;
+    path.push_back(nextRoom_);
+    std::queue<Room*> rest = movementQueue_;
+    while (!rest.empty()) {
+        path.push_back(rest.front());
+        rest.pop();
+    }
+    return path;
+}
+
+void Robot::abandonHop() {
+    nextRoom_ = nullptr;
+    movementProgress_ = 0.0;
+    while (!movementQueue_.empty()) movementQueue_.pop();
+}
+
 double Robot::getBatteryLevel() const { return batteryLevel_; }
 double Robot::getWaterLevel() const { return waterLevel_; }
 bool Robot::needsCharging() const { return batteryLevel_ < 20.0; }
@@ -223,7 +250,7 @@ void Robot::setCharging(bool charging) {
 void Robot::refillWater() { 
     waterLevel_ = 100.0; 
     lowWaterAlertSent_ = false; 
-    std::cout << "Robot " << name_ << " water refilled at charger.\n";
+    DebugLog::out() << "Robot " << name_ << " water refilled at charger.\n";
 }
 void Robot::fullyRecharge() { 
     batteryLevel_ = 100.0;
@@ -252,10 +279,28 @@ bool Robot::requestNextTask() {
         return false;
     }
 
-    auto task = scheduler.dequeueTask();
+    // Leave the task queued for another robot rather than start a clean we would abort,
+    // and go charge so this robot can take it next time
+    int declinedId = -1;
+    auto task = scheduler.dequeueTaskIf([this, &declinedId](const CleaningTask& next) {
+        if (next.getRoom() && !EnergyModel::fitsCleaning(batteryLevel_, waterLevel_, *next.getRoom(),
+                                                         next.getCleanType())) {
+            declinedId = next.getID();
+            return false;
+        }
+        return true;
+    });
     if (!task) {
+        if (declinedId >= 0 && declinedId != declinedTaskId_) {
+            DebugLog::out() << "[DEBUG] Robot " << name_ << " declined task " << declinedId
+                      << ": predicted to run out of resources.\n";
+            declinedTaskId_ = declinedId;
+            recordPreemptiveAbort();
+        }
+        if (declinedId >= 0) chargeRequested_ = true;
         return false;
     }
+    declinedTaskId_ = -1;
 
     setCurrentTask(task);
     if (task->getRoom() != getCurrentRoom()) {
@@ -278,6 +323,7 @@ void Robot::setLowBatteryAlertSent(bool val) { lowBatteryAlertSent_ = val; }
 void Robot::setLowWaterAlertSent(bool val) { lowWaterAlertSent_ = val; }
 
 void Robot::setCurrentTask(std::shared_ptr<CleaningTask> task) {
+    if (task != currentTask_) hopsTowardTask_ = 0;
     currentTask_ = task;
     if (task) {
         targetRoom_ = task->getRoom();
@@ -288,27 +334,29 @@ std::shared_ptr<CleaningTask> Robot::getCurrentTask() const {
     return currentTask_;
 }
 
-void Robot::saveCurrentTask() {
+bool Robot::saveCurrentTask() {
     if (cleaning_ && currentTask_) {
         savedTask_ = currentTask_;
         savedCleaningTimeRemaining_ = cleaningTimeRemaining_;
-        std::cout << "Robot " << name_ << " saved current partial task.\n";
+        DebugLog::out() << "Robot " << name_ << " saved current partial task.\n";
+        return true;
     }
+    return false;
 }
 
 bool Robot::resumeSavedTask() {
     if (savedTask_) {
         Room* savedRoom = savedTask_->getRoom();
         if (savedRoom && savedRoom != currentRoom_) {
-            std::cout << "Robot " << name_ << " attempting to return to saved task room.\n";
+            DebugLog::out() << "Robot " << name_ << " attempting to return to saved task room.\n";
             if (!robotMap_) {
-                std::cout << "Robot " << name_ << ": No map reference available to resume task.\n";
+                DebugLog::out() << "Robot " << name_ << ": No map reference available to resume task.\n";
                 return false;
             }
             // Compute route
             auto route = robotMap_->getRoute(*currentRoom_, *savedRoom);
             if (route.empty()) {
-                std::cout << "Robot " << name_ << ": No path to saved task room.\n";
+                DebugLog::out() << "Robot " << name_ << ": No path to saved task room.\n";
                 return false;
             }
             // Set movement path
@@ -327,13 +375,41 @@ bool Robot::resumeSavedTask() {
             cleaningTimeRemaining_ = savedCleaningTimeRemaining_;
             savedTask_.reset();
             savedCleaningTimeRemaining_ = 0.0;
-            std::cout << "Robot " << name_ << " resumed previously saved task.\n";
+            DebugLog::out() << "Robot " << name_ << " resumed previously saved task.\n";
             return true;
         }
     }
     return false;
 }
 
+void Robot::recordMidTaskAbort() {
+    midTaskAborts_++;
+    wastedTravelHops_ += hopsTowardTask_;
+    hopsTowardTask_ = 0;
+}
+
+void Robot::giveBackCurrentTask() {
+    auto task = std::move(currentTask_);
+    targetRoom_ = nullptr;
+    if (savedTask_ == task) {
+        savedTask_.reset();
+        savedCleaningTimeRemaining_ = 0.0;
+    }
+    task->setStatus("Pending");
+    // Tasks this robot took from the shared queue go straight back; assigned ones
+    // belong to a Scheduler, which the simulator requeues them on
+    if (task->getRobot()) {
+        returnedTask_ = std::move(task);
+    } else {
+        TaskScheduler::getInstance().enqueueTask(std::move(task));
+    }
+}
+
+void Robot::restoreSavedTask(std::shared_ptr<CleaningTask> task, double cleaningTimeRemaining) {
+    savedTask_ = task;
+    savedCleaningTimeRemaining_ = task ? cleaningTimeRemaining : 0.0;
+}
+
 void Robot::repair() {
     failed_ = false;
 }
\ No newline at end of file
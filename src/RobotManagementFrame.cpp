@@ -2,15 +2,30 @@
 #include "LoginDialog/LoginDialog.hpp"
 #include "AlertDialog/AlertDialog.hpp"
 #include "map_panel/map_panel.hpp"
+#include "robot_status_table/robot_status_table.hpp"
+#include "tick_profile_panel/tick_profile_panel.hpp"
 #include "config/ResourceConfig.hpp"
 #include <wx/notebook.h>
 #include <wx/grid.h>
 #include <iostream>
 #include <wx/filename.h>
+#include <cstdlib>
+#include <chrono>
+#include <optional>
 #include "AlertSystem/alert_system.h"
 #include "RobotSimulator/RobotSimulator.hpp"
 #include "map/map.h"
 #include "Scheduler/Scheduler.hpp"
+#include "ZonePartition/ZonePartition.h"
+#include "MapWatcher/MapWatcher.h"
+#include "DirtModel/DirtModel.h"
+#include "AutoTaskPlanner/AutoTaskPlanner.h"
+#include "RobotMetrics/MetricsAggregator.h"
+#include "Telemetry/TelemetryWriter.h"
+#include "Checkpoint/SimulationCheckpoint.h"
+#include "SimulationThread/SimulationThread.h"
+#include "Metrics/MetricsRegistry.h"
+#include "Metrics/MetricsServer.h"
 #include "robot_control/robot_control_panel.hpp"
 #include "scheduler_panel/scheduler_panel.hpp"
 #include "user/user.h"
@@ -25,6 +40,9 @@ const std::string RobotManagementFrame::DB_NAME = "mydb9";
 
 RobotManagementFrame::RobotManagementFrame(const wxString& title)
     : wxFrame(nullptr, wxID_ANY, title, wxDefaultPosition, wxSize(1024, 768)),
+      robotGrid(nullptr),
+      robotStatusTable_(nullptr),
+      tickProfilePanel_(nullptr),
       robotControlPanel(nullptr),
       schedulerPanel_(nullptr),
       mapPanel_(nullptr),
@@ -54,6 +72,17 @@ RobotManagementFrame::RobotManagementFrame(const wxString& title)
 
         // Create map
         auto map = std::make_shared<Map>(true); 
+
+        // Warm restart from the last checkpoint; ROBOT_COLD_START=1 starts from an empty database instead
+        auto restoreStarted = std::chrono::steady_clock::now();
+        std::optional<SimulationCheckpoint> checkpoint;
+        const char* coldStart = std::getenv("ROBOT_COLD_START");
+        if (!coldStart || std::string(coldStart) == "0") {
+            checkpoint = dbAdapter->loadCheckpoint();
+        }
+        if (!checkpoint) {
+            dbAdapter->clearCollections();
+        }
         dbAdapter->initializeRooms(map->getRooms());
 
         // Create alert system
@@ -65,24 +94,26 @@ RobotManagementFrame::RobotManagementFrame(const wxString& title)
         auto addPredefinedRobot = [&](const std::string& name,
                                     Robot::Size size,
                                     Robot::Strategy strategy) {
-            Room* charger = map->getRoomById(0);
+            Room* charger = map->getRoomById(map->getChargers().front().roomId);
             auto newRobot = std::make_shared<Robot>(name, 100.0, size, strategy, 100.0);
             if (charger) newRobot->setCurrentRoom(charger);
             newRobot->setMap(map.get());
             simulator_->getRobots().push_back(newRobot);
         };
 
-        addPredefinedRobot("Robot_Large_Vacuum", Robot::Size::LARGE, Robot::Strategy::VACUUM);
-        addPredefinedRobot("Robot_Large_Scrub", Robot::Size::LARGE, Robot::Strategy::SCRUB);
-        addPredefinedRobot("Robot_Large_Shampoo", Robot::Size::LARGE, Robot::Strategy::SHAMPOO);
+        if (!checkpoint) {
+            addPredefinedRobot("Robot_Large_Vacuum", Robot::Size::LARGE, Robot::Strategy::VACUUM);
+            addPredefinedRobot("Robot_Large_Scrub", Robot::Size::LARGE, Robot::Strategy::SCRUB);
+            addPredefinedRobot("Robot_Large_Shampoo", Robot::Size::LARGE, Robot::Strategy::SHAMPOO);
 
-        addPredefinedRobot("Robot_Medium_Vacuum", Robot::Size::MEDIUM, Robot::Strategy::VACUUM);
-        addPredefinedRobot("Robot_Medium_Scrub", Robot::Size::MEDIUM, Robot::Strategy::SCRUB);
-        addPredefinedRobot("Robot_Medium_Shampoo", Robot::Size::MEDIUM, Robot::Strategy::SHAMPOO);
+            addPredefinedRobot("Robot_Medium_Vacuum", Robot::Size::MEDIUM, Robot::Strategy::VACUUM);
+            addPredefinedRobot("Robot_Medium_Scrub", Robot::Size::MEDIUM, Robot::Strategy::SCRUB);
+            addPredefinedRobot("Robot_Medium_Shampoo", Robot::Size::MEDIUM, Robot::Strategy::SHAMPOO);
 
-        addPredefinedRobot("Robot_Small_Vacuum", Robot::Size::SMALL, Robot::Strategy::VACUUM);
-        addPredefinedRobot("Robot_Small_Scrub", Robot::Size::SMALL, Robot::Strategy::SCRUB);
-        addPredefinedRobot("Robot_Small_Shampoo", Robot::Size::SMALL, Robot::Strategy::SHAMPOO);
+            addPredefinedRobot("Robot_Small_Vacuum", Robot::Size::SMALL, Robot::Strategy::VACUUM);
+            addPredefinedRobot("Robot_Small_Scrub", Robot::Size::SMALL, Robot::Strategy::SCRUB);
+            addPredefinedRobot("Robot_Small_Shampoo", Robot::Size::SMALL, Robot::Strategy::SHAMPOO);
+        }
         SetStatusText("Simulator initialized");
 
             // Create scheduler after we have robots in simulator
@@ -94,6 +125,43 @@ RobotManagementFrame::RobotManagementFrame(const wxString& title)
 
         // IMPORTANT: Set the simulator in the scheduler
         scheduler_->setSimulator(simulator_);
+        simulator_->setScheduler(scheduler_);
+
+        // Dirty rooms get tasks in the shared queue without going through the scheduler panel.
+        // It is attached before a restore so generated ids and rooms carry on from the checkpoint.
+        auto autoTaskPlanner = std::make_shared<AutoTaskPlanner>(map);
+        simulator_->setAutoTaskPlanner(autoTaskPlanner);
+
+        if (checkpoint) {
+            checkpoint->restore(*simulator_, *scheduler_);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - restoreStarted).count();
+            MetricsRegistry::global().gauge("robot_warm_restart_seconds",
+                                            "Time to load and restore the last checkpoint at startup").set(seconds);
+            std::cout << "[DEBUG] Warm restart: " << checkpoint->robots.size() << " robots and "
+                      << checkpoint->tasks.size() << " tasks restored in " << seconds << "s\n";
+            SetStatusText("Fleet restored from checkpoint");
+        }
+        simulator_->setZonePartition(std::make_shared<ZonePartition>(*map));
+
+        // Edits to map.json are picked up live and applied between ticks
+        auto mapWatcher = std::make_shared<MapWatcher>(config::ResourceConfig::getMapPath());
+        mapWatcher->start();
+        simulator_->setMapWatcher(mapWatcher);
+        simulator_->enableDirtModel(DirtModel::kDefaultDirtyThreshold);
+
+        autoTaskPlanner->notifyAllRooms();
+        autoTaskPlanner->start();
+        simulator_->setMetricsAggregator(std::make_shared<MetricsAggregator>());
+        auto telemetry = std::make_shared<TelemetryWriter>(dbAdapter);
+        telemetry->start();
+        simulator_->setTelemetryWriter(telemetry);
+        auto checkpointer = std::make_shared<Checkpointer>(dbAdapter);
+        checkpointer->start();
+        simulator_->setCheckpointer(checkpointer);
+
+        // From here on the simulator belongs to the simulation thread; panels read its snapshots
+        simulation_ = std::make_shared<SimulationThread>(simulator_, scheduler_);
+        simulation_->refresh();
         InitializeUsers();
         if (!ShowLogin()) {
             Close(true);
@@ -110,7 +178,7 @@ RobotManagementFrame::RobotManagementFrame(const wxString& title)
 
         if (currentUser->getRole()->hasPermission("Scheduler")) {
             // Pass alertSystem and dbAdapter as well
-            schedulerPanel_ = new SchedulerPanel(notebook, simulator_, scheduler_, alertSystem, dbAdapter);
+            schedulerPanel_ = new SchedulerPanel(notebook, simulation_, scheduler_, alertSystem, dbAdapter);
             notebook->AddPage(schedulerPanel_, "Scheduler");
         }
 
@@ -119,12 +187,12 @@ RobotManagementFrame::RobotManagementFrame(const wxString& title)
         }
 
         if (currentUser->getRole()->hasPermission("Map")) {
-            mapPanel_ = new MapPanel(notebook, simulator_);
+            mapPanel_ = new MapPanel(notebook, simulation_);
             notebook->AddPage(mapPanel_, "Map");
         }
 
         if (currentUser->getRole()->hasPermission("Robot Control")) {
-            robotControlPanel = new RobotControlPanel(notebook, simulator_, scheduler_);
+            robotControlPanel = new RobotControlPanel(notebook, simulation_, scheduler_);
             notebook->AddPage(robotControlPanel, "Robot Control");
         }
 
@@ -139,8 +207,24 @@ RobotManagementFrame::RobotManagementFrame(const wxString& title)
         alertCheckTimer = new wxTimer(this, ALERT_TIMER_ID);
         alertCheckTimer->Start(1000); 
 
+        // Polling a snapshot is cheap, so check often and redraw as soon as a tick lands
         statusUpdateTimer = new wxTimer(this, STATUS_TIMER_ID);
-        statusUpdateTimer->Start(1000);
+        statusUpdateTimer->Start(100);
+        simulation_->start();
+
+        // Scrape endpoint for the in-process metrics; ROBOT_METRICS_PORT moves it, 0 turns it off
+        const char* metricsPort = std::getenv("ROBOT_METRICS_PORT");
+        int port = metricsPort ? std::atoi(metricsPort) : MetricsServer::kDefaultPort;
+        if (port > 0 && port <= 65535) {
+            metricsServer_ = std::make_shared<MetricsServer>(MetricsRegistry::global(), static_cast<uint16_t>(port));
+            try {
+                metricsServer_->start();
+            } catch (const std::exception& e) {
+                // Metrics are optional; the app runs without them
+                std::cerr << e.what() << std::endl;
+                metricsServer_.reset();
+            }
+        }
 
         BindEvents();
 
@@ -163,6 +247,24 @@ RobotManagementFrame::RobotManagementFrame(const wxString& title)
 
 
 RobotManagementFrame::~RobotManagementFrame() {
+    // Stop ticking before the panels that commands report back to go away
+    if (simulation_) {
+        simulation_->stop();
+    }
+    if (simulator_ && simulator_->getTelemetryWriter()) {
+        // Writes out the samples queued since the last flush
+        simulator_->getTelemetryWriter()->stop();
+    }
+    if (simulator_ && simulator_->getCheckpointer()) {
+        // The simulation thread is done, so capture the final state here
+        simulator_->getCheckpointer()->stop();
+        if (dbAdapter) {
+            dbAdapter->saveCheckpoint(SimulationCheckpoint::capture(*simulator_, scheduler_.get()));
+        }
+    }
+    if (metricsServer_) {
+        metricsServer_->stop();
+    }
     if (statusUpdateTimer) {
         statusUpdateTimer->Stop();
         delete statusUpdateTimer;
@@ -260,14 +362,9 @@ void RobotManagementFrame::CreateDashboardPanel(wxNotebook* notebook) {
     wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
 
     robotGrid = new wxGrid(panel, wxID_ANY);
-    auto robotStatuses = simulator_->getRobotStatuses();
-    robotGrid->CreateGrid((int)robotStatuses.size(), 5);
-
-    robotGrid->SetColLabelValue(0, "Robot Name");
-    robotGrid->SetColLabelValue(1, "Battery Level");
-    robotGrid->SetColLabelValue(2, "Water Level");
-    robotGrid->SetColLabelValue(3, "Status");
-    robotGrid->SetColLabelValue(4, "Current Room");
+    robotStatusTable_ = new RobotStatusTable(simulation_);
+    robotGrid->SetTable(robotStatusTable_, true);
+    robotGrid->EnableEditing(false);
 
     robotGrid->SetColSize(0, 100);
     robotGrid->SetColSize(1, 100);
@@ -282,6 +379,9 @@ void RobotManagementFrame::CreateDashboardPanel(wxNotebook* notebook) {
     refreshBtn->Bind(wxEVT_BUTTON, &RobotManagementFrame::OnRefreshStatus, this);
     sizer->Add(refreshBtn, 0, wxALL, 5);
 
+    tickProfilePanel_ = new TickProfilePanel(panel, simulation_);
+    sizer->Add(tickProfilePanel_, 0, wxEXPAND | wxALL, 5);
+
     panel->SetSizer(sizer);
     notebook->AddPage(panel, "Dashboard");
 }
@@ -289,65 +389,8 @@ void RobotManagementFrame::CreateDashboardPanel(wxNotebook* notebook) {
 
 
 void RobotManagementFrame::UpdateRobotGrid() {
-    auto robotStatuses = simulator_->getRobotStatuses();
-    int requiredRows = (int)robotStatuses.size();
-    int requiredCols = 5;
-
-    int currentRows = robotGrid->GetNumberRows();
-    int currentCols = robotGrid->GetNumberCols();
-
-    if (currentCols != requiredCols) {
-        if (currentCols > requiredCols) {
-            robotGrid->DeleteCols(0, currentCols - requiredCols);
-        } else {
-            robotGrid->AppendCols(requiredCols - currentCols);
-        }
-
-        robotGrid->SetColLabelValue(0, "Robot Name");
-        robotGrid->SetColLabelValue(1, "Battery Level");
-        robotGrid->SetColLabelValue(2, "Water Level");
-        robotGrid->SetColLabelValue(3, "Status");
-        robotGrid->SetColLabelValue(4, "Current Room");
-
-        robotGrid->SetColSize(0, 100);
-        robotGrid->SetColSize(1, 100);
-        robotGrid->SetColSize(2, 100);
-        robotGrid->SetColSize(3, 120);
-        robotGrid->SetColSize(4, 120);
-    }
-
-    if (currentRows != requiredRows) {
-        if (currentRows > requiredRows) {
-            robotGrid->DeleteRows(0, currentRows - requiredRows);
-        } else {
-            robotGrid->AppendRows(requiredRows - currentRows);
-        }
-    }
-
-    int row = 0;
-    for (const auto& robot : robotStatuses) {
-        robotGrid->SetCellValue(row, 0, robot.name);
-        robotGrid->SetCellValue(row, 1, wxString::Format("%.1f%%", robot.batteryLevel));
-        robotGrid->SetCellValue(row, 2, wxString::Format("%.1f%%", robot.waterLevel));
-        robotGrid->SetCellValue(row, 3, robot.status);
-        robotGrid->SetCellValue(row, 4, robot.currentRoomName);
-
-        if (robot.batteryLevel < 20.0) {
-            robotGrid->SetCellBackgroundColour(row, 1, wxColour(255, 200, 200));
-        } else {
-            robotGrid->SetCellBackgroundColour(row, 1, wxColour(200, 255, 200));
-        }
-
-        if (robot.waterLevel < 20.0) {
-            robotGrid->SetCellBackgroundColour(row, 2, wxColour(255, 200, 200));
-        } else {
-            robotGrid->SetCellBackgroundColour(row, 2, wxColour(200, 255, 200));
-        }
-
-        row++;
-    }
-
-    robotGrid->ForceRefresh();
+    // Only rows whose robot changed since the last call are repainted
+    if (robotStatusTable_) robotStatusTable_->Sync(robotGrid);
 }
 
 void RobotManagementFrame::CheckAndUpdateAlerts() {
@@ -425,22 +468,26 @@ void RobotManagementFrame::OnReturnToCharger(wxCommandEvent& evt) {
 }
 
 void RobotManagementFrame::OnStatusUpdateTimer(wxTimerEvent& evt) {
-    // Update simulator to move robots
-    simulator_->update(1.0f);
+    // Robots move on the simulation thread; only redraw when it has published a new tick
+    if (!simulation_->refresh()) return;
 
     UpdateRobotGrid();
+    if (tickProfilePanel_) {
+        tickProfilePanel_->UpdateProfile();
+    }
     // UpdateRobotChoices();
     // Remove or comment out this line:
     // UpdateSchedulerRobotChoices();
 
     if (mapPanel_) {
-        mapPanel_->Refresh();
+        mapPanel_->RefreshChanged();
     }
 }
 
 void RobotManagementFrame::AddAlert(const Alert& alert) {
+    // Saved by the adapter's alert thread so the UI never waits on the database
     if (dbAdapter) {
-        dbAdapter->saveAlert(alert);
+        dbAdapter->saveAlertAsync(alert);
     }
 
     std::time_t timestamp = alert.getTimestamp();
@@ -540,7 +587,7 @@ void RobotManagementFrame::CreateSchedulerPanel(wxNotebook* notebook) {
 }
 
 void RobotManagementFrame::CreateRobotAnalyticsPanel(wxNotebook* notebook) {
-    auto analyticsPanel = new RobotAnalyticsPanel(notebook, dbAdapter, simulator_);
+    auto analyticsPanel = new RobotAnalyticsPanel(notebook, simulator_->getMetricsAggregator());
     notebook->AddPage(analyticsPanel, "Robot Analytics");
 }
 
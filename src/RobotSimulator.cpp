@@ -4,17 +4,40 @@
 #include "AlertSystem/alert_system.h"
 #include "map/map.h"
 #include "CleaningTask/cleaningTask.h"
+#include "TaskScheduler/TaskScheduler.h"
+#include "EnergyModel/EnergyModel.h"
+#include "ZonePartition/ZonePartition.h"
+#include "ZoneDispatcher/ZoneDispatcher.h"
+#include "MapWatcher/MapWatcher.h"
+#include "map/MapDiff.h"
+#include "map/MapSnapshot.h"
+#include "DirtModel/DirtModel.h"
+#include "AutoTaskPlanner/AutoTaskPlanner.h"
+#include "RobotMetrics/MetricsAggregator.h"
+#include "Telemetry/TelemetryWriter.h"
+#include "Checkpoint/SimulationCheckpoint.h"
+#include "Log/DebugLog.h"
 #include "alert/Alert.h"
 #include "adapter/MongoDBAdapter.hpp" // Ensure included if needed
 #include <iostream>
 #include <algorithm>
 #include <ctime>
+#include <cmath>
+#include <future>
+#include <map>
+#include <sstream>
+#include <unordered_set>
 
 RobotSimulator::RobotSimulator(std::shared_ptr<Map> map,
                                std::shared_ptr<Scheduler> scheduler,
                                std::shared_ptr<AlertSystem> alertSystem,
                                std::shared_ptr<MongoDBAdapter> dbAdapter)
-    : map_(map), scheduler_(scheduler), alertSystem_(alertSystem), dbAdapter_(dbAdapter) {}
+    : map_(map), scheduler_(scheduler), alertSystem_(alertSystem), dbAdapter_(dbAdapter),
+      chargingScheduler_(map ? std::make_shared<ChargingScheduler>(*map) : nullptr) {
+    if (map_) {
+        map_->publishSnapshot();
+    }
+}
 
 std::shared_ptr<Robot> RobotSimulator::getRobotByName(const std::string& name) {
     for (auto& r : robots_) {
@@ -28,41 +51,110 @@ std::vector<std::shared_ptr<Robot>>& RobotSimulator::getRobots() {
 }
 
 void RobotSimulator::update(double deltaTime) {
+    TickProfiler::Scope tickScope(profiler_, TickProfiler::Phase::TICK);
     std::cout << "[DEBUG] RobotSimulator::update start\n";
-    for (auto& robot : robots_) {
-        bool wasCleaning = robot->isCleaning();
-        robot->updateState(deltaTime);
+    simTime_ += deltaTime;
+    {
+        TickProfiler::Scope scope(profiler_, TickProfiler::Phase::MAP_UPDATES);
+        if (mapWatcher_) {
+            for (const auto& diff : mapWatcher_->takePendingDiffs()) {
+                applyMapDiff(diff);
+            }
+        }
+        if (reservations_) {
+            reservations_->advanceTo(static_cast<long>(simTime_ / ReservationTable::kSecondsPerSlot));
+        }
+    }
+
+    std::vector<bool> wasCleaningBefore(robots_.size());
+    std::vector<bool> wasChargingBefore(robots_.size());
+    std::vector<std::shared_ptr<CleaningTask>> tasksBefore(robots_.size());
+    for (size_t i = 0; i < robots_.size(); ++i) {
+        wasCleaningBefore[i] = robots_[i]->isCleaning();
+        wasChargingBefore[i] = robots_[i]->isCharging();
+        tasksBefore[i] = robots_[i]->getCurrentTask();
+    }
+    {
+        TickProfiler::Scope scope(profiler_, TickProfiler::Phase::ROBOT_UPDATES);
+        advanceRobots(deltaTime);
+        updateOccupancy();
+    }
+
+    if (dirtModel_) {
+        TickProfiler::Scope scope(profiler_, TickProfiler::Phase::DIRT_MODEL);
+        for (const auto& task : tasksBefore) {
+            if (task && task->getRoom() && task->getStatus() == "Completed") {
+                dirtModel_->markCleaned(task->getRoom()->getRoomId(), simTime_);
+            }
+        }
+        auto newlyDirty = dirtModel_->update(simTime_);
+        if (autoTaskPlanner_) autoTaskPlanner_->notifyRoomsChanged(newlyDirty);
+    }
+    for (size_t i = 0; i < tasksBefore.size(); ++i) {
+        const auto& task = tasksBefore[i];
+        if (task && (task->getStatus() == "Completed" || task->getStatus() == "Failed")) {
+            if (auto scheduler = schedulerFor(robots_[i])) scheduler->forgetPlannedRoute(task->getID());
+        }
+    }
+    if (autoTaskPlanner_) {
+        for (const auto& task : tasksBefore) {
+            if (task && task->getRoom() && (task->getStatus() == "Completed" || task->getStatus() == "Failed")) {
+                autoTaskPlanner_->releaseRoom(task->getRoom()->getRoomId(), task->getID(),
+                                              task->getStatus() == "Failed");
+            }
+        }
+    }
+
+    for (size_t i = 0; i < robots_.size(); ++i) {
+        auto& robot = robots_[i];
+        bool wasCleaning = wasCleaningBefore[i];
+        bool wasCharging = wasChargingBefore[i];
         bool nowCleaning = robot->isCleaning();
 
         // Reintroduce analytics saving after each robot update
         if (dbAdapter_) {
             // The robot maintains errorCount_ and totalWorkTime_ internally.
             // By calling saveRobotAnalytics here, the DB is updated in real-time.
-            dbAdapter_->saveRobotAnalytics(robot);
+            TickProfiler::Scope scope(profiler_, TickProfiler::Phase::ANALYTICS_SAVE);
+            if (metricsAggregator_) {
+                dbAdapter_->saveRobotAnalytics(robot, metricsAggregator_->robotMetrics(i, MetricsAggregator::Window::HOUR));
+            } else {
+                dbAdapter_->saveRobotAnalytics(robot);
+            }
         }
 
-        // Handle low resources and return to charger if needed
-        if ((robot->getBatteryLevel() < 20.0 || robot->getWaterLevel() <= 0.0) && !robot->isCharging()) {
-            requestReturnToCharger(robot->getName());
+        // A task the robot arrived at without the resources to clean goes back in the queue
+        if (auto returned = robot->takeReturnedTask()) {
+            if (auto scheduler = schedulerFor(robot)) {
+                scheduler->requeueTask(returned);
+            } else {
+                TaskScheduler::getInstance().enqueueTask(returned);
+            }
+        }
+
+        // Handle low resources and return to charger if needed, including robots that
+        // declined queued work they could not finish on what is left
+        bool chargeRequested = robot->takeChargeRequest();
+        if ((robot->getBatteryLevel() < 20.0 || robot->getWaterLevel() <= 0.0 || chargeRequested) &&
+            !robot->isCharging()) {
+            requestReturnToCharger(robot);
             continue;
         }
 
         // If robot just finished a cleaning task
         if (wasCleaning && !nowCleaning && !robot->getCurrentTask()) {
-            if (scheduler_) {
-                auto nextTask = scheduler_->getNextTaskForRobot(robot->getName());
-                if (nextTask) {
-                    robot->setCurrentTask(nextTask);
-                    assignTaskToRobot(nextTask);
-                } else {
-                    handleNoTaskAndReturnToChargerIfNeeded(robot);
-                }
-            } else {
-                handleNoTaskAndReturnToChargerIfNeeded(robot);
-            }
+            dispatchNextTask(robot);
+        } else if (wasCharging && !robot->isCharging() && !robot->getCurrentTask() && schedulerFor(robot)) {
+            // Freshly charged robots pick up anything held back while they were low
+            dispatchNextTask(robot);
         }
     }
 
+    if (chargingScheduler_) {
+        TickProfiler::Scope scope(profiler_, TickProfiler::Phase::CHARGING_SCHEDULER);
+        chargingScheduler_->update(simTime_);
+    }
+
     std::cout << "[DEBUG] After RobotSimulator::update cycle:\n";
     for (auto& robot : robots_) {
         std::cout << "  Robot " << robot->getName() 
@@ -70,10 +162,141 @@ void RobotSimulator::update(double deltaTime) {
                   << " Status=" << robot->getStatus() << "\n";
     }
 
-    checkRobotStatesAndSendAlerts();
+    {
+        TickProfiler::Scope scope(profiler_, TickProfiler::Phase::STATE_ALERTS);
+        checkRobotStatesAndSendAlerts();
+    }
+    {
+        TickProfiler::Scope scope(profiler_, TickProfiler::Phase::STATUS_FEED);
+        collectStatusChanges();
+    }
+    if (metricsAggregator_) {
+        TickProfiler::Scope scope(profiler_, TickProfiler::Phase::ROBOT_METRICS);
+        metricsAggregator_->observe(robots_, simTime_);
+    }
+    if (telemetry_) {
+        TickProfiler::Scope scope(profiler_, TickProfiler::Phase::TELEMETRY);
+        telemetry_->record(robots_, simTime_);
+    }
+    if (checkpointer_) {
+        TickProfiler::Scope scope(profiler_, TickProfiler::Phase::CHECKPOINT);
+        checkpointer_->record(*this, simTime_);
+    }
     std::cout << "[DEBUG] RobotSimulator::update end\n";
 }
 
+void RobotSimulator::advanceRobots(double deltaTime) {
+    if (!zones_ || zones_->zoneCount() < 2) {
+        for (auto& robot : robots_) {
+            robot->updateState(deltaTime);
+        }
+        return;
+    }
+
+    // A robot only touches its own state and the room it is in, so robots in
+    // different zones can advance in parallel. Robots about to cross into another
+    // zone run afterwards so no room is written from two workers, and taking work
+    // from the TaskScheduler, which can move a robot into any room, waits until the
+    // workers are joined. Each worker buffers its debug output and the buffers are
+    // printed in zone order.
+    std::map<int, std::vector<Robot*>> byZone;
+    std::vector<Robot*> crossing;
+    for (auto& robot : robots_) {
+        int zone = zones_->zoneOf(robot->getCurrentRoom());
+        if (robot->getNextRoom() && zones_->zoneOf(robot->getNextRoom()) != zone) {
+            crossing.push_back(robot.get());
+        } else {
+            byZone[zone].push_back(robot.get());
+        }
+    }
+
+    std::vector<std::ostringstream> logs(byZone.size());
+    std::vector<std::future<void>> workers;
+    size_t next = 0;
+    for (auto& entry : byZone) {
+        auto* group = &entry.second;
+        auto* log = &logs[next++];
+        workers.push_back(std::async(std::launch::async, [group, log, deltaTime]() {
+            DebugLog::Redirect redirect(*log);
+            for (Robot* robot : *group) robot->updateState(deltaTime, false);
+        }));
+    }
+    for (auto& worker : workers) {
+        worker.get();
+    }
+    for (const auto& log : logs) {
+        std::cout << log.str();
+    }
+    for (auto& entry : byZone) {
+        for (Robot* robot : entry.second) {
+            if (!robot->getCurrentTask() && robot->canAcceptTask()) robot->requestNextTask();
+        }
+    }
+    for (Robot* robot : crossing) {
+        robot->updateState(deltaTime);
+    }
+}
+
+void RobotSimulator::updateOccupancy() {
+    for (auto& robot : robots_) {
+        Room* now = robot->getCurrentRoom();
+        Room*& counted = occupiedRooms_[robot.get()];
+        if (now == counted) continue;
+        if (counted) counted->addOccupant(-1);
+        if (now) now->addOccupant(1);
+        if (now && counted && dirtModel_) dirtModel_->recordVisit(now->getRoomId(), simTime_);
+        counted = now;
+    }
+}
+
+std::shared_ptr<Scheduler> RobotSimulator::schedulerFor(const std::shared_ptr<Robot>& robot) const {
+    if (zoneDispatcher_) {
+        return zoneDispatcher_->getShardForRobot(robot->getName());
+    }
+    return scheduler_;
+}
+
+void RobotSimulator::dispatchNextTask(std::shared_ptr<Robot> robot) {
+    TickProfiler::Scope scope(profiler_, TickProfiler::Phase::TASK_DISPATCH);
+    auto scheduler = schedulerFor(robot);
+    if (!scheduler) {
+        handleNoTaskAndReturnToChargerIfNeeded(robot);
+        return;
+    }
+
+    auto nextTask = scheduler->getNextTaskForRobot(robot->getName());
+    if (!nextTask) {
+        handleNoTaskAndReturnToChargerIfNeeded(robot);
+        return;
+    }
+
+    // Only dispatch if route, clean and the trip back to a charger fit in what is left
+    EnergyModel energy(*map_);
+    auto prediction = energy.predict(*robot, *nextTask);
+    if (prediction.reachable && !prediction.feasible) {
+        std::cout << "[DEBUG] Robot " << robot->getName() << " holding task " << nextTask->getID()
+                  << " until recharged (needs " << prediction.batteryNeeded << "% battery, "
+                  << prediction.waterNeeded << "% water).\n";
+        robot->recordPreemptiveAbort();
+        scheduler->requeueTask(nextTask);
+        requestReturnToCharger(robot);
+        return;
+    }
+
+    robot->setCurrentTask(nextTask);
+    assignTaskToRobot(nextTask);
+}
+
+RobotSimulator::EnergyStats RobotSimulator::getEnergyStats() const {
+    EnergyStats stats{0, 0, 0};
+    for (const auto& robot : robots_) {
+        stats.preemptiveAborts += robot->getPreemptiveAborts();
+        stats.midTaskAborts += robot->getMidTaskAborts();
+        stats.wastedTravelHops += robot->getWastedTravelHops();
+    }
+    return stats;
+}
+
 void RobotSimulator::handleNoTaskAndReturnToChargerIfNeeded(std::shared_ptr<Robot> robot) {
     double battery = robot->getBatteryLevel();
     double water = robot->getWaterLevel();
@@ -85,7 +308,7 @@ void RobotSimulator::handleNoTaskAndReturnToChargerIfNeeded(std::shared_ptr<Robo
     if (needsReturn) {
         std::cout << "Debug: Robot " << robot->getName()
                   << " has no tasks and/or low resources, returning to charger.\n";
-        requestReturnToCharger(robot->getName());
+        requestReturnToCharger(robot);
     } else {
         std::cout << "Debug: Robot " << robot->getName()
                   << " has no tasks but does not need charger right now.\n";
@@ -95,22 +318,32 @@ void RobotSimulator::handleNoTaskAndReturnToChargerIfNeeded(std::shared_ptr<Robo
 void RobotSimulator::moveRobotToRoom(const std::string& robotName, int roomId) {
     auto robot = getRobotByName(robotName);
     if (!robot) return;
+    moveRobotToRoom(robot, roomId);
+}
+
+void RobotSimulator::moveRobotToRoom(const std::shared_ptr<Robot>& robot, int roomId) {
     Room* currentRoom = robot->getCurrentRoom();
     Room* targetRoom = map_->getRoomById(roomId);
     if (!currentRoom || !targetRoom) return;
 
+    // Sent somewhere other than its charger: give up the slot or queue place
+    if (chargingScheduler_ && chargingScheduler_->getAssignment(robot.get(), simTime_).chargerRoomId != roomId) {
+        chargingScheduler_->cancel(robot.get());
+        if (targetRoom != currentRoom) robot->setCharging(false);
+    }
+
     auto route = map_->getRoute(*currentRoom, *targetRoom);
     if (route.empty()) {
         if (alertSystem_) {
-            alertSystem_->sendAlert("No path found for robot " + robotName, "Movement");
+            alertSystem_->sendAlert("No path found for robot " + robot->getName(), "Movement");
             // Optionally save alert
             if (dbAdapter_) {
                 // Convert currentRoom to shared_ptr<Room>
                 std::shared_ptr<Room> curRoomPtr = currentRoom ? std::make_shared<Room>(*currentRoom) : nullptr;
                 
                 // Alert with "Task" title so it appears in the same category
-                Alert alert("Movement", "No path found for robot " + robotName, 
-                            getRobotByName(robotName), curRoomPtr, std::time(nullptr), Alert::LOW);
+                Alert alert("Movement", "No path found for robot " + robot->getName(),
+                            robot, curRoomPtr, std::time(nullptr), Alert::LOW);
                 dbAdapter_->saveAlert(alert);
             }
         }
@@ -125,7 +358,11 @@ void RobotSimulator::startRobotCleaning(const std::string& robotName) {
     if (!robot) {
         throw std::runtime_error("Robot not found: " + robotName);
     }
-    std::cout << "[DEBUG] Robot " << robotName << " attempting to start cleaning." << std::endl;
+    startRobotCleaning(robot);
+}
+
+void RobotSimulator::startRobotCleaning(const std::shared_ptr<Robot>& robot) {
+    std::cout << "[DEBUG] Robot " << robot->getName() << " attempting to start cleaning." << std::endl;
     robot->startCleaning(CleaningTask::VACUUM); 
 }
 
@@ -134,17 +371,32 @@ void RobotSimulator::stopRobotCleaning(const std::string& robotName) {
     if (!robot) {
         throw std::runtime_error("Robot not found: " + robotName);
     }
-    std::cout << "[DEBUG] Robot " << robotName << " attempting to stop cleaning." << std::endl;
+    stopRobotCleaning(robot);
+}
+
+void RobotSimulator::stopRobotCleaning(const std::shared_ptr<Robot>& robot) {
+    std::cout << "[DEBUG] Robot " << robot->getName() << " attempting to stop cleaning." << std::endl;
     robot->stopCleaning();
+    // A stopped robot that is not charging has no use for a slot it was heading to
+    if (chargingScheduler_ && !robot->isCharging()) chargingScheduler_->cancel(robot.get());
 }
 
 void RobotSimulator::manuallyPickUpRobot(const std::string& robotName) {
     auto robot = getRobotByName(robotName);
     if (!robot) return;
-    Room* charger = map_->getRoomById(0);
+    manuallyPickUpRobot(robot);
+}
+
+void RobotSimulator::manuallyPickUpRobot(const std::shared_ptr<Robot>& robot) {
+    // Carried from wherever it is now, so it gets a fresh slot rather than an old queue place
+    chargingScheduler_->cancel(robot.get());
+    auto assignment = chargingScheduler_->requestCharge(robot, simTime_);
+    Room* charger = map_->getRoomById(assignment.chargerRoomId);
     if (!charger) return;
     robot->setCurrentRoom(charger);
-    robot->setCharging(true);
+    if (!assignment.queued) {
+        robot->setCharging(true);
+    }
 }
 
 void RobotSimulator::requestReturnToCharger(const std::string& robotName) {
@@ -152,42 +404,328 @@ void RobotSimulator::requestReturnToCharger(const std::string& robotName) {
     if (!robot) {
         throw std::runtime_error("Robot not found: " + robotName);
     }
+    requestReturnToCharger(robot);
+}
 
-    Room* charger = map_->getRoomById(0);
+void RobotSimulator::requestReturnToCharger(const std::shared_ptr<Robot>& robot) {
+    TickProfiler::Scope scope(profiler_, TickProfiler::Phase::RETURN_TO_CHARGER);
+    auto assignment = chargingScheduler_->requestCharge(robot, simTime_);
+    Room* charger = map_->getRoomById(assignment.chargerRoomId);
     if (!charger) {
-        throw std::runtime_error("Charging station not found");
+        // A map edit removed every charger; the robot stays put until one is added
+        chargingScheduler_->cancel(robot.get());
+        std::cout << "[DEBUG] Robot " << robot->getName() << " has no charging station to return to.\n";
+        return;
+    }
+    // Already there: it either charges or waits for its slot in place
+    if (robot->getCurrentRoom() == charger) {
+        return;
     }
 
-    auto route = map_->getRoute(*robot->getCurrentRoom(), *charger);
+    auto route = planRoute(robot, robot->getCurrentRoom(), charger);
     if (!route.empty()) {
         robot->setMovementPath(route, *map_);
     } else {
         robot->setCurrentRoom(charger);
-        robot->setCharging(true);
+        if (!assignment.queued) {
+            robot->setCharging(true);
+        }
+    }
+}
+
+ChargingScheduler::Assignment RobotSimulator::getChargerAssignment(const std::string& robotName) {
+    auto robot = getRobotByName(robotName);
+    if (!robot) {
+        throw std::runtime_error("Robot not found: " + robotName);
+    }
+    return chargingScheduler_->getAssignment(robot.get(), simTime_);
+}
+
+ChargingScheduler::Stats RobotSimulator::getChargingStats() const {
+    return chargingScheduler_ ? chargingScheduler_->getStats() : ChargingScheduler::Stats{};
+}
+
+void RobotSimulator::enableDirtModel(double dirtyThreshold) {
+    dirtModel_ = std::make_shared<DirtModel>(*map_, simTime_, dirtyThreshold);
+}
+
+void RobotSimulator::enableTrafficReservation(bool enabled) {
+    if (!enabled) {
+        reservations_.reset();
+        return;
+    }
+    if (!reservations_) {
+        reservations_ = std::make_shared<ReservationTable>(*map_);
+    }
+}
+
+ReservationTable::Stats RobotSimulator::getTrafficStats() const {
+    return reservations_ ? reservations_->getStats() : ReservationTable::Stats{};
+}
+
+std::vector<int> RobotSimulator::planRoute(const std::shared_ptr<Robot>& robot, Room* from, Room* to,
+                                           int dwellSlots) {
+    if (!from || !to) return {};
+    if (!reservations_) {
+        return zones_ ? zones_->getRoute(*from, *to) : map_->getRoute(*from, *to);
+    }
+    long slot = static_cast<long>(simTime_ / ReservationTable::kSecondsPerSlot);
+    return reservations_->planRoute(robot.get(), from, to, slot, dwellSlots);
+}
+
+bool RobotSimulator::hopOpen(Room* from, Room* to) const {
+    if (from == to) return true;   // waiting in place
+    if (map_->getRoomById(to->getRoomId()) != to) return false;
+    bool connected = std::find(from->neighbors.begin(), from->neighbors.end(), to) != from->neighbors.end();
+    return connected && !map_->isVirtualWallBetween(from, to);
+}
+
+int RobotSimulator::applyMapDiff(const MapDiff& diff) {
+    if (diff.empty()) return 0;
+    std::unordered_set<int> touched = diff.applyTo(*map_);
+
+    // Everything derived from the old topology is rebuilt or marked stale
+    if (dirtModel_) {
+        for (int id : diff.removedRooms) dirtModel_->removeRoom(id);
+        for (const auto& spec : diff.addedRooms) dirtModel_->addRoom(map_->getRoomById(spec.id), simTime_);
+    }
+    if (zones_) {
+        zones_ = std::make_shared<ZonePartition>(*map_);
+    }
+    if (zoneDispatcher_) {
+        zoneDispatcher_->onMapChanged();
+    } else if (scheduler_) {
+        scheduler_->onMapChanged();
+    }
+    auto exists = [this](const Room* room) {
+        return room && map_->getRoomById(room->getRoomId()) == room;
+    };
+    // Generated tasks wait in the shared queue; ones for removed rooms can never run
+    if (!diff.removedRooms.empty()) {
+        auto orphaned = TaskScheduler::getInstance().removeIf(
+            [&exists](const CleaningTask& task) { return task.getRoom() && !exists(task.getRoom()); });
+        for (const auto& task : orphaned) task->markFailed();
+    }
+    std::vector<std::shared_ptr<Robot>> displaced;
+    if (chargingScheduler_ && (!diff.addedChargers.empty() || !diff.removedChargers.empty())) {
+        displaced = chargingScheduler_->syncChargers();
+    }
+
+    int rerouted = 0;
+    for (auto& robot : robots_) {
+        Room* current = robot->getCurrentRoom();
+        if (current && !exists(current)) {
+            evacuateRemovedRoom(robot);
+            rerouted++;
+            continue;
+        }
+        std::vector<Room*> path = robot->getRemainingPath();
+        if (!current || path.empty()) continue;
+
+        // Only a path through an edited room can have been broken
+        bool affected = touched.count(current->getRoomId()) > 0;
+        for (Room* room : path) {
+            affected = affected || touched.count(room->getRoomId()) > 0;
+        }
+        if (!affected) continue;
+
+        bool valid = true;
+        Room* previous = current;
+        for (Room* room : path) {
+            if (!hopOpen(previous, room)) {
+                valid = false;
+                break;
+            }
+            previous = room;
+        }
+        if (valid) continue;
+
+        // Finish the hop in progress when it is still open, otherwise turn back
+        Room* destination = path.back();
+        Room* from = path.front();
+        if (!hopOpen(current, from)) {
+            robot->abandonHop();
+            from = current;
+        }
+
+        auto task = robot->getCurrentTask();
+        bool destinationExists = map_->getRoomById(destination->getRoomId()) == destination;
+        std::vector<int> route;
+        if (destinationExists) {
+            int dwellSlots = 0;
+            if (reservations_ && task && task->getRoom() == destination) {
+                dwellSlots = static_cast<int>(std::ceil(Robot::cleaningTimeForRoom(*destination) /
+                                                        ReservationTable::kSecondsPerSlot));
+            }
+            route = planRoute(robot, from, destination, dwellSlots);
+        }
+
+        if (!route.empty()) {
+            robot->setMovementPath(route, *map_);
+        } else {
+            std::cout << "[DEBUG] Robot " << robot->getName() << " has no route to "
+                      << destination->getRoomName() << " after map change, stopping.\n";
+            if (from == current) {
+                robot->abandonHop();
+            } else {
+                robot->setMovementPath({from->getRoomId()}, *map_);
+            }
+            if (task && task->getRoom() == destination) {
+                robot->setCurrentTask(nullptr);
+                auto scheduler = schedulerFor(robot);
+                if (destinationExists && scheduler) {
+                    scheduler->requeueTask(task);
+                }
+            }
+        }
+        rerouted++;
+    }
+
+    // Robots that were charging or queued at a removed charger look for another one
+    for (const auto& robot : displaced) {
+        if (robot->isFailed() || robot->getCurrentTask()) continue;
+        robot->setCharging(false);
+        requestReturnToCharger(robot);
+    }
+
+    map_->publishSnapshot();
+    if (autoTaskPlanner_) {
+        autoTaskPlanner_->notifyRoomsChanged(std::vector<int>(touched.begin(), touched.end()));
+    }
+    std::cout << "[DEBUG] RobotSimulator: applied map change (" << diff.changeCount() << " edits), re-routed "
+              << rerouted << " robots\n";
+    return rerouted;
+}
+
+void RobotSimulator::evacuateRemovedRoom(const std::shared_ptr<Robot>& robot) {
+    auto exists = [this](const Room* room) {
+        return room && map_->getRoomById(room->getRoomId()) == room;
+    };
+
+    // Land in the room it was heading into when that is still there, otherwise at a charger
+    Room* landing = exists(robot->getNextRoom()) ? robot->getNextRoom() : homeRoom();
+    std::cout << "[DEBUG] Robot " << robot->getName() << " was in removed room "
+              << robot->getCurrentRoom()->getRoomName() << ", moving to "
+              << (landing ? landing->getRoomName() : "nowhere") << ".\n";
+
+    // Work in a removed room is dropped; work elsewhere goes back in the queue
+    auto task = robot->getCurrentTask();
+    robot->stopCleaning();
+    robot->abandonHop();
+    robot->setCurrentTask(nullptr);
+    if (robot->getSavedTask() && !exists(robot->getSavedTask()->getRoom())) {
+        robot->restoreSavedTask(nullptr, 0.0);
+    }
+    robot->setCurrentRoom(landing);
+    if (task) {
+        auto scheduler = schedulerFor(robot);
+        if (exists(task->getRoom()) && scheduler) {
+            task->setStatus("Pending");
+            scheduler->requeueTask(task);
+        } else {
+            task->markFailed();
+        }
     }
+    if (landing) dispatchNextTask(robot);
 }
 
 std::vector<RobotSimulator::RobotStatus> RobotSimulator::getRobotStatuses() const {
     std::vector<RobotStatus> statuses;
-    for (auto& robot : robots_) {
-        RobotStatus rs {
-            robot->getName(),
-            robot->getBatteryLevel(),
-            robot->getWaterLevel(),
-            robot->getCurrentRoom() ? robot->getCurrentRoom()->getRoomName() : "Unknown",
-            robot->isCleaning(),
-            robot->needsCharging(),
-            robot->getStatus()
-        };
-        statuses.push_back(rs);
+    statuses.reserve(robots_.size());
+    for (size_t i = 0; i < robots_.size(); ++i) {
+        statuses.push_back(getRobotStatus(i));
     }
     return statuses;
 }
 
+RobotSimulator::RobotStatus RobotSimulator::getRobotStatus(size_t index) const {
+    const auto& robot = robots_.at(index);
+    return RobotStatus {
+        robot->getName(),
+        robot->getBatteryLevel(),
+        robot->getWaterLevel(),
+        robot->getCurrentRoom() ? robot->getCurrentRoom()->getRoomName() : "Unknown",
+        robot->isCleaning(),
+        robot->needsCharging(),
+        robot->getStatus()
+    };
+}
+
+namespace {
+    // Same precedence as Robot::getStatus, without building the string
+    int statusCode(const Robot& robot) {
+        if (robot.isFailed()) return 0;
+        if (robot.getBatteryLevel() <= 0.0) return 1;
+        if (robot.isCharging()) return 2;
+        if (robot.isCleaning()) return 3;
+        if (robot.isMoving()) return 4;
+        return 5;
+    }
+}
+
+bool RobotSimulator::StatusKey::operator==(const StatusKey& other) const {
+    return robot == other.robot && battery == other.battery && water == other.water &&
+           state == other.state && room == other.room;
+}
+
+uint64_t RobotSimulator::collectStatusChanges() {
+    // Robots can also be added straight through getRobots(), so new rows are picked up here
+    std::vector<size_t> changed;
+    if (statusKeys_.size() > robots_.size()) statusKeys_.resize(robots_.size());
+    for (size_t i = 0; i < robots_.size(); ++i) {
+        const Robot& robot = *robots_[i];
+        StatusKey key{&robot, std::lround(robot.getBatteryLevel() * 10.0), std::lround(robot.getWaterLevel() * 10.0),
+                      statusCode(robot), robot.getCurrentRoom()};
+        if (i == statusKeys_.size()) {
+            statusKeys_.push_back(key);
+        } else if (statusKeys_[i] == key) {
+            continue;
+        } else {
+            statusKeys_[i] = key;
+        }
+        changed.push_back(i);
+    }
+    if (changed.empty()) return statusVersion_;
+
+    ++statusVersion_;
+    for (size_t index : changed) {
+        statusLog_.emplace_back(statusVersion_, index);
+    }
+    // Keep about one fleet's worth of history; older readers just redraw everything
+    while (statusLog_.size() > robots_.size() + 64) {
+        statusLogFloor_ = statusLog_.front().first;
+        statusLog_.pop_front();
+    }
+    return statusVersion_;
+}
+
+std::vector<size_t> RobotSimulator::getChangedRobots(uint64_t sinceVersion) const {
+    std::vector<size_t> indexes;
+    if (sinceVersion < statusLogFloor_) {
+        indexes.resize(robots_.size());
+        for (size_t i = 0; i < indexes.size(); ++i) indexes[i] = i;
+        return indexes;
+    }
+    auto first = std::upper_bound(statusLog_.begin(), statusLog_.end(), sinceVersion,
+                                  [](uint64_t version, const std::pair<uint64_t, size_t>& entry) {
+                                      return version < entry.first;
+                                  });
+    for (auto it = first; it != statusLog_.end(); ++it) {
+        if (it->second < robots_.size()) indexes.push_back(it->second);
+    }
+    std::sort(indexes.begin(), indexes.end());
+    indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+    return indexes;
+}
+
 const Map& RobotSimulator::getMap() const {
     return *map_;
 }
 
+std::shared_ptr<const MapSnapshot> RobotSimulator::getMapSnapshot() const {
+    return map_->getSnapshot();
+}
+
 std::shared_ptr<AlertSystem> RobotSimulator::getAlertSystem() const {
     return alertSystem_;
 }
@@ -236,8 +774,16 @@ void RobotSimulator::checkRobotStatesAndSendAlerts() {
     }
 }
 
+Room* RobotSimulator::homeRoom() const {
+    // The first charger that still exists, or any room when an edit removed them all
+    for (int chargerId : map_->getChargerRoomIds()) {
+        if (Room* room = map_->getRoomById(chargerId)) return room;
+    }
+    return map_->getRooms().empty() ? nullptr : map_->getRooms().front();
+}
+
 void RobotSimulator::addRobot(const std::string& robotName) {
-    Room* charger = map_->getRoomById(0);
+    Room* charger = homeRoom();
     // Default to MEDIUM size and VACUUM strategy if none specified
     auto newRobot = std::make_shared<Robot>(robotName, 100.0, Robot::Size::MEDIUM, Robot::Strategy::VACUUM, 100.0);
     if (charger) newRobot->setCurrentRoom(charger);
@@ -245,6 +791,14 @@ void RobotSimulator::addRobot(const std::string& robotName) {
     robots_.push_back(newRobot);
 }
 
+void RobotSimulator::addRobot(std::shared_ptr<Robot> robot) {
+    if (!robot->getCurrentRoom()) {
+        robot->setCurrentRoom(homeRoom());
+    }
+    robot->setMap(map_.get());
+    robots_.push_back(robot);
+}
+
 void RobotSimulator::assignTaskToRobot(std::shared_ptr<CleaningTask> task) {
     auto robot = task->getRobot();
     if (!robot) return;
@@ -254,7 +808,22 @@ void RobotSimulator::assignTaskToRobot(std::shared_ptr<CleaningTask> task) {
     if (!currentRoom || !targetRoom) return;
 
     robot->setTargetRoom(targetRoom);
-    auto route = map_->getRoute(*currentRoom, *targetRoom);
+
+    // Reuse the leg from the robot's planned tour when it starts where the robot is.
+    // With reservations on, plan around other robots instead and hold the room for the clean.
+    std::vector<int> route;
+    if (auto scheduler = schedulerFor(robot)) {
+        route = scheduler->takePlannedRoute(task->getID(), currentRoom->getRoomId());
+    }
+    if (reservations_) {
+        int dwellSlots = static_cast<int>(std::ceil(Robot::cleaningTimeForRoom(*targetRoom) /
+                                                    ReservationTable::kSecondsPerSlot));
+        route = planRoute(robot, currentRoom, targetRoom, dwellSlots);
+    } else {
+        if (route.empty() || route.back() != targetRoom->getRoomId()) {
+            route = planRoute(robot, currentRoom, targetRoom);
+        }
+    }
     if (!route.empty()) {
         robot->setMovementPath(route, *map_);
     }
@@ -1,19 +1,66 @@
 #include "Room/Room.h"
+#include "map/RoomStateTable.h"
+#include <cctype>
 #include <iostream>
 
+namespace {
+    bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (std::tolower(static_cast<unsigned char>(a[i])) != b[i]) return false;
+        }
+        return true;
+    }
+}
+
+RoomSize parseRoomSize(std::string_view size) {
+    if (equalsIgnoreCase(size, "small")) return RoomSize::SMALL;
+    if (equalsIgnoreCase(size, "medium")) return RoomSize::MEDIUM;
+    return RoomSize::LARGE;
+}
+
+FloorType parseFloorType(std::string_view flooring) {
+    if (equalsIgnoreCase(flooring, "carpet")) return FloorType::CARPET;
+    if (equalsIgnoreCase(flooring, "wood")) return FloorType::WOOD;
+    if (equalsIgnoreCase(flooring, "hardwood")) return FloorType::HARDWOOD;
+    if (equalsIgnoreCase(flooring, "tile")) return FloorType::TILE;
+    return FloorType::OTHER;
+}
+
 // Constructor implementation
 Room::Room(const std::string& roomName, int roomId, const std::string& flooringType, 
            const std::string& size, bool isRoomClean, const std::vector<Room*>& neighbors)
     : roomName(roomName), 
       roomId(roomId), 
       flooringType(flooringType), 
-      isRoomClean(isRoomClean), 
       size(size), 
+      roomSize(parseRoomSize(size)), 
+      floorType(parseFloorType(flooringType)), 
       neighbors(neighbors), 
-      map(nullptr) {}
+      map(nullptr) {
+    state_.clean = isRoomClean;
+}
+
+Room::StateLink::StateLink(const StateLink& other) : clean(other.isClean()) {}
+
+Room::StateLink& Room::StateLink::operator=(const StateLink& other) {
+    // Copies detach: only the map's own rooms write into its table
+    table = nullptr;
+    slot = 0;
+    clean = other.isClean();
+    return *this;
+}
+
+bool Room::StateLink::isClean() const {
+    return table ? table->isClean(slot) : clean;
+}
+
+bool Room::isClean() const {
+    return state_.isClean();
+}
 
 // Getter for room name
-std::string Room::getRoomName() const {
+const std::string& Room::getRoomName() const {
     return roomName;
 }
 
@@ -23,7 +70,7 @@ int Room::getRoomId() const {
 }
 
 // Getter for room size
-std::string Room::getSize() const {
+const std::string& Room::getSize() const {
     return size;
 }
 
@@ -33,17 +80,25 @@ void Room::getRoomInfo() const {
               << ", Room ID: " << roomId
               << ", Flooring Type: " << flooringType
               << ", Size: " << size
-              << ", Room is clean?: " << (isRoomClean ? "Yes" : "No") << std::endl;
+              << ", Room is clean?: " << (isClean() ? "Yes" : "No") << std::endl;
 }
 
 // Marking a given room as clean
 void Room::markClean(){
-    isRoomClean = true;
+    if (state_.table) {
+        state_.table->setClean(state_.slot, true);
+    } else {
+        state_.clean = true;
+    }
 }
 
 // Marking a given room as dirty
 void Room::markDirty(){
-    isRoomClean = false;
+    if (state_.table) {
+        state_.table->setClean(state_.slot, false);
+    } else {
+        state_.clean = false;
+    }
 }
 
 // Adding a neighbor to neighbors vector
@@ -51,6 +106,36 @@ void Room::addNeighbor(Room* neighbor){
     neighbors.push_back(neighbor);
 }
 
-std::string Room::getFlooringType() const {
+const std::string& Room::getFlooringType() const {
     return flooringType;
 }
+
+void Room::setSize(const std::string& newSize) {
+    size = newSize;
+    roomSize = parseRoomSize(newSize);
+}
+
+void Room::setFlooringType(const std::string& newFlooringType) {
+    flooringType = newFlooringType;
+    floorType = parseFloorType(newFlooringType);
+}
+
+void Room::setPosition(const RoomPosition& position) {
+    position_ = position;
+    hasPosition_ = true;
+}
+
+void Room::clearPosition() {
+    position_ = RoomPosition{};
+    hasPosition_ = false;
+}
+
+void Room::attachState(RoomStateTable* table, size_t slot) {
+    if (table) table->setClean(slot, state_.isClean());
+    state_.table = table;
+    state_.slot = slot;
+}
+
+void Room::addOccupant(int delta) {
+    if (state_.table) state_.table->addOccupant(state_.slot, delta);
+}
@@ -0,0 +1,46 @@
+#include "map/RoomStateTable.h"
+#include <stdexcept>
+
+RoomStateTable::~RoomStateTable() {
+    for (auto& chunk : chunks_) {
+        delete chunk.load(std::memory_order_relaxed);
+    }
+}
+
+size_t RoomStateTable::allocateSlot(bool isClean) {
+    size_t slot = size_.load(std::memory_order_relaxed);
+    size_t chunkIndex = slot / kChunkSize;
+    if (chunkIndex >= kMaxChunks) {
+        throw std::runtime_error("RoomStateTable is full");
+    }
+    if (!chunks_[chunkIndex].load(std::memory_order_relaxed)) {
+        chunks_[chunkIndex].store(new Chunk(), std::memory_order_release);
+    }
+    entry(slot).clean.store(isClean, std::memory_order_relaxed);
+    size_.store(slot + 1, std::memory_order_release);
+    return slot;
+}
+
+RoomStateTable::Entry& RoomStateTable::entry(size_t slot) const {
+    Chunk* chunk = chunks_[slot / kChunkSize].load(std::memory_order_acquire);
+    if (!chunk) {
+        throw std::out_of_range("RoomStateTable slot not allocated");
+    }
+    return chunk->entries[slot % kChunkSize];
+}
+
+bool RoomStateTable::isClean(size_t slot) const {
+    return entry(slot).clean.load(std::memory_order_acquire);
+}
+
+void RoomStateTable::setClean(size_t slot, bool clean) {
+    entry(slot).clean.store(clean, std::memory_order_release);
+}
+
+int RoomStateTable::occupancy(size_t slot) const {
+    return entry(slot).occupancy.load(std::memory_order_acquire);
+}
+
+void RoomStateTable::addOccupant(size_t slot, int delta) {
+    entry(slot).occupancy.fetch_add(delta, std::memory_order_acq_rel);
+}
@@ -6,6 +6,8 @@
 #include "adapter/MongoDBAdapter.hpp"
 #include "alert/Alert.h"
 #include "AlertDialog/AlertDialog.hpp"
+#include "EnergyModel/EnergyModel.h"
+#include "AutoTaskPlanner/AutoTaskPlanner.h"
 #include <algorithm>
 #include <stdexcept>
 #include <ctime>
@@ -13,6 +15,7 @@
 
 void Scheduler::addTask(std::shared_ptr<CleaningTask> task) {
     tasks_.push_back(task);
+    if (task->getRobot()) staleTours_.insert(task->getRobot()->getName());
     std::cout << "[DEBUG] Scheduler::addTask: Added task " << task->getID() << "\n";
     printTasks();
 }
@@ -24,6 +27,17 @@ std::shared_ptr<CleaningTask> Scheduler::getNextTaskForRobot(const std::string&
     std::cout << "[DEBUG] Scheduler::getNextTaskForRobot for robot " << robotName << "\n";
     printTasks();
 
+    // With several pending tasks, hand them out in tour order instead of insertion order
+    if (staleTours_.count(robotName)) {
+        size_t pending = std::count_if(tasks_.begin(), tasks_.end(),
+            [&robot](const std::shared_ptr<CleaningTask>& t) {
+                return t->getRobot() == robot && t->getStatus() == "Pending";
+            });
+        if (pending > 1) {
+            planTourForRobot(robotName);
+        }
+    }
+
     // Find the first Pending task for this robot
     auto it = std::find_if(tasks_.begin(), tasks_.end(), 
         [&robot](const std::shared_ptr<CleaningTask>& t) {
@@ -46,6 +60,7 @@ std::shared_ptr<CleaningTask> Scheduler::getNextTaskForRobot(const std::string&
 
 void Scheduler::requeueTask(std::shared_ptr<CleaningTask> task) {
     tasks_.push_back(task);
+    if (task->getRobot()) staleTours_.insert(task->getRobot()->getName());
     std::cout << "[DEBUG] Scheduler::requeueTask: Requeued task " << task->getID() << "\n";
     printTasks();
 }
@@ -80,6 +95,17 @@ void Scheduler::assignCleaningTask(const std::string& robotName, int targetRoomI
     }
 
     CleaningTask::CleanType ctype = CleaningTask::stringToCleanType(strategy);
+
+    // Refuse work the robot is predicted to abort halfway through
+    if (currentRoom) {
+        EnergyModel energy(*map_);
+        auto prediction = energy.predict(currentRoom, robot->getBatteryLevel(), robot->getWaterLevel(),
+                                         selectedRoom, ctype);
+        if (prediction.reachable && !prediction.feasible) {
+            robot->recordPreemptiveAbort();
+            throw std::runtime_error("Cannot assign task: robot does not have enough battery or water to finish it.");
+        }
+    }
     auto task = std::make_shared<CleaningTask>(++taskIdCounter_, CleaningTask::MEDIUM, ctype, selectedRoom);
 
     task->assignRobot(robot);
@@ -109,10 +135,83 @@ void Scheduler::assignCleaningTask(const std::string& robotName, int targetRoomI
 }
 
 
+TourPlanner::Tour Scheduler::planTourForRobot(const std::string& robotName) {
+    auto robot = findRobotByName(robotName);
+    if (!robot) throw std::runtime_error("Robot not found.");
+
+    std::vector<size_t> slots;
+    std::vector<std::shared_ptr<CleaningTask>> batch;
+    for (size_t i = 0; i < tasks_.size(); ++i) {
+        if (tasks_[i]->getRobot() == robot && tasks_[i]->getStatus() == "Pending") {
+            slots.push_back(i);
+            batch.push_back(tasks_[i]);
+        }
+    }
+
+    TourPlanner planner(*map_);
+    TourPlanner::Tour tour = planner.planTour(*robot, batch);
+
+    // Write the tour order back into the same slots; unreachable tasks go last
+    size_t slot = 0;
+    for (const auto& stop : tour.stops) {
+        if (stop.isCharger) continue;
+        tasks_[slots[slot++]] = stop.task;
+        plannedRoutes_[stop.task->getID()] = stop.leg;
+    }
+    for (const auto& task : tour.unreachable) {
+        tasks_[slots[slot++]] = task;
+        plannedRoutes_.erase(task->getID());
+    }
+    staleTours_.erase(robotName);
+
+    std::cout << "[DEBUG] Scheduler::planTourForRobot: " << robotName << " tour of " << batch.size()
+              << " tasks, " << tour.totalHops << " hops, " << tour.chargerVisits << " charger visits\n";
+    return tour;
+}
+
+std::vector<int> Scheduler::takePlannedRoute(int taskId, int fromRoomId) {
+    auto it = plannedRoutes_.find(taskId);
+    if (it == plannedRoutes_.end()) return {};
+    std::vector<int> route = std::move(it->second);
+    plannedRoutes_.erase(it);
+    if (route.empty() || route.front() != fromRoomId) return {};
+    return route;
+}
+
+void Scheduler::onMapChanged() {
+    plannedRoutes_.clear();
+    tasks_.erase(std::remove_if(tasks_.begin(), tasks_.end(),
+        [this](const std::shared_ptr<CleaningTask>& t) {
+            Room* room = t->getRoom();
+            bool removed = room && map_->getRoomById(room->getRoomId()) != room;
+            if (removed) {
+                std::cout << "[DEBUG] Scheduler::onMapChanged: dropping task " << t->getID()
+                          << " for removed room " << room->getRoomName() << "\n";
+            }
+            return removed;
+        }), tasks_.end());
+    for (const auto& task : tasks_) {
+        if (task->getRobot()) staleTours_.insert(task->getRobot()->getName());
+    }
+}
+
 const std::vector<std::shared_ptr<CleaningTask>>& Scheduler::getAllTasks() const {
     return tasks_;
 }
 
+void Scheduler::restoreTasks(std::vector<std::shared_ptr<CleaningTask>> tasks, int lastTaskId) {
+    tasks_ = std::move(tasks);
+    taskIdCounter_ = lastTaskId;
+    plannedRoutes_.clear();
+    staleTours_.clear();
+    for (const auto& task : tasks_) {
+        // Generated tasks number from their own range
+        if (task->getID() < AutoTaskPlanner::kFirstTaskId) taskIdCounter_ = std::max(taskIdCounter_, task->getID());
+        if (task->getRobot()) staleTours_.insert(task->getRobot()->getName());
+    }
+    std::cout << "[DEBUG] Scheduler::restoreTasks: Restored " << tasks_.size() << " tasks\n";
+}
+
 void Scheduler::checkAndReturnToChargerIfNeeded(std::shared_ptr<Robot> robot) {
     if (!robot) return;
 
@@ -0,0 +1,278 @@
+#include "Checkpoint/SimulationCheckpoint.h"
+#include "RobotSimulator/RobotSimulator.hpp"
+#include "Scheduler/Scheduler.hpp"
+#include "adapter/MongoDBAdapter.hpp"
+#include "AutoTaskPlanner/AutoTaskPlanner.h"
+#include "CleaningTask/cleaningTask.h"
+#include "Robot/Robot.h"
+#include "Room/Room.h"
+#include "map/map.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+    bool isFinished(const CleaningTask& task) {
+        return task.getStatus() == "Completed" || task.getStatus() == "Failed";
+    }
+}
+
+SimulationCheckpoint SimulationCheckpoint::capture(RobotSimulator& simulator, const Scheduler* scheduler) {
+    SimulationCheckpoint checkpoint;
+    checkpoint.simTime = simulator.getSimTime();
+
+    std::unordered_map<int, size_t> taskIndex;
+    auto addTask = [&](const std::shared_ptr<CleaningTask>& task, bool queued) {
+        if (!task || isFinished(*task)) return -1;
+        auto [it, inserted] = taskIndex.emplace(task->getID(), checkpoint.tasks.size());
+        if (inserted) {
+            TaskState state;
+            state.id = task->getID();
+            state.priority = static_cast<int>(task->getPriority());
+            state.cleanType = static_cast<int>(task->getCleanType());
+            state.roomId = task->getRoom() ? task->getRoom()->getRoomId() : -1;
+            state.robot = task->getRobot() ? task->getRobot()->getName() : "";
+            checkpoint.tasks.push_back(std::move(state));
+        }
+        checkpoint.tasks[it->second].queued |= queued;
+        return task->getID();
+    };
+
+    if (scheduler) {
+        checkpoint.lastTaskId = scheduler->getLastTaskId();
+        for (const auto& task : scheduler->getAllTasks()) addTask(task, true);
+    }
+    if (auto planner = simulator.getAutoTaskPlanner()) {
+        checkpoint.nextGeneratedTaskId = planner->getNextTaskId();
+    }
+
+    const auto& robots = simulator.getRobots();
+    checkpoint.robots.reserve(robots.size());
+    for (const auto& robot : robots) {
+        RobotState state;
+        state.name = robot->getName();
+        state.size = static_cast<int>(robot->getSize());
+        state.strategy = static_cast<int>(robot->getStrategy());
+        state.batteryLevel = robot->getBatteryLevel();
+        state.waterLevel = robot->getWaterLevel();
+        state.roomId = robot->getCurrentRoom() ? robot->getCurrentRoom()->getRoomId() : -1;
+        state.charging = robot->isCharging();
+        state.failed = robot->isFailed();
+        state.errorCount = robot->getErrorCount();
+        state.totalWorkTime = robot->getTotalWorkTime();
+        state.lowBatteryAlertSent = robot->isLowBatteryAlertSent();
+        state.lowWaterAlertSent = robot->isLowWaterAlertSent();
+        state.currentTaskId = addTask(robot->getCurrentTask(), false);
+
+        auto saved = robot->getSavedTask();
+        if (robot->isCleaning() && state.currentTaskId >= 0) {
+            // The clean in progress becomes the saved task; an older one goes back in the queue
+            if (saved && saved != robot->getCurrentTask()) addTask(saved, true);
+            state.savedTaskId = state.currentTaskId;
+            state.savedCleaningTimeRemaining = robot->getCleaningTimeRemaining();
+        } else {
+            state.savedTaskId = addTask(saved, false);
+            if (state.savedTaskId >= 0) state.savedCleaningTimeRemaining = robot->getSavedCleaningTimeRemaining();
+        }
+        checkpoint.robots.push_back(std::move(state));
+    }
+
+    const auto& rooms = simulator.getMap().getRooms();
+    checkpoint.rooms.reserve(rooms.size());
+    for (const Room* room : rooms) {
+        checkpoint.rooms.push_back(RoomState{room->getRoomId(), room->isClean()});
+    }
+    return checkpoint;
+}
+
+void SimulationCheckpoint::restore(RobotSimulator& simulator, Scheduler& scheduler) const {
+    if (version != kVersion) {
+        throw std::runtime_error("Unsupported checkpoint version " + std::to_string(version));
+    }
+    const Map& map = simulator.getMap();
+    simulator.setSimTime(simTime);
+
+    for (const RoomState& state : rooms) {
+        Room* room = map.getRoomById(state.roomId);
+        if (!room) continue;
+        if (state.clean) {
+            room->markClean();
+        } else {
+            room->markDirty();
+        }
+    }
+
+    auto& fleet = simulator.getRobots();
+    fleet.clear();
+    fleet.reserve(robots.size());
+    std::unordered_map<std::string, std::shared_ptr<Robot>> byName;
+    byName.reserve(robots.size());
+    for (const RobotState& state : robots) {
+        auto robot = std::make_shared<Robot>(state.name, state.batteryLevel, static_cast<Robot::Size>(state.size),
+                                             static_cast<Robot::Strategy>(state.strategy), state.waterLevel);
+        robot->setCurrentRoom(map.getRoomById(state.roomId));
+        robot->failed_ = state.failed;
+        robot->errorCount_ = state.errorCount;
+        robot->totalWorkTime_ = state.totalWorkTime;
+        robot->setLowBatteryAlertSent(state.lowBatteryAlertSent);
+        robot->setLowWaterAlertSent(state.lowWaterAlertSent);
+        simulator.addRobot(robot);
+        byName.emplace(state.name, robot);
+    }
+
+    std::unordered_map<int, std::shared_ptr<CleaningTask>> byId;
+    byId.reserve(tasks.size());
+    std::vector<std::shared_ptr<CleaningTask>> queue;
+    std::unordered_set<int> queuedIds;
+    std::unordered_map<std::string, std::shared_ptr<CleaningTask>> firstQueued;   // by robot
+    // Generated tasks keep their own id range, so they neither move the
+    // scheduler's counter nor get generated again for the same room
+    int highestTaskId = std::min(lastTaskId, AutoTaskPlanner::kFirstTaskId - 1);
+    std::unordered_map<int, int> generated;   // room id -> task id
+    for (const TaskState& state : tasks) {
+        Room* room = map.getRoomById(state.roomId);
+        if (state.id >= AutoTaskPlanner::kFirstTaskId) {
+            if (room) generated[state.roomId] = state.id;
+        } else {
+            highestTaskId = std::max(highestTaskId, state.id);
+        }
+        if (!room) continue;
+        auto task = std::make_shared<CleaningTask>(state.id, static_cast<CleaningTask::Priority>(state.priority),
+                                                   static_cast<CleaningTask::CleanType>(state.cleanType), room);
+        auto robot = byName.find(state.robot);
+        if (robot != byName.end()) task->assignRobot(robot->second);
+        byId.emplace(state.id, task);
+        if (state.queued) {
+            queue.push_back(task);
+            queuedIds.insert(state.id);
+            if (task->getRobot()) firstQueued.emplace(state.robot, task);
+        }
+    }
+
+    auto findTask = [&byId](int id) -> std::shared_ptr<CleaningTask> {
+        auto it = byId.find(id);
+        return it == byId.end() ? nullptr : it->second;
+    };
+
+    // Robots that cannot pick their task up yet get it from the queue once they can
+    std::vector<std::pair<std::shared_ptr<Robot>, std::shared_ptr<CleaningTask>>> resume;
+    std::vector<std::shared_ptr<Robot>> toCharger;
+    std::unordered_set<int> dispatched;
+    for (const RobotState& state : robots) {
+        const auto& robot = byName[state.name];
+        auto saved = findTask(state.savedTaskId);
+        robot->restoreSavedTask(saved, state.savedCleaningTimeRemaining);
+        auto task = findTask(state.currentTaskId);
+        if (!task) task = saved;
+        if (robot->isFailed()) continue;
+
+        bool low = robot->getBatteryLevel() < 20.0 || robot->getWaterLevel() <= 0.0;
+        if (state.charging || low) {
+            // A saved task resumes on a full charge, anything else waits in the queue
+            if (task && task != saved && queuedIds.insert(task->getID()).second) {
+                queue.push_back(task);
+            }
+            toCharger.push_back(robot);
+        } else if (task) {
+            resume.emplace_back(robot, task);
+        } else if (auto next = firstQueued.find(state.name); next != firstQueued.end()) {
+            // Idle with work waiting: take the first queued task, as a dispatch would
+            resume.emplace_back(robot, next->second);
+            dispatched.insert(next->second->getID());
+        }
+    }
+
+    queue.erase(std::remove_if(queue.begin(), queue.end(),
+                               [&dispatched](const std::shared_ptr<CleaningTask>& task) {
+                                   return dispatched.count(task->getID()) > 0;
+                               }),
+                queue.end());
+    scheduler.restoreTasks(std::move(queue), highestTaskId);
+    if (auto planner = simulator.getAutoTaskPlanner()) {
+        planner->restore(nextGeneratedTaskId, generated);
+    }
+
+    for (const auto& robot : toCharger) {
+        simulator.requestReturnToCharger(robot);
+    }
+    for (const auto& [robot, task] : resume) {
+        robot->setCurrentTask(task);
+        if (robot->getCurrentRoom() == task->getRoom()) {
+            robot->startCleaning(task->getCleanType());
+        } else {
+            simulator.assignTaskToRobot(task);
+        }
+    }
+
+    std::cout << "[DEBUG] SimulationCheckpoint::restore: " << robots.size() << " robots, "
+              << tasks.size() << " tasks at t=" << simTime << "\n";
+}
+
+Checkpointer::Checkpointer(std::shared_ptr<MongoDBAdapter> dbAdapter, double intervalSeconds)
+    : dbAdapter_(dbAdapter), intervalSeconds_(intervalSeconds) {
+}
+
+Checkpointer::~Checkpointer() {
+    stop();
+}
+
+void Checkpointer::record(RobotSimulator& simulator, double now) {
+    // Small tolerance so a whole number of ticks is not skipped over rounding
+    if (lastCapture_ >= 0.0 && now - lastCapture_ < intervalSeconds_ - 1e-9) return;
+    lastCapture_ = now;
+    SimulationCheckpoint checkpoint = SimulationCheckpoint::capture(simulator, simulator.getScheduler().get());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = std::move(checkpoint);
+    }
+    ++captures_;
+    wake_.notify_all();
+}
+
+std::optional<SimulationCheckpoint> Checkpointer::takePending() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::optional<SimulationCheckpoint> checkpoint;
+    checkpoint.swap(pending_);
+    return checkpoint;
+}
+
+void Checkpointer::start() {
+    if (running_) return;
+    running_ = true;
+    thread_ = std::thread(&Checkpointer::run, this);
+}
+
+void Checkpointer::stop() {
+    if (!running_) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) thread_.join();
+    flush();
+}
+
+void Checkpointer::run() {
+    while (running_) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() { return pending_.has_value() || !running_; });
+            if (!running_) break;
+        }
+        flush();
+    }
+}
+
+void Checkpointer::flush() {
+    auto checkpoint = takePending();
+    if (!checkpoint || !dbAdapter_) return;
+    try {
+        dbAdapter_->saveCheckpoint(*checkpoint);
+        ++writes_;
+    } catch (const std::exception& e) {
+        std::cout << "[DEBUG] Checkpointer: write failed: " << e.what() << "\n";
+    }
+}
@@ -0,0 +1,210 @@
+#include "SimulationThread/SimulationThread.h"
+#include "Metrics/MetricsRegistry.h"
+#include "Scheduler/Scheduler.hpp"
+#include "Room/Room.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+SimulationThread::SimulationThread(std::shared_ptr<RobotSimulator> simulator, std::shared_ptr<Scheduler> scheduler,
+                                   double tickSeconds)
+    : simulator_(simulator), scheduler_(scheduler), tickSeconds_(tickSeconds),
+      interval_(std::chrono::milliseconds(static_cast<long>(tickSeconds * 1000.0))) {
+    if (!simulator_) {
+        throw std::runtime_error("SimulationThread needs a simulator");
+    }
+    MetricsRegistry& metrics = MetricsRegistry::global();
+    tickDuration_ = &metrics.histogram("robot_simulation_tick_seconds",
+                                       "Wall-clock time of one simulation tick, commands and publish included");
+    tickCounter_ = &metrics.counter("robot_simulation_ticks_total", "Simulation ticks run");
+    const char* depthHelp = "Commands waiting for the simulation thread";
+    postedDepth_ = &metrics.gauge("robot_simulation_command_queue_depth", depthHelp, {{"queue", "posted"}});
+    typedDepth_ = &metrics.gauge("robot_simulation_command_queue_depth", depthHelp, {{"queue", "typed"}});
+
+    commandBus_.setWakeCallback([this]() {
+        typedDepth_->set(static_cast<double>(commandBus_.pendingCount()));
+        // Taking the lock orders this wake-up after the thread's predicate check
+        { std::lock_guard<std::mutex> lock(mutex_); }
+        wake_.notify_one();
+    });
+    // Readers have a snapshot from the start
+    publish();
+}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+void SimulationThread::start() {
+    if (running_) return;
+    running_ = true;
+    thread_ = std::thread(&SimulationThread::run, this);
+}
+
+void SimulationThread::stop() {
+    if (!running_) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+void SimulationThread::post(Command command) {
+    if (!command) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        commands_.push_back(std::move(command));
+        postedDepth_->set(static_cast<double>(commands_.size()));
+    }
+    wake_.notify_one();
+}
+
+size_t SimulationThread::pendingCommands() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return commands_.size();
+}
+
+void SimulationThread::step() {
+    Histogram::Timer timer(*tickDuration_);
+    applyCommands();
+    // A failed tick is reported and the next one runs as usual, so one bad
+    // edit or command cannot end the thread
+    try {
+        simulator_->update(tickSeconds_);
+    } catch (const std::exception& e) {
+        std::cout << "[DEBUG] SimulationThread: tick failed: " << e.what() << "\n";
+    }
+    ++ticks_;
+    tickCounter_->inc();
+    publish();
+}
+
+bool SimulationThread::applyCommands() {
+    TickProfiler::Scope scope(simulator_->getProfiler(), TickProfiler::Phase::COMMANDS);
+    std::vector<Command> batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        batch.swap(commands_);
+        postedDepth_->set(0.0);
+    }
+    for (auto& command : batch) {
+        try {
+            command(*simulator_);
+        } catch (const std::exception& e) {
+            std::cout << "[DEBUG] SimulationThread: command failed: " << e.what() << "\n";
+        }
+    }
+    size_t typed = commandBus_.apply(*simulator_);
+    typedDepth_->set(static_cast<double>(commandBus_.pendingCount()));
+    return !batch.empty() || typed > 0;
+}
+
+void SimulationThread::run() {
+    auto nextTick = std::chrono::steady_clock::now() + interval_.load();
+    while (running_) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait_until(lock, nextTick, [this]() {
+                return !running_ || !commands_.empty() || commandBus_.pendingCount() > 0;
+            });
+            if (!running_) break;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (now < nextTick) {
+            // Woken early by a command: apply it now so the UI sees the result before the next tick
+            if (applyCommands()) publish();
+            continue;
+        }
+        step();
+        // After a stall, tick on from now rather than trying to catch up
+        nextTick = std::max(nextTick + interval_.load(), now);
+    }
+}
+
+void SimulationThread::publish() {
+    TickProfiler::Scope scope(simulator_->getProfiler(), TickProfiler::Phase::PUBLISH);
+    FleetSnapshot& next = snapshots_.writeBuffer();
+    const auto& robots = simulator_->getRobots();
+    uint64_t version = simulator_->collectStatusChanges();
+
+    // The slot was last filled a couple of publishes ago; refetch only rows that moved since
+    std::vector<size_t> stale;
+    if (next.robots.size() != robots.size()) {
+        next.robots.resize(robots.size());
+        stale.resize(robots.size());
+        for (size_t i = 0; i < stale.size(); ++i) stale[i] = i;
+    } else {
+        stale = simulator_->getChangedRobots(next.statusVersion);
+    }
+    for (size_t i : stale) {
+        auto& row = next.robots[i];
+        row.status = simulator_->getRobotStatus(i);
+        row.version = version;
+        row.size = robots[i]->getSize();
+        row.strategy = robots[i]->getStrategy();
+    }
+    // Positions move every tick without changing the status row
+    for (size_t i = 0; i < robots.size(); ++i) {
+        const Robot& robot = *robots[i];
+        auto& row = next.robots[i];
+        row.currentRoomId = robot.getCurrentRoom() ? robot.getCurrentRoom()->getRoomId() : -1;
+        row.nextRoomId = robot.getNextRoom() ? robot.getNextRoom()->getRoomId() : -1;
+        row.movementProgress = robot.getMovementProgress();
+        row.failed = robot.isFailed();
+    }
+
+    if (scheduler_) {
+        // Tasks keep their place in the scheduler's list, so rows are reused by position
+        const auto& tasks = scheduler_->getAllTasks();
+        size_t count = 0;
+        for (const auto& task : tasks) {
+            if (!task) continue;
+            if (count == next.tasks.size()) next.tasks.emplace_back();
+            FleetSnapshot::TaskState& state = next.tasks[count++];
+            if (state.id == task->getID() && state.version == task->getVersion()) continue;
+            state.id = task->getID();
+            state.version = task->getVersion();
+            Room* room = task->getRoom();
+            state.roomId = room ? room->getRoomId() : -1;
+            state.roomName = room ? room->getRoomName() : "";
+            state.cleanType = task->getCleanType();
+            state.robotName = task->getRobot() ? task->getRobot()->getName() : "";
+            state.status = task->getStatus();
+        }
+        next.tasks.resize(count);
+    }
+
+    next.tick = ticks_;
+    next.simTime = simulator_->getSimTime();
+    next.map = simulator_->getMapSnapshot();
+    next.previousStatusVersion = publishedStatusVersion_;
+    next.changedRobots = simulator_->getChangedRobots(publishedStatusVersion_);
+    next.statusVersion = version;
+    publishedStatusVersion_ = version;
+    updateStatusGauges(next);
+    snapshots_.publish();
+}
+
+void SimulationThread::updateStatusGauges(const FleetSnapshot& snapshot) {
+    std::map<std::string, int> robotCounts;
+    for (const auto& row : snapshot.robots) ++robotCounts[row.status.status];
+    std::map<std::string, int> taskCounts;
+    for (const auto& task : snapshot.tasks) ++taskCounts[task.status];
+
+    auto report = [](std::map<std::string, Gauge*>& gauges, const std::map<std::string, int>& counts,
+                     const char* name, const char* help) {
+        for (const auto& entry : counts) {
+            if (!gauges.count(entry.first)) {
+                gauges[entry.first] = &MetricsRegistry::global().gauge(name, help, {{"status", entry.first}});
+            }
+        }
+        for (auto& [status, gauge] : gauges) {
+            auto it = counts.find(status);
+            gauge->set(it == counts.end() ? 0.0 : it->second);
+        }
+    };
+    report(robotStatusGauges_, robotCounts, "robot_fleet_robots", "Robots by status");
+    report(taskStatusGauges_, taskCounts, "robot_fleet_tasks", "Cleaning tasks by status");
+}
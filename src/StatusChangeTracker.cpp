@@ -0,0 +1,101 @@
+#include "adapter/StatusChangeTracker.hpp"
+#include "Robot/Robot.h"
+#include "Room/Room.h"
+#include <cmath>
+#include <functional>
+
+namespace {
+    long tenths(double value) {
+        return std::lround(value * 10.0);
+    }
+
+    void combine(uint64_t& seed, uint64_t value) {
+        seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+}
+
+RobotStatusRecord RobotStatusRecord::from(const Robot& robot) {
+    RobotStatusRecord record;
+    record.name = robot.getName();
+    record.batteryLevel = robot.getBatteryLevel();
+    record.waterLevel = robot.getWaterLevel();
+    record.status = robot.getStatus();
+    record.currentRoom = robot.getCurrentRoom() ? robot.getCurrentRoom()->getRoomName() : "Unknown";
+    record.movementProgress = robot.getMovementProgress();
+    record.isCleaning = robot.isCleaning();
+    record.isCharging = robot.isCharging();
+    record.needsMaintenance = robot.needsMaintenance();
+    record.lowBatteryAlertSent = robot.isLowBatteryAlertSent();
+    record.lowWaterAlertSent = robot.isLowWaterAlertSent();
+    return record;
+}
+
+uint64_t RobotStatusRecord::hash() const {
+    uint64_t seed = 0;
+    combine(seed, static_cast<uint64_t>(tenths(batteryLevel)));
+    combine(seed, static_cast<uint64_t>(tenths(waterLevel)));
+    combine(seed, std::hash<std::string>{}(status));
+    combine(seed, std::hash<std::string>{}(currentRoom));
+    combine(seed, static_cast<uint64_t>(tenths(movementProgress)));
+    uint64_t flags = (isCleaning ? 1u : 0u) | (isCharging ? 2u : 0u) | (needsMaintenance ? 4u : 0u) |
+                     (lowBatteryAlertSent ? 8u : 0u) | (lowWaterAlertSent ? 16u : 0u);
+    combine(seed, flags);
+    return seed;
+}
+
+uint32_t RobotStatusRecord::changedFrom(const RobotStatusRecord& other) const {
+    uint32_t fields = 0;
+    if (tenths(batteryLevel) != tenths(other.batteryLevel)) fields |= BATTERY_LEVEL;
+    if (tenths(waterLevel) != tenths(other.waterLevel)) fields |= WATER_LEVEL;
+    if (status != other.status) fields |= STATUS;
+    if (currentRoom != other.currentRoom) fields |= CURRENT_ROOM;
+    if (tenths(movementProgress) != tenths(other.movementProgress)) fields |= MOVEMENT_PROGRESS;
+    if (isCleaning != other.isCleaning) fields |= IS_CLEANING;
+    if (isCharging != other.isCharging) fields |= IS_CHARGING;
+    if (needsMaintenance != other.needsMaintenance) fields |= NEEDS_MAINTENANCE;
+    if (lowBatteryAlertSent != other.lowBatteryAlertSent) fields |= LOW_BATTERY_ALERT_SENT;
+    if (lowWaterAlertSent != other.lowWaterAlertSent) fields |= LOW_WATER_ALERT_SENT;
+    return fields;
+}
+
+uint32_t StatusChangeTracker::fieldsToWrite(const RobotStatusRecord& record) {
+    auto it = written_.find(record.name);
+    if (it == written_.end()) return RobotStatusRecord::ALL_FIELDS;
+    // Equal hashes settle the common unchanged case without comparing fields
+    uint32_t fields = record.hash() == it->second.hash ? 0 : record.changedFrom(it->second.record);
+    if (fields == 0) ++stats_.skipped;
+    return fields;
+}
+
+void StatusChangeTracker::markWritten(const RobotStatusRecord& record, uint32_t fields) {
+    if (fields == 0) return;
+    auto it = written_.find(record.name);
+    if (it == written_.end()) {
+        written_.emplace(record.name, Written{record.hash(), record});
+    } else {
+        // Keep the old value of fields not sent: that is what the document still holds,
+        // so small drifts add up until they are worth a write
+        RobotStatusRecord& kept = it->second.record;
+        if (fields & RobotStatusRecord::BATTERY_LEVEL) kept.batteryLevel = record.batteryLevel;
+        if (fields & RobotStatusRecord::WATER_LEVEL) kept.waterLevel = record.waterLevel;
+        if (fields & RobotStatusRecord::STATUS) kept.status = record.status;
+        if (fields & RobotStatusRecord::CURRENT_ROOM) kept.currentRoom = record.currentRoom;
+        if (fields & RobotStatusRecord::MOVEMENT_PROGRESS) kept.movementProgress = record.movementProgress;
+        if (fields & RobotStatusRecord::IS_CLEANING) kept.isCleaning = record.isCleaning;
+        if (fields & RobotStatusRecord::IS_CHARGING) kept.isCharging = record.isCharging;
+        if (fields & RobotStatusRecord::NEEDS_MAINTENANCE) kept.needsMaintenance = record.needsMaintenance;
+        if (fields & RobotStatusRecord::LOW_BATTERY_ALERT_SENT) kept.lowBatteryAlertSent = record.lowBatteryAlertSent;
+        if (fields & RobotStatusRecord::LOW_WATER_ALERT_SENT) kept.lowWaterAlertSent = record.lowWaterAlertSent;
+        it->second.hash = kept.hash();
+    }
+    ++stats_.written;
+    for (uint32_t bits = fields; bits; bits &= bits - 1) ++stats_.fieldsWritten;
+}
+
+void StatusChangeTracker::forget(const std::string& name) {
+    written_.erase(name);
+}
+
+void StatusChangeTracker::clear() {
+    written_.clear();
+}
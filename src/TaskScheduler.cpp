@@ -13,6 +13,14 @@ void TaskScheduler::enqueueTask(std::shared_ptr<CleaningTask> task) {
               << static_cast<int>(task->getPriority()) << std::endl;
 }
 
+void TaskScheduler::enqueueTasks(const std::vector<std::shared_ptr<CleaningTask>>& tasks) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& task : tasks) {
+        taskQueue.push(task);
+    }
+    std::cout << "[TaskScheduler] Enqueued batch of " << tasks.size() << " tasks" << std::endl;
+}
+
 std::shared_ptr<CleaningTask> TaskScheduler::dequeueTask() {
     std::lock_guard<std::mutex> lock(mutex);
     if (taskQueue.empty()) {
@@ -26,6 +34,38 @@ std::shared_ptr<CleaningTask> TaskScheduler::dequeueTask() {
     return task;
 }
 
+std::shared_ptr<CleaningTask> TaskScheduler::dequeueTaskIf(const std::function<bool(const CleaningTask&)>& accept) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (taskQueue.empty() || !accept(*taskQueue.top())) {
+        return nullptr;
+    }
+
+    auto task = taskQueue.top();
+    taskQueue.pop();
+    std::cout << "[TaskScheduler] Dequeued task with priority: "
+              << static_cast<int>(task->getPriority()) << std::endl;
+    return task;
+}
+
+std::vector<std::shared_ptr<CleaningTask>> TaskScheduler::removeIf(const std::function<bool(const CleaningTask&)>& match) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::shared_ptr<CleaningTask>> removed;
+    std::vector<std::shared_ptr<CleaningTask>> kept;
+    kept.reserve(taskQueue.size());
+    while (!taskQueue.empty()) {
+        auto task = taskQueue.top();
+        taskQueue.pop();
+        (match(*task) ? removed : kept).push_back(std::move(task));
+    }
+    for (auto& task : kept) {
+        taskQueue.push(std::move(task));
+    }
+    if (!removed.empty()) {
+        std::cout << "[TaskScheduler] Removed " << removed.size() << " tasks" << std::endl;
+    }
+    return removed;
+}
+
 bool TaskScheduler::hasTasks() const {
     std::lock_guard<std::mutex> lock(mutex);
     return !taskQueue.empty();
@@ -0,0 +1,193 @@
+#include "Telemetry/TelemetryWriter.h"
+#include "RobotMetrics/MetricsAggregator.h"
+#include "adapter/MongoDBAdapter.hpp"
+#include "Robot/Robot.h"
+#include "Room/Room.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+void TelemetrySeries::append(const TelemetrySample& sample) {
+    time.push_back(sample.time);
+    battery.push_back(sample.battery);
+    water.push_back(sample.water);
+    roomId.push_back(sample.roomId);
+    state.push_back(sample.state);
+}
+
+void TelemetrySeries::appendRange(const TelemetrySeries& other, double from, double to) {
+    // Samples are in time order, so the range is one contiguous run
+    auto first = std::lower_bound(other.time.begin(), other.time.end(), from) - other.time.begin();
+    auto last = std::lower_bound(other.time.begin(), other.time.end(), to) - other.time.begin();
+    if (first >= last) return;
+    time.insert(time.end(), other.time.begin() + first, other.time.begin() + last);
+    battery.insert(battery.end(), other.battery.begin() + first, other.battery.begin() + last);
+    water.insert(water.end(), other.water.begin() + first, other.water.begin() + last);
+    roomId.insert(roomId.end(), other.roomId.begin() + first, other.roomId.begin() + last);
+    state.insert(state.end(), other.state.begin() + first, other.state.begin() + last);
+}
+
+TelemetrySample TelemetrySeries::at(size_t i) const {
+    return TelemetrySample{time[i], battery[i], water[i], roomId[i], state[i]};
+}
+
+const std::array<TelemetryWriter::Tier, TelemetryWriter::kTierCount>& TelemetryWriter::tiers() {
+    static const std::array<Tier, kTierCount> kTiers{{
+        {0, 600.0, 86400.0},
+        {60, 6 * 3600.0, 30 * 86400.0},
+        {900, 7 * 86400.0, 0.0}
+    }};
+    return kTiers;
+}
+
+int TelemetryWriter::resolutionFor(double from, double now) {
+    for (const Tier& tier : tiers()) {
+        if (tier.retentionSeconds <= 0.0 || from >= now - tier.retentionSeconds) return tier.resolution;
+    }
+    return tiers().back().resolution;
+}
+
+TelemetryWriter::TelemetryWriter(std::shared_ptr<MongoDBAdapter> dbAdapter, double sampleSeconds)
+    : dbAdapter_(dbAdapter), sampleSeconds_(sampleSeconds) {
+}
+
+TelemetryWriter::~TelemetryWriter() {
+    stop();
+}
+
+void TelemetryWriter::record(const std::vector<std::shared_ptr<Robot>>& robots, double now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& robot : robots) {
+        if (!robot) continue;
+        RobotState& entry = robots_[robot->getName()];
+        // Small tolerance so a 1s tick is not skipped over rounding
+        if (entry.lastSample >= 0.0 && now - entry.lastSample < sampleSeconds_ - 1e-9) continue;
+        TelemetrySample sample;
+        sample.time = now;
+        sample.battery = static_cast<float>(robot->getBatteryLevel());
+        sample.water = static_cast<float>(robot->getWaterLevel());
+        sample.roomId = robot->getCurrentRoom() ? robot->getCurrentRoom()->getRoomId() : -1;
+        sample.state = static_cast<uint8_t>(MetricsAggregator::stateOf(*robot));
+        entry.pending.push_back(sample);
+        entry.lastSample = now;
+        latest_ = std::max(latest_, now);
+    }
+}
+
+void TelemetryWriter::record(const std::string& robot, const TelemetrySample& sample) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RobotState& entry = robots_[robot];
+    entry.pending.push_back(sample);
+    entry.lastSample = std::max(entry.lastSample, sample.time);
+    latest_ = std::max(latest_, sample.time);
+}
+
+size_t TelemetryWriter::pendingSamples() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto& entry : robots_) count += entry.second.pending.size();
+    return count;
+}
+
+void TelemetryWriter::appendTo(std::vector<TelemetryBucket>& appends, BucketIndex& index,
+                               const std::string& robot, const Tier& tier, const TelemetrySample& point) {
+    double start = std::floor(point.time / tier.bucketSeconds) * tier.bucketSeconds;
+    auto key = std::make_tuple(robot, tier.resolution, start);
+    auto it = index.find(key);
+    if (it == index.end()) {
+        TelemetryBucket bucket;
+        bucket.robot = robot;
+        bucket.resolution = tier.resolution;
+        bucket.start = start;
+        bucket.length = tier.bucketSeconds;
+        appends.push_back(std::move(bucket));
+        it = index.emplace(key, appends.size() - 1).first;
+    }
+    appends[it->second].samples.append(point);
+}
+
+TelemetryBatch TelemetryWriter::takeBatch() {
+    TelemetryBatch batch;
+    BucketIndex index;
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto& [name, entry] : robots_) {
+        for (const TelemetrySample& sample : entry.pending) {
+            appendTo(batch.appends, index, name, tiers()[0], sample);
+            for (size_t t = 1; t < kTierCount; ++t) {
+                const Tier& tier = tiers()[t];
+                Rollup& rollup = entry.rollups[t];
+                double interval = std::floor(sample.time / tier.resolution) * tier.resolution;
+                if (rollup.open && interval != rollup.intervalStart) {
+                    // Interval finished: one averaged point stamped with its start
+                    TelemetrySample point = rollup.last;
+                    point.time = rollup.intervalStart;
+                    point.battery = static_cast<float>(rollup.battery / rollup.count);
+                    point.water = static_cast<float>(rollup.water / rollup.count);
+                    appendTo(batch.appends, index, name, tier, point);
+                    rollup = Rollup{};
+                }
+                if (!rollup.open) {
+                    rollup.open = true;
+                    rollup.intervalStart = interval;
+                }
+                ++rollup.count;
+                rollup.battery += sample.battery;
+                rollup.water += sample.water;
+                rollup.last = sample;
+            }
+        }
+        entry.pending.clear();
+    }
+
+    // Expire a tier only when its cutoff crosses a bucket edge, so deletes stay rare
+    for (size_t t = 0; t < kTierCount; ++t) {
+        const Tier& tier = tiers()[t];
+        if (tier.retentionSeconds <= 0.0) continue;
+        double cutoff = std::floor((latest_ - tier.retentionSeconds) / tier.bucketSeconds) * tier.bucketSeconds;
+        if (cutoff > expiredBefore_[t]) {
+            expiredBefore_[t] = cutoff;
+            batch.expireBefore.emplace_back(tier.resolution, cutoff);
+        }
+    }
+    return batch;
+}
+
+void TelemetryWriter::start(std::chrono::milliseconds flushInterval) {
+    if (running_) return;
+    flushInterval_ = flushInterval;
+    running_ = true;
+    thread_ = std::thread(&TelemetryWriter::run, this);
+}
+
+void TelemetryWriter::stop() {
+    if (!running_) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) thread_.join();
+    flush();
+}
+
+void TelemetryWriter::run() {
+    while (running_) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait_for(lock, flushInterval_, [this]() { return !running_; });
+            if (!running_) break;
+        }
+        flush();
+    }
+}
+
+void TelemetryWriter::flush() {
+    TelemetryBatch batch = takeBatch();
+    if (batch.empty() || !dbAdapter_) return;
+    try {
+        dbAdapter_->writeTelemetry(batch);
+    } catch (const std::exception& e) {
+        std::cout << "[DEBUG] TelemetryWriter: flush failed: " << e.what() << "\n";
+    }
+}
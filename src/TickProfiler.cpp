@@ -0,0 +1,133 @@
+#include "TickProfiler/TickProfiler.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include <nlohmann/json.hpp>
+
+size_t LatencyHistogram::bucketFor(uint64_t nanos) {
+    if (nanos < static_cast<uint64_t>(kSubBuckets)) return static_cast<size_t>(nanos);
+    int exponent = 63 - __builtin_clzll(nanos);
+    if (exponent > kMaxExponent) return kBucketCount - 1;
+    uint64_t sub = (nanos >> (exponent - kSubBucketBits)) & (kSubBuckets - 1);
+    return static_cast<size_t>(exponent - kSubBucketBits + 1) * kSubBuckets + sub;
+}
+
+uint64_t LatencyHistogram::bucketLowerBound(size_t bucket) {
+    if (bucket < static_cast<size_t>(kSubBuckets)) return bucket;
+    int exponent = static_cast<int>(bucket / kSubBuckets) + kSubBucketBits - 1;
+    uint64_t sub = bucket % kSubBuckets;
+    return (kSubBuckets + sub) << (exponent - kSubBucketBits);
+}
+
+void LatencyHistogram::record(uint64_t nanos) {
+    buckets_[bucketFor(nanos)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(nanos, std::memory_order_relaxed);
+    uint64_t seen = max_.load(std::memory_order_relaxed);
+    while (nanos > seen && !max_.compare_exchange_weak(seen, nanos, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+double LatencyHistogram::mean() const {
+    uint64_t n = count();
+    return n ? static_cast<double>(sum_.load(std::memory_order_relaxed)) / n : 0.0;
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+    // Sum the buckets rather than trusting count_, which a concurrent record may have run ahead of
+    uint64_t total = 0;
+    for (const auto& bucket : buckets_) total += bucket.load(std::memory_order_relaxed);
+    if (total == 0) return 0;
+
+    q = std::min(std::max(q, 0.0), 1.0);
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * total)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            uint64_t upper = i + 1 < kBucketCount ? bucketLowerBound(i + 1) - 1 : max();
+            return std::min(upper, max());
+        }
+    }
+    return max();
+}
+
+void TickProfiler::record(Phase phase, std::chrono::nanoseconds elapsed) {
+    if (phase == Phase::COUNT) return;
+    histograms_[static_cast<size_t>(phase)].record(static_cast<uint64_t>(std::max<int64_t>(0, elapsed.count())));
+}
+
+void TickProfiler::reset() {
+    for (auto& histogram : histograms_) histogram.reset();
+}
+
+std::vector<TickProfiler::PhaseSummary> TickProfiler::summarize() const {
+    std::vector<PhaseSummary> summaries;
+    summaries.reserve(kPhaseCount);
+    for (size_t i = 0; i < kPhaseCount; ++i) {
+        const LatencyHistogram& histogram = histograms_[i];
+        PhaseSummary summary;
+        summary.phase = phaseName(static_cast<Phase>(i));
+        summary.count = histogram.count();
+        summary.p50Micros = histogram.percentile(0.50) / 1000.0;
+        summary.p99Micros = histogram.percentile(0.99) / 1000.0;
+        summary.maxMicros = histogram.max() / 1000.0;
+        summary.meanMicros = histogram.mean() / 1000.0;
+        summaries.push_back(summary);
+    }
+    return summaries;
+}
+
+std::string TickProfiler::toJson(int indent) const {
+    nlohmann::json phases = nlohmann::json::array();
+    for (const auto& summary : summarize()) {
+        phases.push_back({
+            {"phase", summary.phase},
+            {"count", summary.count},
+            {"p50_us", summary.p50Micros},
+            {"p99_us", summary.p99Micros},
+            {"max_us", summary.maxMicros},
+            {"mean_us", summary.meanMicros}
+        });
+    }
+    nlohmann::json root = {{"enabled", isEnabled()}, {"phases", phases}};
+    return root.dump(indent);
+}
+
+void TickProfiler::dumpJson(const std::string& filename) const {
+    std::ofstream out(filename, std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to open profile file for writing: " + filename);
+    }
+    out << toJson() << "\n";
+}
+
+const char* TickProfiler::phaseName(Phase phase) {
+    switch (phase) {
+        case Phase::TICK: return "tick";
+        case Phase::MAP_UPDATES: return "map_updates";
+        case Phase::ROBOT_UPDATES: return "robot_updates";
+        case Phase::DIRT_MODEL: return "dirt_model";
+        case Phase::ANALYTICS_SAVE: return "analytics_save";
+        case Phase::RETURN_TO_CHARGER: return "return_to_charger";
+        case Phase::TASK_DISPATCH: return "task_dispatch";
+        case Phase::CHARGING_SCHEDULER: return "charging_scheduler";
+        case Phase::STATE_ALERTS: return "state_alerts";
+        case Phase::STATUS_FEED: return "status_feed";
+        case Phase::ROBOT_METRICS: return "robot_metrics";
+        case Phase::TELEMETRY: return "telemetry";
+        case Phase::CHECKPOINT: return "checkpoint";
+        case Phase::COMMANDS: return "commands";
+        case Phase::PUBLISH: return "publish";
+        case Phase::COUNT: break;
+    }
+    return "unknown";
+}
@@ -0,0 +1,183 @@
+#include "TourPlanner/TourPlanner.h"
+#include "map/map.h"
+#include "Room/Room.h"
+#include "Robot/Robot.h"
+#include "EnergyModel/EnergyModel.h"
+#include <algorithm>
+#include <climits>
+#include <queue>
+
+TourPlanner::TourPlanner(const Map& map, std::vector<int> chargerRoomIds)
+    : map_(map), chargerRoomIds_(chargerRoomIds.empty() ? map.getChargerRoomIds() : std::move(chargerRoomIds)) {}
+
+TourPlanner::DistanceRow TourPlanner::computeDistances(Room* source) const {
+    DistanceRow row;
+    std::queue<Room*> queue;
+    queue.push(source);
+    row.hops[source] = 0;
+    row.parent[source] = nullptr;
+
+    while (!queue.empty()) {
+        Room* current = queue.front();
+        queue.pop();
+        int nextHops = row.hops[current] + 1;
+
+        for (Room* neighbor : current->neighbors) {
+            // Same rule as Map::getRoute: a virtual wall blocks the edge
+            if (row.hops.count(neighbor) || map_.isVirtualWallBetween(current, neighbor)) continue;
+            row.hops[neighbor] = nextHops;
+            row.parent[neighbor] = current;
+            queue.push(neighbor);
+        }
+    }
+    return row;
+}
+
+std::vector<int> TourPlanner::buildLeg(const DistanceRow& row, Room* from, Room* to) const {
+    // The row was computed from `from`, so walk parents back from `to`
+    std::vector<int> leg;
+    for (Room* at = to; at != nullptr; at = row.parent.at(at)) {
+        leg.push_back(at->getRoomId());
+        if (at == from) break;
+    }
+    std::reverse(leg.begin(), leg.end());
+    return leg;
+}
+
+Room* TourPlanner::nearestCharger(const DistanceRow& row) const {
+    Room* best = nullptr;
+    int bestHops = INT_MAX;
+    for (int id : chargerRoomIds_) {
+        Room* charger = map_.getRoomById(id);
+        if (!charger) continue;
+        auto it = row.hops.find(charger);
+        if (it != row.hops.end() && it->second < bestHops) {
+            best = charger;
+            bestHops = it->second;
+        }
+    }
+    return best;
+}
+
+TourPlanner::Tour TourPlanner::planTour(const Robot& robot,
+                                        const std::vector<std::shared_ptr<CleaningTask>>& tasks) const {
+    return planTour(robot.getCurrentRoom(), robot.getBatteryLevel(), robot.getWaterLevel(), tasks);
+}
+
+TourPlanner::Tour TourPlanner::planTour(Room* startRoom, double batteryLevel, double waterLevel,
+                                        const std::vector<std::shared_ptr<CleaningTask>>& tasks) const {
+    Tour tour;
+    if (!startRoom) {
+        tour.unreachable = tasks;
+        return tour;
+    }
+
+    // Precompute one BFS row per distinct room we may leave from
+    std::unordered_map<Room*, DistanceRow> rows;
+    rows.emplace(startRoom, computeDistances(startRoom));
+    const DistanceRow& startRow = rows.at(startRoom);
+
+    std::vector<std::shared_ptr<CleaningTask>> pending;
+    for (const auto& task : tasks) {
+        if (!task || !task->getRoom() || !startRow.hops.count(task->getRoom())) {
+            tour.unreachable.push_back(task);
+            continue;
+        }
+        pending.push_back(task);
+        if (!rows.count(task->getRoom())) {
+            rows.emplace(task->getRoom(), computeDistances(task->getRoom()));
+        }
+    }
+    if (pending.empty()) {
+        tour.roomSequence.push_back(startRoom->getRoomId());
+        return tour;
+    }
+
+    auto dist = [&rows](Room* a, Room* b) { return rows.at(a).hops.at(b); };
+
+    // Nearest-neighbor seed
+    std::vector<size_t> order;
+    std::vector<bool> used(pending.size(), false);
+    Room* at = startRoom;
+    for (size_t step = 0; step < pending.size(); ++step) {
+        size_t best = 0;
+        int bestHops = INT_MAX;
+        for (size_t i = 0; i < pending.size(); ++i) {
+            if (used[i]) continue;
+            int d = dist(at, pending[i]->getRoom());
+            if (d < bestHops) {
+                best = i;
+                bestHops = d;
+            }
+        }
+        used[best] = true;
+        order.push_back(best);
+        at = pending[best]->getRoom();
+    }
+
+    // 2-opt on an open path anchored at the start room
+    auto roomAt = [&](size_t pos) { return pending[order[pos]]->getRoom(); };
+    bool improved = true;
+    while (improved) {
+        improved = false;
+        for (size_t i = 0; i + 1 < order.size(); ++i) {
+            Room* prev = (i == 0) ? startRoom : roomAt(i - 1);
+            for (size_t j = i + 1; j < order.size(); ++j) {
+                Room* next = (j + 1 < order.size()) ? roomAt(j + 1) : nullptr;
+                int before = dist(prev, roomAt(i)) + (next ? dist(roomAt(j), next) : 0);
+                int after = dist(prev, roomAt(j)) + (next ? dist(roomAt(i), next) : 0);
+                if (after < before) {
+                    std::reverse(order.begin() + i, order.begin() + j + 1);
+                    improved = true;
+                }
+            }
+        }
+    }
+
+    // Walk the order, inserting charger visits when the next clean would drop below the minimum
+    double battery = batteryLevel;
+    double water = waterLevel;
+    at = startRoom;
+    tour.roomSequence.push_back(startRoom->getRoomId());
+
+    auto appendLeg = [&tour](std::vector<int> leg, Stop stop) {
+        tour.totalHops += static_cast<int>(leg.size()) - 1;
+        tour.roomSequence.insert(tour.roomSequence.end(), leg.begin() + 1, leg.end());
+        stop.leg = std::move(leg);
+        tour.stops.push_back(std::move(stop));
+    };
+
+    for (size_t pos : order) {
+        const auto& task = pending[pos];
+        Room* room = task->getRoom();
+        double batteryCost = EnergyModel::cleaningBatteryCost(*room);
+        double waterCost = EnergyModel::cleaningWaterCost(*room, task->getCleanType());
+
+        if (!EnergyModel::fitsCleaning(battery, water, *room, task->getCleanType())) {
+            const DistanceRow& row = rows.at(at);
+            Room* charger = nearestCharger(row);
+            if (charger) {
+                appendLeg(buildLeg(row, at, charger), Stop{nullptr, charger->getRoomId(), true, battery, {}});
+                tour.chargerVisits++;
+                battery = 100.0;
+                water = 100.0;
+
+                // Charger to task is the reverse of the task room's path to the charger
+                std::vector<int> leg = buildLeg(rows.at(room), room, charger);
+                std::reverse(leg.begin(), leg.end());
+                appendLeg(std::move(leg), Stop{task, room->getRoomId(), false, battery, {}});
+                battery -= batteryCost;
+                water -= waterCost;
+                at = room;
+                continue;
+            }
+        }
+
+        appendLeg(buildLeg(rows.at(at), at, room), Stop{task, room->getRoomId(), false, battery, {}});
+        battery -= batteryCost;
+        water -= waterCost;
+        at = room;
+    }
+
+    return tour;
+}
@@ -0,0 +1,103 @@
+#include "ZoneDispatcher/ZoneDispatcher.h"
+#include "ZonePartition/ZonePartition.h"
+#include "Scheduler/Scheduler.hpp"
+#include "Robot/Robot.h"
+#include "Room/Room.h"
+#include <future>
+#include <iostream>
+#include <stdexcept>
+
+ZoneDispatcher::ZoneDispatcher(Map* map, std::shared_ptr<ZonePartition> zones)
+    : map_(map), zones_(zones) {
+    if (!zones_) {
+        throw std::runtime_error("ZoneDispatcher needs a zone partition");
+    }
+}
+
+ZoneDispatcher::Shard& ZoneDispatcher::shardFor(int zoneId) {
+    auto& shard = shards_[zoneId];
+    if (!shard) {
+        shard = std::make_unique<Shard>();
+        shard->scheduler = std::make_shared<Scheduler>(map_, &shard->robots);
+        shard->scheduler->setSimulator(simulator_);
+        shard->scheduler->setAlertSystem(alertSystem_);
+        shard->scheduler->setDbAdapter(dbAdapter_);
+    }
+    return *shard;
+}
+
+void ZoneDispatcher::addRobot(std::shared_ptr<Robot> robot) {
+    if (!robot) return;
+    int zoneId = zones_->zoneOf(robot->getCurrentRoom());
+    shardFor(zoneId).robots.push_back(robot);
+    homeZone_[robot->getName()] = zoneId;
+    std::cout << "[DEBUG] ZoneDispatcher: robot " << robot->getName() << " homed in zone " << zoneId << "\n";
+}
+
+void ZoneDispatcher::setSimulator(std::shared_ptr<RobotSimulator> simulator) {
+    simulator_ = simulator;
+    for (auto& entry : shards_) entry.second->scheduler->setSimulator(simulator);
+}
+
+void ZoneDispatcher::setAlertSystem(std::shared_ptr<AlertSystem> alertSystem) {
+    alertSystem_ = alertSystem;
+    for (auto& entry : shards_) entry.second->scheduler->setAlertSystem(alertSystem);
+}
+
+void ZoneDispatcher::setDbAdapter(std::shared_ptr<MongoDBAdapter> dbAdapter) {
+    dbAdapter_ = dbAdapter;
+    for (auto& entry : shards_) entry.second->scheduler->setDbAdapter(dbAdapter);
+}
+
+std::shared_ptr<Scheduler> ZoneDispatcher::getShardForZone(int zoneId) const {
+    auto it = shards_.find(zoneId);
+    return it == shards_.end() ? nullptr : it->second->scheduler;
+}
+
+std::shared_ptr<Scheduler> ZoneDispatcher::getShardForRobot(const std::string& robotName) const {
+    auto it = homeZone_.find(robotName);
+    return it == homeZone_.end() ? nullptr : getShardForZone(it->second);
+}
+
+int ZoneDispatcher::getHomeZone(const std::string& robotName) const {
+    auto it = homeZone_.find(robotName);
+    return it == homeZone_.end() ? -1 : it->second;
+}
+
+void ZoneDispatcher::addTask(std::shared_ptr<CleaningTask> task) {
+    if (!task) return;
+    int zoneId = task->getRobot() ? getHomeZone(task->getRobot()->getName()) : zones_->zoneOf(task->getRoom());
+    shardFor(zoneId).scheduler->addTask(task);
+}
+
+std::shared_ptr<CleaningTask> ZoneDispatcher::getNextTaskForRobot(const std::string& robotName) {
+    auto shard = getShardForRobot(robotName);
+    return shard ? shard->getNextTaskForRobot(robotName) : nullptr;
+}
+
+void ZoneDispatcher::requeueTask(std::shared_ptr<CleaningTask> task) {
+    if (!task) return;
+    int zoneId = task->getRobot() ? getHomeZone(task->getRobot()->getName()) : zones_->zoneOf(task->getRoom());
+    shardFor(zoneId).scheduler->requeueTask(task);
+}
+
+void ZoneDispatcher::planAllTours() {
+    std::vector<std::future<void>> workers;
+    for (auto& entry : shards_) {
+        Shard* shard = entry.second.get();
+        workers.push_back(std::async(std::launch::async, [shard]() {
+            for (const auto& robot : shard->robots) {
+                shard->scheduler->planTourForRobot(robot->getName());
+            }
+        }));
+    }
+    for (auto& worker : workers) {
+        worker.get();
+    }
+}
+
+void ZoneDispatcher::onMapChanged() {
+    for (auto& entry : shards_) {
+        entry.second->scheduler->onMapChanged();
+    }
+}
@@ -0,0 +1,184 @@
+#include "ZonePartition/ZonePartition.h"
+#include "map/map.h"
+#include "Room/Room.h"
+#include <algorithm>
+#include <queue>
+#include <unordered_set>
+
+ZonePartition::ZonePartition(const Map& map, size_t roomsPerZone) : map_(map) {
+    int nextZoneId = 0;
+    for (Room* room : map.getRooms()) {
+        int zoneId = map.getRoomZone(room->getRoomId());
+        if (zoneId < 0) continue;
+        zoneOfRoom_[room->getRoomId()] = zoneId;
+        nextZoneId = std::max(nextZoneId, zoneId + 1);
+    }
+    growZones(std::max<size_t>(1, roomsPerZone), nextZoneId);
+    buildZones();
+}
+
+bool ZonePartition::openEdge(Room* a, Room* b) const {
+    return !map_.isVirtualWallBetween(a, b);
+}
+
+void ZonePartition::growZones(size_t roomsPerZone, int firstZoneId) {
+    // Seed from the lowest unassigned id so the partition is stable between runs
+    std::vector<Room*> rooms = map_.getRooms();
+    std::sort(rooms.begin(), rooms.end(),
+              [](const Room* a, const Room* b) { return a->getRoomId() < b->getRoomId(); });
+
+    int zoneId = firstZoneId;
+    for (Room* seed : rooms) {
+        if (zoneOfRoom_.count(seed->getRoomId())) continue;
+
+        size_t size = 0;
+        std::queue<Room*> frontier;
+        frontier.push(seed);
+        zoneOfRoom_[seed->getRoomId()] = zoneId;
+        while (!frontier.empty() && size < roomsPerZone) {
+            Room* current = frontier.front();
+            frontier.pop();
+            size++;
+            for (Room* neighbor : current->neighbors) {
+                if (zoneOfRoom_.count(neighbor->getRoomId()) || !openEdge(current, neighbor)) continue;
+                if (size + frontier.size() >= roomsPerZone) break;
+                zoneOfRoom_[neighbor->getRoomId()] = zoneId;
+                frontier.push(neighbor);
+            }
+        }
+        zoneId++;
+    }
+}
+
+void ZonePartition::buildZones() {
+    for (Room* room : map_.getRooms()) {
+        zones_[zoneOf(room)].rooms.push_back(room);
+    }
+    for (auto& [zoneId, zone] : zones_) {
+        std::unordered_set<int> neighbors;
+        for (Room* room : zone.rooms) {
+            bool border = false;
+            for (Room* neighbor : room->neighbors) {
+                int other = zoneOf(neighbor);
+                if (other == zoneId || !openEdge(room, neighbor)) continue;
+                border = true;
+                neighbors.insert(other);
+            }
+            if (border) zone.borderRooms.push_back(room);
+        }
+        zone.neighborZones.assign(neighbors.begin(), neighbors.end());
+        std::sort(zone.neighborZones.begin(), zone.neighborZones.end());
+    }
+}
+
+int ZonePartition::zoneOf(int roomId) const {
+    auto it = zoneOfRoom_.find(roomId);
+    return it == zoneOfRoom_.end() ? -1 : it->second;
+}
+
+int ZonePartition::zoneOf(const Room* room) const {
+    return room ? zoneOf(room->getRoomId()) : -1;
+}
+
+std::vector<int> ZonePartition::getZoneIds() const {
+    std::vector<int> ids;
+    for (const auto& entry : zones_) ids.push_back(entry.first);
+    return ids;
+}
+
+const std::vector<Room*>& ZonePartition::getRoomsInZone(int zoneId) const {
+    static const std::vector<Room*> none;
+    auto it = zones_.find(zoneId);
+    return it == zones_.end() ? none : it->second.rooms;
+}
+
+const std::vector<Room*>& ZonePartition::getBorderRooms(int zoneId) const {
+    static const std::vector<Room*> none;
+    auto it = zones_.find(zoneId);
+    return it == zones_.end() ? none : it->second.borderRooms;
+}
+
+std::vector<int> ZonePartition::zonePath(int fromZone, int toZone) const {
+    std::unordered_map<int, int> parent;
+    std::queue<int> queue;
+    parent[fromZone] = fromZone;
+    queue.push(fromZone);
+    while (!queue.empty()) {
+        int current = queue.front();
+        queue.pop();
+        if (current == toZone) {
+            std::vector<int> path;
+            for (int z = toZone; z != fromZone; z = parent[z]) path.push_back(z);
+            path.push_back(fromZone);
+            std::reverse(path.begin(), path.end());
+            return path;
+        }
+        for (int next : zones_.at(current).neighborZones) {
+            if (parent.count(next)) continue;
+            parent[next] = current;
+            queue.push(next);
+        }
+    }
+    return {};
+}
+
+std::vector<Room*> ZonePartition::searchInZone(Room* from, int zoneId,
+                                               const std::function<bool(Room*)>& isGoal) const {
+    std::unordered_map<Room*, Room*> cameFrom;
+    std::queue<Room*> queue;
+    cameFrom[from] = nullptr;
+    queue.push(from);
+    while (!queue.empty()) {
+        Room* current = queue.front();
+        queue.pop();
+        if (isGoal(current)) {
+            std::vector<Room*> path;
+            for (Room* at = current; at != nullptr; at = cameFrom[at]) path.push_back(at);
+            std::reverse(path.begin(), path.end());
+            return path;
+        }
+        for (Room* neighbor : current->neighbors) {
+            if (cameFrom.count(neighbor) || zoneOf(neighbor) != zoneId || !openEdge(current, neighbor)) continue;
+            cameFrom[neighbor] = current;
+            queue.push(neighbor);
+        }
+    }
+    return {};
+}
+
+std::vector<int> ZonePartition::getRoute(Room& start, Room& end) const {
+    int startZone = zoneOf(&start);
+    int endZone = zoneOf(&end);
+    std::vector<int> zones = zonePath(startZone, endZone);
+    if (zones.empty()) return map_.getRoute(start, end);
+
+    std::vector<int> route;
+    Room* at = &start;
+    for (size_t i = 0; i + 1 < zones.size(); ++i) {
+        int nextZone = zones[i + 1];
+        // Walk to the nearest border room that opens into the next zone, then step across
+        auto leg = searchInZone(at, zones[i], [&](Room* room) {
+            for (Room* neighbor : room->neighbors) {
+                if (zoneOf(neighbor) == nextZone && openEdge(room, neighbor)) return true;
+            }
+            return false;
+        });
+        if (leg.empty()) return map_.getRoute(start, end);
+        for (Room* room : leg) route.push_back(room->getRoomId());
+
+        Room* border = leg.back();
+        Room* entry = nullptr;
+        for (Room* neighbor : border->neighbors) {
+            if (zoneOf(neighbor) == nextZone && openEdge(border, neighbor)) {
+                entry = neighbor;
+                break;
+            }
+        }
+        at = entry;
+    }
+
+    auto last = searchInZone(at, endZone, [&end](Room* room) { return room == &end; });
+    if (last.empty()) return map_.getRoute(start, end);
+    for (Room* room : last) route.push_back(room->getRoomId());
+    return route;
+}
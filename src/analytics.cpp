@@ -1,85 +1,95 @@
 #include "analytics/analytics.h"
-#include "adapter/MongoDBAdapter.hpp"
-#include "RobotSimulator/RobotSimulator.hpp"
-#include "Robot/Robot.h"
-#include <tuple>
+#include "RobotMetrics/MetricsAggregator.h"
+#include "RobotMetrics/robot_metrics.h"
 
 wxBEGIN_EVENT_TABLE(RobotAnalyticsPanel, wxPanel)
     EVT_BUTTON(wxID_ANY, RobotAnalyticsPanel::OnRefreshClicked)
 wxEND_EVENT_TABLE()
 
-RobotAnalyticsPanel::RobotAnalyticsPanel(wxWindow* parent, std::shared_ptr<MongoDBAdapter> dbAdapter, std::shared_ptr<RobotSimulator> simulator)
-    : wxPanel(parent), dbAdapter_(dbAdapter), simulator_(simulator) {
-    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+namespace {
+    const MetricsAggregator::Window kWindows[] = {
+        MetricsAggregator::Window::MINUTE, MetricsAggregator::Window::HOUR, MetricsAggregator::Window::DAY};
+
+    void fillRow(wxGrid* grid, int row, const wxString& name, const RobotMetrics& metrics) {
+        grid->SetCellValue(row, 0, name);
+        grid->SetCellValue(row, 1, wxString::Format("%.1f", metrics.utilization * 100.0));
+        grid->SetCellValue(row, 2, wxString::Format("%.2f", metrics.errorRate));
+        grid->SetCellValue(row, 3, wxString::Format("%.1f", metrics.timeEfficiency * 100.0));
+        grid->SetCellValue(row, 4, wxString::Format("%.1f", metrics.costEfficiency * 100.0));
+        grid->SetCellValue(row, 5, wxString::Format("%.1f", metrics.batteryUsage));
+        grid->SetCellValue(row, 6, wxString::Format("%.1f", metrics.waterUsage));
+    }
+}
 
-    analyticsGrid_ = new wxGrid(this, wxID_ANY);
-    analyticsGrid_->CreateGrid(0, 4);
-    analyticsGrid_->SetColLabelValue(0, "Robot Name");
-    analyticsGrid_->SetColLabelValue(1, "Error Count");
-    analyticsGrid_->SetColLabelValue(2, "Total Work Time (s)");
-    analyticsGrid_->SetColLabelValue(3, "Error Rate (errors/hour)");
+RobotAnalyticsPanel::RobotAnalyticsPanel(wxWindow* parent, std::shared_ptr<MetricsAggregator> aggregator)
+    : wxPanel(parent), refreshTimer_(this), aggregator_(aggregator) {
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
 
+    wxBoxSizer* controls = new wxBoxSizer(wxHORIZONTAL);
+    windowChoice_ = new wxChoice(this, wxID_ANY);
+    windowChoice_->Append("Last minute");
+    windowChoice_->Append("Last hour");
+    windowChoice_->Append("Last 24 hours");
+    windowChoice_->SetSelection(1);
     refreshBtn_ = new wxButton(this, wxID_ANY, "Refresh Analytics");
+    controls->Add(new wxStaticText(this, wxID_ANY, "Window:"), 0, wxALL|wxALIGN_CENTER_VERTICAL, 5);
+    controls->Add(windowChoice_, 0, wxALL, 5);
+    controls->Add(refreshBtn_, 0, wxALL, 5);
 
+    analyticsGrid_ = new wxGrid(this, wxID_ANY);
+    analyticsGrid_->CreateGrid(0, 7);
+    analyticsGrid_->SetColLabelValue(0, "Robot Name");
+    analyticsGrid_->SetColLabelValue(1, "Utilization (%)");
+    analyticsGrid_->SetColLabelValue(2, "Error Rate (errors/hour)");
+    analyticsGrid_->SetColLabelValue(3, "Time Cleaning vs Travelling (%)");
+    analyticsGrid_->SetColLabelValue(4, "Battery Spent Cleaning (%)");
+    analyticsGrid_->SetColLabelValue(5, "Battery Use (%/hour)");
+    analyticsGrid_->SetColLabelValue(6, "Water Use (%/hour)");
+    analyticsGrid_->EnableEditing(false);
+
+    sizer->Add(controls, 0, wxEXPAND);
     sizer->Add(analyticsGrid_, 1, wxEXPAND | wxALL, 5);
-    sizer->Add(refreshBtn_, 0, wxALL, 5);
-
     SetSizer(sizer);
+
+    windowChoice_->Bind(wxEVT_CHOICE, &RobotAnalyticsPanel::OnWindowChanged, this);
+    Bind(wxEVT_TIMER, &RobotAnalyticsPanel::OnRefreshTimer, this, refreshTimer_.GetId());
+    // Every value is a precomputed window total, so refreshing is cheap
+    refreshTimer_.Start(1000);
     RefreshAnalytics();
 }
 
-void RobotAnalyticsPanel::RefreshAnalytics() {
-    if (!dbAdapter_ || !simulator_) return;
-    auto data = dbAdapter_->retrieveRobotAnalytics(); 
-    // data: vector<tuple<string, int, double>> -> (name, errorCount, totalTime)
+RobotAnalyticsPanel::~RobotAnalyticsPanel() {
+    refreshTimer_.Stop();
+}
 
-    // Create a map for quick lookup
-    std::map<std::string, std::tuple<int,double>> analyticsMap;
-    for (auto &entry : data) {
-        std::string name;
-        int errorCount;
-        double totalTime;
-        std::tie(name, errorCount, totalTime) = entry;
-        analyticsMap[name] = std::make_tuple(errorCount, totalTime);
-    }
+void RobotAnalyticsPanel::RefreshAnalytics() {
+    if (!aggregator_) return;
+    int selection = windowChoice_->GetSelection();
+    MetricsAggregator::Window window = kWindows[selection == wxNOT_FOUND ? 1 : selection];
 
-    // Clear old rows
+    // One row per robot, then the fleet
+    int wanted = static_cast<int>(aggregator_->robotCount()) + 1;
     int rows = analyticsGrid_->GetNumberRows();
-    if (rows > 0) analyticsGrid_->DeleteRows(0, rows);
-
-    // Get the list of robots from the simulator
-    const auto& robots = simulator_->getRobots();
-
-    for (size_t i = 0; i < robots.size(); ++i) {
-        const auto& robot = robots[i];
-        if (!robot) continue;
+    if (rows < wanted) analyticsGrid_->AppendRows(wanted - rows);
+    if (rows > wanted) analyticsGrid_->DeleteRows(wanted, rows - wanted);
 
-        std::string name = robot->getName();
-        int errorCount = 0;
-        double totalTime = 0.0;
-        
-        // If we have data in the map for this robot
-        if (analyticsMap.find(name) != analyticsMap.end()) {
-            std::tie(errorCount, totalTime) = analyticsMap[name];
-        }
-
-        // Calculate error rate (errors per hour)
-        double errorRate = 0.0;
-        if (totalTime > 0) {
-            errorRate = errorCount / (totalTime / 3600.0);
-        }
-
-        analyticsGrid_->AppendRows(1);
-        int row = (int)analyticsGrid_->GetNumberRows() - 1;
-        analyticsGrid_->SetCellValue(row, 0, name);
-        analyticsGrid_->SetCellValue(row, 1, wxString::Format("%d", errorCount));
-        analyticsGrid_->SetCellValue(row, 2, wxString::Format("%.1f", totalTime));
-        analyticsGrid_->SetCellValue(row, 3, wxString::Format("%.2f", errorRate));
+    analyticsGrid_->BeginBatch();
+    for (int i = 0; i + 1 < wanted; ++i) {
+        fillRow(analyticsGrid_, i, aggregator_->robotName(i), aggregator_->robotMetrics(i, window));
     }
-
-    analyticsGrid_->AutoSize();
+    fillRow(analyticsGrid_, wanted - 1, "Fleet", aggregator_->fleetMetrics(window));
+    analyticsGrid_->EndBatch();
+    if (rows != wanted) analyticsGrid_->AutoSize();
 }
 
 void RobotAnalyticsPanel::OnRefreshClicked(wxCommandEvent& event) {
     RefreshAnalytics();
 }
+
+void RobotAnalyticsPanel::OnWindowChanged(wxCommandEvent& event) {
+    RefreshAnalytics();
+}
+
+void RobotAnalyticsPanel::OnRefreshTimer(wxTimerEvent& event) {
+    RefreshAnalytics();
+}
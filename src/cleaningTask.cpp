@@ -1,7 +1,7 @@
 #include "CleaningTask/cleaningTask.h"
 #include "Robot/Robot.h"
 #include "Room/Room.h"
-#include <iostream>
+#include "Log/DebugLog.h"
 
 CleaningTask::CleaningTask(int id, Priority priority, CleanType cleaningType, Room* room)
     : id(id), priority(priority), status("Pending"), cleaningType(cleaningType), room(room), robot(nullptr) {}
@@ -10,22 +10,26 @@ void CleaningTask::assignRobot(const std::shared_ptr<Robot>& robot) {
     this->robot = robot;
     // Keep it Pending until robot actually starts cleaning:
     status = "Pending"; 
-    std::cout << "[DEBUG] Task " << id << " assigned to " << robot->getName() << " and is now Pending.\n";
+    ++version;
+    DebugLog::out() << "[DEBUG] Task " << id << " assigned to " << robot->getName() << " and is now Pending.\n";
 }
 
 void CleaningTask::markCompleted() {
     status = "Completed";
-    std::cout << "[DEBUG] Task " << id << " marked as completed.\n";
+    ++version;
+    DebugLog::out() << "[DEBUG] Task " << id << " marked as completed.\n";
 }
 
 void CleaningTask::markFailed() {
     status = "Failed";
-    std::cout << "[DEBUG] Task " << id << " marked as failed.\n";
+    ++version;
+    DebugLog::out() << "[DEBUG] Task " << id << " marked as failed.\n";
 }
 
 void CleaningTask::setStatus(const std::string& newStatus) {
-    std::cout << "[DEBUG] Task " << id << " status changing from " << status << " to " << newStatus << "\n";
+    DebugLog::out() << "[DEBUG] Task " << id << " status changing from " << status << " to " << newStatus << "\n";
     status = newStatus;
+    ++version;
 }
 
 int CleaningTask::getID() const {
@@ -7,6 +7,7 @@
 namespace config {
     std::string ResourceConfig::resourceDir_;
     const std::string ResourceConfig::DEFAULT_MAP_NAME = "map.json";
+    const std::string ResourceConfig::COMPILED_MAP_NAME = "map.bin";
 
     bool ResourceConfig::initialize(const std::string& resourceDir) {
         if (!resourceDir.empty()) {
@@ -56,4 +57,8 @@ namespace config {
     std::string ResourceConfig::getMapPath() {
         return getResourcePath(DEFAULT_MAP_NAME);
     }
+
+    std::string ResourceConfig::getCompiledMapPath() {
+        return getResourcePath(COMPILED_MAP_NAME);
+    }
 }
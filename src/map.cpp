@@ -3,6 +3,7 @@
 #include "virtual_wall/virtual_wall.h"
 #include <iostream>
 #include <fstream>
+#include <filesystem>
 #include <nlohmann/json.hpp>
 #include <map>
 #include <algorithm>
@@ -11,25 +12,55 @@
 #include <climits> // For INT_MAX
 #include <unordered_set> // Add this line
 #include "config/ResourceConfig.hpp"
+#include "map/CompiledMap.h"
+#include "map/MapSnapshot.h"
 
 using json = nlohmann::json;
 
 Map::Map(bool loadDefaultMap) {
     if (loadDefaultMap) {
-        loadFromFile(config::ResourceConfig::getMapPath());
+        // Prefer a compiled map next to map.json unless the json has been edited since
+        std::string jsonPath = config::ResourceConfig::getMapPath();
+        std::string compiledPath = config::ResourceConfig::getCompiledMapPath();
+        std::error_code ec;
+        bool useCompiled = std::filesystem::exists(compiledPath, ec) &&
+                           std::filesystem::last_write_time(compiledPath, ec) >=
+                               std::filesystem::last_write_time(jsonPath, ec);
+        if (useCompiled) {
+            try {
+                loadFromFile(compiledPath);
+                return;
+            } catch (const std::exception& e) {
+                // Written by an older map_compiler; the json is still the source of truth
+                if (!roomMap.empty()) throw;
+                std::cout << "[DEBUG] Map: ignoring compiled map, " << e.what() << std::endl;
+            }
+        }
+        loadFromFile(jsonPath);
     }
 }
 
 Map::~Map() {
-    // Destructor implementation
+    // The arena frees the memory itself; rooms still own their name and neighbor list
     for (auto room : roomMap) {
-        delete room;
+        room->~Room();
     }
+    for (auto room : retiredRooms) {
+        room->~Room();
+    }
+}
+
+void Map::reserveRooms(size_t count) {
+    roomMap.reserve(roomMap.size() + count);
+    roomIndex.reserve(roomIndex.size() + count);
 }
 
 void Map::addRoom(const std::string& roomName, int id, const std::string& flooringType, const std::string& size, bool isRoomClean) {
-    Room* newRoom = new Room(roomName, id, flooringType, size, isRoomClean);
+    void* slot = roomArena.allocate(sizeof(Room), alignof(Room));
+    Room* newRoom = new (slot) Room(roomName, id, flooringType, size, isRoomClean);
+    newRoom->attachState(roomStates.get(), roomStates->allocateSlot(isRoomClean));
     roomMap.push_back(newRoom);
+    roomIndex.emplace(id, newRoom);   // first room with an id wins, as with the old linear scan
 }
 
 void Map::connectRooms(Room* room1, Room* room2) {
@@ -40,45 +71,234 @@ void Map::connectRooms(Room* room1, Room* room2) {
 void Map::addVirtualWall(Room* room1, Room* room2) {
     VirtualWall newVW(room1, room2);
     virtualWallMap.push_back(newVW);
+    wallSet.insert(WallKey::of(room1, room2));
+}
+
+void Map::disconnectRooms(Room* room1, Room* room2) {
+    auto& n1 = room1->neighbors;
+    auto& n2 = room2->neighbors;
+    n1.erase(std::remove(n1.begin(), n1.end(), room2), n1.end());
+    n2.erase(std::remove(n2.begin(), n2.end(), room1), n2.end());
+}
+
+void Map::removeVirtualWall(Room* room1, Room* room2) {
+    if (!wallSet.erase(WallKey::of(room1, room2))) return;
+    virtualWallMap.erase(std::remove_if(virtualWallMap.begin(), virtualWallMap.end(),
+        [room1, room2](const VirtualWall& wall) {
+            return (wall.getRoom1() == room1 && wall.getRoom2() == room2) ||
+                   (wall.getRoom1() == room2 && wall.getRoom2() == room1);
+        }), virtualWallMap.end());
+}
+
+void Map::removeRoom(int id) {
+    Room* room = getRoomById(id);
+    if (!room) return;
+
+    std::vector<Room*> neighbors = room->neighbors;
+    for (Room* neighbor : neighbors) {
+        disconnectRooms(room, neighbor);
+    }
+    std::vector<std::pair<Room*, Room*>> walls;
+    for (const auto& wall : virtualWallMap) {
+        if (wall.getRoom1() == room || wall.getRoom2() == room) {
+            walls.emplace_back(wall.getRoom1(), wall.getRoom2());
+        }
+    }
+    for (const auto& [room1, room2] : walls) {
+        removeVirtualWall(room1, room2);
+    }
+
+    roomMap.erase(std::remove(roomMap.begin(), roomMap.end(), room), roomMap.end());
+    roomIndex.erase(id);
+    roomZones.erase(id);
+    removeCharger(id);
+    retiredRooms.push_back(room);
+}
+
+void Map::addCharger(int roomId, int slots) {
+    for (auto& charger : chargers) {
+        if (charger.roomId == roomId) {
+            charger.slots = slots;
+            return;
+        }
+    }
+    chargers.push_back(ChargerSpec{roomId, slots});
+}
+
+void Map::removeCharger(int roomId) {
+    chargers.erase(std::remove_if(chargers.begin(), chargers.end(),
+                                  [roomId](const ChargerSpec& charger) { return charger.roomId == roomId; }),
+                   chargers.end());
+}
+
+namespace {
+    // Flat records collected while streaming map.json, turned into rooms afterwards
+    struct RoomRecord {
+        std::string name;
+        int id = -1;
+        std::string flooringType;
+        std::string size = "medium";
+        bool isRoomClean = false;
+        bool hasName = false;
+        bool hasId = false;
+        bool hasFlooring = false;
+        RoomPosition position;
+        bool hasX = false;
+        bool hasY = false;
+    };
+
+    struct ZoneRecord {
+        int id = -1;
+        std::vector<int> rooms;
+    };
+
+    // SAX handler for map.json. Only the shape the map format uses is tracked:
+    // a top-level object of sections, each an array of flat objects. Zone
+    // objects may hold one array of room ids.
+    class MapSaxHandler : public nlohmann::json_sax<json> {
+    public:
+        std::vector<RoomRecord> rooms;
+        std::vector<std::pair<int, int>> connections;
+        std::vector<std::pair<int, int>> virtualWalls;
+        std::vector<ChargerSpec> chargers;
+        std::vector<ZoneRecord> zones;
+        std::string error;
+
+        bool null() override { return true; }
+        bool boolean(bool val) override {
+            if (depth_ == 3 && section_ == "rooms" && key_ == "isRoomClean") room_.isRoomClean = val;
+            return true;
+        }
+        bool number_integer(number_integer_t val) override { return integer(static_cast<long long>(val)); }
+        bool number_unsigned(number_unsigned_t val) override { return integer(static_cast<long long>(val)); }
+        bool number_float(number_float_t val, const string_t&) override {
+            if (depth_ == 3 && section_ == "rooms") coordinate(static_cast<double>(val));
+            return true;
+        }
+        bool string(string_t& val) override {
+            if (depth_ == 3 && section_ == "rooms") {
+                if (key_ == "name") { room_.name = val; room_.hasName = true; }
+                else if (key_ == "flooringType") { room_.flooringType = val; room_.hasFlooring = true; }
+                else if (key_ == "size") room_.size = val;
+            }
+            return true;
+        }
+        bool binary(binary_t&) override { return true; }
+
+        bool start_object(std::size_t) override {
+            if (++depth_ == 3) {
+                room_ = RoomRecord{};
+                zone_ = ZoneRecord{};
+                ints_.clear();
+            }
+            return true;
+        }
+        bool key(string_t& val) override {
+            if (depth_ == 1) section_ = val;
+            else if (depth_ == 3) key_ = val;
+            return true;
+        }
+        bool end_object() override {
+            if (depth_ == 3 && !finishItem()) return false;
+            depth_--;
+            return true;
+        }
+        bool start_array(std::size_t) override {
+            depth_++;
+            return true;
+        }
+        bool end_array() override {
+            depth_--;
+            return true;
+        }
+        bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+            error = ex.what();
+            return false;
+        }
+
+    private:
+        int depth_ = 0;
+        std::string section_;
+        std::string key_;
+        RoomRecord room_;
+        ZoneRecord zone_;
+        std::unordered_map<std::string, int> ints_;
+
+        bool integer(long long val) {
+            int v = static_cast<int>(val);
+            if (depth_ == 3) {
+                ints_[key_] = v;
+                if (section_ == "rooms" && key_ == "id") { room_.id = v; room_.hasId = true; }
+                else if (section_ == "rooms" && key_ == "floor") room_.position.level = v;
+                else if (section_ == "rooms") coordinate(static_cast<double>(val));
+            } else if (depth_ == 4 && section_ == "zones" && key_ == "rooms") {
+                zone_.rooms.push_back(v);
+            }
+            return true;
+        }
+
+        void coordinate(double val) {
+            if (key_ == "x") { room_.position.x = val; room_.hasX = true; }
+            else if (key_ == "y") { room_.position.y = val; room_.hasY = true; }
+        }
+
+        bool require(const char* field, const char* what) {
+            if (ints_.count(field)) return true;
+            error = std::string(what) + " entry is missing \"" + field + "\"";
+            return false;
+        }
+
+        bool finishItem() {
+            if (section_ == "rooms") {
+                if (!room_.hasName || !room_.hasId || !room_.hasFlooring) {
+                    error = "room entry needs name, id and flooringType";
+                    return false;
+                }
+                rooms.push_back(room_);
+            } else if (section_ == "connections") {
+                if (!require("from", "connection") || !require("to", "connection")) return false;
+                connections.emplace_back(ints_["from"], ints_["to"]);
+            } else if (section_ == "virtualWalls") {
+                if (!require("room1", "virtual wall") || !require("room2", "virtual wall")) return false;
+                virtualWalls.emplace_back(ints_["room1"], ints_["room2"]);
+            } else if (section_ == "chargers") {
+                if (!require("roomId", "charger")) return false;
+                int slots = ints_.count("slots") ? ints_["slots"] : ChargerSpec::kUnlimitedSlots;
+                chargers.push_back(ChargerSpec{ints_["roomId"], slots});
+            } else if (section_ == "zones") {
+                if (!require("id", "zone")) return false;
+                zone_.id = ints_["id"];
+                zones.push_back(zone_);
+            }
+            return true;
+        }
+    };
 }
 
 void Map::loadFromFile(const std::string& filename) {
-    std::cout << "Opening map file: " << filename << std::endl;
-    std::ifstream file(filename);
+    if (CompiledMap::isCompiledMap(filename)) {
+        CompiledMap::load(*this, filename);
+        return;
+    }
+
+    std::ifstream file(filename, std::ios::binary);
     if (!file.is_open()) {
         throw std::runtime_error("Failed to open map file: " + filename);
     }
 
-    json j;
-    try {
-        file >> j;
-        std::cout << "JSON content loaded successfully" << std::endl;
-        
-        // Debug print JSON structure
-        std::cout << "JSON structure:" << std::endl;
-        std::cout << j.dump(2) << std::endl;
-    } catch (const json::parse_error& e) {
-        throw std::runtime_error("JSON parsing error in map file: " + std::string(e.what()));
+    // Stream the file instead of building a DOM; nothing is echoed per item
+    MapSaxHandler handler;
+    if (!json::sax_parse(file, &handler)) {
+        throw std::runtime_error("JSON parsing error in map file: " + handler.error);
     }
 
-    // Load rooms
-    std::cout << "Loading rooms..." << std::endl;
-    for (const auto& roomData : j["rooms"]) {
-        std::string size = roomData.contains("size") ? roomData["size"] : "medium";
-        std::cout << "Creating room: " << roomData["name"].get<std::string>() 
-                 << ", id: " << roomData["id"].get<int>() 
-                 << ", floor: " << roomData["flooringType"].get<std::string>() << std::endl;
-        Room* room = new Room(roomData["name"], roomData["id"], roomData["flooringType"], 
-                            size, roomData["isRoomClean"]);
-        roomMap.push_back(room);
+    reserveRooms(handler.rooms.size());
+    for (const auto& record : handler.rooms) {
+        addRoom(record.name, record.id, record.flooringType, record.size, record.isRoomClean);
+        if (record.hasX && record.hasY) roomMap.back()->setPosition(record.position);
     }
 
-    // Load connections
-    std::cout << "Loading connections..." << std::endl;
-    for (const auto& conn : j["connections"]) {
-        int fromId = conn["from"].get<int>();
-        int toId = conn["to"].get<int>();
-        std::cout << "Connecting rooms: " << fromId << " -> " << toId << std::endl;
+    for (const auto& [fromId, toId] : handler.connections) {
         Room* room1 = getRoomById(fromId);
         Room* room2 = getRoomById(toId);
         if (room1 && room2) {
@@ -86,35 +306,49 @@ void Map::loadFromFile(const std::string& filename) {
         }
     }
 
-    // Load virtual walls
-    std::cout << "Loading virtual walls..." << std::endl;
-    if (j.contains("virtualWalls")) {
-        for (const auto& vw : j["virtualWalls"]) {
-            try {
-                int room1Id = vw["room1"].get<int>();
-                int room2Id = vw["room2"].get<int>();
-                std::cout << "Adding virtual wall between rooms: " << room1Id << " -> " << room2Id << std::endl;
-                Room* room1 = getRoomById(room1Id);
-                Room* room2 = getRoomById(room2Id);
-                if (room1 && room2) {
-                    addVirtualWall(room1, room2);
-                }
-            } catch (const json::exception& e) {
-                std::cerr << "Error processing virtual wall: " << e.what() << std::endl;
-                std::cerr << "Virtual wall data: " << vw.dump() << std::endl;
-                throw;
-            }
+    for (const auto& [room1Id, room2Id] : handler.virtualWalls) {
+        Room* room1 = getRoomById(room1Id);
+        Room* room2 = getRoomById(room2Id);
+        if (room1 && room2) {
+            addVirtualWall(room1, room2);
         }
     }
-}
 
-Room* Map::getRoomById(int id) const {
-    for (auto room : roomMap) {
-        if (room->getRoomId() == id) {
-            return room;
+    for (const auto& zone : handler.zones) {
+        for (int roomId : zone.rooms) {
+            setRoomZone(roomId, zone.id);
+        }
+    }
+
+    for (const auto& charger : handler.chargers) {
+        if (!getRoomById(charger.roomId)) {
+            throw std::runtime_error("Charger declared for unknown room: " + std::to_string(charger.roomId));
         }
+        addCharger(charger.roomId, charger.slots);
+    }
+
+    publishSnapshot();
+    std::cout << "Loaded map " << filename << ": " << handler.rooms.size() << " rooms, "
+              << handler.connections.size() << " connections, " << handler.virtualWalls.size()
+              << " virtual walls" << std::endl;
+}
+
+void Map::publishSnapshot() {
+    std::atomic_store(&snapshot, MapSnapshot::capture(*this, ++snapshotVersion, roomStates));
+}
+
+std::shared_ptr<const MapSnapshot> Map::getSnapshot() const {
+    auto current = std::atomic_load(&snapshot);
+    if (!current) {
+        static const auto empty = std::make_shared<const MapSnapshot>();
+        return empty;
     }
-    return nullptr;
+    return current;
+}
+
+Room* Map::getRoomById(int id) const {
+    auto it = roomIndex.find(id);
+    return it == roomIndex.end() ? nullptr : it->second;
 }
 
 const std::vector<Room*>& Map::getRooms() const {
@@ -125,16 +359,42 @@ const std::vector<VirtualWall>& Map::getVirtualWalls() const {
     return virtualWallMap;
 }
 
-bool Map::isVirtualWallBetween(Room* room1, Room* room2) const {
-    for (const auto& vw : virtualWallMap) {
-        if ((vw.getRoom1() == room1 && vw.getRoom2() == room2) ||
-            (vw.getRoom1() == room2 && vw.getRoom2() == room1)) {
-            return true;
-        }
+std::vector<ChargerSpec> Map::getChargers() const {
+    if (chargers.empty()) {
+        return {ChargerSpec{0, ChargerSpec::kUnlimitedSlots}};
+    }
+    return chargers;
+}
+
+std::vector<int> Map::getChargerRoomIds() const {
+    std::vector<int> ids;
+    for (const auto& charger : getChargers()) {
+        ids.push_back(charger.roomId);
+    }
+    return ids;
+}
+
+bool Map::isChargerRoom(int roomId) const {
+    if (chargers.empty()) return roomId == 0;
+    for (const auto& charger : chargers) {
+        if (charger.roomId == roomId) return true;
     }
     return false;
 }
 
+void Map::setRoomZone(int roomId, int zoneId) {
+    roomZones[roomId] = zoneId;
+}
+
+int Map::getRoomZone(int roomId) const {
+    auto it = roomZones.find(roomId);
+    return it == roomZones.end() ? -1 : it->second;
+}
+
+bool Map::isVirtualWallBetween(Room* room1, Room* room2) const {
+    return !wallSet.empty() && wallSet.count(WallKey::of(room1, room2)) > 0;
+}
+
 
 // std::vector<int> Map::getRoute(Room& start, Room& end) const {
 //     // First check if there's a virtual wall between start and end rooms
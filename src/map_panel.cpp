@@ -1,155 +1,432 @@
 #include "map_panel/map_panel.hpp"
 #include <wx/dcbuffer.h>
+#include <wx/dcmemory.h>
 #include <cmath>
-#include <map>
 #include <algorithm>
 #include <iostream>
 #include "map/map.h"
+#include "MapLayout/MapLayout.h"
 #include "Room/Room.h"
-#include "Robot/Robot.h" // Include if needed for robot access
+#include "SimulationThread/SimulationThread.h"
+
+namespace {
+    const int kMargin = 50;
+    const int kRoomRadius = 20;             // map units, before zoom
+    const int kRobotRadius = kRoomRadius / 2;
+    const int kMinRoomPixels = 3;
+    const double kMinScale = 0.01;
+    const double kMaxScale = 8.0;
+    const double kLabelScale = 0.5;         // room labels are left out when zoomed further out
+
+    int circleRadiusFor(RoomSize size) {
+        if (size == RoomSize::SMALL) return kRoomRadius - 5;
+        if (size == RoomSize::LARGE) return kRoomRadius + 5;
+        return kRoomRadius;
+    }
+}
 
 wxBEGIN_EVENT_TABLE(MapPanel, wxPanel)
     EVT_PAINT(MapPanel::OnPaint)
+    EVT_SIZE(MapPanel::OnSize)
     EVT_LEFT_DOWN(MapPanel::OnMouseClick) // Capture left-click events
+    EVT_LEFT_UP(MapPanel::OnMouseUp)
+    EVT_MOTION(MapPanel::OnMouseMove)
+    EVT_MOUSEWHEEL(MapPanel::OnMouseWheel)
+    EVT_KEY_DOWN(MapPanel::OnKeyDown)
 wxEND_EVENT_TABLE()
 
-MapPanel::MapPanel(wxWindow* parent, std::shared_ptr<RobotSimulator> simulator)
-    : wxPanel(parent), simulator_(simulator) {
+MapPanel::MapPanel(wxWindow* parent, std::shared_ptr<SimulationThread> simulation)
+    : wxPanel(parent, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxTAB_TRAVERSAL | wxWANTS_CHARS),
+      simulation_(simulation) {
     SetBackgroundColour(*wxWHITE);
     SetBackgroundStyle(wxBG_STYLE_PAINT);
 }
 
-void MapPanel::OnPaint(wxPaintEvent& event) {
-    wxAutoBufferedPaintDC dc(this);
-    dc.Clear();
-
-    const Map& map = simulator_->getMap();
-    const std::vector<Room*>& rooms = map.getRooms();
-    if (rooms.empty()) return;
+void MapPanel::updateSpatialIndex(const std::shared_ptr<const MapSnapshot>& snapshot) {
+    if (snapshot == spatialSnapshot_) return;
+    spatialSnapshot_ = snapshot;
 
-    // Get panel size
-    int width, height;
-    GetClientSize(&width, &height);
+    const auto& rooms = snapshot->rooms();
+    positions_ = MapLayout::positionsFor(*snapshot);
 
-    // Determine scaling factors and layout
-    int margin = 50;
-    int drawableWidth = width - 2 * margin;
-    int drawableHeight = height - 2 * margin;
-    size_t numRooms = rooms.size();
-    if (numRooms == 0) return;
+    std::unordered_map<int, std::vector<QuadTree::Item>> itemsByLevel;
+    maxEdgeLength_ = 0.0;
+    for (size_t i = 0; i < rooms.size(); ++i) {
+        const RoomPosition& p = positions_[i];
+        itemsByLevel[p.level].push_back(QuadTree::Item{p.x, p.y, static_cast<int>(i)});
+        for (size_t j : rooms[i].neighbors) {
+            if (j <= i || positions_[j].level != p.level) continue;
+            maxEdgeLength_ = std::max(maxEdgeLength_, std::hypot(positions_[j].x - p.x, positions_[j].y - p.y));
+        }
+    }
 
-    double angleIncrement = 2 * M_PI / numRooms;
-    double radius = std::min(drawableWidth, drawableHeight) / 2 - margin;
-    int centerX = width / 2;
-    int centerY = height / 2;
+    roomIndex_.clear();
+    levels_.clear();
+    for (auto& [level, items] : itemsByLevel) {
+        levels_.push_back(level);
+        roomIndex_.emplace(level, QuadTree(std::move(items)));
+    }
+    std::sort(levels_.begin(), levels_.end());
+    if (!levels_.empty() && !roomIndex_.count(currentLevel_)) {
+        currentLevel_ = levels_.front();
+        viewFitted_ = false;
+    }
+}
 
-    // Map room IDs to positions
-    std::map<int, wxPoint> roomPositions;
-    for (size_t i = 0; i < numRooms; ++i) {
-        double angle = i * angleIncrement;
-        int x = centerX + static_cast<int>(radius * std::cos(angle));
-        int y = centerY + static_cast<int>(radius * std::sin(angle));
-        roomPositions[rooms[i]->getRoomId()] = wxPoint(x, y);
+void MapPanel::fitView() {
+    viewFitted_ = true;
+    wxSize size = GetClientSize();
+    bool any = false;
+    double minX = 0, minY = 0, maxX = 0, maxY = 0;
+    for (const auto& p : positions_) {
+        if (p.level != currentLevel_) continue;
+        minX = any ? std::min(minX, p.x) : p.x;
+        minY = any ? std::min(minY, p.y) : p.y;
+        maxX = any ? std::max(maxX, p.x) : p.x;
+        maxY = any ? std::max(maxY, p.y) : p.y;
+        any = true;
     }
+    if (!any) return;
+
+    double spanX = std::max(maxX - minX, 1.0);
+    double spanY = std::max(maxY - minY, 1.0);
+    scale_ = std::min((size.x - 2.0 * kMargin) / spanX, (size.y - 2.0 * kMargin) / spanY);
+    scale_ = std::clamp(scale_, kMinScale, 1.0);
+    offsetX_ = size.x / 2.0 - (minX + maxX) / 2.0 * scale_;
+    offsetY_ = size.y / 2.0 - (minY + maxY) / 2.0 * scale_;
+}
+
+void MapPanel::viewChanged() {
+    ++viewGeneration_;
+    Refresh();
+}
+
+QuadTree::Box MapPanel::visibleArea(double margin) const {
+    wxSize size = GetClientSize();
+    RoomPosition topLeft = toWorld(wxPoint(0, 0));
+    RoomPosition bottomRight = toWorld(wxPoint(size.x, size.y));
+    return QuadTree::Box{topLeft.x - margin, topLeft.y - margin, bottomRight.x + margin, bottomRight.y + margin};
+}
+
+wxPoint MapPanel::toScreen(const RoomPosition& position) const {
+    return wxPoint(static_cast<int>(std::lround(position.x * scale_ + offsetX_)),
+                   static_cast<int>(std::lround(position.y * scale_ + offsetY_)));
+}
+
+RoomPosition MapPanel::toWorld(const wxPoint& point) const {
+    return RoomPosition{(point.x - offsetX_) / scale_, (point.y - offsetY_) / scale_, currentLevel_};
+}
 
-    // Draw connections between rooms
+bool MapPanel::layerIsCurrent(const std::shared_ptr<const MapSnapshot>& snapshot) const {
+    return staticLayer_.IsOk() && layerSnapshot_ == snapshot && layerSize_ == GetClientSize() &&
+           layerViewGeneration_ == viewGeneration_;
+}
+
+void MapPanel::rebuildStaticLayer(const std::shared_ptr<const MapSnapshot>& snapshot) {
+    updateSpatialIndex(snapshot);
+    if (!viewFitted_) fitView();
+
+    layerSnapshot_ = snapshot;
+    layerSize_ = GetClientSize();
+    layerViewGeneration_ = viewGeneration_;
+    staticLayer_.Create(std::max(layerSize_.x, 1), std::max(layerSize_.y, 1));
+
+    wxMemoryDC dc(staticLayer_);
+    dc.SetBackground(*wxWHITE_BRUSH);
+    dc.Clear();
+
+    const auto& rooms = snapshot->rooms();
+    roomClean_.assign(rooms.size(), 0);
+    roomRects_.clear();
+    visibleRooms_.clear();
+    auto index = roomIndex_.find(currentLevel_);
+    if (index == roomIndex_.end()) return;
+
+    // Rooms just outside the view can still have an edge, circle or label inside it
+    double roomMargin = kRoomRadius + 5 + (scale_ >= kLabelScale ? 300.0 : kMinRoomPixels) / scale_;
+    QuadTree::Box roomArea = visibleArea(roomMargin);
+    std::vector<int> candidates;
+    index->second.query(visibleArea(std::max(maxEdgeLength_, roomMargin)), candidates);
+    std::vector<char> isCandidate(rooms.size(), 0);
+    for (int i : candidates) isCandidate[i] = 1;
+
+    // Draw connections between rooms on this floor
     dc.SetPen(*wxBLACK_PEN);
-    for (const Room* room : rooms) {
-        if (!room) continue;
-        wxPoint from = roomPositions[room->getRoomId()];
-        for (const Room* neighbor : room->neighbors) {
-            if (!neighbor) continue;
-            wxPoint to = roomPositions[neighbor->getRoomId()];
-            dc.DrawLine(from, to);
+    for (int i : candidates) {
+        wxPoint from = toScreen(positions_[i]);
+        for (size_t j : rooms[i].neighbors) {
+            if (positions_[j].level != currentLevel_) continue;
+            if (isCandidate[j] && j < static_cast<size_t>(i)) continue;
+            dc.DrawLine(from, toScreen(positions_[j]));
         }
     }
 
     // Draw virtual walls
     dc.SetPen(wxPen(*wxRED, 2, wxPENSTYLE_DOT));
-    const auto& virtualWalls = map.getVirtualWalls();
-    for (const auto& vw : virtualWalls) {
-        const Room* room1 = vw.getRoom1();
-        const Room* room2 = vw.getRoom2();
+    for (const auto& [room1Id, room2Id] : snapshot->virtualWalls()) {
+        const auto* room1 = snapshot->findRoom(room1Id);
+        const auto* room2 = snapshot->findRoom(room2Id);
         if (!room1 || !room2) continue;
-        
-        wxPoint from = roomPositions[room1->getRoomId()];
-        wxPoint to = roomPositions[room2->getRoomId()];
-        dc.DrawLine(from, to);
-    }
-
-    // Draw rooms
-    int roomRadius = 20;
-    for (const Room* room : rooms) {
-        if (!room) continue;
-        wxPoint pos = roomPositions[room->getRoomId()];
-        
-        // Adjust radius based on room size
-        int circleRadius = roomRadius;
-        if (room->getSize() == "small") {
-            circleRadius = roomRadius - 5;
-        } else if (room->getSize() == "large") {
-            circleRadius = roomRadius + 5;
-        }
+        size_t a = room1 - rooms.data();
+        size_t b = room2 - rooms.data();
+        if (positions_[a].level != currentLevel_ || positions_[b].level != currentLevel_) continue;
+        if (!isCandidate[a] && !isCandidate[b]) continue;
+        dc.DrawLine(toScreen(positions_[a]), toScreen(positions_[b]));
+    }
 
-        // Set brush based on cleanliness and whether it's a charger
-        if (room->getRoomId() == 0) {
-            dc.SetBrush(*wxYELLOW_BRUSH); // Charging station
-        } else if (room->isRoomClean) {
-            dc.SetBrush(*wxGREEN_BRUSH); // Clean room
+    wxRect client(wxPoint(0, 0), layerSize_);
+    for (int i : candidates) {
+        if (!roomArea.contains(positions_[i].x, positions_[i].y)) continue;
+        roomClean_[i] = snapshot->isClean(rooms[i]) ? 1 : 0;
+        drawRoom(dc, i, roomClean_[i] != 0);
+        if (roomRects_[i].Intersects(client)) {
+            visibleRooms_.push_back(i);
         } else {
-            dc.SetBrush(*wxLIGHT_GREY_BRUSH); // Dirty room
+            roomRects_.erase(i);
         }
+    }
 
-        dc.SetPen(*wxBLACK_PEN);
-        dc.DrawCircle(pos, circleRadius);
+    if (levels_.size() > 1) {
+        dc.SetTextForeground(*wxBLACK);
+        dc.DrawText(wxString::Format("Floor %d (PgUp/PgDn)", currentLevel_), 5, 5);
+    }
+    dc.SelectObject(wxNullBitmap);
+}
+
+void MapPanel::drawRoom(wxDC& dc, size_t index, bool clean) {
+    const auto& room = layerSnapshot_->rooms()[index];
+    wxPoint pos = toScreen(positions_[index]);
+    int circleRadius = std::max(kMinRoomPixels, static_cast<int>(std::lround(circleRadiusFor(room.size) * scale_)));
 
-        wxString roomLabel = wxString::Format("%s (%d)",
-            wxString::FromUTF8(room->getRoomName()), room->getRoomId());
-        dc.DrawText(roomLabel, pos.x - circleRadius, pos.y - circleRadius - 15);
+    // Set brush based on cleanliness and whether it's a charger
+    if (room.isCharger) {
+        dc.SetBrush(*wxYELLOW_BRUSH); // Charging station
+    } else if (clean) {
+        dc.SetBrush(*wxGREEN_BRUSH); // Clean room
+    } else {
+        dc.SetBrush(*wxLIGHT_GREY_BRUSH); // Dirty room
     }
+    dc.SetPen(room.id == selectedRoomId_ ? wxPen(*wxBLUE, 3) : *wxBLACK_PEN);
+    dc.DrawCircle(pos, circleRadius);
+
+    wxRect area(pos.x - circleRadius, pos.y - circleRadius, 2 * circleRadius + 1, 2 * circleRadius + 1);
+    if (scale_ >= kLabelScale) {
+        wxString roomLabel = wxString::Format("%s (%d)", wxString::FromUTF8(room.name), room.id);
+        wxPoint labelAt(pos.x - circleRadius, pos.y - circleRadius - 15);
+        dc.DrawText(roomLabel, labelAt);
+        area.Union(wxRect(labelAt, dc.GetTextExtent(roomLabel)));
+    }
+    roomRects_[index] = area.Inflate(3);
+}
 
-    // Draw robots
-    const auto& robots = simulator_->getRobots();
-    for (const auto& robot : robots) {
-        if (!robot) continue;
+bool MapPanel::robotPosition(const FleetSnapshot::RobotState& robot, wxPoint& pos) const {
+    if (robot.currentRoomId < 0 || !layerSnapshot_) return false;
+    const auto& rooms = layerSnapshot_->rooms();
+    const auto* from = layerSnapshot_->findRoom(robot.currentRoomId);
+    if (!from) return false;
+    const RoomPosition& start = positions_[from - rooms.data()];
+    if (start.level != currentLevel_) return false;
+
+    RoomPosition at = start;
+    double movementProgress = robot.movementProgress;
+    const auto* to = robot.nextRoomId >= 0 ? layerSnapshot_->findRoom(robot.nextRoomId) : nullptr;
+    if (to && movementProgress > 0.0) {
+        const RoomPosition& end = positions_[to - rooms.data()];
+        if (end.level == currentLevel_) {
+            // movementProgress is a percentage of the hop
+            double progress = movementProgress / 100.0;
+            at.x += (end.x - start.x) * progress;
+            at.y += (end.y - start.y) * progress;
+        }
+    }
+    pos = toScreen(at);
+    return true;
+}
 
-        Room* currentRoom = robot->getCurrentRoom();
-        Room* nextRoom = robot->getNextRoom();
-        if (!currentRoom) continue;
+wxRect MapPanel::robotRect(size_t index, const FleetSnapshot::RobotState& robot, const wxPoint& pos) {
+    auto label = labelSizes_.find(index);
+    if (label == labelSizes_.end()) {
+        label = labelSizes_.emplace(index, GetTextExtent(wxString::FromUTF8(robot.status.name))).first;
+    }
+    wxRect body(pos.x - kRobotRadius, pos.y - kRobotRadius, 2 * kRobotRadius + 1, 2 * kRobotRadius + 1);
+    wxRect text(wxPoint(pos.x + kRobotRadius + 5, pos.y - 5), label->second);
+    return body.Union(text).Inflate(2);
+}
 
+std::unordered_map<size_t, MapPanel::RobotOverlay> MapPanel::currentOverlays() {
+    std::unordered_map<size_t, RobotOverlay> overlays;
+    wxRect client(wxPoint(0, 0), GetClientSize());
+    const auto& robots = simulation_->latest().robots;
+    for (size_t i = 0; i < robots.size(); ++i) {
         wxPoint pos;
-        double movementProgress = robot->getMovementProgress(); // Ensure double or convert
+        if (!robotPosition(robots[i], pos)) continue;
+        wxRect rect = robotRect(i, robots[i], pos);
+        if (!rect.Intersects(client)) continue;
+        overlays[i] = RobotOverlay{rect, robots[i].failed};
+    }
+    return overlays;
+}
 
-        if (nextRoom && movementProgress > 0.0) {
-            wxPoint from = roomPositions[currentRoom->getRoomId()];
-            wxPoint to = roomPositions[nextRoom->getRoomId()];
+void MapPanel::RefreshChanged() {
+    auto snapshot = simulation_->latest().map;
+    if (!layerIsCurrent(snapshot)) {
+        Refresh();
+        return;
+    }
 
-            // movementProgress should be between 0 and 100, we normalize to [0,1]
-            double progress = movementProgress / 100.0;
-            // If your old logic used /5.0, ensure movementProgress scale is consistent.
-            // Adjust as per your logic. For now, assume movementProgress in %:
-            pos.x = from.x + static_cast<int>((to.x - from.x) * progress);
-            pos.y = from.y + static_cast<int>((to.y - from.y) * progress);
-        } else {
-            pos = roomPositions[currentRoom->getRoomId()];
+    // Cleanliness is live state, not part of the snapshot: patch only visible rooms that flipped
+    const auto& rooms = snapshot->rooms();
+    wxMemoryDC layerDC;
+    bool layerSelected = false;
+    for (size_t i : visibleRooms_) {
+        char clean = snapshot->isClean(rooms[i]) ? 1 : 0;
+        if (clean == roomClean_[i]) continue;
+        if (!layerSelected) {
+            layerDC.SelectObject(staticLayer_);
+            layerSelected = true;
         }
+        roomClean_[i] = clean;
+        drawRoom(layerDC, i, clean != 0);
+        RefreshRect(roomRects_[i], false);
+    }
+    if (layerSelected) layerDC.SelectObject(wxNullBitmap);
 
-        dc.SetBrush(*wxBLUE_BRUSH);
+    auto next = currentOverlays();
+    for (const auto& [robot, overlay] : next) {
+        auto previous = overlays_.find(robot);
+        if (previous == overlays_.end()) {
+            RefreshRect(overlay.rect, false);
+        } else if (previous->second.rect != overlay.rect || previous->second.failed != overlay.failed) {
+            RefreshRect(previous->second.rect, false);
+            RefreshRect(overlay.rect, false);
+        }
+    }
+    for (const auto& [robot, overlay] : overlays_) {
+        if (!next.count(robot)) RefreshRect(overlay.rect, false);
+    }
+    overlays_.swap(next);
+}
 
-        if (robot->isFailed()) {
-            dc.SetBrush(*wxRED_BRUSH);
-            }
+void MapPanel::OnSize(wxSizeEvent& event) {
+    Refresh();
+    event.Skip();
+}
 
-        dc.SetPen(*wxBLACK_PEN);
-        dc.DrawCircle(pos, roomRadius / 2);
+void MapPanel::OnPaint(wxPaintEvent& event) {
+    wxAutoBufferedPaintDC dc(this);
+
+    // Paint from the published snapshot so the map can change underneath us
+    auto snapshot = simulation_->latest().map;
+    if (!layerIsCurrent(snapshot)) {
+        rebuildStaticLayer(snapshot);
+        overlays_ = currentOverlays();
+    }
+
+    const wxRegion& damaged = GetUpdateRegion();
+    {
+        wxMemoryDC layerDC(staticLayer_);
+        for (wxRegionIterator it(damaged); it; ++it) {
+            wxRect area = it.GetRect();
+            dc.Blit(area.x, area.y, area.width, area.height, &layerDC, area.x, area.y);
+        }
+    }
 
-        wxString robotName = wxString::FromUTF8(robot->getName());
-        dc.DrawText(robotName, pos.x + roomRadius / 2 + 5, pos.y - 5);
+    // Robots are drawn where the latest tick left them, but only those inside the damaged area
+    const auto& robots = simulation_->latest().robots;
+    for (size_t i = 0; i < robots.size(); ++i) {
+        const auto& robot = robots[i];
+        wxPoint pos;
+        if (!robotPosition(robot, pos)) continue;
+        if (damaged.Contains(robotRect(i, robot, pos)) == wxOutRegion) continue;
+
+        dc.SetBrush(robot.failed ? *wxRED_BRUSH : *wxBLUE_BRUSH);
+        dc.SetPen(*wxBLACK_PEN);
+        dc.DrawCircle(pos, kRobotRadius);
+        dc.DrawText(wxString::FromUTF8(robot.status.name), pos.x + kRobotRadius + 5, pos.y - 5);
     }
 }
 
 void MapPanel::OnMouseClick(wxMouseEvent& event) {
+    SetFocus();
     wxPoint pos = event.GetPosition();
-    std::cout << "Mouse clicked at: " << pos.x << ", " << pos.y << std::endl;
+    dragging_ = true;
+    dragLast_ = pos;
+
+    // Hit-test against the rooms on this floor
+    int selected = -1;
+    auto index = roomIndex_.find(currentLevel_);
+    if (spatialSnapshot_ && index != roomIndex_.end()) {
+        RoomPosition at = toWorld(pos);
+        double reach = std::max(static_cast<double>(kRoomRadius + 5), kMinRoomPixels / scale_);
+        int hit = index->second.nearest(at.x, at.y, reach);
+        if (hit >= 0) {
+            const auto& room = spatialSnapshot_->rooms()[hit];
+            double radius = std::max(static_cast<double>(circleRadiusFor(room.size)), kMinRoomPixels / scale_);
+            if (std::hypot(positions_[hit].x - at.x, positions_[hit].y - at.y) <= radius) {
+                selected = room.id;
+                std::cout << "[DEBUG] MapPanel: selected room " << room.name << " (" << room.id << ")" << std::endl;
+            }
+        }
+    }
+    if (selected != selectedRoomId_) {
+        selectedRoomId_ = selected;
+        viewChanged();
+    }
+    event.Skip();
+}
+
+void MapPanel::OnMouseUp(wxMouseEvent& event) {
+    dragging_ = false;
     event.Skip();
 }
+
+void MapPanel::OnMouseMove(wxMouseEvent& event) {
+    if (!dragging_ || !event.LeftIsDown()) {
+        dragging_ = false;
+        event.Skip();
+        return;
+    }
+    wxPoint pos = event.GetPosition();
+    offsetX_ += pos.x - dragLast_.x;
+    offsetY_ += pos.y - dragLast_.y;
+    dragLast_ = pos;
+    viewChanged();
+}
+
+void MapPanel::OnMouseWheel(wxMouseEvent& event) {
+    if (event.GetWheelDelta() == 0) return;
+    // Zoom about the cursor so the point under it stays put
+    wxPoint pos = event.GetPosition();
+    RoomPosition anchor = toWorld(pos);
+    double steps = static_cast<double>(event.GetWheelRotation()) / event.GetWheelDelta();
+    scale_ = std::clamp(scale_ * std::pow(1.2, steps), kMinScale, kMaxScale);
+    offsetX_ = pos.x - anchor.x * scale_;
+    offsetY_ = pos.y - anchor.y * scale_;
+    viewChanged();
+}
+
+void MapPanel::OnKeyDown(wxKeyEvent& event) {
+    auto level = std::find(levels_.begin(), levels_.end(), currentLevel_);
+    switch (event.GetKeyCode()) {
+        case WXK_PAGEUP:
+            if (level != levels_.end() && level + 1 != levels_.end()) {
+                currentLevel_ = *(level + 1);
+                fitView();
+                viewChanged();
+            }
+            break;
+        case WXK_PAGEDOWN:
+            if (level != levels_.end() && level != levels_.begin()) {
+                currentLevel_ = *(level - 1);
+                fitView();
+                viewChanged();
+            }
+            break;
+        case WXK_HOME:
+            fitView();
+            viewChanged();
+            break;
+        default:
+            event.Skip();
+    }
+}
@@ -1,13 +1,16 @@
 #include "robot_control/robot_control_panel.hpp"
 #include "RobotSimulator/RobotSimulator.hpp"
+#include "CommandBus/CommandBus.h"
+#include "SimulationThread/SimulationThread.h"
+#include "map/MapSnapshot.h"
 #include "Scheduler/Scheduler.hpp"
 #include "Room/Room.h"
 #include "Robot/Robot.h"
 #include "alert/Alert.h"
 #include "AlertSystem/alert_system.h"
-#include "adapter/MongoDBAdapter.hpp"
 #include "RobotManagementFrame/RobotManagementFrame.hpp" // For AddAlert method and frame access
 
+#include <chrono>
 #include <ctime>
 #include <algorithm>
 #include <memory>
@@ -17,15 +20,20 @@ wxBEGIN_EVENT_TABLE(RobotControlPanel, wxPanel)
 // event table if needed
 wxEND_EVENT_TABLE()
 
-RobotControlPanel::RobotControlPanel(wxWindow* parent, std::shared_ptr<RobotSimulator> simulator, std::shared_ptr<Scheduler> scheduler)
-    : wxPanel(parent), simulator_(simulator), scheduler_(scheduler), robotChoice_(nullptr), roomChoice_(nullptr),
-      moveButton_(nullptr), pickUpButton_(nullptr) {
+RobotControlPanel::RobotControlPanel(wxWindow* parent, std::shared_ptr<SimulationThread> simulation, std::shared_ptr<Scheduler> scheduler)
+    : wxPanel(parent), simulation_(simulation), scheduler_(scheduler), robotChoice_(nullptr), roomChoice_(nullptr),
+      moveButton_(nullptr), pickUpButton_(nullptr), resultTimer_(this) {
+    // Set once at startup, so safe to keep using from the UI thread
+    alertSystem_ = simulation_->getSimulator()->getAlertSystem();
     CreateControls();
     UpdateRobotList();
     UpdateRoomList();
+    Bind(wxEVT_TIMER, &RobotControlPanel::OnResultTimer, this, resultTimer_.GetId());
 }
 
-RobotControlPanel::~RobotControlPanel() {}
+RobotControlPanel::~RobotControlPanel() {
+    resultTimer_.Stop();
+}
 
 void RobotControlPanel::CreateControls() {
     wxBoxSizer* mainSizer = new wxBoxSizer(wxVERTICAL);
@@ -72,19 +80,21 @@ void RobotControlPanel::CreateControls() {
 
 void RobotControlPanel::UpdateRobotList() {
     robotChoice_->Clear();
-    auto statuses = simulator_->getRobotStatuses();
-    for (auto& st : statuses) {
-        robotChoice_->Append(st.name);
+    for (const auto& robot : simulation_->latest().robots) {
+        robotChoice_->Append(robot.status.name);
     }
 }
 
 void RobotControlPanel::UpdateRoomList() {
     roomChoice_->Clear();
-    const auto& rooms = simulator_->getMap().getRooms();
-    for (const auto& r : rooms) {
-        if (!r) continue;
-        wxString label = wxString::Format("%s (%s)", r->getRoomName(), r->getFlooringType());
-        roomChoice_->Append(label, r);
+    roomIds_.clear();
+    const auto& snapshot = simulation_->latest().map;
+    if (snapshot) {
+        for (const auto& room : snapshot->rooms()) {
+            wxString label = wxString::Format("%s (%s)", room.name, room.flooringType);
+            roomChoice_->Append(label);
+            roomIds_.push_back(room.id);
+        }
     }
     roomChoice_->Enable(roomChoice_->GetCount() > 0);
     if (roomChoice_->GetCount() > 0) {
@@ -95,190 +105,114 @@ void RobotControlPanel::UpdateRoomList() {
 void RobotControlPanel::OnRobotSelected(wxCommandEvent& event) {
     int sel = robotChoice_->GetSelection();
     if (sel != wxNOT_FOUND) {
-        selectedRobotName_ = robotChoice_->GetString(sel).ToStdString();
+        selectedRobot_ = sel;
         roomChoice_->Enable(true);
         moveButton_->Enable(true);
         pickUpButton_->Enable(true);
     } else {
-        selectedRobotName_.clear();
+        selectedRobot_ = -1;
         roomChoice_->Enable(false);
         moveButton_->Enable(false);
         pickUpButton_->Enable(false);
     }
 }
 
-// Helper function to find a robot by name
-static std::shared_ptr<Robot> findRobotByName(const std::shared_ptr<RobotSimulator>& simulator, const std::string& robotName) {
-    const auto& robots = simulator->getRobots();
-    for (auto& r : robots) {
-        if (r->getName() == robotName) {
-            return r;
-        }
-    }
-    return nullptr;
-}
-
 // Helper: Get main frame to display alerts
 RobotManagementFrame* getMainFrame(wxWindow* wnd) {
     wxWindow* top = wxGetTopLevelParent(wnd);
     return dynamic_cast<RobotManagementFrame*>(top);
 }
 
-void RobotControlPanel::OnStartCleaning(wxCommandEvent& event) {
-    auto alertSystem = simulator_->getAlertSystem(); 
-    auto dbAdapter = simulator_->getDbAdapter(); 
-    auto frame = getMainFrame(this);
-
-    if (selectedRobotName_.empty()) {
-        if (alertSystem) alertSystem->sendAlert("No robot selected!", "Error");
-        if (dbAdapter && frame) {
-            Alert alert("Error", "No robot selected!", nullptr, nullptr, std::time(nullptr), Alert::HIGH);
-            dbAdapter->saveAlert(alert);
-            frame->AddAlert(alert);
-        }
-        return;
+void RobotControlPanel::reportAlert(const std::string& type, const std::string& message, Alert::Severity severity,
+                                    std::shared_ptr<Robot> robot, std::shared_ptr<Room> room) {
+    if (alertSystem_) alertSystem_->sendAlert(message, type);
+    // The frame stores the alert and hands it to the database thread
+    if (auto frame = getMainFrame(this)) {
+        frame->AddAlert(Alert(type, message, robot, room, std::time(nullptr), severity));
     }
+}
 
-    simulator_->startRobotCleaning(selectedRobotName_);
-    if (alertSystem) alertSystem->sendAlert("Robot started cleaning.", "Info");
-    if (dbAdapter && frame) {
-        auto robot = findRobotByName(simulator_, selectedRobotName_);
-        std::shared_ptr<Room> room = (robot && robot->getCurrentRoom()) ? std::make_shared<Room>(*robot->getCurrentRoom()) : nullptr;
-        Alert alert("Info", "Robot started cleaning.", robot, room, std::time(nullptr), Alert::LOW);
-        dbAdapter->saveAlert(alert);
-        frame->AddAlert(alert);
+bool RobotControlPanel::requireSelectedRobot() {
+    if (selectedRobot_ < 0) {
+        reportAlert("Error", "No robot selected!", Alert::HIGH);
+        return false;
     }
+    return true;
 }
 
-void RobotControlPanel::OnStopCleaning(wxCommandEvent& event) {
-    auto alertSystem = simulator_->getAlertSystem();
-    auto dbAdapter = simulator_->getDbAdapter();
-    auto frame = getMainFrame(this);
+void RobotControlPanel::submitCommand(CommandBus::CommandType type, const std::string& message, int roomId) {
+    CommandBus::Command command;
+    command.type = type;
+    command.robot = static_cast<CommandBus::RobotHandle>(selectedRobot_);
+    command.roomId = roomId;
+    auto ticket = simulation_->getCommandBus().submit(command);
+    // A repeat of a pending command is reported once, when the original runs
+    if (ticket.coalesced) return;
+    pendingCommands_.push_back({ticket.result, message});
+    if (!resultTimer_.IsRunning()) resultTimer_.Start(100);
+}
 
-    if (selectedRobotName_.empty()) {
-        if (alertSystem) alertSystem->sendAlert("No robot selected!", "Error");
-        if (dbAdapter && frame) {
-            Alert alert("Error", "No robot selected!", nullptr, nullptr, std::time(nullptr), Alert::HIGH);
-            dbAdapter->saveAlert(alert);
-            frame->AddAlert(alert);
+void RobotControlPanel::OnResultTimer(wxTimerEvent& event) {
+    auto ready = [](const PendingCommand& pending) {
+        return pending.result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    };
+    std::vector<PendingCommand> done;
+    for (auto it = pendingCommands_.begin(); it != pendingCommands_.end();) {
+        if (ready(*it)) {
+            done.push_back(std::move(*it));
+            it = pendingCommands_.erase(it);
+        } else {
+            ++it;
         }
-        return;
     }
+    if (pendingCommands_.empty()) resultTimer_.Stop();
 
-    simulator_->stopRobotCleaning(selectedRobotName_);
-    if (alertSystem) alertSystem->sendAlert("Robot stopped cleaning.", "Info");
-    if (dbAdapter && frame) {
-        auto robot = findRobotByName(simulator_, selectedRobotName_);
-        std::shared_ptr<Room> room = (robot && robot->getCurrentRoom()) ? std::make_shared<Room>(*robot->getCurrentRoom()) : nullptr;
-        Alert alert("Info", "Robot stopped cleaning.", robot, room, std::time(nullptr), Alert::LOW);
-        dbAdapter->saveAlert(alert);
-        frame->AddAlert(alert);
+    for (const auto& pending : done) {
+        const CommandBus::Result& result = pending.result.get();
+        if (result.ok) {
+            reportAlert("Info", pending.message, Alert::LOW, result.robot, result.room);
+        } else {
+            reportAlert("Error", result.error, Alert::HIGH, result.robot, result.room);
+        }
     }
 }
 
-void RobotControlPanel::OnReturnToCharger(wxCommandEvent& event) {
-    auto alertSystem = simulator_->getAlertSystem();
-    auto dbAdapter = simulator_->getDbAdapter();
-    auto frame = getMainFrame(this);
+void RobotControlPanel::OnStartCleaning(wxCommandEvent& event) {
+    if (!requireSelectedRobot()) return;
+    submitCommand(CommandBus::CommandType::START_CLEANING, "Robot started cleaning.");
+}
 
-    if (selectedRobotName_.empty()) {
-        if (alertSystem) alertSystem->sendAlert("No robot selected!", "Error");
-        if (dbAdapter && frame) {
-            Alert alert("Error", "No robot selected!", nullptr, nullptr, std::time(nullptr), Alert::HIGH);
-            dbAdapter->saveAlert(alert);
-            frame->AddAlert(alert);
-        }
-        return;
-    }
+void RobotControlPanel::OnStopCleaning(wxCommandEvent& event) {
+    if (!requireSelectedRobot()) return;
+    submitCommand(CommandBus::CommandType::STOP_CLEANING, "Robot stopped cleaning.");
+}
 
-    simulator_->requestReturnToCharger(selectedRobotName_);
-    if (alertSystem) alertSystem->sendAlert("Robot returning to charger.", "Info");
-    if (dbAdapter && frame) {
-        auto robot = findRobotByName(simulator_, selectedRobotName_);
-        std::shared_ptr<Room> room = (robot && robot->getCurrentRoom()) ? std::make_shared<Room>(*robot->getCurrentRoom()) : nullptr;
-        Alert alert("Info", "Robot returning to charger.", robot, room, std::time(nullptr), Alert::LOW);
-        dbAdapter->saveAlert(alert);
-        frame->AddAlert(alert);
-    }
+void RobotControlPanel::OnReturnToCharger(wxCommandEvent& event) {
+    if (!requireSelectedRobot()) return;
+    submitCommand(CommandBus::CommandType::RETURN_TO_CHARGER, "Robot returning to charger.");
 }
 
 void RobotControlPanel::OnMoveToRoom(wxCommandEvent& evt) {
-    auto alertSystem = simulator_->getAlertSystem();
-    auto dbAdapter = simulator_->getDbAdapter();
-    auto frame = getMainFrame(this);
-
-    if (selectedRobotName_.empty()) {
-        if (alertSystem) alertSystem->sendAlert("No robot selected!", "Error");
-        if (dbAdapter && frame) {
-            Alert alert("Error", "No robot selected!", nullptr, nullptr, std::time(nullptr), Alert::HIGH);
-            dbAdapter->saveAlert(alert);
-            frame->AddAlert(alert);
-        }
-        return;
-    }
+    if (!requireSelectedRobot()) return;
 
     int sel = roomChoice_->GetSelection();
     if (sel == wxNOT_FOUND) {
-        if (alertSystem) alertSystem->sendAlert("Please select a room.", "Error");
-        if (dbAdapter && frame) {
-            Alert alert("Error", "Please select a room.", nullptr, nullptr, std::time(nullptr), Alert::HIGH);
-            dbAdapter->saveAlert(alert);
-            frame->AddAlert(alert);
-        }
+        reportAlert("Error", "Please select a room.", Alert::HIGH);
         return;
     }
 
-    Room* targetRoom = reinterpret_cast<Room*>(roomChoice_->GetClientData(sel));
+    const auto& snapshot = simulation_->latest().map;
+    const MapSnapshot::RoomView* targetRoom =
+        (snapshot && static_cast<size_t>(sel) < roomIds_.size()) ? snapshot->findRoom(roomIds_[sel]) : nullptr;
     if (!targetRoom) {
-        if (alertSystem) alertSystem->sendAlert("Invalid room selection.", "Error");
-        if (dbAdapter && frame) {
-            Alert alert("Error", "Invalid room selection.", nullptr, nullptr, std::time(nullptr), Alert::HIGH);
-            dbAdapter->saveAlert(alert);
-            frame->AddAlert(alert);
-        }
+        reportAlert("Error", "Invalid room selection.", Alert::HIGH);
         return;
     }
 
-    simulator_->moveRobotToRoom(selectedRobotName_, targetRoom->getRoomId());
-    if (alertSystem) alertSystem->sendAlert("Robot moving to " + targetRoom->getRoomName(), "Info");
-    if (dbAdapter && frame) {
-        auto robot = findRobotByName(simulator_, selectedRobotName_);
-        std::shared_ptr<Room> room = std::make_shared<Room>(*targetRoom);
-        Alert alert("Info", "Robot moving to " + targetRoom->getRoomName(), robot, room, std::time(nullptr), Alert::LOW);
-        dbAdapter->saveAlert(alert);
-        frame->AddAlert(alert);
-    }
+    submitCommand(CommandBus::CommandType::MOVE_TO_ROOM, "Robot moving to " + targetRoom->name, targetRoom->id);
 }
 
 void RobotControlPanel::OnPickUpRobot(wxCommandEvent& event) {
-    auto alertSystem = simulator_->getAlertSystem();
-    auto dbAdapter = simulator_->getDbAdapter();
-    auto frame = getMainFrame(this);
-
-    if (selectedRobotName_.empty()) {
-        if (alertSystem) alertSystem->sendAlert("No robot selected!", "Error");
-        if (dbAdapter && frame) {
-            Alert alert("Error", "No robot selected!", nullptr, nullptr, std::time(nullptr), Alert::HIGH);
-            dbAdapter->saveAlert(alert);
-            frame->AddAlert(alert);
-        }
-        return;
-    }
-
-    simulator_->manuallyPickUpRobot(selectedRobotName_);
-
-    // Find the robot
-    auto robot = findRobotByName(simulator_, selectedRobotName_);
-    if (robot) {
-        // Mark the robot as repaired
-        robot->repair();  // We'll add this method in Robot class
-    }
-
-    if (alertSystem) alertSystem->sendAlert("Robot picked up, repaired, and moved instantly to charger.", "Info");
-    if (dbAdapter && frame) {
-        std::shared_ptr<Room> room = (robot && robot->getCurrentRoom()) ? std::make_shared<Room>(*robot->getCurrentRoom()) : nullptr;
-        Alert alert("Info", "Robot picked up, repaired, and moved instantly to charger.", robot, room, std::time(nullptr), Alert::LOW);
-        dbAdapter->saveAlert(alert);
-        frame->AddAlert(alert);
-    }
+    if (!requireSelectedRobot()) return;
+    submitCommand(CommandBus::CommandType::PICK_UP, "Robot picked up, repaired, and moved instantly to charger.");
 }
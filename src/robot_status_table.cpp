@@ -0,0 +1,94 @@
+#include "robot_status_table/robot_status_table.hpp"
+#include "SimulationThread/SimulationThread.h"
+
+namespace {
+    const double kLowLevel = 20.0;
+}
+
+RobotStatusTable::RobotStatusTable(std::shared_ptr<SimulationThread> simulation)
+    : simulation_(simulation), lowAttr_(new wxGridCellAttr), okAttr_(new wxGridCellAttr) {
+    lowAttr_->SetBackgroundColour(wxColour(255, 200, 200));
+    okAttr_->SetBackgroundColour(wxColour(200, 255, 200));
+    lowAttr_->SetReadOnly();
+    okAttr_->SetReadOnly();
+
+    const FleetSnapshot& fleet = simulation_->latest();
+    rows_ = static_cast<int>(fleet.robots.size());
+    seenVersion_ = fleet.statusVersion;
+}
+
+RobotStatusTable::~RobotStatusTable() {
+    lowAttr_->DecRef();
+    okAttr_->DecRef();
+}
+
+wxString RobotStatusTable::GetValue(int row, int col) {
+    const auto& robots = simulation_->latest().robots;
+    if (row < 0 || static_cast<size_t>(row) >= robots.size()) return wxEmptyString;
+    const auto& status = robots[row].status;
+    switch (col) {
+        case NAME:    return status.name;
+        case BATTERY: return wxString::Format("%.1f%%", status.batteryLevel);
+        case WATER:   return wxString::Format("%.1f%%", status.waterLevel);
+        case STATUS:  return status.status;
+        case ROOM:    return status.currentRoomName;
+        default:      return wxEmptyString;
+    }
+}
+
+wxString RobotStatusTable::GetColLabelValue(int col) {
+    switch (col) {
+        case NAME:    return "Robot Name";
+        case BATTERY: return "Battery Level";
+        case WATER:   return "Water Level";
+        case STATUS:  return "Status";
+        case ROOM:    return "Current Room";
+        default:      return wxEmptyString;
+    }
+}
+
+wxGridCellAttr* RobotStatusTable::GetAttr(int row, int col, wxGridCellAttr::wxAttrKind kind) {
+    const auto& robots = simulation_->latest().robots;
+    if (row < 0 || static_cast<size_t>(row) >= robots.size() || (col != BATTERY && col != WATER)) return nullptr;
+    const auto& status = robots[row].status;
+    double level = col == BATTERY ? status.batteryLevel : status.waterLevel;
+    wxGridCellAttr* attr = level < kLowLevel ? lowAttr_ : okAttr_;
+    // The grid releases the attribute after drawing the cell
+    attr->IncRef();
+    return attr;
+}
+
+void RobotStatusTable::resizeRows(wxGrid* grid, int count) {
+    if (count > rows_) {
+        wxGridTableMessage msg(this, wxGRIDTABLE_NOTIFY_ROWS_APPENDED, count - rows_);
+        rows_ = count;
+        grid->ProcessTableMessage(msg);
+    } else if (count < rows_) {
+        wxGridTableMessage msg(this, wxGRIDTABLE_NOTIFY_ROWS_DELETED, count, rows_ - count);
+        rows_ = count;
+        grid->ProcessTableMessage(msg);
+    }
+}
+
+void RobotStatusTable::refreshRow(wxGrid* grid, size_t row) {
+    if (row >= static_cast<size_t>(rows_)) return;
+    int r = static_cast<int>(row);
+    wxRect rect = grid->BlockToDeviceRect(wxGridCellCoords(r, 0), wxGridCellCoords(r, COLUMN_COUNT - 1));
+    if (!rect.IsEmpty()) grid->GetGridWindow()->RefreshRect(rect, false);
+}
+
+void RobotStatusTable::Sync(wxGrid* grid) {
+    const FleetSnapshot& fleet = simulation_->latest();
+    resizeRows(grid, static_cast<int>(fleet.robots.size()));
+    if (fleet.statusVersion == seenVersion_) return;
+
+    if (fleet.previousStatusVersion == seenVersion_) {
+        for (size_t row : fleet.changedRobots) refreshRow(grid, row);
+    } else {
+        // Missed a snapshot in between: fall back to the per-row versions
+        for (size_t row = 0; row < fleet.robots.size(); ++row) {
+            if (fleet.robots[row].version > seenVersion_) refreshRow(grid, row);
+        }
+    }
+    seenVersion_ = fleet.statusVersion;
+}
@@ -1,12 +1,14 @@
 #include "scheduler_panel/scheduler_panel.hpp"
 #include "CleaningTask/cleaningTask.h"
+#include "CleaningRules/CleaningRules.h"
 #include "Robot/Robot.h"
-#include "RobotSimulator/RobotSimulator.hpp"
+#include "SimulationThread/SimulationThread.h"
 #include "Scheduler/Scheduler.hpp"
 #include "Room/Room.h"
 #include "AlertSystem/alert_system.h"
 #include "adapter/MongoDBAdapter.hpp"
 #include "map/map.h"
+#include "map/MapSnapshot.h"
 
 #include <wx/msgdlg.h>
 #include <wx/button.h>
@@ -29,12 +31,12 @@ wxBEGIN_EVENT_TABLE(SchedulerPanel, wxPanel)
 wxEND_EVENT_TABLE()
 
 SchedulerPanel::SchedulerPanel(wxWindow* parent,
-                               std::shared_ptr<RobotSimulator> simulator,
+                               std::shared_ptr<SimulationThread> simulation,
                                std::shared_ptr<Scheduler> scheduler,
                                std::shared_ptr<AlertSystem> alertSystem,
                                std::shared_ptr<MongoDBAdapter> dbAdapter)
     : wxPanel(parent),
-      simulator_(simulator),
+      simulation_(simulation),
       scheduler_(scheduler),
       alertSystem_(alertSystem),
       dbAdapter_(dbAdapter),
@@ -79,12 +81,7 @@ void SchedulerPanel::CreateControls() {
     sizer->Add(robotChoice_, 0, wxEXPAND | wxALL, 5);
     sizer->Add(assignTaskBtn_, 0, wxEXPAND | wxALL, 5);
 
-    taskListCtrl_ = new wxListCtrl(this, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxLC_REPORT);
-    taskListCtrl_->InsertColumn(0, "Task ID");
-    taskListCtrl_->InsertColumn(1, "Room");
-    taskListCtrl_->InsertColumn(2, "Strategy");
-    taskListCtrl_->InsertColumn(3, "Robot");
-    taskListCtrl_->InsertColumn(4, "Status");
+    taskListCtrl_ = new TaskListCtrl(this);
 
     sizer->Add(taskListCtrl_, 1, wxEXPAND | wxALL, 5);
 
@@ -98,7 +95,7 @@ void SchedulerPanel::BindEvents() {
 }
 
 void SchedulerPanel::UpdateRoomList() {
-    if (!simulator_) return;
+    if (!simulation_) return;
 
     int currentSelection = roomChoice_->GetSelection();
     wxString currentSelectionString;
@@ -106,12 +103,13 @@ void SchedulerPanel::UpdateRoomList() {
         currentSelectionString = roomChoice_->GetString(currentSelection);
     }
 
-    std::vector<std::pair<wxString, void*>> newRoomList;
-    const auto& rooms = simulator_->getMap().getRooms();
-    for (const auto& room : rooms) {
-        if (room && !room->isRoomClean) {
-            wxString roomChoiceLabel = wxString::Format("%s (%s)", room->getRoomName(), room->getSize());
-            newRoomList.emplace_back(roomChoiceLabel, reinterpret_cast<void*>(room));
+    std::vector<std::pair<wxString, int>> newRoomList;
+    auto snapshot = simulation_->latest().map;
+    if (!snapshot) return;
+    for (const auto& room : snapshot->rooms()) {
+        if (!snapshot->isClean(room)) {
+            wxString roomChoiceLabel = wxString::Format("%s (%s)", room.name, room.sizeLabel);
+            newRoomList.emplace_back(roomChoiceLabel, room.id);
         }
     }
 
@@ -120,7 +118,7 @@ void SchedulerPanel::UpdateRoomList() {
         needUpdate = true;
     } else {
         for (size_t i = 0; i < newRoomList.size(); ++i) {
-            if (newRoomList[i].first != roomChoice_->GetString(i)) {
+            if (newRoomList[i].first != roomChoice_->GetString(i) || newRoomList[i].second != roomIds_[i]) {
                 needUpdate = true;
                 break;
             }
@@ -129,8 +127,10 @@ void SchedulerPanel::UpdateRoomList() {
 
     if (needUpdate) {
         roomChoice_->Clear();
+        roomIds_.clear();
         for (const auto& roomEntry : newRoomList) {
-            roomChoice_->Append(roomEntry.first, roomEntry.second);
+            roomChoice_->Append(roomEntry.first);
+            roomIds_.push_back(roomEntry.second);
         }
 
         int newSelectionIndex = roomChoice_->FindString(currentSelectionString);
@@ -146,27 +146,28 @@ void SchedulerPanel::UpdateRoomList() {
     UpdateRoomSelection();
 }
 
-void SchedulerPanel::UpdateRoomSelection() {
+const MapSnapshot::RoomView* SchedulerPanel::selectedRoom() const {
     int sel = roomChoice_->GetSelection();
-    if (sel == wxNOT_FOUND) {
-        // No room selected, clear robot list
-        robotChoice_->Clear();
-        robotChoice_->Enable(false);
-        return;
-    }
+    if (sel == wxNOT_FOUND || static_cast<size_t>(sel) >= roomIds_.size()) return nullptr;
+    const auto& snapshot = simulation_->latest().map;
+    return snapshot ? snapshot->findRoom(roomIds_[sel]) : nullptr;
+}
 
-    Room* selectedRoom = reinterpret_cast<Room*>(roomChoice_->GetClientData(sel));
-    if (!selectedRoom) {
+void SchedulerPanel::UpdateRoomSelection() {
+    const MapSnapshot::RoomView* room = selectedRoom();
+    if (!room) {
+        // No room selected, clear robot list
         robotChoice_->Clear();
+        robotRows_.clear();
         robotChoice_->Enable(false);
         return;
     }
 
     // Update the robot list based on the selected room
-    UpdateRobotListForRoom(selectedRoom);
+    UpdateRobotListForRoom(*room);
 }
 
-void SchedulerPanel::UpdateRobotListForRoom(Room* room) {
+void SchedulerPanel::UpdateRobotListForRoom(const MapSnapshot::RoomView& room) {
     // Store the currently selected robot if any
     wxString currentlySelected;
     int currentSelection = robotChoice_->GetSelection();
@@ -175,22 +176,18 @@ void SchedulerPanel::UpdateRobotListForRoom(Room* room) {
     }
 
     robotChoice_->Clear();
-    if (!room || !simulator_) {
-        robotChoice_->Enable(false);
-        return;
-    }
-
-    auto suitableRobots = findSuitableRobotsForRoom(room);
+    robotRows_ = findSuitableRobotsForRoom(room);
 
-    if (suitableRobots.empty()) {
-        std::cout << "[DEBUG] No suitable robots found for " << room->getRoomName() << ".\n";
+    if (robotRows_.empty()) {
+        std::cout << "[DEBUG] No suitable robots found for " << room.name << ".\n";
         robotChoice_->Enable(false);
         return;
     }
 
     // Populate the robot list
-    for (auto& robot : suitableRobots) {
-        robotChoice_->Append(wxString::FromUTF8(robot->getName()), robot.get());
+    const auto& robots = simulation_->latest().robots;
+    for (size_t row : robotRows_) {
+        robotChoice_->Append(wxString::FromUTF8(robots[row].status.name));
     }
 
     robotChoice_->Enable(true);
@@ -214,50 +211,13 @@ void SchedulerPanel::UpdateRobotListForRoom(Room* room) {
     robotChoice_->Layout();
 }
 
-std::shared_ptr<Robot> SchedulerPanel::findSuitableRobotForRoom(Room* room) {
-    // This method is no longer needed directly since we now return a vector.
-    // Keep it if you still use it elsewhere, or remove if not needed.
-    auto robots = findSuitableRobotsForRoom(room);
-    if (!robots.empty()) return robots.front();
-    return nullptr;
-}
-
-std::vector<std::shared_ptr<Robot>> SchedulerPanel::findSuitableRobotsForRoom(Room* room) {
-    std::vector<std::shared_ptr<Robot>> result;
-    if (!room || !simulator_) return result;
-
-    std::string floorType = room->getFlooringType();
-    std::transform(floorType.begin(), floorType.end(), floorType.begin(), ::tolower);
-
-    bool carpet = (floorType == "carpet");
-    bool hardFloor = (floorType == "wood" || floorType == "tile" || floorType == "hardwood");
-
-    std::vector<Robot::Strategy> acceptableStrategies;
-    if (carpet) {
-        acceptableStrategies = {Robot::Strategy::VACUUM, Robot::Strategy::SHAMPOO};
-    } else if (hardFloor) {
-        acceptableStrategies = {Robot::Strategy::VACUUM, Robot::Strategy::SCRUB};
-    } else {
-        acceptableStrategies = {Robot::Strategy::VACUUM};
-    }
-
-    std::string roomSize = room->getSize();
-    std::transform(roomSize.begin(), roomSize.end(), roomSize.begin(), ::tolower);
-
-    Robot::Size neededSize;
-    if (roomSize == "small") {
-        neededSize = Robot::Size::SMALL;
-    } else if (roomSize == "medium") {
-        neededSize = Robot::Size::MEDIUM;
-    } else {
-        neededSize = Robot::Size::LARGE;
-    }
-
-    auto& allRobots = simulator_->getRobots();
-    for (auto& r : allRobots) {
-        if (!r->isFailed() && r->getSize() == neededSize && 
-            std::find(acceptableStrategies.begin(), acceptableStrategies.end(), r->getStrategy()) != acceptableStrategies.end()) {
-            result.push_back(r);
+std::vector<size_t> SchedulerPanel::findSuitableRobotsForRoom(const MapSnapshot::RoomView& room) const {
+    std::vector<size_t> result;
+    const auto& robots = simulation_->latest().robots;
+    for (size_t i = 0; i < robots.size(); ++i) {
+        const auto& r = robots[i];
+        if (!r.failed && CleaningRules::canClean(r.size, r.strategy, room.size, room.floor)) {
+            result.push_back(i);
         }
     }
 
@@ -282,37 +242,41 @@ void SchedulerPanel::OnAssignTask(wxCommandEvent& event) {
         return;
     }
 
-    Room* selectedRoom = reinterpret_cast<Room*>(roomChoice_->GetClientData(roomChoice_->GetSelection()));
+    const MapSnapshot::RoomView* selectedRoom = this->selectedRoom();
     if (!selectedRoom) {
         if (alertSystem_) alertSystem_->sendAlert("Invalid room selection.", "Error");
         wxMessageBox("Invalid room selection.", "Error", wxOK|wxICON_ERROR);
         return;
     }
 
-    Robot* selectedRobot = reinterpret_cast<Robot*>(robotChoice_->GetClientData(robotChoice_->GetSelection()));
-    if (!selectedRobot) {
+    int robotSel = robotChoice_->GetSelection();
+    const auto& robots = simulation_->latest().robots;
+    if (static_cast<size_t>(robotSel) >= robotRows_.size() || robotRows_[robotSel] >= robots.size()) {
         if (alertSystem_) alertSystem_->sendAlert("Invalid robot selection.", "Error");
         wxMessageBox("Invalid robot selection.", "Error", wxOK|wxICON_ERROR);
         return;
     }
+    const auto& selectedRobot = robots[robotRows_[robotSel]];
 
     // Determine cleaning type from the robot's strategy
-    CleaningTask::CleanType ctype;
-    switch (selectedRobot->getStrategy()) {
-        case Robot::Strategy::VACUUM: ctype = CleaningTask::VACUUM; break;
-        case Robot::Strategy::SCRUB: ctype = CleaningTask::SCRUB; break;
-        case Robot::Strategy::SHAMPOO: ctype = CleaningTask::SHAMPOO; break;
-    }
-
-    try {
-        scheduler_->assignCleaningTask(selectedRobot->getName(), selectedRoom->getRoomId(), cleanTypeToString(ctype));
-    } catch (const std::exception& e) {
-        if (alertSystem_) alertSystem_->sendAlert(std::string("Assignment Error: ") + e.what(), "Error");
-        wxMessageBox(e.what(), "Assignment Error", wxOK|wxICON_ERROR);
-        return;
-    }
-
-    UpdateTaskList();
+    CleaningTask::CleanType ctype = CleaningRules::cleanTypeFor(selectedRobot.strategy);
+
+    // The scheduler belongs to the simulation thread; the task shows up in the list with the next snapshot
+    auto scheduler = scheduler_;
+    auto alertSystem = alertSystem_;
+    std::string robotName = selectedRobot.status.name;
+    int roomId = selectedRoom->id;
+    simulation_->post([this, scheduler, alertSystem, robotName, roomId, ctype](RobotSimulator&) {
+        try {
+            scheduler->assignCleaningTask(robotName, roomId, cleanTypeToString(ctype));
+        } catch (const std::exception& e) {
+            if (alertSystem) alertSystem->sendAlert(std::string("Assignment Error: ") + e.what(), "Error");
+            std::string message = e.what();
+            CallAfter([message]() {
+                wxMessageBox(message, "Assignment Error", wxOK|wxICON_ERROR);
+            });
+        }
+    });
 }
 
 void SchedulerPanel::OnTimer(wxTimerEvent& event) {
@@ -321,30 +285,41 @@ void SchedulerPanel::OnTimer(wxTimerEvent& event) {
 }
 
 void SchedulerPanel::UpdateTaskList() {
-    taskListCtrl_->DeleteAllItems();
-
-    const auto& tasks = scheduler_->getAllTasks();
-    int index = 0;
-    for (const auto& task : tasks) {
-        if (!task) continue;
-        long itemIndex = taskListCtrl_->InsertItem(index, wxString::Format("%d", task->getID()));
+    taskListCtrl_->Sync(simulation_->latest().tasks);
+}
 
-        Room* room = task->getRoom();
-        if (room) {
-            taskListCtrl_->SetItem(itemIndex, 1, wxString::FromUTF8(room->getRoomName()));
-        } else {
-            taskListCtrl_->SetItem(itemIndex, 1, "Unknown Room");
-        }
+TaskListCtrl::TaskListCtrl(wxWindow* parent)
+    : wxListCtrl(parent, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxLC_REPORT | wxLC_VIRTUAL) {
+    InsertColumn(0, "Task ID");
+    InsertColumn(1, "Room");
+    InsertColumn(2, "Strategy");
+    InsertColumn(3, "Robot");
+    InsertColumn(4, "Status");
+}
 
-        taskListCtrl_->SetItem(itemIndex, 2, wxString::FromUTF8(cleanTypeToString(task->getCleanType())));
+void TaskListCtrl::Sync(const std::vector<FleetSnapshot::TaskState>& tasks) {
+    bool resized = tasks.size() != rows_.size();
+    rows_.resize(tasks.size());
+
+    for (size_t index = 0; index < tasks.size(); ++index) {
+        const auto& task = tasks[index];
+        Row& row = rows_[index];
+        if (row.id == task.id && row.version == task.version) continue;
+        row.id = task.id;
+        row.version = task.version;
+        row.cells[0] = wxString::Format("%d", task.id);
+        row.cells[1] = task.roomId >= 0 ? wxString::FromUTF8(task.roomName) : wxString("Unknown Room");
+        row.cells[2] = wxString::FromUTF8(cleanTypeToString(task.cleanType));
+        row.cells[3] = task.robotName.empty() ? wxString("Unassigned") : wxString::FromUTF8(task.robotName);
+        row.cells[4] = wxString::FromUTF8(task.status);
+        if (!resized) RefreshItem(static_cast<long>(index));
+    }
 
-        if (auto robot = task->getRobot()) {
-            taskListCtrl_->SetItem(itemIndex, 3, wxString::FromUTF8(robot->getName()));
-        } else {
-            taskListCtrl_->SetItem(itemIndex, 3, "Unassigned");
-        }
+    // A new item count repaints the whole visible page anyway
+    if (resized) SetItemCount(static_cast<long>(tasks.size()));
+}
 
-        taskListCtrl_->SetItem(itemIndex, 4, wxString::FromUTF8(task->getStatus()));
-        index++;
-    }
+wxString TaskListCtrl::OnGetItemText(long item, long column) const {
+    if (item < 0 || static_cast<size_t>(item) >= rows_.size() || column < 0 || column >= 5) return wxEmptyString;
+    return rows_[item].cells[column];
 }
@@ -0,0 +1,77 @@
+#include "tick_profile_panel/tick_profile_panel.hpp"
+#include "SimulationThread/SimulationThread.h"
+#include "RobotSimulator/RobotSimulator.hpp"
+#include "TickProfiler/TickProfiler.h"
+#include <wx/filedlg.h>
+#include <exception>
+
+TickProfilePanel::TickProfilePanel(wxWindow* parent, std::shared_ptr<SimulationThread> simulation)
+    : wxPanel(parent), simulation_(simulation), enableBox_(nullptr), phaseList_(nullptr) {
+    wxStaticBoxSizer* sizer = new wxStaticBoxSizer(wxVERTICAL, this, "Tick Profile");
+
+    wxBoxSizer* controls = new wxBoxSizer(wxHORIZONTAL);
+    enableBox_ = new wxCheckBox(this, wxID_ANY, "Profile ticks");
+    enableBox_->SetValue(simulation_->getSimulator()->getProfiler().isEnabled());
+    wxButton* resetBtn = new wxButton(this, wxID_ANY, "Reset");
+    wxButton* saveBtn = new wxButton(this, wxID_ANY, "Save JSON...");
+    controls->Add(enableBox_, 0, wxALL|wxALIGN_CENTER_VERTICAL, 5);
+    controls->Add(resetBtn, 0, wxALL, 5);
+    controls->Add(saveBtn, 0, wxALL, 5);
+
+    phaseList_ = new wxListCtrl(this, wxID_ANY, wxDefaultPosition, wxSize(-1, 200), wxLC_REPORT | wxLC_SINGLE_SEL);
+    phaseList_->InsertColumn(0, "Phase", wxLIST_FORMAT_LEFT, 160);
+    phaseList_->InsertColumn(1, "Count", wxLIST_FORMAT_RIGHT, 80);
+    phaseList_->InsertColumn(2, "p50 (us)", wxLIST_FORMAT_RIGHT, 90);
+    phaseList_->InsertColumn(3, "p99 (us)", wxLIST_FORMAT_RIGHT, 90);
+    phaseList_->InsertColumn(4, "Max (us)", wxLIST_FORMAT_RIGHT, 90);
+    phaseList_->InsertColumn(5, "Mean (us)", wxLIST_FORMAT_RIGHT, 90);
+
+    enableBox_->Bind(wxEVT_CHECKBOX, &TickProfilePanel::OnToggle, this);
+    resetBtn->Bind(wxEVT_BUTTON, &TickProfilePanel::OnReset, this);
+    saveBtn->Bind(wxEVT_BUTTON, &TickProfilePanel::OnSave, this);
+
+    sizer->Add(controls, 0, wxEXPAND);
+    sizer->Add(phaseList_, 1, wxEXPAND|wxALL, 5);
+    SetSizer(sizer);
+    UpdateProfile();
+}
+
+void TickProfilePanel::UpdateProfile() {
+    // The histograms are atomics, so reading them here never stalls the simulation thread
+    auto summaries = simulation_->getSimulator()->getProfiler().summarize();
+    if (phaseList_->GetItemCount() != static_cast<int>(summaries.size())) {
+        phaseList_->DeleteAllItems();
+        for (size_t i = 0; i < summaries.size(); ++i) {
+            phaseList_->InsertItem(static_cast<long>(i), summaries[i].phase);
+        }
+    }
+    for (size_t i = 0; i < summaries.size(); ++i) {
+        const auto& summary = summaries[i];
+        long row = static_cast<long>(i);
+        phaseList_->SetItem(row, 1, wxString::Format("%llu", static_cast<unsigned long long>(summary.count)));
+        phaseList_->SetItem(row, 2, wxString::Format("%.1f", summary.p50Micros));
+        phaseList_->SetItem(row, 3, wxString::Format("%.1f", summary.p99Micros));
+        phaseList_->SetItem(row, 4, wxString::Format("%.1f", summary.maxMicros));
+        phaseList_->SetItem(row, 5, wxString::Format("%.1f", summary.meanMicros));
+    }
+}
+
+void TickProfilePanel::OnToggle(wxCommandEvent& event) {
+    simulation_->getSimulator()->getProfiler().setEnabled(enableBox_->GetValue());
+}
+
+void TickProfilePanel::OnReset(wxCommandEvent& event) {
+    simulation_->getSimulator()->getProfiler().reset();
+    UpdateProfile();
+}
+
+void TickProfilePanel::OnSave(wxCommandEvent& event) {
+    wxFileDialog dialog(this, "Save tick profile", "", "tick_profile.json", "JSON files (*.json)|*.json",
+                        wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    if (dialog.ShowModal() != wxID_OK) return;
+    try {
+        simulation_->getSimulator()->getProfiler().dumpJson(dialog.GetPath().ToStdString());
+    } catch (const std::exception& e) {
+        wxMessageBox(e.what(), "Error", wxOK | wxICON_ERROR);
+    }
+}
@@ -0,0 +1,197 @@
+#include <catch2/catch_test_macros.hpp>
+#include "AutoTaskPlanner/AutoTaskPlanner.h"
+#include "CleaningRules/CleaningRules.h"
+#include "CleaningTask/cleaningTask.h"
+#include "Robot/Robot.h"
+#include "map/map.h"
+#include "Room/Room.h"
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+    struct Collector {
+        std::vector<std::shared_ptr<CleaningTask>> tasks;
+        int batches = 0;
+        AutoTaskPlanner::Sink sink() {
+            return [this](const std::vector<std::shared_ptr<CleaningTask>>& batch) {
+                tasks.insert(tasks.end(), batch.begin(), batch.end());
+                batches++;
+            };
+        }
+    };
+
+    // Room 0 is the charger; 1 carpet, 2 tile, 3 other are dirty, 4 wood is clean
+    std::shared_ptr<Map> buildMap() {
+        auto map = std::make_shared<Map>();
+        map->addRoom("Charging Station", 0, "tile", "small", false);
+        map->addRoom("Lounge", 1, "carpet", "medium", false);
+        map->addRoom("Kitchen", 2, "tile", "small", false);
+        map->addRoom("Garage", 3, "concrete", "large", false);
+        map->addRoom("Study", 4, "wood", "small", true);
+        map->addCharger(0, 1);
+        map->publishSnapshot();
+        return map;
+    }
+}
+
+TEST_CASE("Cleaning Rules", "[rules]") {
+    CHECK(CleaningRules::cleanTypeFor(FloorType::CARPET) == CleaningTask::SHAMPOO);
+    CHECK(CleaningRules::cleanTypeFor(FloorType::TILE) == CleaningTask::SCRUB);
+    CHECK(CleaningRules::cleanTypeFor(FloorType::HARDWOOD) == CleaningTask::SCRUB);
+    CHECK(CleaningRules::cleanTypeFor(FloorType::OTHER) == CleaningTask::VACUUM);
+    CHECK(CleaningRules::cleanTypeFor(Robot::Strategy::SHAMPOO) == CleaningTask::SHAMPOO);
+
+    Room carpet("Lounge", 1, "carpet", "medium", false);
+    Robot mediumShampoo("A", 100.0, Robot::Size::MEDIUM, Robot::Strategy::SHAMPOO, 100.0);
+    Robot mediumScrub("B", 100.0, Robot::Size::MEDIUM, Robot::Strategy::SCRUB, 100.0);
+    Robot smallVacuum("C", 100.0, Robot::Size::SMALL, Robot::Strategy::VACUUM, 100.0);
+    CHECK(CleaningRules::canClean(mediumShampoo, carpet));
+    CHECK_FALSE(CleaningRules::canClean(mediumScrub, carpet));
+    CHECK_FALSE(CleaningRules::canClean(smallVacuum, carpet));
+}
+
+TEST_CASE("Auto Task Planner", "[autotask]") {
+    SECTION("Dirty rooms get one task each with the floor's clean type") {
+        auto map = buildMap();
+        Collector out;
+        AutoTaskPlanner planner(map, out.sink());
+        planner.notifyAllRooms();
+        CHECK(planner.processPending() == 3);
+
+        REQUIRE(out.tasks.size() == 3);
+        for (const auto& task : out.tasks) {
+            REQUIRE(task->getRoom());
+            CHECK(task->getStatus() == "Pending");
+            CHECK(task->getID() >= AutoTaskPlanner::kFirstTaskId);
+            CHECK(task->getCleanType() == CleaningRules::cleanTypeFor(task->getRoom()->getFloorType()));
+        }
+        CHECK(planner.hasOutstandingTask(1));
+        CHECK_FALSE(planner.hasOutstandingTask(0));
+        CHECK_FALSE(planner.hasOutstandingTask(4));
+
+        // Reporting the same rooms again does not duplicate work
+        planner.notifyAllRooms();
+        CHECK(planner.processPending() == 0);
+        CHECK(planner.getStats().roomsEvaluated == 10);
+    }
+
+    SECTION("Only changed rooms are re-evaluated") {
+        auto map = buildMap();
+        Collector out;
+        AutoTaskPlanner planner(map, out.sink());
+        planner.notifyAllRooms();
+        planner.processPending();
+
+        // Cleaned room frees its slot; a later dirty report generates again
+        map->getRoomById(1)->markClean();
+        planner.notifyRoomChanged(1);
+        CHECK(planner.processPending() == 0);
+        CHECK_FALSE(planner.hasOutstandingTask(1));
+        map->getRoomById(1)->markDirty();
+        map->getRoomById(4)->markDirty();
+        planner.notifyRoomsChanged({1, 4});
+        CHECK(planner.processPending() == 2);
+        CHECK(planner.getStats().roomsEvaluated == 5 + 1 + 2);
+
+        // A completed task frees its room, which is regenerated while it stays dirty
+        int kitchenTask = -1;
+        for (const auto& task : out.tasks) {
+            if (task->getRoom()->getRoomId() == 2) kitchenTask = task->getID();
+        }
+        planner.releaseRoom(2, kitchenTask);
+        CHECK(planner.processPending() == 1);
+        CHECK(out.tasks.size() == 6);
+    }
+
+    SECTION("Only the room's own task releases it") {
+        auto map = buildMap();
+        Collector out;
+        std::unordered_set<int> retracted;
+        AutoTaskPlanner planner(map, out.sink());
+        planner.setRetract([&retracted](const std::unordered_set<int>& ids) {
+            retracted.insert(ids.begin(), ids.end());
+        });
+        planner.notifyAllRooms();
+        planner.processPending();
+        auto taskFor = [&out](int roomId) {
+            for (const auto& task : out.tasks) {
+                if (task->getRoom()->getRoomId() == roomId) return task->getID();
+            }
+            return -1;
+        };
+
+        // A manual clean finishing first does not free the room while it is dirty
+        planner.releaseRoom(1, 7);
+        CHECK(planner.processPending() == 0);
+        CHECK(planner.hasOutstandingTask(1));
+
+        // Once that clean leaves the room clean, the generated task is withdrawn
+        map->getRoomById(1)->markClean();
+        planner.releaseRoom(1, 7);
+        CHECK(planner.processPending() == 0);
+        CHECK_FALSE(planner.hasOutstandingTask(1));
+        CHECK(retracted == std::unordered_set<int>{taskFor(1)});
+
+        // A failed task frees the room but is not retried until the room is reported again
+        planner.releaseRoom(2, taskFor(2), true);
+        CHECK_FALSE(planner.hasOutstandingTask(2));
+        CHECK(planner.processPending() == 0);
+        planner.notifyRoomChanged(2);
+        CHECK(planner.processPending() == 1);
+        CHECK(out.tasks.size() == 4);
+    }
+
+    SECTION("Tasks are submitted in batches") {
+        auto map = std::make_shared<Map>();
+        map->addRoom("Charging Station", 0, "tile", "small", true);
+        for (int id = 1; id <= 10; ++id) {
+            map->addRoom("Room " + std::to_string(id), id, "carpet", "small", false);
+        }
+        map->publishSnapshot();
+        Collector out;
+        AutoTaskPlanner planner(map, out.sink(), 4);
+        planner.notifyAllRooms();
+        CHECK(planner.processPending() == 10);
+        CHECK(out.batches == 3);
+        CHECK(planner.getStats().batchesSubmitted == 3);
+    }
+
+    SECTION("Ten thousand rooms are evaluated in one pass") {
+        auto map = std::make_shared<Map>();
+        map->reserveRooms(10000);
+        const char* floors[] = {"carpet", "tile", "wood", "other"};
+        for (int id = 1; id <= 10000; ++id) {
+            map->addRoom("Room " + std::to_string(id), id, floors[id % 4], "small", id % 2 == 0);
+        }
+        map->publishSnapshot();
+        Collector out;
+        AutoTaskPlanner planner(map, out.sink(), 256);
+        planner.notifyAllRooms();
+        CHECK(planner.processPending() == 5000);
+        auto stats = planner.getStats();
+        CHECK(stats.roomsEvaluated == 10000);
+        CHECK(stats.lastPassMillis < 1000.0);
+    }
+
+    SECTION("Background thread picks up reports") {
+        auto map = buildMap();
+        Collector out;
+        std::mutex outMutex;
+        AutoTaskPlanner planner(map, [&](const std::vector<std::shared_ptr<CleaningTask>>& batch) {
+            std::lock_guard<std::mutex> lock(outMutex);
+            out.tasks.insert(out.tasks.end(), batch.begin(), batch.end());
+        });
+        planner.start();
+        planner.notifyAllRooms();
+        for (int i = 0; i < 200 && planner.getStats().tasksGenerated < 3; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        planner.stop();
+        CHECK_FALSE(planner.isRunning());
+        std::lock_guard<std::mutex> lock(outMutex);
+        CHECK(out.tasks.size() == 3);
+    }
+}
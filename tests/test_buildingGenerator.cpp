@@ -0,0 +1,132 @@
+#include <catch2/catch_test_macros.hpp>
+#include "MapGenerator/BuildingGenerator.h"
+#include "map/map.h"
+#include "map/CompiledMap.h"
+#include "Room/Room.h"
+#include "Robot/Robot.h"
+#include <cstdio>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+TEST_CASE("Building Generator", "[generator]") {
+    BuildingGenerator::Options options;
+    options.seed = 42;
+    options.floors = 3;
+    options.corridorsPerFloor = 2;
+    options.roomsPerCorridor = 10;
+    options.virtualWallFraction = 0.1;
+    options.robots = 12;
+    auto building = BuildingGenerator::generate(options);
+    const Map& map = *building.map;
+
+    SECTION("Shape follows the options") {
+        // Per floor: charger, lobby, 2 corridors of 5 segments and 10 rooms each
+        CHECK(map.getRooms().size() == 3 * (2 + 2 * (5 + 10)));
+        REQUIRE(map.getChargers().size() == 3);
+        CHECK(map.getChargers()[0].roomId == 0);
+        CHECK(map.getChargers()[0].slots == 3);
+        CHECK(map.getRoomById(0)->getRoomName() == "Floor 0 Charging Station");
+
+        std::set<int> ids;
+        std::map<int, int> perFloor;
+        bool zonesMatchFloors = true;
+        for (const Room* room : map.getRooms()) {
+            ids.insert(room->getRoomId());
+            REQUIRE(room->hasPosition());
+            perFloor[room->getPosition().level]++;
+            zonesMatchFloors = zonesMatchFloors && map.getRoomZone(room->getRoomId()) == room->getPosition().level;
+        }
+        CHECK(ids.size() == map.getRooms().size());
+        CHECK(perFloor.size() == 3);
+        CHECK(perFloor[2] == 32);
+        CHECK(zonesMatchFloors);
+        CHECK_FALSE(map.getVirtualWalls().empty());
+    }
+
+    SECTION("Every room is reachable from the first charger") {
+        // Walls on many doors, so a sealed room would show up
+        options.virtualWallFraction = 0.5;
+        options.adjacentDoorFraction = 0.5;
+        auto walled = BuildingGenerator::generate(options);
+        for (const Map* built : std::vector<const Map*>{&map, walled.map.get()}) {
+            Room* start = built->getRoomById(0);
+            size_t unreachable = 0;
+            for (Room* room : built->getRooms()) {
+                if (room != start && built->getRoute(*start, *room).empty()) unreachable++;
+            }
+            CHECK(unreachable == 0);
+        }
+        CHECK(walled.map->getVirtualWalls().size() > map.getVirtualWalls().size());
+    }
+
+    SECTION("The same seed gives the same building, another seed a different one") {
+        auto again = BuildingGenerator::generate(options);
+        CHECK(BuildingGenerator::mapJson(*again.map) == BuildingGenerator::mapJson(map));
+        options.seed = 43;
+        auto other = BuildingGenerator::generate(options);
+        CHECK(BuildingGenerator::mapJson(*other.map) != BuildingGenerator::mapJson(map));
+    }
+
+    SECTION("Size weights shape the room mix") {
+        options.floors = 1;
+        options.roomsPerCorridor = 400;
+        options.sizeWeights = {0.0, 0.0, 1.0};
+        auto large = BuildingGenerator::generate(options);
+        bool allLarge = true;
+        for (const Room* room : large.map->getRooms()) {
+            if (room->getRoomName().find(" Room ") == std::string::npos) continue;
+            allLarge = allLarge && room->getSize() == "large";
+        }
+        CHECK(allLarge);
+    }
+
+    SECTION("map.json and compiled output load back unchanged") {
+        std::string jsonPath = "generated_building_test.json";
+        std::string binPath = "generated_building_test.bin";
+        BuildingGenerator::writeMapJson(map, jsonPath);
+        CompiledMap::write(map, binPath);
+
+        Map fromJson;
+        fromJson.loadFromFile(jsonPath);
+        Map fromBin;
+        fromBin.loadFromFile(binPath);
+        std::remove(jsonPath.c_str());
+        std::remove(binPath.c_str());
+
+        CHECK(BuildingGenerator::mapJson(fromJson) == BuildingGenerator::mapJson(map));
+        CHECK(BuildingGenerator::mapJson(fromBin) == BuildingGenerator::mapJson(map));
+    }
+
+    SECTION("Fleet mixes sizes and strategies and round-trips") {
+        REQUIRE(building.fleet.size() == 12);
+        CHECK(building.fleet[0].name == "Robot_Large_Vacuum_0");
+        CHECK(building.fleet[4].size == Robot::Size::MEDIUM);
+        CHECK(building.fleet[4].strategy == Robot::Strategy::SCRUB);
+        CHECK(building.fleet[9].name == "Robot_Large_Vacuum_1");
+        // Robots start spread over the floors' chargers
+        CHECK(building.fleet[1].homeRoomId == map.getChargers()[1].roomId);
+
+        std::string path = "generated_fleet_test.json";
+        BuildingGenerator::writeFleetJson(building.fleet, path);
+        auto fleet = BuildingGenerator::readFleetJson(path);
+        std::remove(path.c_str());
+        REQUIRE(fleet.size() == building.fleet.size());
+        CHECK(fleet[8].name == building.fleet[8].name);
+        CHECK(fleet[8].size == Robot::Size::SMALL);
+        CHECK(fleet[8].strategy == Robot::Strategy::SHAMPOO);
+
+        auto robots = BuildingGenerator::createRobots(fleet, *building.map);
+        REQUIRE(robots.size() == 12);
+        CHECK(robots[2]->getCurrentRoom() == building.map->getRoomById(fleet[2].homeRoomId));
+        CHECK(robots[2]->getStrategy() == Robot::Strategy::SHAMPOO);
+    }
+
+    SECTION("Bad options and fleet names are rejected") {
+        options.floors = 0;
+        CHECK_THROWS_AS(BuildingGenerator::generate(options), std::runtime_error);
+        CHECK_THROWS_AS(BuildingGenerator::parseSize("Huge"), std::runtime_error);
+        CHECK_THROWS_AS(BuildingGenerator::parseStrategy("Mop"), std::runtime_error);
+    }
+}
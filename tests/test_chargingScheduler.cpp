@@ -0,0 +1,140 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include "ChargingScheduler/ChargingScheduler.h"
+#include "RobotSimulator/RobotSimulator.hpp"
+#include "Robot/Robot.h"
+#include "map/map.h"
+#include "Room/Room.h"
+#include <memory>
+
+// Builds a corridor 0 - 1 - 2 - 3
+static std::shared_ptr<Map> buildCorridor() {
+    auto map = std::make_shared<Map>();
+    map->addRoom("Charging Station", 0, "tile", "small", true);
+    for (int id = 1; id <= 3; ++id) {
+        map->addRoom("Room " + std::to_string(id), id, "wood", "small", false);
+    }
+    for (int id = 0; id < 3; ++id) {
+        map->connectRooms(map->getRoomById(id), map->getRoomById(id + 1));
+    }
+    return map;
+}
+
+static std::shared_ptr<Robot> makeRobot(const std::string& name, double battery, Map& map, int roomId) {
+    auto robot = std::make_shared<Robot>(name, battery, Robot::Size::SMALL, Robot::Strategy::VACUUM);
+    robot->setCurrentRoom(map.getRoomById(roomId));
+    robot->setMap(&map);
+    return robot;
+}
+
+TEST_CASE("Charging Scheduler", "[charging]") {
+    SECTION("Maps without chargers default to room 0") {
+        auto map = buildCorridor();
+        auto chargers = map->getChargers();
+        REQUIRE(chargers.size() == 1);
+        CHECK(chargers[0].roomId == 0);
+        CHECK(chargers[0].slots == ChargerSpec::kUnlimitedSlots);
+        CHECK(map->isChargerRoom(0));
+        CHECK_FALSE(map->isChargerRoom(3));
+    }
+
+    SECTION("Queues a robot when the only slot is taken") {
+        auto map = buildCorridor();
+        map->addCharger(0, 1);
+        ChargingScheduler scheduler(*map);
+        auto first = makeRobot("First", 50.0, *map, 1);
+        auto second = makeRobot("Second", 50.0, *map, 1);
+
+        auto a = scheduler.requestCharge(first, 0.0);
+        auto b = scheduler.requestCharge(second, 0.0);
+
+        CHECK(a.chargerRoomId == 0);
+        CHECK_FALSE(a.queued);
+        CHECK(a.readyAt == Catch::Approx(12.5));   // one hop, then 50% at 20%/s
+        CHECK(b.queued);
+        CHECK(b.readyAt == Catch::Approx(15.0));   // starts when the first robot is done
+        CHECK(second->isWaitingForCharger());
+        CHECK(scheduler.freeSlots(0) == 0);
+        CHECK(scheduler.queueLength(0) == 1);
+    }
+
+    SECTION("Picks the nearest charger with a free slot") {
+        auto map = buildCorridor();
+        map->addCharger(0, 1);
+        map->addCharger(3, 1);
+        ChargingScheduler scheduler(*map);
+        auto first = makeRobot("First", 50.0, *map, 1);
+        auto second = makeRobot("Second", 50.0, *map, 1);
+
+        CHECK(scheduler.requestCharge(first, 0.0).chargerRoomId == 0);
+        auto b = scheduler.requestCharge(second, 0.0);
+        CHECK(b.chargerRoomId == 3);
+        CHECK_FALSE(b.queued);
+    }
+
+    SECTION("Queued robot charges once the slot frees up") {
+        auto map = buildCorridor();
+        map->addCharger(0, 1);
+        RobotSimulator simulator(map, nullptr, nullptr, nullptr);
+        simulator.getRobots().push_back(makeRobot("First", 50.0, *map, 1));
+        simulator.getRobots().push_back(makeRobot("Second", 50.0, *map, 1));
+        auto first = simulator.getRobots()[0];
+        auto second = simulator.getRobots()[1];
+
+        simulator.requestReturnToCharger("First");
+        simulator.requestReturnToCharger("Second");
+        for (int i = 0; i < 11; ++i) simulator.update(1.0);
+
+        // Both have arrived but only one slot exists
+        CHECK(first->isCharging());
+        CHECK_FALSE(second->isCharging());
+        CHECK(second->isWaitingForCharger());
+
+        for (int i = 0; i < 10; ++i) simulator.update(1.0);
+        CHECK(first->getBatteryLevel() == Catch::Approx(100.0));
+        CHECK(second->getBatteryLevel() == Catch::Approx(100.0));
+        CHECK_FALSE(second->isWaitingForCharger());
+
+        auto stats = simulator.getChargingStats();
+        CHECK(stats.requests == 2);
+        CHECK(stats.queuedRequests == 1);
+        CHECK(stats.totalWaitSeconds > 0.0);
+    }
+
+    SECTION("A redirected or failed occupant frees its slot") {
+        auto map = buildCorridor();
+        map->addCharger(0, 1);
+        RobotSimulator simulator(map, nullptr, nullptr, nullptr);
+        simulator.getRobots().push_back(makeRobot("First", 50.0, *map, 1));
+        simulator.getRobots().push_back(makeRobot("Second", 50.0, *map, 2));
+        simulator.getRobots().push_back(makeRobot("Third", 50.0, *map, 3));
+        auto first = simulator.getRobots()[0];
+        auto second = simulator.getRobots()[1];
+        auto third = simulator.getRobots()[2];
+
+        simulator.requestReturnToCharger("First");
+        simulator.requestReturnToCharger("Second");
+        REQUIRE(simulator.getChargerAssignment("Second").queued);
+        REQUIRE(second->isWaitingForCharger());
+
+        // Sending the occupant elsewhere hands its slot to the queued robot
+        simulator.moveRobotToRoom("First", 3);
+        CHECK_FALSE(simulator.getChargerAssignment("First").chargerRoomId == 0);
+        simulator.update(0.1);
+        CHECK_FALSE(second->isWaitingForCharger());
+        CHECK_FALSE(simulator.getChargerAssignment("Second").queued);
+
+        // A queued robot moved away leaves the queue
+        simulator.requestReturnToCharger("Third");
+        REQUIRE(third->isWaitingForCharger());
+        simulator.moveRobotToRoom("Third", 2);
+        CHECK_FALSE(third->isWaitingForCharger());
+        CHECK(simulator.getChargerAssignment("Third").chargerRoomId == -1);
+
+        // A failed occupant is released on the next update
+        second->failed_ = true;
+        simulator.update(0.1);
+        CHECK(simulator.getChargerAssignment("Second").chargerRoomId == -1);
+        CHECK(simulator.getChargingStats().queuedRequests == 2);
+    }
+}
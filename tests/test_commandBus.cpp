@@ -0,0 +1,214 @@
+#include <catch2/catch_test_macros.hpp>
+#include "CommandBus/CommandBus.h"
+#include "SimulationThread/SimulationThread.h"
+#include "RobotSimulator/RobotSimulator.hpp"
+#include "Robot/Robot.h"
+#include "map/map.h"
+#include "Room/Room.h"
+#include <chrono>
+#include <future>
+#include <memory>
+
+namespace {
+    // Charger 0 connected to rooms 1 and 2
+    std::shared_ptr<Map> buildMap() {
+        auto map = std::make_shared<Map>();
+        map->addRoom("Charging Station", 0, "tile", "small", true);
+        map->addRoom("Lounge", 1, "carpet", "medium", false);
+        map->addRoom("Kitchen", 2, "tile", "medium", false);
+        map->connectRooms(map->getRoomById(0), map->getRoomById(1));
+        map->connectRooms(map->getRoomById(0), map->getRoomById(2));
+        map->addCharger(0, 2);
+        map->publishSnapshot();
+        return map;
+    }
+
+    CommandBus::Command command(CommandBus::CommandType type, size_t robot, int roomId = -1) {
+        CommandBus::Command result;
+        result.type = type;
+        result.robot = robot;
+        result.roomId = roomId;
+        return result;
+    }
+
+    bool isReady(const std::shared_future<CommandBus::Result>& future) {
+        return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+}
+
+TEST_CASE("Command Bus", "[commandbus]") {
+    using Type = CommandBus::CommandType;
+    auto map = buildMap();
+    auto simulator = std::make_shared<RobotSimulator>(map, nullptr, nullptr, nullptr);
+    simulator->addRobot("Alpha");
+    simulator->addRobot("Beta");
+    CommandBus bus;
+
+    SECTION("Commands wait for apply and resolve their futures in one batch") {
+        auto start = bus.submit(command(Type::START_CLEANING, 0));
+        auto move = bus.submit(command(Type::MOVE_TO_ROOM, 1, 2));
+        CHECK(bus.pendingCount() == 2);
+        CHECK_FALSE(isReady(start.result));
+        CHECK(start.id != move.id);
+
+        CHECK(bus.apply(*simulator) == 2);
+        CHECK(bus.pendingCount() == 0);
+        REQUIRE(isReady(start.result));
+        REQUIRE(isReady(move.result));
+
+        const auto& started = start.result.get();
+        CHECK(started.ok);
+        CHECK(started.robot == simulator->getRobots()[0]);
+        REQUIRE(started.room);
+        CHECK(started.room->getRoomName() == "Charging Station");
+
+        const auto& moved = move.result.get();
+        CHECK(moved.ok);
+        REQUIRE(moved.room);
+        CHECK(moved.room->getRoomName() == "Kitchen");
+        CHECK(simulator->getRobots()[1]->getNextRoom() == map->getRoomById(2));
+
+        auto stats = bus.getStats();
+        CHECK(stats.submitted == 2);
+        CHECK(stats.applied == 2);
+        CHECK(stats.batches == 1);
+        CHECK(bus.apply(*simulator) == 0);
+        CHECK(bus.getStats().batches == 1);
+    }
+
+    SECTION("Repeated commands share the pending one") {
+        auto first = bus.submit(command(Type::RETURN_TO_CHARGER, 0));
+        auto second = bus.submit(command(Type::RETURN_TO_CHARGER, 0));
+        auto other = bus.submit(command(Type::RETURN_TO_CHARGER, 1));
+        CHECK_FALSE(first.coalesced);
+        CHECK(second.coalesced);
+        CHECK(second.id == first.id);
+        CHECK_FALSE(other.coalesced);
+        CHECK(bus.pendingCount() == 2);
+        CHECK(bus.getStats().coalesced == 1);
+
+        bus.apply(*simulator);
+        CHECK(second.result.get().ok);
+        // Once applied, the same request queues anew
+        CHECK_FALSE(bus.submit(command(Type::RETURN_TO_CHARGER, 0)).coalesced);
+    }
+
+    SECTION("A new destination supersedes the pending one") {
+        auto toLounge = bus.submit(command(Type::MOVE_TO_ROOM, 0, 1));
+        auto toKitchen = bus.submit(command(Type::MOVE_TO_ROOM, 0, 2));
+        REQUIRE(isReady(toLounge.result));
+        CHECK_FALSE(toLounge.result.get().ok);
+        CHECK(toLounge.result.get().error == "Superseded by a later command");
+        CHECK(bus.pendingCount() == 1);
+
+        auto home = bus.submit(command(Type::RETURN_TO_CHARGER, 0));
+        REQUIRE(isReady(toKitchen.result));
+        CHECK_FALSE(toKitchen.result.get().ok);
+        CHECK(bus.getStats().superseded == 2);
+        CHECK(bus.pendingCount() == 1);
+
+        bus.apply(*simulator);
+        CHECK(home.result.get().ok);
+        // Already at the charger, so it stays there
+        CHECK(simulator->getRobots()[0]->getCurrentRoom() == map->getRoomById(0));
+        CHECK(simulator->getRobots()[0]->getNextRoom() == nullptr);
+    }
+
+    SECTION("Only the robot's latest pending command is coalesced with") {
+        // The second start must run after the stop, not fold into the first start
+        auto start = bus.submit(command(Type::START_CLEANING, 0));
+        auto stop = bus.submit(command(Type::STOP_CLEANING, 0));
+        auto restart = bus.submit(command(Type::START_CLEANING, 0));
+        CHECK_FALSE(restart.coalesced);
+        CHECK(restart.id != start.id);
+        CHECK(bus.pendingCount() == 3);
+
+        // Going home again after a move replaces the move, not the earlier trip home
+        auto home = bus.submit(command(Type::RETURN_TO_CHARGER, 1));
+        auto toKitchen = bus.submit(command(Type::MOVE_TO_ROOM, 1, 2));
+        auto homeAgain = bus.submit(command(Type::RETURN_TO_CHARGER, 1));
+        CHECK_FALSE(homeAgain.coalesced);
+        REQUIRE(isReady(home.result));
+        REQUIRE(isReady(toKitchen.result));
+        CHECK(toKitchen.result.get().error == "Superseded by a later command");
+        CHECK(bus.getStats().coalesced == 0);
+        CHECK(bus.pendingCount() == 4);
+
+        CHECK(bus.apply(*simulator) == 4);
+        CHECK(stop.result.get().ok);
+        CHECK(restart.result.get().ok);
+        CHECK(homeAgain.result.get().ok);
+        CHECK(simulator->getRobots()[1]->getNextRoom() == nullptr);
+    }
+
+    SECTION("A superseding destination keeps its place behind the robot's earlier commands") {
+        auto toLounge = bus.submit(command(Type::MOVE_TO_ROOM, 0, 1));
+        auto stop = bus.submit(command(Type::STOP_CLEANING, 0));
+        auto toKitchen = bus.submit(command(Type::MOVE_TO_ROOM, 0, 2));
+        // The stop sits between the two moves, so neither replaces the other
+        CHECK_FALSE(isReady(toLounge.result));
+        CHECK(bus.pendingCount() == 3);
+
+        bus.apply(*simulator);
+        CHECK(toLounge.result.get().ok);
+        CHECK(stop.result.get().ok);
+        CHECK(toKitchen.result.get().ok);
+        CHECK(simulator->getRobots()[0]->getNextRoom() == map->getRoomById(2));
+    }
+
+    SECTION("Bad handles and rooms fail only their own command") {
+        auto unknownRobot = bus.submit(command(Type::START_CLEANING, 7));
+        auto unknownRoom = bus.submit(command(Type::MOVE_TO_ROOM, 1, 42));
+        auto fine = bus.submit(command(Type::START_CLEANING, 1));
+        CHECK(bus.apply(*simulator) == 3);
+
+        CHECK_FALSE(unknownRobot.result.get().ok);
+        CHECK(unknownRobot.result.get().error == "Unknown robot handle 7");
+        CHECK_FALSE(unknownRoom.result.get().ok);
+        CHECK(unknownRoom.result.get().error == "Unknown room 42");
+        CHECK(fine.result.get().ok);
+        CHECK(bus.getStats().failed == 2);
+    }
+
+    SECTION("Picking up a robot repairs it at the charger") {
+        auto robot = simulator->getRobots()[1];
+        robot->setCurrentRoom(map->getRoomById(2));
+        robot->failed_ = true;
+        auto pickUp = bus.submit(command(Type::PICK_UP, 1));
+        bus.apply(*simulator);
+        REQUIRE(pickUp.result.get().ok);
+        CHECK_FALSE(robot->isFailed());
+        CHECK(robot->getCurrentRoom() == map->getRoomById(0));
+        REQUIRE(pickUp.result.get().room);
+        CHECK(pickUp.result.get().room->getRoomName() == "Charging Station");
+    }
+}
+
+TEST_CASE("Command Bus on the simulation thread", "[commandbus]") {
+    using Type = CommandBus::CommandType;
+    auto map = buildMap();
+    auto simulator = std::make_shared<RobotSimulator>(map, nullptr, nullptr, nullptr);
+    simulator->addRobot("Alpha");
+    SimulationThread simulation(simulator, nullptr);
+    REQUIRE(simulation.refresh());
+
+    SECTION("Typed commands apply at the tick boundary") {
+        auto move = simulation.getCommandBus().submit(command(Type::MOVE_TO_ROOM, 0, 1));
+        CHECK_FALSE(isReady(move.result));
+        simulation.step();
+        REQUIRE(isReady(move.result));
+        CHECK(move.result.get().ok);
+        REQUIRE(simulation.refresh());
+        CHECK(simulation.latest().robots[0].nextRoomId == 1);
+    }
+
+    SECTION("Submitting wakes an idle thread") {
+        simulation.setTickInterval(std::chrono::milliseconds(60000));
+        simulation.start();
+        auto move = simulation.getCommandBus().submit(command(Type::MOVE_TO_ROOM, 0, 2));
+        REQUIRE(move.result.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+        CHECK(move.result.get().ok);
+        simulation.stop();
+        CHECK(simulation.getTickCount() == 0);
+    }
+}
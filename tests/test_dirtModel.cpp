@@ -0,0 +1,120 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include "DirtModel/DirtModel.h"
+#include "RobotSimulator/RobotSimulator.hpp"
+#include "Robot/Robot.h"
+#include "CleaningTask/cleaningTask.h"
+#include "map/map.h"
+#include "Room/Room.h"
+#include <algorithm>
+#include <memory>
+#include <random>
+
+using Catch::Approx;
+
+// Room 1 carpet, 2 wood, 3 tile, all clean; 4 carpet and starts dirty
+static std::shared_ptr<Map> buildFloors() {
+    auto map = std::make_shared<Map>();
+    map->addRoom("Charging Station", 0, "tile", "small", true);
+    map->addRoom("Lounge", 1, "carpet", "small", true);
+    map->addRoom("Study", 2, "wood", "small", true);
+    map->addRoom("Kitchen", 3, "tile", "small", true);
+    map->addRoom("Den", 4, "carpet", "small", false);
+    for (int id = 1; id <= 4; ++id) {
+        map->connectRooms(map->getRoomById(0), map->getRoomById(id));
+    }
+    return map;
+}
+
+TEST_CASE("Dirt Model", "[dirt]") {
+    SECTION("Dirt builds up by flooring and is capped") {
+        auto map = buildFloors();
+        DirtModel dirt(*map);
+
+        CHECK(dirt.dirtLevel(1, 0.0) == 0.0);
+        CHECK(dirt.dirtLevel(1, 100.0) == Approx(100.0 * DirtModel::baseRate(FloorType::CARPET)));
+        CHECK(dirt.dirtLevel(3, 100.0) == Approx(100.0 * DirtModel::baseRate(FloorType::TILE)));
+        CHECK(dirt.dirtLevel(1, 100.0) > dirt.dirtLevel(2, 100.0));
+        CHECK(dirt.dirtLevel(2, 100.0) > dirt.dirtLevel(3, 100.0));
+        CHECK(dirt.dirtLevel(4, 0.0) == Approx(DirtModel::kDefaultDirtyThreshold));
+        CHECK(dirt.dirtLevel(1, 1e6) == DirtModel::kMaxDirt);
+    }
+
+    SECTION("Rooms flip dirty when they cross the threshold") {
+        auto map = buildFloors();
+        DirtModel dirt(*map, 0.0, 10.0);
+        double carpetCrossing = 10.0 / DirtModel::baseRate(FloorType::CARPET);
+
+        CHECK(dirt.update(carpetCrossing - 1.0).empty());
+        CHECK(map->getRoomById(1)->isClean());
+        auto dirty = dirt.update(carpetCrossing + 1.0);
+        CHECK(dirty == std::vector<int>{1});
+        CHECK_FALSE(map->getRoomById(1)->isClean());
+
+        dirt.markCleaned(1, carpetCrossing + 1.0);
+        CHECK(map->getRoomById(1)->isClean());
+        CHECK(dirt.dirtLevel(1, carpetCrossing + 1.0) == 0.0);
+        CHECK(dirt.update(carpetCrossing + 2.0).empty());
+    }
+
+    SECTION("Visits and traffic bring the crossing forward") {
+        auto map = buildFloors();
+        DirtModel dirt(*map, 0.0, 10.0);
+        dirt.recordVisit(3, 0.0, 9.5);
+        dirt.setTrafficMultiplier(3, 5.0, 0.0);
+        CHECK(dirt.dirtLevel(3, 0.0) == Approx(9.5));
+        CHECK(dirt.dirtLevel(3, 2.0) == Approx(9.5 + 2.0 * 5.0 * DirtModel::baseRate(FloorType::TILE)));
+        CHECK(dirt.update(10.0) == std::vector<int>{3});
+    }
+
+    SECTION("Top-K matches a full sort") {
+        auto map = std::make_shared<Map>();
+        const char* floors[] = {"carpet", "wood", "tile", "hardwood"};
+        for (int id = 0; id < 500; ++id) {
+            map->addRoom("Room " + std::to_string(id), id, floors[id % 4], "small", true);
+        }
+        DirtModel dirt(*map);
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> amount(0.0, 20.0);
+        for (int step = 0; step < 2000; ++step) {
+            int id = static_cast<int>(rng() % 500);
+            double now = step * 0.5;
+            switch (rng() % 3) {
+                case 0: dirt.recordVisit(id, now, amount(rng)); break;
+                case 1: dirt.markCleaned(id, now); break;
+                default: dirt.setTrafficMultiplier(id, 0.5 + (rng() % 4), now); break;
+            }
+        }
+
+        double now = 1500.0;
+        std::vector<double> levels;
+        for (int id = 0; id < 500; ++id) levels.push_back(dirt.dirtLevel(id, now));
+        std::sort(levels.rbegin(), levels.rend());
+
+        auto top = dirt.topDirtiest(25, now);
+        REQUIRE(top.size() == 25);
+        for (size_t i = 0; i < top.size(); ++i) {
+            CHECK(top[i].dirt == Approx(levels[i]));
+            CHECK(top[i].dirt == Approx(dirt.dirtLevel(top[i].roomId, now)));
+        }
+    }
+
+    SECTION("Simulator resets dirt when a clean finishes") {
+        auto map = buildFloors();
+        RobotSimulator simulator(map, nullptr, nullptr, nullptr);
+        simulator.enableDirtModel(DirtModel::kDefaultDirtyThreshold);
+        simulator.addRobot("Cleaner");
+        auto robot = simulator.getRobots()[0];
+
+        auto task = std::make_shared<CleaningTask>(1, CleaningTask::HIGH, CleaningTask::VACUUM, map->getRoomById(4));
+        task->assignRobot(robot);
+        robot->setCurrentTask(task);
+        simulator.assignTaskToRobot(task);
+        for (int i = 0; i < 40 && task->getStatus() != "Completed"; ++i) {
+            simulator.update(1.0);
+        }
+        REQUIRE(task->getStatus() == "Completed");
+        CHECK(simulator.getDirtModel()->dirtLevel(4, simulator.getSimTime()) < 1.0);
+        CHECK(map->getRoomById(4)->isClean());
+    }
+}
@@ -0,0 +1,192 @@
+#include <catch2/catch_test_macros.hpp>
+#include "QuadTree/QuadTree.h"
+#include "MapLayout/MapLayout.h"
+#include "map/map.h"
+#include "map/CompiledMap.h"
+#include "map/MapDiff.h"
+#include "map/MapSnapshot.h"
+#include "Room/Room.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <vector>
+
+static std::string tempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static double distance(const RoomPosition& a, const RoomPosition& b) {
+    return std::hypot(a.x - b.x, a.y - b.y);
+}
+
+// rows x cols grid of rooms connected to their right and lower neighbors
+static void buildGrid(Map& map, int rows, int cols) {
+    for (int id = 0; id < rows * cols; ++id) {
+        map.addRoom("Room " + std::to_string(id), id, "tile", "small", true);
+    }
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            int id = r * cols + c;
+            if (c + 1 < cols) map.connectRooms(map.getRoomById(id), map.getRoomById(id + 1));
+            if (r + 1 < rows) map.connectRooms(map.getRoomById(id), map.getRoomById(id + cols));
+        }
+    }
+}
+
+TEST_CASE("Quad Tree", "[layout]") {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> coord(-500.0, 500.0);
+    std::vector<QuadTree::Item> items;
+    for (int id = 0; id < 2000; ++id) items.push_back({coord(rng), coord(rng), id});
+    // Stacked points must not recurse forever
+    for (int id = 2000; id < 2050; ++id) items.push_back({10.0, 10.0, id});
+    QuadTree tree(items);
+    REQUIRE(tree.size() == items.size());
+
+    for (int q = 0; q < 50; ++q) {
+        double x = coord(rng);
+        double y = coord(rng);
+        QuadTree::Box area{x, y, x + 150.0, y + 80.0};
+        std::vector<int> found;
+        tree.query(area, found);
+        std::vector<int> expected;
+        for (const auto& item : items) {
+            if (area.contains(item.x, item.y)) expected.push_back(item.id);
+        }
+        std::sort(found.begin(), found.end());
+        CHECK(found == expected);
+
+        int hit = tree.nearest(x, y, 40.0);
+        double best = 40.0;
+        for (const auto& item : items) best = std::min(best, std::hypot(item.x - x, item.y - y));
+        if (hit < 0) {
+            CHECK(best >= 40.0);
+        } else {
+            CHECK(std::hypot(items[hit].x - x, items[hit].y - y) == best);
+        }
+    }
+
+    QuadTree empty;
+    std::vector<int> none;
+    empty.query({-1, -1, 1, 1}, none);
+    CHECK(none.empty());
+    CHECK(empty.nearest(0, 0, 10) == -1);
+}
+
+TEST_CASE("Map Layout", "[layout]") {
+    SECTION("Unplaced rooms are spread out around pinned ones") {
+        Map map;
+        buildGrid(map, 10, 10);
+        map.getRoomById(0)->setPosition(RoomPosition{1000.0, 2000.0, 0});
+
+        CHECK(MapLayout::assignMissingPositions(map) == 99);
+        CHECK(map.getRoomById(0)->getPosition() == RoomPosition{1000.0, 2000.0, 0});
+
+        double edgeTotal = 0.0;
+        int edges = 0;
+        double closest = 1e9;
+        const auto& rooms = map.getRooms();
+        for (size_t i = 0; i < rooms.size(); ++i) {
+            REQUIRE(rooms[i]->hasPosition());
+            for (const Room* neighbor : rooms[i]->neighbors) {
+                edgeTotal += distance(rooms[i]->getPosition(), neighbor->getPosition());
+                edges++;
+            }
+            for (size_t j = i + 1; j < rooms.size(); ++j) {
+                closest = std::min(closest, distance(rooms[i]->getPosition(), rooms[j]->getPosition()));
+            }
+        }
+        double meanEdge = edgeTotal / edges;
+        CHECK(meanEdge > 0.5 * MapLayout::kSpacing);
+        CHECK(meanEdge < 2.0 * MapLayout::kSpacing);
+        CHECK(closest > 0.25 * MapLayout::kSpacing);
+    }
+
+    SECTION("Layout is deterministic and follows the pinned room's floor") {
+        Map first;
+        Map second;
+        buildGrid(first, 4, 5);
+        buildGrid(second, 4, 5);
+        first.getRoomById(7)->setPosition(RoomPosition{0.0, 0.0, 2});
+        second.getRoomById(7)->setPosition(RoomPosition{0.0, 0.0, 2});
+        MapLayout::assignMissingPositions(first);
+        MapLayout::assignMissingPositions(second);
+        for (const Room* room : first.getRooms()) {
+            CHECK(room->getPosition() == second.getRoomById(room->getRoomId())->getPosition());
+            CHECK(room->getPosition().level == 2);
+        }
+    }
+
+    SECTION("Snapshot positions keep declared rooms and fill the rest") {
+        Map map;
+        buildGrid(map, 3, 3);
+        map.getRoomById(4)->setPosition(RoomPosition{50.0, 60.0, 0});
+        map.publishSnapshot();
+        auto snapshot = map.getSnapshot();
+        auto positions = MapLayout::positionsFor(*snapshot);
+        REQUIRE(positions.size() == 9);
+        size_t center = snapshot->findRoom(4) - snapshot->rooms().data();
+        CHECK(positions[center] == RoomPosition{50.0, 60.0, 0});
+        CHECK_FALSE(map.getRoomById(0)->hasPosition());
+    }
+}
+
+TEST_CASE("Room Coordinates", "[layout]") {
+    std::string path = tempPath("positioned_map.json");
+    std::ofstream(path) << R"({"rooms": [
+        {"name": "Hall", "id": 1, "flooringType": "tile", "x": 10, "y": -20.5, "floor": 1},
+        {"name": "Den", "id": 2, "flooringType": "carpet", "x": 3.5},
+        {"name": "Attic", "id": 3, "flooringType": "wood"}],
+        "connections": [{"from": 1, "to": 2}, {"from": 2, "to": 3}]})";
+
+    SECTION("Positions are read from map.json") {
+        Map map;
+        map.loadFromFile(path);
+        REQUIRE(map.getRoomById(1)->hasPosition());
+        CHECK(map.getRoomById(1)->getPosition() == RoomPosition{10.0, -20.5, 1});
+        // Both x and y are needed
+        CHECK_FALSE(map.getRoomById(2)->hasPosition());
+        CHECK_FALSE(map.getRoomById(3)->hasPosition());
+        const auto* view = map.getSnapshot()->findRoom(1);
+        REQUIRE(view);
+        CHECK(view->hasPosition);
+        CHECK(view->position.level == 1);
+    }
+
+    SECTION("Compiled maps keep positions") {
+        Map source;
+        source.loadFromFile(path);
+        MapLayout::assignMissingPositions(source);
+        std::string binPath = tempPath("positioned_map.bin");
+        CompiledMap::write(source, binPath);
+
+        Map compiled;
+        compiled.loadFromFile(binPath);
+        for (const Room* room : source.getRooms()) {
+            const Room* copy = compiled.getRoomById(room->getRoomId());
+            REQUIRE(copy->hasPosition());
+            CHECK(copy->getPosition() == room->getPosition());
+        }
+        std::filesystem::remove(binPath);
+    }
+
+    SECTION("Moving a room is a map change") {
+        Map before;
+        Map after;
+        before.loadFromFile(path);
+        after.loadFromFile(path);
+        after.getRoomById(1)->setPosition(RoomPosition{99.0, 0.0, 1});
+        after.getRoomById(3)->setPosition(RoomPosition{5.0, 5.0, 0});
+
+        MapDiff diff = MapDiff::between(before, after);
+        CHECK(diff.changedRooms.size() == 2);
+        diff.applyTo(before);
+        CHECK(before.getRoomById(1)->getPosition() == RoomPosition{99.0, 0.0, 1});
+        CHECK(before.getRoomById(3)->hasPosition());
+        CHECK(MapDiff::between(before, after).empty());
+    }
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,110 @@
+#include <catch2/catch_test_macros.hpp>
+#include "map/map.h"
+#include "map/CompiledMap.h"
+#include "Room/Room.h"
+#include "config/ResourceConfig.hpp"
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+static std::string tempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static std::vector<int> neighborIds(const Room* room) {
+    std::vector<int> ids;
+    for (const Room* neighbor : room->neighbors) ids.push_back(neighbor->getRoomId());
+    return ids;
+}
+
+TEST_CASE("Map Loading", "[map]") {
+    SECTION("Streams map.json") {
+        Map map;
+        map.loadFromFile(config::ResourceConfig::getMapPath());
+
+        REQUIRE(map.getRooms().size() == 11);
+        CHECK(map.getRoomById(3)->getRoomName() == "Master Bedroom");
+        CHECK(map.getRoomById(3)->getSize() == "large");
+        CHECK(map.getVirtualWalls().size() == 3);
+        CHECK(map.isVirtualWallBetween(map.getRoomById(5), map.getRoomById(4)));
+        REQUIRE(map.getChargers().size() == 1);
+        CHECK(map.getChargers()[0].slots == 3);
+    }
+
+    SECTION("Rejects malformed json") {
+        std::string path = tempPath("broken_map.json");
+        std::ofstream(path) << R"({"rooms": [{"name": "Hall", "id": 1,)";
+        Map map;
+        CHECK_THROWS_AS(map.loadFromFile(path), std::runtime_error);
+        std::filesystem::remove(path);
+    }
+
+    SECTION("Rejects rooms without an id") {
+        std::string path = tempPath("no_id_map.json");
+        std::ofstream(path) << R"({"rooms": [{"name": "Hall", "flooringType": "tile", "isRoomClean": true}],
+                                   "connections": []})";
+        Map map;
+        CHECK_THROWS_AS(map.loadFromFile(path), std::runtime_error);
+        std::filesystem::remove(path);
+    }
+
+    SECTION("Compiled map round trips") {
+        Map source;
+        source.loadFromFile(config::ResourceConfig::getMapPath());
+        source.setRoomZone(1, 2);
+        std::string path = tempPath("round_trip_map.bin");
+        CompiledMap::write(source, path);
+
+        REQUIRE(CompiledMap::isCompiledMap(path));
+        Map compiled;
+        compiled.loadFromFile(path);
+
+        REQUIRE(compiled.getRooms().size() == source.getRooms().size());
+        for (const Room* room : source.getRooms()) {
+            const Room* copy = compiled.getRoomById(room->getRoomId());
+            REQUIRE(copy != nullptr);
+            CHECK(copy->getRoomName() == room->getRoomName());
+            CHECK(copy->flooringType == room->flooringType);
+            CHECK(copy->getSize() == room->getSize());
+            CHECK(copy->isClean() == room->isClean());
+            CHECK(neighborIds(copy) == neighborIds(room));
+        }
+        CHECK(compiled.getVirtualWalls().size() == source.getVirtualWalls().size());
+        CHECK(compiled.getChargers()[0].slots == 3);
+        CHECK(compiled.getRoomZone(1) == 2);
+        CHECK(compiled.getRoute(*compiled.getRoomById(0), *compiled.getRoomById(10)) ==
+              source.getRoute(*source.getRoomById(0), *source.getRoomById(10)));
+        std::filesystem::remove(path);
+    }
+
+    SECTION("Rejects a truncated compiled map") {
+        Map source;
+        source.loadFromFile(config::ResourceConfig::getMapPath());
+        std::string path = tempPath("truncated_map.bin");
+        CompiledMap::write(source, path);
+        std::filesystem::resize_file(path, sizeof(CompiledMap::Header) + 8);
+
+        Map compiled;
+        CHECK_THROWS_AS(compiled.loadFromFile(path), std::runtime_error);
+        std::filesystem::remove(path);
+    }
+
+    SECTION("Rejects a section size that would wrap past the end of the file") {
+        Map source;
+        source.loadFromFile(config::ResourceConfig::getMapPath());
+        std::string path = tempPath("corrupt_map.bin");
+        CompiledMap::write(source, path);
+        {
+            std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+            CompiledMap::Header header;
+            file.read(reinterpret_cast<char*>(&header), sizeof(header));
+            header.stringBytes = ~uint64_t{0} - 64;
+            file.seekp(0);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        }
+
+        Map compiled;
+        CHECK_THROWS_AS(compiled.loadFromFile(path), std::runtime_error);
+        std::filesystem::remove(path);
+    }
+}
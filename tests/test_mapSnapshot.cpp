@@ -0,0 +1,103 @@
+#include <catch2/catch_test_macros.hpp>
+#include "map/MapSnapshot.h"
+#include "map/MapDiff.h"
+#include "map/map.h"
+#include "RobotSimulator/RobotSimulator.hpp"
+#include "Robot/Robot.h"
+#include "Room/Room.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+
+TEST_CASE("Map Snapshots", "[map]") {
+    SECTION("Loading publishes a snapshot matching the map") {
+        Map map(true);
+        auto snapshot = map.getSnapshot();
+        REQUIRE(snapshot->version() >= 1);
+        REQUIRE(snapshot->rooms().size() == map.getRooms().size());
+        CHECK(snapshot->findRoom(3)->name == "Master Bedroom");
+        CHECK(snapshot->findRoom(3)->size == RoomSize::LARGE);
+        CHECK(snapshot->findRoom(0)->isCharger);
+        CHECK(snapshot->isVirtualWallBetween(5, 4));
+        for (const Room* room : map.getRooms()) {
+            CHECK(snapshot->getRoute(0, room->getRoomId()) ==
+                  map.getRoute(*map.getRoomById(0), *map.getRoomById(room->getRoomId())));
+        }
+    }
+
+    SECTION("Published snapshots never change") {
+        auto map = std::make_shared<Map>(true);
+        RobotSimulator simulator(map, nullptr, nullptr, nullptr);
+        auto before = simulator.getMapSnapshot();
+
+        MapDiff diff;
+        diff.addedWalls.push_back({1, 2});
+        simulator.applyMapDiff(diff);
+        auto after = simulator.getMapSnapshot();
+
+        CHECK(after->version() > before->version());
+        CHECK_FALSE(before->isVirtualWallBetween(1, 2));
+        CHECK(after->isVirtualWallBetween(1, 2));
+    }
+
+    SECTION("Cleanliness is shared live through the state table") {
+        Map map(true);
+        auto snapshot = map.getSnapshot();
+        Room* bedroom = map.getRoomById(3);
+        const auto* view = snapshot->findRoom(3);
+        REQUIRE_FALSE(snapshot->isClean(*view));
+
+        bedroom->markClean();
+        CHECK(snapshot->isClean(*view));
+
+        // Copies are detached from the table
+        Room copy(*bedroom);
+        copy.markDirty();
+        CHECK_FALSE(copy.isClean());
+        CHECK(snapshot->isClean(*view));
+    }
+
+    SECTION("Occupancy follows the robots") {
+        auto map = std::make_shared<Map>(true);
+        RobotSimulator simulator(map, nullptr, nullptr, nullptr);
+        simulator.addRobot("First");
+        simulator.addRobot("Second");
+        simulator.update(0.1);
+
+        auto snapshot = simulator.getMapSnapshot();
+        CHECK(snapshot->occupancy(*snapshot->findRoom(0)) == 2);
+
+        simulator.getRobots()[0]->setCurrentRoom(map->getRoomById(1));
+        simulator.update(0.1);
+        CHECK(snapshot->occupancy(*snapshot->findRoom(0)) == 1);
+        CHECK(snapshot->occupancy(*snapshot->findRoom(1)) == 1);
+    }
+
+    SECTION("Readers run alongside publishing without locks") {
+        Map map(true);
+        std::atomic<bool> done{false};
+        std::atomic<long> reads{0};
+        std::thread reader([&]() {
+            while (!done) {
+                auto snapshot = map.getSnapshot();
+                for (const auto& room : snapshot->rooms()) {
+                    snapshot->isClean(room);
+                }
+                reads++;
+            }
+        });
+
+        for (int i = 0; i < 200; ++i) {
+            Room* room = map.getRoomById(i % 10 + 1);
+            if (i % 2) room->markClean(); else room->markDirty();
+            if (i % 20 == 0) {
+                map.addRoom("Annex " + std::to_string(i), 100 + i, "tile", "small", false);
+                map.publishSnapshot();
+            }
+        }
+        while (reads < 10) std::this_thread::yield();
+        done = true;
+        reader.join();
+        CHECK(map.getSnapshot()->rooms().size() == 21);
+    }
+}
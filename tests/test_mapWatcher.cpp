@@ -0,0 +1,258 @@
+#include <catch2/catch_test_macros.hpp>
+#include "MapWatcher/MapWatcher.h"
+#include "map/MapDiff.h"
+#include "RobotSimulator/RobotSimulator.hpp"
+#include "Robot/Robot.h"
+#include "Scheduler/Scheduler.hpp"
+#include "TaskScheduler/TaskScheduler.h"
+#include "CleaningTask/cleaningTask.h"
+#include "map/map.h"
+#include "Room/Room.h"
+#include "config/ResourceConfig.hpp"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <thread>
+
+using json = nlohmann::json;
+
+// Short way 0-1-2-3 and a long way round 0-4-5-6-3
+static std::shared_ptr<Map> buildLoop() {
+    auto map = std::make_shared<Map>();
+    map->addRoom("Charging Station", 0, "tile", "small", true);
+    for (int id = 1; id <= 6; ++id) {
+        map->addRoom("Room " + std::to_string(id), id, "wood", "small", false);
+    }
+    auto connect = [&map](int a, int b) { map->connectRooms(map->getRoomById(a), map->getRoomById(b)); };
+    connect(0, 1); connect(1, 2); connect(2, 3);
+    connect(0, 4); connect(4, 5); connect(5, 6); connect(6, 3);
+    return map;
+}
+
+static void writeJson(const std::string& path, const json& data) {
+    std::string tmp = path + ".tmp";
+    std::ofstream(tmp) << data.dump(2);
+    std::filesystem::rename(tmp, path);
+}
+
+static bool waitForDiff(MapWatcher& watcher) {
+    for (int i = 0; i < 100 && !watcher.hasPendingDiffs(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    return watcher.hasPendingDiffs();
+}
+
+TEST_CASE("Map Hot Reload", "[map]") {
+    SECTION("Diff captures rooms, connections and walls") {
+        auto before = buildLoop();
+        auto after = buildLoop();
+        after->addRoom("Closet", 7, "carpet", "small", false);
+        after->connectRooms(after->getRoomById(3), after->getRoomById(7));
+        after->disconnectRooms(after->getRoomById(0), after->getRoomById(4));
+        after->addVirtualWall(after->getRoomById(2), after->getRoomById(3));
+        after->getRoomById(5)->setSize("large");
+
+        MapDiff diff = MapDiff::between(*before, *after);
+        REQUIRE(diff.addedRooms.size() == 1);
+        CHECK(diff.addedRooms[0].id == 7);
+        REQUIRE(diff.changedRooms.size() == 1);
+        CHECK(diff.changedRooms[0].size == "large");
+        CHECK(diff.addedConnections == std::vector<MapDiff::Edge>{{3, 7}});
+        CHECK(diff.removedConnections == std::vector<MapDiff::Edge>{{0, 4}});
+        CHECK(diff.addedWalls == std::vector<MapDiff::Edge>{{2, 3}});
+
+        Room* room5 = before->getRoomById(5);
+        auto touched = diff.applyTo(*before);
+        CHECK(touched.count(3));
+        CHECK(touched.count(0));
+        CHECK_FALSE(touched.count(5));
+        CHECK(before->getRoomById(5) == room5);
+        CHECK(room5->getRoomSize() == RoomSize::LARGE);
+        CHECK(MapDiff::between(*before, *after).empty());
+    }
+
+    SECTION("Removed rooms stay valid for robots holding them") {
+        auto map = buildLoop();
+        Room* room2 = map->getRoomById(2);
+        MapDiff diff;
+        diff.removedRooms.push_back(2);
+        diff.applyTo(*map);
+
+        CHECK(map->getRoomById(2) == nullptr);
+        CHECK(map->getRooms().size() == 6);
+        CHECK(room2->getRoomName() == "Room 2");
+        CHECK(room2->neighbors.empty());
+        CHECK(map->getRoomById(1)->neighbors.size() == 1);
+    }
+
+    SECTION("Only robots on a broken path are re-routed") {
+        auto map = buildLoop();
+        RobotSimulator simulator(map, nullptr, nullptr, nullptr);
+        simulator.addRobot("Runner");
+        simulator.addRobot("Idle");
+        auto runner = simulator.getRobots()[0];
+        simulator.moveRobotToRoom("Runner", 3);
+        runner->updateState(5.0);   // halfway through the first hop
+        REQUIRE(runner->getRemainingPath().size() == 3);
+
+        MapDiff unrelated;
+        unrelated.addedRooms.push_back({7, "Closet", "carpet", "small", false});
+        unrelated.addedConnections.push_back({5, 7});
+        CHECK(simulator.applyMapDiff(unrelated) == 0);
+
+        MapDiff blocking;
+        blocking.addedWalls.push_back({2, 3});
+        CHECK(simulator.applyMapDiff(blocking) == 1);
+
+        // Keeps the hop in progress, then doubles back round the long way
+        auto path = runner->getRemainingPath();
+        REQUIRE(path.size() == 6);
+        CHECK(path.front() == map->getRoomById(1));
+        CHECK(path[2] == map->getRoomById(4));
+        CHECK(path.back() == map->getRoomById(3));
+        CHECK(runner->getMovementProgress() > 0.0);
+    }
+
+    SECTION("Robots stop when their destination is removed") {
+        auto map = buildLoop();
+        RobotSimulator simulator(map, nullptr, nullptr, nullptr);
+        simulator.addRobot("Runner");
+        auto runner = simulator.getRobots()[0];
+        simulator.moveRobotToRoom("Runner", 2);
+
+        MapDiff removal;
+        removal.removedRooms.push_back(2);
+        CHECK(simulator.applyMapDiff(removal) == 1);
+        auto path = runner->getRemainingPath();
+        REQUIRE(path.size() == 1);
+        CHECK(path.front() == map->getRoomById(1));
+    }
+
+    SECTION("Robots in a removed room are moved out and stop its work") {
+        auto map = buildLoop();
+        auto simulator = std::make_shared<RobotSimulator>(map, nullptr, nullptr, nullptr);
+        auto scheduler = std::make_shared<Scheduler>(map.get(), &simulator->getRobots());
+        scheduler->setSimulator(simulator);
+        simulator->setScheduler(scheduler);
+        simulator->addRobot("Cleaner");
+        simulator->addRobot("Leaving");
+        auto cleaner = simulator->getRobots()[0];
+        auto leaving = simulator->getRobots()[1];
+
+        auto task = std::make_shared<CleaningTask>(1, CleaningTask::MEDIUM, CleaningTask::VACUUM, map->getRoomById(2));
+        task->assignRobot(cleaner);
+        cleaner->setCurrentRoom(map->getRoomById(2));
+        cleaner->setCurrentTask(task);
+        cleaner->startCleaning(CleaningTask::VACUUM);
+        REQUIRE(cleaner->isCleaning());
+
+        // Leaving is on its way out of room 2 towards a task in room 3
+        auto onward = std::make_shared<CleaningTask>(2, CleaningTask::MEDIUM, CleaningTask::VACUUM, map->getRoomById(3));
+        onward->assignRobot(leaving);
+        leaving->setCurrentRoom(map->getRoomById(2));
+        leaving->setCurrentTask(onward);
+        leaving->setMovementPath({3}, *map);
+
+        MapDiff removal;
+        removal.removedRooms.push_back(2);
+        CHECK(simulator->applyMapDiff(removal) == 2);
+
+        CHECK_FALSE(cleaner->isCleaning());
+        CHECK(task->getStatus() == "Failed");
+        CHECK(cleaner->getCurrentRoom() == map->getRoomById(0));
+        CHECK_FALSE(cleaner->isMoving());
+
+        // Lands where it was heading and picks its task straight back up
+        CHECK(leaving->getCurrentRoom() == map->getRoomById(3));
+        CHECK(leaving->getCurrentTask() == onward);
+        CHECK(onward->getStatus() == "Pending");
+    }
+
+    SECTION("Queued generated tasks for a removed room are dropped") {
+        auto& queue = TaskScheduler::getInstance();
+        while (queue.hasTasks()) queue.dequeueTask();
+
+        auto map = buildLoop();
+        RobotSimulator simulator(map, nullptr, nullptr, nullptr);
+        auto doomed = std::make_shared<CleaningTask>(1000000, CleaningTask::LOW, CleaningTask::VACUUM, map->getRoomById(2));
+        auto kept = std::make_shared<CleaningTask>(1000001, CleaningTask::LOW, CleaningTask::VACUUM, map->getRoomById(3));
+        queue.enqueueTasks({doomed, kept});
+
+        MapDiff removal;
+        removal.removedRooms.push_back(2);
+        simulator.applyMapDiff(removal);
+
+        CHECK(doomed->getStatus() == "Failed");
+        REQUIRE(queue.taskCount() == 1);
+        CHECK(queue.dequeueTask() == kept);
+    }
+
+    SECTION("Removing a charger room sends its robots to another charger") {
+        auto map = buildLoop();
+        map->addCharger(0);
+        map->addCharger(3, 1);
+        RobotSimulator simulator(map, nullptr, nullptr, nullptr);
+        auto low = std::make_shared<Robot>("Low", 50.0, Robot::Size::MEDIUM, Robot::Strategy::VACUUM);
+        low->setCurrentRoom(map->getRoomById(3));
+        simulator.addRobot(low);
+        simulator.requestReturnToCharger(low);
+        REQUIRE(simulator.getChargerAssignment("Low").chargerRoomId == 3);
+
+        auto after = buildLoop();
+        after->removeRoom(3);
+        after->addCharger(0);
+        MapDiff diff = MapDiff::between(*map, *after);
+        CHECK(diff.removedRooms == std::vector<int>{3});
+        CHECK(diff.removedChargers == std::vector<int>{3});
+        CHECK(diff.addedChargers.empty());
+
+        simulator.applyMapDiff(diff);
+        CHECK_FALSE(map->isChargerRoom(3));
+        CHECK(map->getChargerRoomIds() == std::vector<int>{0});
+        CHECK(low->getCurrentRoom() == map->getRoomById(0));
+        CHECK(simulator.getChargerAssignment("Low").chargerRoomId == 0);
+        CHECK_NOTHROW(simulator.update(1.0));
+        CHECK(low->isCharging());
+
+        // With every charger gone, new robots still land in a live room
+        MapDiff lastCharger;
+        lastCharger.removedRooms.push_back(0);
+        simulator.applyMapDiff(lastCharger);
+        auto late = std::make_shared<Robot>("Late", 100.0, Robot::Size::MEDIUM, Robot::Strategy::VACUUM);
+        simulator.addRobot(late);
+        REQUIRE(late->getCurrentRoom());
+        CHECK(map->getRoomById(late->getCurrentRoom()->getRoomId()) == late->getCurrentRoom());
+    }
+
+    SECTION("Watcher queues a diff when the file changes") {
+        std::string path = (std::filesystem::temp_directory_path() / "watched_map.json").string();
+        json data;
+        std::ifstream(config::ResourceConfig::getMapPath()) >> data;
+        writeJson(path, data);
+
+        MapWatcher watcher(path);
+        watcher.start();
+
+        data["virtualWalls"].push_back({{"room1", 1}, {"room2", 2}});
+        writeJson(path, data);
+        REQUIRE(waitForDiff(watcher));
+        auto diffs = watcher.takePendingDiffs();
+        REQUIRE(diffs.size() == 1);
+        CHECK(diffs[0].addedWalls == std::vector<MapDiff::Edge>{{1, 2}});
+        CHECK(diffs[0].addedRooms.empty());
+
+        // A broken file is skipped and the previous version stays the baseline
+        std::ofstream(path) << "{\"rooms\": [";
+        CHECK_FALSE(watcher.reload());
+        CHECK(watcher.getStats().failedReloads >= 1);
+        watcher.stop();
+        CHECK_FALSE(watcher.hasPendingDiffs());
+
+        writeJson(path, data);
+        CHECK(watcher.reload());
+        CHECK_FALSE(watcher.hasPendingDiffs());
+        std::filesystem::remove(path);
+    }
+}
@@ -47,18 +47,18 @@ TEST_CASE("Testing Room"){
     SECTION("Marking Room Clean and Dirty"){
         Room room1("Living Room", 1, "Carpet", "medium", false);
         Room room2("Kitchen", 2, "Tile", "medium", false);
-        REQUIRE(room1.isRoomClean == false);
-        REQUIRE(room2.isRoomClean == false);
+        REQUIRE(room1.isClean() == false);
+        REQUIRE(room2.isClean() == false);
 
         room1.markClean();
         room2.markClean();
-        REQUIRE(room1.isRoomClean == true);
-        REQUIRE(room2.isRoomClean == true);
+        REQUIRE(room1.isClean() == true);
+        REQUIRE(room2.isClean() == true);
 
         room1.markDirty();
         room2.markDirty();
-        REQUIRE(room1.isRoomClean == false);
-        REQUIRE(room2.isRoomClean == false);
+        REQUIRE(room1.isClean() == false);
+        REQUIRE(room2.isClean() == false);
     }
 
     SECTION("Room Add Neighbor") {
@@ -0,0 +1,159 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include "RobotMetrics/MetricsAggregator.h"
+#include "RobotMetrics/robot_metrics.h"
+#include "RobotSimulator/RobotSimulator.hpp"
+#include "Robot/Robot.h"
+#include "map/map.h"
+#include "Room/Room.h"
+#include <memory>
+#include <vector>
+
+using Catch::Approx;
+
+TEST_CASE("Metrics Aggregator windows", "[analytics]") {
+    using State = MetricsAggregator::State;
+    using Window = MetricsAggregator::Window;
+    MetricsAggregator aggregator;
+
+    SECTION("Nothing observed gives zeros") {
+        RobotMetrics metrics = aggregator.fleetMetrics(Window::HOUR);
+        CHECK(metrics.utilization == 0.0f);
+        CHECK(metrics.errorRate == 0.0f);
+        CHECK(metrics.costEfficiency == 0.0f);
+        CHECK(metrics.timeEfficiency == 0.0f);
+        CHECK(aggregator.robotMetrics(3, Window::DAY).batteryUsage == 0.0f);
+        CHECK(aggregator.robotCount() == 0);
+    }
+
+    SECTION("Metrics come from time, usage and errors in the window") {
+        // 30s cleaning using 3% battery, 10s moving using 1%, 20s idle, then an error
+        aggregator.record(0, State::CLEANING, 30.0, 3.0, 6.0, false, 30.0);
+        aggregator.record(0, State::MOVING, 10.0, 1.0, 0.0, false, 40.0);
+        aggregator.record(0, State::IDLE, 20.0, 0.0, 0.0, true, 59.0);
+
+        auto totals = aggregator.robotTotals(0, Window::MINUTE);
+        CHECK(totals.observedSeconds() == Approx(60.0));
+        CHECK(totals.busySeconds() == Approx(40.0));
+        CHECK(totals.errors == 1.0);
+
+        RobotMetrics metrics = aggregator.robotMetrics(0, Window::MINUTE);
+        CHECK(metrics.utilization == Approx(40.0 / 60.0));
+        CHECK(metrics.timeEfficiency == Approx(30.0 / 40.0));
+        CHECK(metrics.costEfficiency == Approx(0.75));
+        CHECK(metrics.errorRate == Approx(60.0));          // one error in a minute
+        CHECK(metrics.batteryUsage == Approx(4.0 * 60.0));  // percent per hour
+        CHECK(metrics.waterUsage == Approx(6.0 * 60.0));
+    }
+
+    SECTION("Old buckets fall out of the short windows first") {
+        aggregator.record(0, State::CLEANING, 30.0, 2.0, 0.0, false, 30.0);
+        CHECK(aggregator.robotMetrics(0, Window::MINUTE).utilization == Approx(1.0));
+
+        // Two idle minutes later the minute window only holds idle time
+        for (int t = 31; t <= 150; ++t) {
+            aggregator.record(0, State::IDLE, 1.0, 0.0, 0.0, false, t);
+        }
+        auto minute = aggregator.robotTotals(0, Window::MINUTE);
+        CHECK(minute.busySeconds() == 0.0);
+        CHECK(minute.observedSeconds() == Approx(60.0));
+        CHECK(aggregator.robotMetrics(0, Window::MINUTE).utilization == 0.0f);
+
+        auto hour = aggregator.robotTotals(0, Window::HOUR);
+        CHECK(hour.seconds[static_cast<size_t>(State::CLEANING)] == Approx(30.0));
+        CHECK(hour.observedSeconds() == Approx(150.0));
+
+        // A day later even the day window has moved past it
+        aggregator.record(0, State::IDLE, 1.0, 0.0, 0.0, false, 200000.0);
+        CHECK(aggregator.robotTotals(0, Window::DAY).observedSeconds() == Approx(1.0));
+        CHECK(aggregator.robotTotals(0, Window::HOUR).observedSeconds() == Approx(1.0));
+    }
+
+    SECTION("Samples older than the window are ignored") {
+        aggregator.record(0, State::IDLE, 1.0, 0.0, 0.0, false, 500.0);
+        aggregator.record(0, State::CLEANING, 1.0, 0.0, 0.0, false, 100.0);
+        CHECK(aggregator.robotTotals(0, Window::MINUTE).busySeconds() == 0.0);
+        CHECK(aggregator.robotTotals(0, Window::HOUR).busySeconds() == Approx(1.0));
+    }
+
+    SECTION("The fleet window sums every robot") {
+        aggregator.record(0, State::CLEANING, 10.0, 1.0, 0.0, false, 10.0);
+        aggregator.record(1, State::IDLE, 10.0, 0.0, 0.0, false, 10.0);
+        aggregator.record(1, State::ERROR, 0.0, 0.0, 0.0, true, 10.0);
+        CHECK(aggregator.robotCount() == 2);
+        RobotMetrics fleet = aggregator.fleetMetrics(Window::HOUR);
+        CHECK(fleet.utilization == Approx(0.5));
+        CHECK(fleet.errorRate == Approx(1.0 / (20.0 / 3600.0)));  // per robot-hour
+        CHECK(aggregator.fleetTotals(Window::DAY).observedSeconds() == Approx(20.0));
+
+        aggregator.reset();
+        CHECK(aggregator.robotCount() == 0);
+        CHECK(aggregator.fleetTotals(Window::HOUR).observedSeconds() == 0.0);
+    }
+}
+
+TEST_CASE("Metrics Aggregator fed by robot samples", "[analytics]") {
+    using State = MetricsAggregator::State;
+    using Window = MetricsAggregator::Window;
+    MetricsAggregator aggregator;
+    auto robot = std::make_shared<Robot>("Alpha", 100.0, Robot::Size::MEDIUM, Robot::Strategy::VACUUM, 100.0);
+    std::vector<std::shared_ptr<Robot>> robots{robot};
+
+    SECTION("Intervals are charged to the state at the previous sample") {
+        CHECK(MetricsAggregator::stateOf(*robot) == State::IDLE);
+        aggregator.observe(robots, 0.0);
+        CHECK(aggregator.robotName(0) == "Alpha");
+        CHECK(aggregator.robotTotals(0, Window::MINUTE).observedSeconds() == 0.0);
+
+        robot->failed_ = true;
+        CHECK(MetricsAggregator::stateOf(*robot) == State::ERROR);
+        aggregator.observe(robots, 5.0);
+        auto totals = aggregator.robotTotals(0, Window::MINUTE);
+        CHECK(totals.seconds[static_cast<size_t>(State::IDLE)] == Approx(5.0));
+        CHECK(totals.errors == 1.0);
+
+        // Staying failed is not a new error
+        aggregator.observe(robots, 8.0);
+        totals = aggregator.robotTotals(0, Window::MINUTE);
+        CHECK(totals.seconds[static_cast<size_t>(State::ERROR)] == Approx(3.0));
+        CHECK(totals.errors == 1.0);
+    }
+
+    SECTION("A new robot at an index starts afresh") {
+        aggregator.observe(robots, 0.0);
+        aggregator.observe(robots, 5.0);
+        REQUIRE(aggregator.robotTotals(0, Window::MINUTE).observedSeconds() == 5.0);
+        robots[0] = std::make_shared<Robot>("Beta", 100.0, Robot::Size::SMALL, Robot::Strategy::SCRUB, 100.0);
+        robots[0]->failed_ = true;
+        aggregator.observe(robots, 10.0);
+        CHECK(aggregator.robotName(0) == "Beta");
+        CHECK(aggregator.robotTotals(0, Window::MINUTE).observedSeconds() == 0.0);
+    }
+}
+
+TEST_CASE("Simulator feeds the aggregator every tick", "[analytics]") {
+    auto map = std::make_shared<Map>();
+    map->addRoom("Charging Station", 0, "tile", "small", true);
+    map->addRoom("Lounge", 1, "carpet", "medium", false);
+    map->connectRooms(map->getRoomById(0), map->getRoomById(1));
+    map->addCharger(0, 2);
+    map->publishSnapshot();
+    auto simulator = std::make_shared<RobotSimulator>(map, nullptr, nullptr, nullptr);
+    simulator->addRobot("Alpha");
+    simulator->addRobot("Beta");
+    auto aggregator = std::make_shared<MetricsAggregator>();
+    simulator->setMetricsAggregator(aggregator);
+    REQUIRE(simulator->getMetricsAggregator() == aggregator);
+
+    simulator->moveRobotToRoom("Alpha", 1);
+    for (int i = 0; i < 5; ++i) simulator->update(1.0);
+
+    REQUIRE(aggregator->robotCount() == 2);
+    CHECK(aggregator->robotName(0) == "Alpha");
+    CHECK(aggregator->robotName(1) == "Beta");
+    // The first tick only takes a sample; the next four are charged
+    CHECK(aggregator->fleetTotals(MetricsAggregator::Window::MINUTE).observedSeconds() == Approx(8.0));
+    CHECK(aggregator->robotTotals(0, MetricsAggregator::Window::MINUTE).busySeconds() > 0.0);
+    CHECK(aggregator->robotTotals(1, MetricsAggregator::Window::MINUTE).busySeconds() == 0.0);
+    CHECK(simulator->getProfiler().histogram(TickProfiler::Phase::ROBOT_METRICS).count() == 0);
+}
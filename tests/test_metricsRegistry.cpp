@@ -0,0 +1,205 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include "Metrics/MetricsRegistry.h"
+#include "Metrics/MetricsServer.h"
+#include "SimulationThread/SimulationThread.h"
+#include "RobotSimulator/RobotSimulator.hpp"
+#include "map/map.h"
+#include "Room/Room.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    bool contains(const std::string& text, const std::string& part) {
+        return text.find(part) != std::string::npos;
+    }
+
+    // Whole response, headers included
+    std::string httpRequest(uint16_t port, const std::string& request) {
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) throw std::runtime_error("socket failed");
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(port);
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            ::close(fd);
+            throw std::runtime_error("connect failed");
+        }
+        ::send(fd, request.data(), request.size(), 0);
+        std::string reply;
+        char buffer[4096];
+        ssize_t n;
+        while ((n = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) reply.append(buffer, static_cast<size_t>(n));
+        ::close(fd);
+        return reply;
+    }
+}
+
+TEST_CASE("Metrics Registry", "[metrics]") {
+    MetricsRegistry registry;
+
+    SECTION("Counters add up across threads") {
+        Counter& counter = registry.counter("test_events_total", "Events");
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&counter]() {
+                for (int i = 0; i < 10000; ++i) counter.inc();
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        counter.inc(5);
+        CHECK(counter.value() == 80005);
+        // One thread keeps its slot
+        CHECK(Counter::shardIndex() == Counter::shardIndex());
+        CHECK(Counter::shardIndex() < Counter::kShards);
+    }
+
+    SECTION("The same name and labels give the same metric") {
+        Gauge& first = registry.gauge("test_depth", "Depth", {{"queue", "a"}});
+        Gauge& again = registry.gauge("test_depth", "Depth", {{"queue", "a"}});
+        Gauge& other = registry.gauge("test_depth", "Depth", {{"queue", "b"}});
+        CHECK(&first == &again);
+        CHECK(&first != &other);
+
+        first.set(3);
+        first.add(-1.5);
+        CHECK(again.value() == Catch::Approx(1.5));
+        CHECK(other.value() == 0.0);
+    }
+
+    SECTION("Names and types are checked") {
+        registry.counter("test_total", "Total");
+        CHECK_THROWS_AS(registry.gauge("test_total", "Total"), std::runtime_error);
+        CHECK_THROWS_AS(registry.histogram("test_total", "Total"), std::runtime_error);
+        CHECK_THROWS_AS(registry.counter("0starts_with_digit", "Bad"), std::runtime_error);
+        CHECK_THROWS_AS(registry.counter("has space", "Bad"), std::runtime_error);
+        CHECK_THROWS_AS(registry.counter("test_labelled", "Bad", {{"bad-label", "x"}}), std::runtime_error);
+    }
+
+    SECTION("Histogram bounds are inclusive and the overflow counts only towards +Inf") {
+        Histogram& histogram = registry.histogram("test_seconds", "Latency", {}, {1.0, 0.1, 0.5});
+        REQUIRE(histogram.bounds() == std::vector<double>{0.1, 0.5, 1.0});
+        histogram.observe(0.05);
+        histogram.observe(0.1);
+        histogram.observe(0.3);
+        histogram.observe(2.0);
+        CHECK(histogram.bucketCounts() == std::vector<uint64_t>{2, 1, 0, 1});
+        CHECK(histogram.count() == 4);
+        CHECK(histogram.sum() == Catch::Approx(2.45));
+
+        // Later series of the family share the first one's bounds
+        Histogram& labelled = registry.histogram("test_seconds", "Latency", {{"op", "x"}}, {42.0});
+        CHECK(labelled.bounds() == histogram.bounds());
+    }
+
+    SECTION("Exposition follows the text format") {
+        registry.counter("test_requests_total", "Requests served", {{"code", "200"}}).inc(7);
+        registry.gauge("test_temperature", "Current \\ temperature").set(21.5);
+        registry.gauge("test_rooms", "Rooms", {{"name", "Room \"A\"\n"}}).set(2);
+        Histogram& histogram = registry.histogram("test_tick_seconds", "Tick", {{"phase", "all"}}, {0.01, 0.1});
+        histogram.observe(0.005);
+        histogram.observe(0.05);
+        histogram.observe(0.5);
+
+        std::string text = registry.exposition();
+        CHECK(contains(text, "# HELP test_requests_total Requests served\n# TYPE test_requests_total counter\n"));
+        CHECK(contains(text, "test_requests_total{code=\"200\"} 7\n"));
+        CHECK(contains(text, "# HELP test_temperature Current \\\\ temperature\n"));
+        CHECK(contains(text, "# TYPE test_temperature gauge\ntest_temperature 21.5\n"));
+        CHECK(contains(text, "test_rooms{name=\"Room \\\"A\\\"\\n\"} 2\n"));
+        CHECK(contains(text, "# TYPE test_tick_seconds histogram\n"));
+        CHECK(contains(text, "test_tick_seconds_bucket{phase=\"all\",le=\"0.01\"} 1\n"));
+        CHECK(contains(text, "test_tick_seconds_bucket{phase=\"all\",le=\"0.1\"} 2\n"));
+        CHECK(contains(text, "test_tick_seconds_bucket{phase=\"all\",le=\"+Inf\"} 3\n"));
+        CHECK(contains(text, "test_tick_seconds_sum{phase=\"all\"} 0.555\n"));
+        CHECK(contains(text, "test_tick_seconds_count{phase=\"all\"} 3\n"));
+        // Families in name order
+        CHECK(text.find("test_requests_total") < text.find("test_rooms"));
+        CHECK(text.find("test_rooms") < text.find("test_temperature"));
+    }
+}
+
+TEST_CASE("Metrics Server", "[metrics]") {
+    MetricsRegistry registry;
+    registry.counter("test_scraped_total", "Scraped").inc(3);
+    MetricsServer server(registry, 0);
+    server.start();
+    REQUIRE(server.isRunning());
+    REQUIRE(server.getPort() != 0);
+
+    SECTION("GET /metrics returns the exposition") {
+        std::string reply = httpRequest(server.getPort(), "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+        CHECK(contains(reply, "HTTP/1.0 200 OK\r\n"));
+        CHECK(contains(reply, "Content-Type: text/plain; version=0.0.4"));
+        CHECK(contains(reply, "\r\n\r\n# HELP test_scraped_total Scraped\n"));
+        CHECK(contains(reply, "test_scraped_total 3\n"));
+        CHECK(server.getScrapeCount() == 1);
+
+        // Each scrape sees current values
+        registry.counter("test_scraped_total", "Scraped").inc();
+        CHECK(contains(httpRequest(server.getPort(), "GET /metrics?x=1 HTTP/1.0\r\n\r\n"), "test_scraped_total 4\n"));
+    }
+
+    SECTION("Other paths and methods are refused") {
+        CHECK(contains(httpRequest(server.getPort(), "GET / HTTP/1.0\r\n\r\n"), "404 Not Found"));
+        CHECK(contains(httpRequest(server.getPort(), "POST /metrics HTTP/1.0\r\n\r\n"), "405 Method Not Allowed"));
+        std::string head = httpRequest(server.getPort(), "HEAD /metrics HTTP/1.0\r\n\r\n");
+        CHECK(contains(head, "200 OK"));
+        CHECK_FALSE(contains(head, "test_scraped_total"));
+        CHECK(server.getScrapeCount() == 1);
+    }
+
+    SECTION("A taken port fails to start") {
+        MetricsServer clash(registry, server.getPort());
+        CHECK_THROWS_AS(clash.start(), std::runtime_error);
+        CHECK_FALSE(clash.isRunning());
+    }
+
+    server.stop();
+    CHECK_FALSE(server.isRunning());
+}
+
+TEST_CASE("Simulation metrics", "[metrics]") {
+    auto map = std::make_shared<Map>();
+    map->addRoom("Charging Station", 0, "tile", "small", true);
+    map->addRoom("Lounge", 1, "carpet", "medium", false);
+    map->connectRooms(map->getRoomById(0), map->getRoomById(1));
+    map->addCharger(0, 2);
+    map->publishSnapshot();
+    auto simulator = std::make_shared<RobotSimulator>(map, nullptr, nullptr, nullptr);
+    simulator->addRobot("Alpha");
+    simulator->addRobot("Beta");
+
+    MetricsRegistry& metrics = MetricsRegistry::global();
+    SimulationThread simulation(simulator, nullptr);
+    uint64_t ticksBefore = metrics.counter("robot_simulation_ticks_total", "Simulation ticks run").value();
+    uint64_t timedBefore = metrics.histogram("robot_simulation_tick_seconds", "").count();
+
+    simulation.post([](RobotSimulator&) {});
+    CHECK(metrics.gauge("robot_simulation_command_queue_depth", "", {{"queue", "posted"}}).value() == 1.0);
+
+    simulation.step();
+    CHECK(metrics.gauge("robot_simulation_command_queue_depth", "", {{"queue", "posted"}}).value() == 0.0);
+    CHECK(metrics.counter("robot_simulation_ticks_total", "").value() == ticksBefore + 1);
+    CHECK(metrics.histogram("robot_simulation_tick_seconds", "").count() == timedBefore + 1);
+
+    // Every robot is counted under exactly one status
+    REQUIRE(simulation.refresh());
+    double counted = 0.0;
+    for (const auto& robot : simulation.latest().robots) {
+        CHECK(metrics.gauge("robot_fleet_robots", "", {{"status", robot.status.status}}).value() >= 1.0);
+    }
+    for (const char* status : {"Idle", "Moving", "Cleaning", "Charging", "Error", "Disabled (No Battery)"}) {
+        counted += metrics.gauge("robot_fleet_robots", "", {{"status", status}}).value();
+    }
+    CHECK(counted == 2.0);
+    CHECK(contains(metrics.exposition(), "# TYPE robot_fleet_robots gauge\n"));
+}
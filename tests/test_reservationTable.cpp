@@ -0,0 +1,76 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ReservationTable/ReservationTable.h"
+#include "Robot/Robot.h"
+#include "map/map.h"
+#include "Room/Room.h"
+#include <vector>
+
+// Builds a crossroads: 1 - 2 - 3 across and 4 - 2 - 5 down, with room 2 as the only junction
+static void buildCrossroads(Map& map) {
+    map.addRoom("Charging Station", 0, "tile", "small", true);
+    for (int id = 1; id <= 5; ++id) {
+        map.addRoom("Room " + std::to_string(id), id, "wood", "small", false);
+    }
+    map.connectRooms(map.getRoomById(0), map.getRoomById(1));
+    map.connectRooms(map.getRoomById(1), map.getRoomById(2));
+    map.connectRooms(map.getRoomById(2), map.getRoomById(3));
+    map.connectRooms(map.getRoomById(4), map.getRoomById(2));
+    map.connectRooms(map.getRoomById(2), map.getRoomById(5));
+}
+
+TEST_CASE("Reservation Table", "[traffic]") {
+    Map map;
+    buildCrossroads(map);
+    Robot first("First", 100.0, Robot::Size::SMALL, Robot::Strategy::VACUUM);
+    Robot second("Second", 100.0, Robot::Size::SMALL, Robot::Strategy::VACUUM);
+
+    SECTION("Second robot waits for the junction") {
+        ReservationTable table(map);
+        auto a = table.planRoute(&first, map.getRoomById(1), map.getRoomById(3), 0);
+        auto b = table.planRoute(&second, map.getRoomById(4), map.getRoomById(5), 0);
+
+        CHECK(a == std::vector<int>{1, 2, 3});
+        CHECK(b == std::vector<int>{4, 4, 2, 5});
+        CHECK(table.getStats().plans == 2);
+        CHECK(table.getStats().waitSlots == 1);
+        CHECK(table.getStats().fallbacks == 0);
+    }
+
+    SECTION("Destination stays reserved while the robot cleans") {
+        ReservationTable table(map);
+        auto a = table.planRoute(&first, map.getRoomById(1), map.getRoomById(2), 0, 2);
+        auto b = table.planRoute(&second, map.getRoomById(4), map.getRoomById(5), 0);
+
+        CHECK(a == std::vector<int>{1, 2});
+        // Room 2 is held for slots 1 to 3, so the crossing waits until slot 4
+        CHECK(b == std::vector<int>{4, 4, 4, 4, 2, 5});
+        CHECK(table.getStats().waitSlots == 3);
+    }
+
+    SECTION("Releasing a plan frees its rooms") {
+        ReservationTable table(map);
+        table.planRoute(&first, map.getRoomById(1), map.getRoomById(3), 0);
+        table.release(&first);
+        CHECK(table.reservationCount() == 0);
+
+        auto b = table.planRoute(&second, map.getRoomById(4), map.getRoomById(5), 0);
+        CHECK(b == std::vector<int>{4, 2, 5});
+    }
+
+    SECTION("Old slots are dropped as time advances") {
+        ReservationTable table(map);
+        table.planRoute(&first, map.getRoomById(1), map.getRoomById(3), 0);
+        CHECK(table.reservationCount() == 3);
+        table.advanceTo(2);
+        CHECK(table.reservationCount() == 1);
+    }
+
+    SECTION("Charging station is shared without reservations") {
+        ReservationTable table(map);
+        auto a = table.planRoute(&first, map.getRoomById(2), map.getRoomById(0), 0, 5);
+        auto b = table.planRoute(&second, map.getRoomById(3), map.getRoomById(0), 1, 5);
+
+        CHECK(a == std::vector<int>{2, 1, 0});
+        CHECK(b == std::vector<int>{3, 2, 1, 0});
+    }
+}
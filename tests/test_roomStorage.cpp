@@ -0,0 +1,74 @@
+#include <catch2/catch_test_macros.hpp>
+#include "map/map.h"
+#include "Room/Room.h"
+#include "Room/InternedString.h"
+#include <memory>
+#include <vector>
+
+TEST_CASE("Room Storage", "[map]") {
+    SECTION("Interned strings share one copy and compare as strings") {
+        InternedString a("carpet");
+        InternedString b(std::string("carpet"));
+        InternedString c("tile");
+
+        CHECK(a == b);
+        CHECK(&a.str() == &b.str());
+        CHECK(a != c);
+        CHECK(a == "carpet");
+        CHECK(std::string("tile") == c);
+        CHECK(InternedString().empty());
+    }
+
+    SECTION("Rooms keep stable addresses as the map grows") {
+        Map map;
+        map.addRoom("First", 0, "tile", "small", true);
+        Room* first = map.getRoomById(0);
+        for (int id = 1; id < 2000; ++id) {
+            map.addRoom("Room " + std::to_string(id), id, id % 2 ? "wood" : "carpet", "medium", false);
+        }
+
+        REQUIRE(map.getRoomById(0) == first);
+        CHECK(first->getRoomName() == "First");
+        CHECK(map.getRoomById(1999)->getFlooringType() == "wood");
+        CHECK(&map.getRoomById(2)->getFlooringType() == &map.getRoomById(4)->getFlooringType());
+        CHECK(&map.getRoomById(1)->getSize() == &map.getRoomById(2)->getSize());
+    }
+
+    SECTION("Copied rooms outlive the map") {
+        std::shared_ptr<Room> copy;
+        {
+            Map map(true);
+            Room* source = map.getRoomById(3);
+            map.connectRooms(source, map.getRoomById(0));
+            copy = std::make_shared<Room>(*source);
+        }
+        CHECK(copy->getRoomName() == "Master Bedroom");
+        CHECK(copy->getSize() == "large");
+        CHECK(copy->flooringType == "carpet");
+    }
+}
+
+TEST_CASE("Room Attributes", "[map]") {
+    SECTION("Size and flooring are parsed once, ignoring case") {
+        Room room("Living Room", 1, "Wood", "Large", true);
+        CHECK(room.getRoomSize() == RoomSize::LARGE);
+        CHECK(room.getFloorType() == FloorType::WOOD);
+        CHECK(isHardFloor(room.getFloorType()));
+        CHECK(room.getSize() == "Large");
+
+        CHECK(parseRoomSize("SMALL") == RoomSize::SMALL);
+        CHECK(parseRoomSize("medium") == RoomSize::MEDIUM);
+        CHECK(parseRoomSize("huge") == RoomSize::LARGE);
+        CHECK(parseFloorType("Carpet") == FloorType::CARPET);
+        CHECK(parseFloorType("tile") == FloorType::TILE);
+        CHECK(parseFloorType("marble") == FloorType::OTHER);
+        CHECK_FALSE(isHardFloor(FloorType::CARPET));
+    }
+
+    SECTION("Loaded rooms carry parsed attributes") {
+        Map map(true);
+        CHECK(map.getRoomById(3)->getRoomSize() == RoomSize::LARGE);
+        CHECK(map.getRoomById(3)->getFloorType() == FloorType::CARPET);
+        CHECK(map.getRoomById(0)->getFloorType() == FloorType::TILE);
+    }
+}
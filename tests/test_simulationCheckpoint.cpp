@@ -0,0 +1,320 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include "Checkpoint/SimulationCheckpoint.h"
+#include "AutoTaskPlanner/AutoTaskPlanner.h"
+#include "RobotSimulator/RobotSimulator.hpp"
+#include "Scheduler/Scheduler.hpp"
+#include "CleaningTask/cleaningTask.h"
+#include "Robot/Robot.h"
+#include "map/map.h"
+#include "Room/Room.h"
+#include <memory>
+#include <stdexcept>
+
+using Catch::Approx;
+
+namespace {
+    // Charger - Lounge - Kitchen - Hall in a line
+    struct Fleet {
+        std::shared_ptr<Map> map = std::make_shared<Map>();
+        std::shared_ptr<RobotSimulator> simulator;
+        std::shared_ptr<Scheduler> scheduler;
+
+        Fleet() {
+            map->addRoom("Charging Station", 0, "tile", "small", true);
+            map->addRoom("Lounge", 1, "carpet", "medium", true);
+            map->addRoom("Kitchen", 2, "tile", "small", true);
+            map->addRoom("Hall", 3, "wood", "large", true);
+            map->connectRooms(map->getRoomById(0), map->getRoomById(1));
+            map->connectRooms(map->getRoomById(1), map->getRoomById(2));
+            map->connectRooms(map->getRoomById(2), map->getRoomById(3));
+            map->addCharger(0, 2);
+            simulator = std::make_shared<RobotSimulator>(map, nullptr, nullptr, nullptr);
+            scheduler = std::make_shared<Scheduler>(map.get(), &simulator->getRobots());
+            scheduler->setSimulator(simulator);
+            simulator->setScheduler(scheduler);
+        }
+
+        std::shared_ptr<Robot> add(const std::string& name, int roomId, double battery = 100.0,
+                                   Robot::Size size = Robot::Size::MEDIUM,
+                                   Robot::Strategy strategy = Robot::Strategy::VACUUM, double water = 100.0) {
+            auto robot = std::make_shared<Robot>(name, battery, size, strategy, water);
+            robot->setCurrentRoom(map->getRoomById(roomId));
+            simulator->addRobot(robot);
+            return robot;
+        }
+
+        std::shared_ptr<Robot> robot(const std::string& name) {
+            for (const auto& r : simulator->getRobots()) {
+                if (r->getName() == name) return r;
+            }
+            return nullptr;
+        }
+    };
+}
+
+TEST_CASE("Checkpoint round trip", "[checkpoint]") {
+    Fleet before;
+    auto large = before.add("Large", 1, 80.0, Robot::Size::LARGE, Robot::Strategy::SCRUB, 60.0);
+    auto small = before.add("Small", 0, 100.0, Robot::Size::SMALL, Robot::Strategy::SHAMPOO);
+    auto broken = before.add("Broken", 2);
+    broken->failed_ = true;
+    broken->errorCount_ = 3;
+    broken->totalWorkTime_ = 42.0;
+    before.map->getRoomById(3)->markDirty();
+    before.simulator->setSimTime(120.0);
+
+    // Large is on its way to the kitchen; Small has a task waiting in the queue
+    before.scheduler->assignCleaningTask("Large", 2, "Scrub");
+    auto queued = std::make_shared<CleaningTask>(7, CleaningTask::HIGH, CleaningTask::SHAMPOO, before.map->getRoomById(3));
+    queued->assignRobot(small);
+    before.scheduler->addTask(queued);
+
+    SimulationCheckpoint checkpoint = SimulationCheckpoint::capture(*before.simulator, before.scheduler.get());
+    CHECK(checkpoint.simTime == 120.0);
+    CHECK(checkpoint.lastTaskId == 1);
+    REQUIRE(checkpoint.robots.size() == 3);
+    CHECK(checkpoint.robots[0].size == static_cast<int>(Robot::Size::LARGE));
+    CHECK(checkpoint.robots[0].currentTaskId == 1);
+    CHECK(checkpoint.robots[1].currentTaskId == -1);
+    CHECK(checkpoint.robots[2].failed);
+    REQUIRE(checkpoint.tasks.size() == 2);
+    CHECK(checkpoint.tasks[1].id == 7);
+    CHECK(checkpoint.tasks[1].robot == "Small");
+    CHECK(checkpoint.tasks[1].queued);
+    REQUIRE(checkpoint.rooms.size() == 4);
+    CHECK_FALSE(checkpoint.rooms[3].clean);
+
+    Fleet after;
+    after.add("Stale", 0);
+    checkpoint.restore(*after.simulator, *after.scheduler);
+
+    CHECK(after.simulator->getSimTime() == 120.0);
+    CHECK_FALSE(after.map->getRoomById(3)->isClean());
+    CHECK(after.map->getRoomById(2)->isClean());
+    REQUIRE(after.simulator->getRobots().size() == 3);
+    CHECK_FALSE(after.robot("Stale"));
+
+    auto restoredLarge = after.robot("Large");
+    REQUIRE(restoredLarge);
+    CHECK(restoredLarge->getSize() == Robot::Size::LARGE);
+    CHECK(restoredLarge->getStrategy() == Robot::Strategy::SCRUB);
+    CHECK(restoredLarge->getBatteryLevel() == 80.0);
+    CHECK(restoredLarge->getWaterLevel() == 60.0);
+    CHECK(restoredLarge->getCurrentRoom() == after.map->getRoomById(1));
+    REQUIRE(restoredLarge->getCurrentTask());
+    CHECK(restoredLarge->getCurrentTask()->getID() == 1);
+    CHECK(restoredLarge->isMoving());
+    CHECK(restoredLarge->getNextRoom() == after.map->getRoomById(2));
+
+    // Small was idle with a queued task, so it was sent straight to it
+    auto restoredSmall = after.robot("Small");
+    REQUIRE(restoredSmall);
+    CHECK(restoredSmall->getSize() == Robot::Size::SMALL);
+    REQUIRE(restoredSmall->getCurrentTask());
+    CHECK(restoredSmall->getCurrentTask()->getID() == 7);
+    CHECK(restoredSmall->getCurrentTask()->getPriority() == CleaningTask::HIGH);
+    CHECK(restoredSmall->getCurrentTask()->getCleanType() == CleaningTask::SHAMPOO);
+    CHECK(restoredSmall->getCurrentTask()->getRobot() == restoredSmall);
+    CHECK(restoredSmall->isMoving());
+
+    auto restoredBroken = after.robot("Broken");
+    REQUIRE(restoredBroken);
+    CHECK(restoredBroken->isFailed());
+    CHECK(restoredBroken->getErrorCount() == 3);
+    CHECK(restoredBroken->getTotalWorkTime() == 42.0);
+    CHECK_FALSE(restoredBroken->isMoving());
+
+    // Task 1 stays queued as it was; new ids continue after the highest restored one
+    REQUIRE(after.scheduler->getAllTasks().size() == 1);
+    CHECK(after.scheduler->getAllTasks()[0]->getID() == 1);
+    CHECK(after.scheduler->getLastTaskId() == 7);
+}
+
+TEST_CASE("Checkpoint resumes interrupted work", "[checkpoint]") {
+    Fleet before;
+
+    SECTION("A clean in progress resumes with its remaining time") {
+        auto alpha = before.add("Alpha", 1);
+        auto task = std::make_shared<CleaningTask>(1, CleaningTask::MEDIUM, CleaningTask::VACUUM, before.map->getRoomById(1));
+        task->assignRobot(alpha);
+        alpha->setCurrentTask(task);
+        alpha->startCleaning(CleaningTask::VACUUM);
+        REQUIRE(alpha->isCleaning());
+        alpha->updateState(2.0);
+        double remaining = alpha->getCleaningTimeRemaining();
+        REQUIRE(remaining > 0.0);
+
+        SimulationCheckpoint checkpoint = SimulationCheckpoint::capture(*before.simulator, before.scheduler.get());
+        REQUIRE(checkpoint.robots.size() == 1);
+        CHECK(checkpoint.robots[0].currentTaskId == 1);
+        CHECK(checkpoint.robots[0].savedTaskId == 1);
+        CHECK(checkpoint.robots[0].savedCleaningTimeRemaining == Approx(remaining));
+
+        Fleet after;
+        checkpoint.restore(*after.simulator, *after.scheduler);
+        auto restored = after.robot("Alpha");
+        REQUIRE(restored);
+        CHECK(restored->isCleaning());
+        CHECK(restored->getCleaningTimeRemaining() == Approx(remaining));
+        CHECK_FALSE(restored->getSavedTask());
+        CHECK(restored->getCurrentTask()->getStatus() == "In Progress");
+    }
+
+    SECTION("A robot low on battery heads to the charger and its task waits in the queue") {
+        auto alpha = before.add("Alpha", 2, 10.0);
+        auto task = std::make_shared<CleaningTask>(4, CleaningTask::LOW, CleaningTask::SCRUB, before.map->getRoomById(3));
+        task->assignRobot(alpha);
+        alpha->setCurrentTask(task);
+
+        SimulationCheckpoint checkpoint = SimulationCheckpoint::capture(*before.simulator, before.scheduler.get());
+        CHECK_FALSE(checkpoint.tasks[0].queued);
+
+        Fleet after;
+        checkpoint.restore(*after.simulator, *after.scheduler);
+        auto restored = after.robot("Alpha");
+        REQUIRE(restored);
+        CHECK_FALSE(restored->getCurrentTask());
+        CHECK(restored->isMoving());
+        CHECK(restored->getNextRoom() == after.map->getRoomById(1));
+        REQUIRE(after.scheduler->getAllTasks().size() == 1);
+        CHECK(after.scheduler->getAllTasks()[0]->getID() == 4);
+        CHECK(after.scheduler->getAllTasks()[0]->getRobot() == restored);
+        CHECK(after.scheduler->getAllTasks()[0]->getStatus() == "Pending");
+    }
+
+    SECTION("Finished tasks are not kept") {
+        auto alpha = before.add("Alpha", 1);
+        auto done = std::make_shared<CleaningTask>(2, CleaningTask::MEDIUM, CleaningTask::VACUUM, before.map->getRoomById(2));
+        done->assignRobot(alpha);
+        done->markCompleted();
+        before.scheduler->addTask(done);
+
+        SimulationCheckpoint checkpoint = SimulationCheckpoint::capture(*before.simulator, before.scheduler.get());
+        CHECK(checkpoint.tasks.empty());
+    }
+}
+
+TEST_CASE("Checkpoint keeps generated task ids apart", "[checkpoint]") {
+    std::vector<std::shared_ptr<CleaningTask>> generatedBefore, generatedAfter;
+    auto collect = [](std::vector<std::shared_ptr<CleaningTask>>& into) {
+        return [&into](const std::vector<std::shared_ptr<CleaningTask>>& batch) {
+            into.insert(into.end(), batch.begin(), batch.end());
+        };
+    };
+
+    Fleet before;
+    auto plannerBefore = std::make_shared<AutoTaskPlanner>(before.map, collect(generatedBefore));
+    before.simulator->setAutoTaskPlanner(plannerBefore);
+    before.map->getRoomById(3)->markDirty();
+    before.map->publishSnapshot();
+    plannerBefore->notifyAllRooms();
+    REQUIRE(plannerBefore->processPending() == 1);
+
+    // Alpha took the generated task; the scheduler has one of its own queued for Beta
+    auto alpha = before.add("Alpha", 1);
+    auto generated = generatedBefore[0];
+    generated->assignRobot(alpha);
+    alpha->setCurrentTask(generated);
+    before.add("Beta", 1);
+    before.scheduler->assignCleaningTask("Beta", 2, "Vacuum");
+
+    SimulationCheckpoint checkpoint = SimulationCheckpoint::capture(*before.simulator, before.scheduler.get());
+    CHECK(checkpoint.lastTaskId == 1);
+    CHECK(checkpoint.nextGeneratedTaskId == AutoTaskPlanner::kFirstTaskId + 1);
+
+    Fleet after;
+    auto plannerAfter = std::make_shared<AutoTaskPlanner>(after.map, collect(generatedAfter));
+    after.simulator->setAutoTaskPlanner(plannerAfter);
+    checkpoint.restore(*after.simulator, *after.scheduler);
+    after.map->publishSnapshot();
+
+    // Scheduler ids stay below the planner's range, and the planner carries on past its last id
+    CHECK(after.scheduler->getLastTaskId() == 1);
+    CHECK(plannerAfter->getNextTaskId() == AutoTaskPlanner::kFirstTaskId + 1);
+    CHECK(plannerAfter->hasOutstandingTask(3));
+    REQUIRE(after.robot("Alpha")->getCurrentTask());
+    CHECK(after.robot("Alpha")->getCurrentTask()->getID() == AutoTaskPlanner::kFirstTaskId);
+
+    // Room 3 already has its task back, so the startup pass does not make another
+    plannerAfter->notifyAllRooms();
+    CHECK(plannerAfter->processPending() == 0);
+    after.map->getRoomById(2)->markDirty();
+    plannerAfter->notifyRoomChanged(2);
+    REQUIRE(plannerAfter->processPending() == 1);
+    CHECK(generatedAfter[0]->getID() == AutoTaskPlanner::kFirstTaskId + 1);
+}
+
+TEST_CASE("Checkpoint restore on a changed map", "[checkpoint]") {
+    SimulationCheckpoint checkpoint;
+    checkpoint.simTime = 30.0;
+    SimulationCheckpoint::RobotState robot;
+    robot.name = "Alpha";
+    robot.roomId = 99;
+    robot.currentTaskId = 5;
+    checkpoint.robots.push_back(robot);
+    SimulationCheckpoint::TaskState task;
+    task.id = 5;
+    task.roomId = 99;
+    task.robot = "Alpha";
+    task.queued = true;
+    checkpoint.tasks.push_back(task);
+    checkpoint.rooms.push_back(SimulationCheckpoint::RoomState{99, false});
+
+    Fleet after;
+
+    SECTION("Robots in removed rooms start at the charger and their tasks are dropped") {
+        checkpoint.restore(*after.simulator, *after.scheduler);
+        auto restored = after.robot("Alpha");
+        REQUIRE(restored);
+        CHECK(restored->getCurrentRoom() == after.map->getRoomById(0));
+        CHECK_FALSE(restored->getCurrentTask());
+        CHECK(after.scheduler->getAllTasks().empty());
+    }
+
+    SECTION("An unknown version is refused") {
+        checkpoint.version = SimulationCheckpoint::kVersion + 1;
+        CHECK_THROWS_AS(checkpoint.restore(*after.simulator, *after.scheduler), std::runtime_error);
+    }
+}
+
+TEST_CASE("Checkpointer", "[checkpoint]") {
+    Fleet fleet;
+    fleet.add("Alpha", 0);
+    Checkpointer checkpointer(nullptr, 5.0);
+
+    SECTION("Captures once per interval and keeps only the latest") {
+        fleet.simulator->setSimTime(1.0);
+        checkpointer.record(*fleet.simulator, 1.0);
+        fleet.simulator->setSimTime(3.0);
+        checkpointer.record(*fleet.simulator, 3.0);
+        CHECK(checkpointer.getCaptureCount() == 1);
+
+        fleet.simulator->setSimTime(6.0);
+        checkpointer.record(*fleet.simulator, 6.0);
+        CHECK(checkpointer.getCaptureCount() == 2);
+
+        auto pending = checkpointer.takePending();
+        REQUIRE(pending);
+        CHECK(pending->simTime == 6.0);
+        CHECK(pending->robots.size() == 1);
+        CHECK_FALSE(checkpointer.takePending());
+    }
+
+    SECTION("The simulator records through its checkpointer") {
+        auto shared = std::make_shared<Checkpointer>(nullptr, 5.0);
+        fleet.simulator->setCheckpointer(shared);
+        for (int i = 0; i < 6; ++i) fleet.simulator->update(1.0);
+        CHECK(shared->getCaptureCount() == 2);
+    }
+
+    SECTION("Stopping writes out the last capture") {
+        checkpointer.start();
+        checkpointer.record(*fleet.simulator, 1.0);
+        checkpointer.stop();
+        CHECK_FALSE(checkpointer.isRunning());
+        CHECK_FALSE(checkpointer.takePending());
+        // No database in tests, so nothing counts as written
+        CHECK(checkpointer.getWriteCount() == 0);
+    }
+}
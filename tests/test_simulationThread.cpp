@@ -0,0 +1,167 @@
+#include <catch2/catch_test_macros.hpp>
+#include "SimulationThread/SimulationThread.h"
+#include "SimulationThread/TripleBuffer.h"
+#include "RobotSimulator/RobotSimulator.hpp"
+#include "Scheduler/Scheduler.hpp"
+#include "Robot/Robot.h"
+#include "map/map.h"
+#include "map/MapSnapshot.h"
+#include "Room/Room.h"
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Charger 0 connected to rooms 1 and 2
+    std::shared_ptr<Map> buildMap() {
+        auto map = std::make_shared<Map>();
+        map->addRoom("Charging Station", 0, "tile", "small", true);
+        map->addRoom("Lounge", 1, "carpet", "medium", false);
+        map->addRoom("Kitchen", 2, "tile", "medium", false);
+        map->connectRooms(map->getRoomById(0), map->getRoomById(1));
+        map->connectRooms(map->getRoomById(0), map->getRoomById(2));
+        map->addCharger(0, 2);
+        map->publishSnapshot();
+        return map;
+    }
+
+    template <typename Condition>
+    bool waitFor(Condition condition) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (condition()) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        return condition();
+    }
+}
+
+TEST_CASE("Triple Buffer", "[simthread]") {
+    TripleBuffer<int> buffer;
+    CHECK_FALSE(buffer.refresh());
+
+    buffer.writeBuffer() = 1;
+    buffer.publish();
+    buffer.writeBuffer() = 2;
+    buffer.publish();
+    // The reader skips straight to the newest value
+    REQUIRE(buffer.refresh());
+    CHECK(buffer.read() == 2);
+    CHECK_FALSE(buffer.refresh());
+    CHECK(buffer.read() == 2);
+
+    buffer.writeBuffer() = 3;
+    buffer.publish();
+    REQUIRE(buffer.refresh());
+    CHECK(buffer.read() == 3);
+
+    SECTION("Concurrent writer never tears a value") {
+        struct Pair { long a = 0; long b = 0; };
+        TripleBuffer<Pair> pairs;
+        std::thread writer([&pairs]() {
+            for (long i = 1; i <= 200000; ++i) {
+                pairs.writeBuffer() = Pair{i, -i};
+                pairs.publish();
+            }
+        });
+        long last = 0;
+        bool consistent = true;
+        bool monotonic = true;
+        while (last < 200000) {
+            if (!pairs.refresh()) continue;
+            const Pair& value = pairs.read();
+            consistent = consistent && value.a == -value.b;
+            monotonic = monotonic && value.a > last;
+            last = value.a;
+        }
+        writer.join();
+        CHECK(consistent);
+        CHECK(monotonic);
+    }
+}
+
+TEST_CASE("Simulation Thread", "[simthread]") {
+    auto map = buildMap();
+    auto simulator = std::make_shared<RobotSimulator>(map, nullptr, nullptr, nullptr);
+    simulator->getRobots().push_back(std::make_shared<Robot>("Shampooer", 100.0, Robot::Size::MEDIUM,
+                                                             Robot::Strategy::SHAMPOO, 100.0));
+    simulator->getRobots().back()->setCurrentRoom(map->getRoomById(0));
+    simulator->getRobots().back()->setMap(map.get());
+    simulator->addRobot("Vacuum");
+    auto scheduler = std::make_shared<Scheduler>(map.get(), &simulator->getRobots());
+    simulator->setScheduler(scheduler);
+
+    SimulationThread simulation(simulator, scheduler);
+    REQUIRE(simulation.refresh());
+
+    SECTION("The first snapshot is there before any tick") {
+        const FleetSnapshot& fleet = simulation.latest();
+        CHECK(fleet.tick == 0);
+        REQUIRE(fleet.robots.size() == 2);
+        CHECK(fleet.robots[0].status.name == "Shampooer");
+        CHECK(fleet.robots[0].strategy == Robot::Strategy::SHAMPOO);
+        CHECK(fleet.robots[0].currentRoomId == 0);
+        CHECK(fleet.robots[1].status.currentRoomName == "Charging Station");
+        CHECK(fleet.map == map->getSnapshot());
+        CHECK(fleet.tasks.empty());
+        CHECK(fleet.changedRobots == std::vector<size_t>{0, 1});
+    }
+
+    SECTION("Commands run before the next tick and show up in its snapshot") {
+        simulation.post([](RobotSimulator& sim) {
+            sim.moveRobotToRoom("Vacuum", 2);
+        });
+        simulation.post([scheduler](RobotSimulator&) {
+            scheduler->assignCleaningTask("Shampooer", 1, "Shampoo");
+        });
+        CHECK(simulation.pendingCommands() == 2);
+        CHECK_FALSE(simulation.refresh());
+
+        simulation.step();
+        CHECK(simulation.pendingCommands() == 0);
+        REQUIRE(simulation.refresh());
+        const FleetSnapshot& fleet = simulation.latest();
+        CHECK(fleet.tick == 1);
+        REQUIRE(fleet.tasks.size() == 1);
+        CHECK(fleet.tasks[0].roomName == "Lounge");
+        CHECK(fleet.tasks[0].robotName == "Shampooer");
+        CHECK(fleet.tasks[0].cleanType == CleaningTask::SHAMPOO);
+        CHECK(fleet.robots[1].nextRoomId == 2);
+        CHECK(fleet.robots[1].status.status == "Moving");
+    }
+
+    SECTION("A failing command does not stop the ones after it") {
+        simulation.post([](RobotSimulator&) { throw std::runtime_error("bad command"); });
+        simulation.post([](RobotSimulator& sim) { sim.getRobots()[0]->failed_ = true; });
+        simulation.step();
+        REQUIRE(simulation.refresh());
+        CHECK(simulation.latest().robots[0].failed);
+        CHECK(simulation.latest().robots[0].status.status == "Error");
+    }
+
+    SECTION("Unchanged ticks report no changed robots") {
+        simulation.step();
+        simulation.step();
+        REQUIRE(simulation.refresh());
+        const FleetSnapshot& fleet = simulation.latest();
+        CHECK(fleet.tick == 2);
+        CHECK(fleet.changedRobots.empty());
+        CHECK(fleet.previousStatusVersion == fleet.statusVersion);
+    }
+
+    SECTION("Running thread ticks, and posted commands wake it early") {
+        simulation.setTickInterval(std::chrono::milliseconds(20));
+        simulation.start();
+        REQUIRE(waitFor([&]() { simulation.refresh(); return simulation.latest().tick >= 3; }));
+
+        simulation.setTickInterval(std::chrono::milliseconds(60000));
+        // Let the loop pick up the long interval before posting
+        uint64_t ticks = simulation.getTickCount();
+        REQUIRE(waitFor([&]() { return simulation.getTickCount() > ticks; }));
+        simulation.post([](RobotSimulator& sim) { sim.getRobots()[1]->failed_ = true; });
+        CHECK(waitFor([&]() { simulation.refresh(); return simulation.latest().robots[1].failed; }));
+        simulation.stop();
+        CHECK_FALSE(simulation.isRunning());
+    }
+}
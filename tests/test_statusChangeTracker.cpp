@@ -0,0 +1,110 @@
+#include <catch2/catch_test_macros.hpp>
+#include "adapter/StatusChangeTracker.hpp"
+#include "Robot/Robot.h"
+
+namespace {
+    RobotStatusRecord record(const std::string& name, double battery = 80.0) {
+        RobotStatusRecord result;
+        result.name = name;
+        result.batteryLevel = battery;
+        result.waterLevel = 50.0;
+        result.status = "Idle";
+        result.currentRoom = "Lounge";
+        return result;
+    }
+}
+
+TEST_CASE("Status records", "[status]") {
+    Robot robot("Alpha", 75.0, Robot::Size::MEDIUM, Robot::Strategy::VACUUM, 40.0);
+    RobotStatusRecord fromRobot = RobotStatusRecord::from(robot);
+    CHECK(fromRobot.name == "Alpha");
+    CHECK(fromRobot.batteryLevel == robot.getBatteryLevel());
+    CHECK(fromRobot.waterLevel == robot.getWaterLevel());
+    CHECK(fromRobot.status == robot.getStatus());
+    CHECK(fromRobot.currentRoom == "Unknown");
+
+    RobotStatusRecord a = record("Alpha");
+    RobotStatusRecord b = a;
+    CHECK(a.hash() == b.hash());
+    CHECK(a.changedFrom(b) == 0);
+
+    // Drift under 0.1% is not a change
+    b.batteryLevel += 0.01;
+    CHECK(a.hash() == b.hash());
+    CHECK(a.changedFrom(b) == 0);
+
+    b.batteryLevel = 79.0;
+    b.isCharging = true;
+    CHECK(a.hash() != b.hash());
+    CHECK(b.changedFrom(a) == (RobotStatusRecord::BATTERY_LEVEL | RobotStatusRecord::IS_CHARGING));
+
+    b = a;
+    b.currentRoom = "Kitchen";
+    b.lowWaterAlertSent = true;
+    CHECK(b.changedFrom(a) == (RobotStatusRecord::CURRENT_ROOM | RobotStatusRecord::LOW_WATER_ALERT_SENT));
+}
+
+TEST_CASE("Status change tracker", "[status]") {
+    StatusChangeTracker tracker;
+
+    SECTION("A robot's first save sends every field") {
+        CHECK(tracker.fieldsToWrite(record("Alpha")) == RobotStatusRecord::ALL_FIELDS);
+        // Until the write is acknowledged the next save sends everything again
+        CHECK(tracker.fieldsToWrite(record("Alpha")) == RobotStatusRecord::ALL_FIELDS);
+        CHECK(tracker.getStats().skipped == 0);
+    }
+
+    SECTION("Unchanged saves are skipped, changed ones send only the changes") {
+        tracker.markWritten(record("Alpha"), RobotStatusRecord::ALL_FIELDS);
+        CHECK(tracker.fieldsToWrite(record("Alpha")) == 0);
+        CHECK(tracker.fieldsToWrite(record("Alpha", 80.02)) == 0);
+        CHECK(tracker.getStats().skipped == 2);
+
+        RobotStatusRecord moved = record("Alpha", 79.5);
+        moved.status = "Cleaning";
+        uint32_t fields = tracker.fieldsToWrite(moved);
+        CHECK(fields == (RobotStatusRecord::BATTERY_LEVEL | RobotStatusRecord::STATUS));
+        tracker.markWritten(moved, fields);
+        CHECK(tracker.fieldsToWrite(moved) == 0);
+
+        const auto& stats = tracker.getStats();
+        CHECK(stats.written == 2);
+        CHECK(stats.skipped == 3);
+        CHECK(stats.fieldsWritten == 12);
+
+        // Other robots are tracked separately
+        CHECK(tracker.fieldsToWrite(record("Beta")) == RobotStatusRecord::ALL_FIELDS);
+    }
+
+    SECTION("Small drifts add up against the value last written") {
+        tracker.markWritten(record("Alpha", 80.0), RobotStatusRecord::ALL_FIELDS);
+
+        // Water changes while battery creeps by less than 0.1% each time
+        RobotStatusRecord next = record("Alpha", 80.04);
+        next.waterLevel = 49.0;
+        uint32_t fields = tracker.fieldsToWrite(next);
+        CHECK(fields == RobotStatusRecord::WATER_LEVEL);
+        tracker.markWritten(next, fields);
+
+        next = record("Alpha", 80.08);
+        next.waterLevel = 49.0;
+        CHECK(tracker.fieldsToWrite(next) == RobotStatusRecord::BATTERY_LEVEL);
+    }
+
+    SECTION("Forgotten robots are written in full again") {
+        tracker.markWritten(record("Alpha"), RobotStatusRecord::ALL_FIELDS);
+        tracker.markWritten(record("Beta"), RobotStatusRecord::ALL_FIELDS);
+        tracker.forget("Alpha");
+        CHECK(tracker.fieldsToWrite(record("Alpha")) == RobotStatusRecord::ALL_FIELDS);
+        CHECK(tracker.fieldsToWrite(record("Beta")) == 0);
+
+        tracker.clear();
+        CHECK(tracker.fieldsToWrite(record("Beta")) == RobotStatusRecord::ALL_FIELDS);
+    }
+
+    SECTION("Nothing marked for an empty field set") {
+        tracker.markWritten(record("Alpha"), 0);
+        CHECK(tracker.getStats().written == 0);
+        CHECK(tracker.fieldsToWrite(record("Alpha")) == RobotStatusRecord::ALL_FIELDS);
+    }
+}
@@ -0,0 +1,101 @@
+#include <catch2/catch_test_macros.hpp>
+#include "RobotSimulator/RobotSimulator.hpp"
+#include "CleaningTask/cleaningTask.h"
+#include "Robot/Robot.h"
+#include "map/map.h"
+#include "Room/Room.h"
+#include <memory>
+#include <vector>
+
+namespace {
+    // Charger 0 connected to rooms 1 and 2
+    std::shared_ptr<Map> buildMap() {
+        auto map = std::make_shared<Map>();
+        map->addRoom("Charging Station", 0, "tile", "small", true);
+        map->addRoom("Lounge", 1, "carpet", "medium", true);
+        map->addRoom("Kitchen", 2, "tile", "small", true);
+        map->connectRooms(map->getRoomById(0), map->getRoomById(1));
+        map->connectRooms(map->getRoomById(0), map->getRoomById(2));
+        map->addCharger(0, 2);
+        map->publishSnapshot();
+        return map;
+    }
+}
+
+TEST_CASE("Robot Status Feed", "[statusfeed]") {
+    auto map = buildMap();
+    RobotSimulator simulator(map, nullptr, nullptr, nullptr);
+    simulator.addRobot("A");
+    simulator.addRobot("B");
+    simulator.addRobot("C");
+    auto& robots = simulator.getRobots();
+
+    uint64_t first = simulator.collectStatusChanges();
+    CHECK(first == 1);
+    CHECK(simulator.getChangedRobots(0) == std::vector<size_t>{0, 1, 2});
+
+    SECTION("Nothing changed keeps the version") {
+        CHECK(simulator.collectStatusChanges() == first);
+        CHECK(simulator.getChangedRobots(first).empty());
+    }
+
+    SECTION("Only the robots that changed are reported") {
+        robots[1]->setCurrentRoom(map->getRoomById(2));
+        uint64_t second = simulator.collectStatusChanges();
+        CHECK(second == first + 1);
+        CHECK(simulator.getChangedRobots(first) == std::vector<size_t>{1});
+
+        robots[2]->failed_ = true;
+        uint64_t third = simulator.collectStatusChanges();
+        CHECK(simulator.getChangedRobots(second) == std::vector<size_t>{2});
+        CHECK(simulator.getChangedRobots(first) == std::vector<size_t>{1, 2});
+        CHECK(simulator.getChangedRobots(third).empty());
+        CHECK(simulator.getRobotStatus(2).status == "Error");
+        CHECK(simulator.getRobotStatus(1).currentRoomName == "Kitchen");
+    }
+
+    SECTION("Robots added through getRobots are picked up") {
+        robots.push_back(std::make_shared<Robot>("D", 50.0, Robot::Size::SMALL, Robot::Strategy::SCRUB, 100.0));
+        simulator.collectStatusChanges();
+        CHECK(simulator.getChangedRobots(first) == std::vector<size_t>{3});
+        CHECK(simulator.getRobotStatuses().size() == 4);
+        CHECK(simulator.getRobotStatus(3).name == "D");
+    }
+
+    SECTION("Readers older than the retained log get every robot") {
+        for (int i = 0; i < 100; ++i) {
+            robots[0]->failed_ = !robots[0]->failed_;
+            simulator.collectStatusChanges();
+        }
+        CHECK(simulator.getChangedRobots(first) == std::vector<size_t>{0, 1, 2});
+        CHECK(simulator.getChangedRobots(simulator.getStatusVersion() - 1) == std::vector<size_t>{0});
+    }
+
+    SECTION("A cleaning robot shows up in the feed after update") {
+        auto task = std::make_shared<CleaningTask>(1, CleaningTask::HIGH, CleaningTask::VACUUM, map->getRoomById(1));
+        task->assignRobot(robots[0]);
+        robots[0]->setCurrentTask(task);
+        simulator.assignTaskToRobot(task);
+        simulator.update(1.0);
+        auto changed = simulator.getChangedRobots(first);
+        CHECK(changed == std::vector<size_t>{0});
+    }
+}
+
+TEST_CASE("Cleaning Task Version", "[statusfeed]") {
+    Room room("Lounge", 1, "carpet", "medium", false);
+    auto robot = std::make_shared<Robot>("A", 100.0, Robot::Size::MEDIUM, Robot::Strategy::SHAMPOO, 100.0);
+    CleaningTask task(1, CleaningTask::LOW, CleaningTask::SHAMPOO, &room);
+
+    unsigned long version = task.getVersion();
+    task.assignRobot(robot);
+    CHECK(task.getVersion() > version);
+    version = task.getVersion();
+    task.setStatus("In Progress");
+    CHECK(task.getVersion() > version);
+    version = task.getVersion();
+    task.markCompleted();
+    CHECK(task.getVersion() > version);
+    CHECK(task.getID() == 1);
+    CHECK(task.getVersion() == version + 1);
+}
@@ -2,6 +2,7 @@
 #include "TaskScheduler/TaskScheduler.h"
 #include "Robot/Robot.h"
 #include "Room/Room.h"
+#include "map/map.h"
 #include "config/ResourceConfig.hpp"
 #include <memory>
 #include <chrono>
@@ -128,6 +129,59 @@ TEST_CASE("Test Task Scheduler System", "[task_scheduler]") {
         CHECK(scheduler.taskCount() == 1);
     }
 
+    SECTION("Robot Declines Task It Cannot Finish") {
+        // 30% battery passes canAcceptTask, but a medium room needs 50%
+        auto tiredRobot = std::make_shared<Robot>("TiredBot", 30.0, Robot::Size::MEDIUM,
+                                                  Robot::Strategy::VACUUM);
+        tiredRobot->setCurrentRoom(fixture.room1.get());
+
+        auto task = std::make_shared<CleaningTask>(1, CleaningTask::Priority::HIGH,
+                                                  CleaningTask::CleanType::VACUUM, fixture.room1.get());
+        scheduler.enqueueTask(task);
+
+        CHECK(tiredRobot->canAcceptTask());
+        CHECK_FALSE(tiredRobot->requestNextTask());
+        CHECK_FALSE(tiredRobot->isCleaning());
+        CHECK(tiredRobot->getPreemptiveAborts() == 1);
+        CHECK(tiredRobot->takeChargeRequest());
+        CHECK_FALSE(tiredRobot->takeChargeRequest());
+
+        // Idling on the next tick declines the same task without counting it again
+        CHECK_FALSE(tiredRobot->requestNextTask());
+        CHECK(tiredRobot->getPreemptiveAborts() == 1);
+
+        // Task is still available for a robot that can finish it
+        CHECK(scheduler.taskCount() == 1);
+    }
+
+    SECTION("Arriving without resources gives the task back") {
+        Map map;
+        map.addRoom("Hallway", 1, "hardwood", "small", true);
+        map.addRoom("Landing", 2, "hardwood", "small", true);
+        map.addRoom("Office", 3, "carpet", "medium", false);
+        auto tiredRobot = std::make_shared<Robot>("TiredBot", 10.0, Robot::Size::MEDIUM,
+                                                  Robot::Strategy::VACUUM);
+        tiredRobot->setCurrentRoom(map.getRoomById(1));
+        auto task = std::make_shared<CleaningTask>(1, CleaningTask::Priority::HIGH,
+                                                   CleaningTask::CleanType::VACUUM, map.getRoomById(3));
+        tiredRobot->setCurrentTask(task);
+
+        // Two hops toward the task, then the clean cannot start
+        tiredRobot->setMovementPath({1, 2, 3}, map);
+        for (int i = 0; i < 20; ++i) tiredRobot->updateState(1.0, false);
+        CHECK(tiredRobot->getCurrentRoom() == map.getRoomById(3));
+        CHECK_FALSE(tiredRobot->isCleaning());
+        CHECK(tiredRobot->getMidTaskAborts() == 1);
+        CHECK(tiredRobot->getWastedTravelHops() == 2);
+
+        // The task is back in the queue and the robot no longer holds it
+        CHECK_FALSE(tiredRobot->getCurrentTask());
+        CHECK(task->getStatus() == "Pending");
+        REQUIRE(scheduler.taskCount() == 1);
+        CHECK(scheduler.dequeueTask() == task);
+        CHECK_FALSE(tiredRobot->takeReturnedTask());
+    }
+
     SECTION("Task Queue Persistence") {
         // Verify queue is empty at start
         CHECK_FALSE(scheduler.hasTasks());
@@ -0,0 +1,181 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include "Telemetry/TelemetryWriter.h"
+#include "RobotMetrics/MetricsAggregator.h"
+#include "RobotSimulator/RobotSimulator.hpp"
+#include "Robot/Robot.h"
+#include "map/map.h"
+#include "Room/Room.h"
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using Catch::Approx;
+
+namespace {
+    TelemetrySample sample(double time, float battery, int roomId = 1,
+                           MetricsAggregator::State state = MetricsAggregator::State::IDLE) {
+        TelemetrySample result;
+        result.time = time;
+        result.battery = battery;
+        result.water = battery / 2.0f;
+        result.roomId = roomId;
+        result.state = static_cast<uint8_t>(state);
+        return result;
+    }
+
+    const TelemetryBucket* find(const TelemetryBatch& batch, const std::string& robot, int resolution, double start) {
+        for (const auto& bucket : batch.appends) {
+            if (bucket.robot == robot && bucket.resolution == resolution && bucket.start == start) return &bucket;
+        }
+        return nullptr;
+    }
+}
+
+TEST_CASE("Telemetry series", "[telemetry]") {
+    TelemetrySeries series;
+    for (int t = 0; t < 10; ++t) series.append(sample(t, 100.0f - t, t % 3));
+    REQUIRE(series.size() == 10);
+    CHECK(series.at(4).battery == 96.0f);
+    CHECK(series.at(4).roomId == 1);
+
+    TelemetrySeries range;
+    range.appendRange(series, 2.5, 6.0);
+    REQUIRE(range.size() == 3);
+    CHECK(range.time == std::vector<double>{3.0, 4.0, 5.0});
+    CHECK(range.battery == std::vector<float>{97.0f, 96.0f, 95.0f});
+    CHECK(range.roomId == std::vector<int32_t>{0, 1, 2});
+    CHECK(range.water.size() == 3);
+    CHECK(range.state.size() == 3);
+
+    range.appendRange(series, 50.0, 60.0);
+    CHECK(range.size() == 3);
+}
+
+TEST_CASE("Telemetry tiers", "[telemetry]") {
+    const auto& tiers = TelemetryWriter::tiers();
+    CHECK(tiers[0].resolution == 0);
+    CHECK(tiers[1].resolution == 60);
+    CHECK(tiers[2].resolution == 900);
+    CHECK(tiers[2].retentionSeconds == 0.0);
+
+    double now = 40 * 86400.0;
+    CHECK(TelemetryWriter::resolutionFor(now - 3600.0, now) == 0);
+    CHECK(TelemetryWriter::resolutionFor(now - 2 * 86400.0, now) == 60);
+    CHECK(TelemetryWriter::resolutionFor(now - 35 * 86400.0, now) == 900);
+}
+
+TEST_CASE("Telemetry writer batches", "[telemetry]") {
+    TelemetryWriter writer(nullptr);
+
+    SECTION("Raw samples land in their bucket and complete minutes roll up") {
+        // Battery falls 0.1% a second
+        for (int t = 0; t < 125; ++t) writer.record("Alpha", sample(t, 100.0f - 0.1f * t, t < 60 ? 1 : 2));
+        CHECK(writer.pendingSamples() == 125);
+        TelemetryBatch batch = writer.takeBatch();
+        CHECK(writer.pendingSamples() == 0);
+
+        const TelemetryBucket* raw = find(batch, "Alpha", 0, 0.0);
+        REQUIRE(raw);
+        CHECK(raw->length == 600.0);
+        CHECK(raw->samples.size() == 125);
+
+        // Minutes 0 and 1 are complete, minute 2 is still open
+        const TelemetryBucket* minutes = find(batch, "Alpha", 60, 0.0);
+        REQUIRE(minutes);
+        REQUIRE(minutes->samples.size() == 2);
+        CHECK(minutes->samples.time == std::vector<double>{0.0, 60.0});
+        CHECK(minutes->samples.battery[0] == Approx(100.0 - 0.1 * 29.5));
+        CHECK(minutes->samples.battery[1] == Approx(100.0 - 0.1 * 89.5));
+        CHECK(minutes->samples.water[0] == Approx((100.0 - 0.1 * 29.5) / 2.0));
+        CHECK(minutes->samples.roomId == std::vector<int32_t>{1, 2});
+        CHECK_FALSE(find(batch, "Alpha", 900, 0.0));
+        CHECK(batch.expireBefore.empty());
+
+        // The open minute carries over to the next batch
+        writer.record("Alpha", sample(180, 50.0f));
+        batch = writer.takeBatch();
+        minutes = find(batch, "Alpha", 60, 0.0);
+        REQUIRE(minutes);
+        REQUIRE(minutes->samples.size() == 1);
+        CHECK(minutes->samples.time[0] == 120.0);
+        CHECK(minutes->samples.battery[0] == Approx(100.0 - 0.1 * 122.0));
+    }
+
+    SECTION("Samples split at bucket edges and per robot") {
+        for (int t = 590; t < 610; ++t) writer.record("Alpha", sample(t, 80.0f));
+        writer.record("Beta", sample(595, 70.0f));
+        TelemetryBatch batch = writer.takeBatch();
+        REQUIRE(find(batch, "Alpha", 0, 0.0));
+        REQUIRE(find(batch, "Alpha", 0, 600.0));
+        CHECK(find(batch, "Alpha", 0, 0.0)->samples.size() == 10);
+        CHECK(find(batch, "Alpha", 0, 600.0)->samples.size() == 10);
+        REQUIRE(find(batch, "Beta", 0, 0.0));
+        CHECK(find(batch, "Beta", 0, 0.0)->samples.battery[0] == 70.0f);
+    }
+
+    SECTION("Old tiers expire once per bucket edge") {
+        writer.record("Alpha", sample(86400.0 + 1250.0, 90.0f));
+        TelemetryBatch batch = writer.takeBatch();
+        REQUIRE(batch.expireBefore.size() == 1);
+        CHECK(batch.expireBefore[0].first == 0);
+        CHECK(batch.expireBefore[0].second == 1200.0);
+
+        writer.record("Alpha", sample(86400.0 + 1300.0, 90.0f));
+        CHECK(writer.takeBatch().expireBefore.empty());
+
+        // A month on, the minute tier expires too; the 15 minute tier never does
+        writer.record("Alpha", sample(31 * 86400.0, 90.0f));
+        batch = writer.takeBatch();
+        REQUIRE(batch.expireBefore.size() == 2);
+        CHECK(batch.expireBefore[1].first == 60);
+        CHECK(batch.expireBefore[1].second == 86400.0);
+    }
+
+    SECTION("The flush thread drains the queue and stop flushes the rest") {
+        writer.start(std::chrono::milliseconds(10));
+        writer.record("Alpha", sample(1, 90.0f));
+        for (int i = 0; i < 200 && writer.pendingSamples() > 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        CHECK(writer.pendingSamples() == 0);
+        writer.record("Alpha", sample(2, 90.0f));
+        writer.stop();
+        CHECK_FALSE(writer.isRunning());
+        CHECK(writer.pendingSamples() == 0);
+    }
+}
+
+TEST_CASE("Simulator samples telemetry every tick", "[telemetry]") {
+    auto map = std::make_shared<Map>();
+    map->addRoom("Charging Station", 0, "tile", "small", true);
+    map->addRoom("Lounge", 1, "carpet", "medium", false);
+    map->connectRooms(map->getRoomById(0), map->getRoomById(1));
+    map->addCharger(0, 2);
+    map->publishSnapshot();
+    auto simulator = std::make_shared<RobotSimulator>(map, nullptr, nullptr, nullptr);
+    simulator->addRobot("Alpha");
+    simulator->addRobot("Beta");
+
+    SECTION("One sample per robot per tick at the default rate") {
+        auto writer = std::make_shared<TelemetryWriter>(nullptr);
+        simulator->setTelemetryWriter(writer);
+        for (int i = 0; i < 3; ++i) simulator->update(1.0);
+        CHECK(writer->pendingSamples() == 6);
+
+        TelemetryBatch batch = writer->takeBatch();
+        const TelemetryBucket* alpha = find(batch, "Alpha", 0, 0.0);
+        REQUIRE(alpha);
+        CHECK(alpha->samples.time == std::vector<double>{1.0, 2.0, 3.0});
+        CHECK(alpha->samples.roomId[0] == 0);
+        CHECK(alpha->samples.battery[0] > 0.0f);
+    }
+
+    SECTION("A coarser sample rate skips ticks") {
+        auto writer = std::make_shared<TelemetryWriter>(nullptr, 2.0);
+        simulator->setTelemetryWriter(writer);
+        for (int i = 0; i < 4; ++i) simulator->update(1.0);
+        CHECK(writer->pendingSamples() == 4);
+    }
+}
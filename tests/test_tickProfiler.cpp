@@ -0,0 +1,143 @@
+#include <catch2/catch_test_macros.hpp>
+#include "TickProfiler/TickProfiler.h"
+#include "SimulationThread/SimulationThread.h"
+#include "RobotSimulator/RobotSimulator.hpp"
+#include "Robot/Robot.h"
+#include "map/map.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+    std::shared_ptr<Map> buildMap() {
+        auto map = std::make_shared<Map>();
+        map->addRoom("Charging Station", 0, "tile", "small", true);
+        map->addRoom("Lounge", 1, "carpet", "medium", false);
+        map->connectRooms(map->getRoomById(0), map->getRoomById(1));
+        map->addCharger(0, 2);
+        map->publishSnapshot();
+        return map;
+    }
+}
+
+TEST_CASE("Latency Histogram", "[profiler]") {
+    SECTION("Buckets are exact below 16ns and within 1/16 above") {
+        for (uint64_t v = 0; v < 16; ++v) {
+            CHECK(LatencyHistogram::bucketFor(v) == v);
+            CHECK(LatencyHistogram::bucketLowerBound(v) == v);
+        }
+        bool bounded = true;
+        bool ordered = true;
+        size_t last = 0;
+        for (uint64_t v = 16; v < (1ull << 30); v += v / 7 + 1) {
+            size_t bucket = LatencyHistogram::bucketFor(v);
+            uint64_t lower = LatencyHistogram::bucketLowerBound(bucket);
+            uint64_t next = LatencyHistogram::bucketLowerBound(bucket + 1);
+            bounded = bounded && lower <= v && v < next && (next - lower) * 16 <= lower;
+            ordered = ordered && bucket >= last;
+            last = bucket;
+        }
+        CHECK(bounded);
+        CHECK(ordered);
+        CHECK(LatencyHistogram::bucketFor(~0ull) == LatencyHistogram::kBucketCount - 1);
+    }
+
+    SECTION("Percentiles, max and mean") {
+        LatencyHistogram histogram;
+        CHECK(histogram.percentile(0.5) == 0);
+        for (uint64_t v = 1; v <= 1000; ++v) histogram.record(v * 1000);   // 1us .. 1ms
+        CHECK(histogram.count() == 1000);
+        CHECK(histogram.max() == 1000000);
+        CHECK(histogram.mean() == 500500.0);
+
+        uint64_t p50 = histogram.percentile(0.50);
+        uint64_t p99 = histogram.percentile(0.99);
+        CHECK(p50 >= 500000);
+        CHECK(p50 <= 500000 + 500000 / 16);
+        CHECK(p99 >= 990000);
+        CHECK(p99 <= 1000000);
+        CHECK(histogram.percentile(1.0) == 1000000);
+
+        histogram.reset();
+        CHECK(histogram.count() == 0);
+        CHECK(histogram.max() == 0);
+    }
+
+    SECTION("Concurrent recording loses nothing") {
+        LatencyHistogram histogram;
+        std::vector<std::thread> writers;
+        for (int t = 0; t < 4; ++t) {
+            writers.emplace_back([&histogram, t]() {
+                for (uint64_t i = 0; i < 50000; ++i) histogram.record(i + t);
+            });
+        }
+        for (auto& writer : writers) writer.join();
+        CHECK(histogram.count() == 200000);
+        CHECK(histogram.max() == 50002);
+    }
+}
+
+TEST_CASE("Tick Profiler", "[profiler]") {
+    auto map = buildMap();
+    auto simulator = std::make_shared<RobotSimulator>(map, nullptr, nullptr, nullptr);
+    simulator->addRobot("Alpha");
+    TickProfiler& profiler = simulator->getProfiler();
+
+    SECTION("Disabled by default and records nothing") {
+        CHECK_FALSE(profiler.isEnabled());
+        simulator->update(1.0);
+        for (const auto& summary : profiler.summarize()) {
+            CHECK(summary.count == 0);
+        }
+    }
+
+    SECTION("Each tick feeds its phases") {
+        profiler.setEnabled(true);
+        for (int i = 0; i < 5; ++i) simulator->update(1.0);
+        CHECK(profiler.histogram(TickProfiler::Phase::TICK).count() == 5);
+        CHECK(profiler.histogram(TickProfiler::Phase::ROBOT_UPDATES).count() == 5);
+        CHECK(profiler.histogram(TickProfiler::Phase::STATE_ALERTS).count() == 5);
+        CHECK(profiler.histogram(TickProfiler::Phase::STATUS_FEED).count() == 5);
+        CHECK(profiler.histogram(TickProfiler::Phase::DIRT_MODEL).count() == 0);
+        // The whole tick takes at least as long as any phase inside it
+        CHECK(profiler.histogram(TickProfiler::Phase::TICK).max() >=
+              profiler.histogram(TickProfiler::Phase::ROBOT_UPDATES).max());
+
+        simulator->requestReturnToCharger("Alpha");
+        CHECK(profiler.histogram(TickProfiler::Phase::RETURN_TO_CHARGER).count() == 1);
+
+        profiler.reset();
+        CHECK(profiler.histogram(TickProfiler::Phase::TICK).count() == 0);
+    }
+
+    SECTION("The simulation thread times commands and publishing") {
+        SimulationThread simulation(simulator, nullptr);
+        profiler.setEnabled(true);
+        simulation.step();
+        CHECK(profiler.histogram(TickProfiler::Phase::COMMANDS).count() == 1);
+        CHECK(profiler.histogram(TickProfiler::Phase::PUBLISH).count() == 1);
+        CHECK(profiler.histogram(TickProfiler::Phase::TICK).count() == 1);
+    }
+
+    SECTION("JSON dump lists every phase") {
+        profiler.setEnabled(true);
+        simulator->update(1.0);
+        std::string path = "tick_profile_test.json";
+        profiler.dumpJson(path);
+        std::ifstream in(path);
+        REQUIRE(in.is_open());
+        nlohmann::json root = nlohmann::json::parse(in);
+        std::remove(path.c_str());
+
+        CHECK(root["enabled"] == true);
+        REQUIRE(root["phases"].size() == TickProfiler::kPhaseCount);
+        CHECK(root["phases"][0]["phase"] == "tick");
+        CHECK(root["phases"][0]["count"] == 1);
+        CHECK(root["phases"][0]["max_us"].get<double>() >= root["phases"][0]["p50_us"].get<double>());
+        CHECK(root["phases"][0].contains("p99_us"));
+    }
+}
@@ -0,0 +1,114 @@
+#include <catch2/catch_test_macros.hpp>
+#include "TourPlanner/TourPlanner.h"
+#include "Scheduler/Scheduler.hpp"
+#include "Robot/Robot.h"
+#include "CleaningTask/cleaningTask.h"
+#include "map/map.h"
+#include "Room/Room.h"
+#include <memory>
+#include <vector>
+
+// Builds a corridor 0 - 1 - 2 - 3 - 4 - 5 with the charger at room 0
+static void buildCorridor(Map& map, const std::string& size) {
+    map.addRoom("Charging Station", 0, "tile", "small", true);
+    for (int id = 1; id <= 5; ++id) {
+        map.addRoom("Room " + std::to_string(id), id, "wood", size, false);
+    }
+    for (int id = 0; id < 5; ++id) {
+        map.connectRooms(map.getRoomById(id), map.getRoomById(id + 1));
+    }
+}
+
+static std::shared_ptr<CleaningTask> makeTask(int id, Room* room) {
+    return std::make_shared<CleaningTask>(id, CleaningTask::MEDIUM, CleaningTask::VACUUM, room);
+}
+
+TEST_CASE("Tour Planner", "[tour]") {
+    SECTION("Orders tasks to minimize travel") {
+        Map map;
+        buildCorridor(map, "small");
+        std::vector<std::shared_ptr<CleaningTask>> tasks = {
+            makeTask(1, map.getRoomById(5)),
+            makeTask(2, map.getRoomById(1)),
+            makeTask(3, map.getRoomById(3)),
+        };
+
+        TourPlanner planner(map);
+        auto tour = planner.planTour(map.getRoomById(0), 100.0, 100.0, tasks);
+
+        REQUIRE(tour.stops.size() == 3);
+        CHECK(tour.stops[0].roomId == 1);
+        CHECK(tour.stops[1].roomId == 3);
+        CHECK(tour.stops[2].roomId == 5);
+        CHECK(tour.totalHops == 5);
+        CHECK(tour.chargerVisits == 0);
+        CHECK(tour.roomSequence == std::vector<int>{0, 1, 2, 3, 4, 5});
+        CHECK(tour.unreachable.empty());
+    }
+
+    SECTION("Inserts a charger visit before the battery runs low") {
+        Map map;
+        buildCorridor(map, "large");
+        std::vector<std::shared_ptr<CleaningTask>> tasks = {
+            makeTask(1, map.getRoomById(2)),
+            makeTask(2, map.getRoomById(3)),
+        };
+
+        // A large room drains 75%, so the second clean needs a recharge first
+        TourPlanner planner(map);
+        auto tour = planner.planTour(map.getRoomById(0), 100.0, 100.0, tasks);
+
+        REQUIRE(tour.stops.size() == 3);
+        CHECK(tour.stops[0].roomId == 2);
+        CHECK(tour.stops[1].isCharger);
+        CHECK(tour.stops[1].roomId == 0);
+        CHECK(tour.stops[2].roomId == 3);
+        CHECK(tour.chargerVisits == 1);
+        CHECK(tour.roomSequence == std::vector<int>{0, 1, 2, 1, 0, 1, 2, 3});
+    }
+
+    SECTION("Tasks behind a virtual wall are reported as unreachable") {
+        Map map;
+        buildCorridor(map, "small");
+        map.addVirtualWall(map.getRoomById(3), map.getRoomById(4));
+        std::vector<std::shared_ptr<CleaningTask>> tasks = {
+            makeTask(1, map.getRoomById(5)),
+            makeTask(2, map.getRoomById(2)),
+        };
+
+        TourPlanner planner(map);
+        auto tour = planner.planTour(map.getRoomById(0), 100.0, 100.0, tasks);
+
+        REQUIRE(tour.stops.size() == 1);
+        CHECK(tour.stops[0].roomId == 2);
+        REQUIRE(tour.unreachable.size() == 1);
+        CHECK(tour.unreachable[0]->getID() == 1);
+    }
+
+    SECTION("Scheduler hands out a robot's batch in tour order") {
+        Map map;
+        buildCorridor(map, "small");
+        auto robot = std::make_shared<Robot>("TourBot", 100.0, Robot::Size::SMALL, Robot::Strategy::VACUUM);
+        robot->setCurrentRoom(map.getRoomById(0));
+        std::vector<std::shared_ptr<Robot>> robots = {robot};
+        Scheduler scheduler(&map, &robots);
+
+        for (int roomId : {4, 1, 5, 2}) {
+            auto task = makeTask(roomId, map.getRoomById(roomId));
+            task->assignRobot(robot);
+            scheduler.addTask(task);
+        }
+
+        std::vector<int> visited;
+        while (auto task = scheduler.getNextTaskForRobot("TourBot")) {
+            visited.push_back(task->getRoom()->getRoomId());
+            robot->setCurrentRoom(task->getRoom());
+        }
+        CHECK(visited == std::vector<int>{1, 2, 4, 5});
+        // The cached leg is handed over once, then forgotten
+        CHECK(scheduler.takePlannedRoute(4, 2) == std::vector<int>{2, 3, 4});
+        CHECK(scheduler.takePlannedRoute(4, 2).empty());
+        scheduler.forgetPlannedRoute(5);
+        CHECK(scheduler.takePlannedRoute(5, 4).empty());
+    }
+}
@@ -0,0 +1,130 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ZonePartition/ZonePartition.h"
+#include "ZoneDispatcher/ZoneDispatcher.h"
+#include "Scheduler/Scheduler.hpp"
+#include "RobotSimulator/RobotSimulator.hpp"
+#include "Robot/Robot.h"
+#include "CleaningTask/cleaningTask.h"
+#include "TaskScheduler/TaskScheduler.h"
+#include "map/map.h"
+#include "Room/Room.h"
+#include <memory>
+#include <vector>
+
+// Two floors of four rooms each (0-3 and 4-7), joined by a stairwell between 3 and 4
+static std::shared_ptr<Map> buildTwoFloors() {
+    auto map = std::make_shared<Map>();
+    map->addRoom("Charging Station", 0, "tile", "small", true);
+    for (int id = 1; id <= 7; ++id) {
+        map->addRoom("Room " + std::to_string(id), id, "wood", "small", false);
+    }
+    for (int id = 0; id < 7; ++id) {
+        map->connectRooms(map->getRoomById(id), map->getRoomById(id + 1));
+    }
+    return map;
+}
+
+static std::shared_ptr<Robot> makeRobot(const std::string& name, Map& map, int roomId) {
+    auto robot = std::make_shared<Robot>(name, 100.0, Robot::Size::SMALL, Robot::Strategy::VACUUM);
+    robot->setCurrentRoom(map.getRoomById(roomId));
+    robot->setMap(&map);
+    return robot;
+}
+
+TEST_CASE("Zone Partition", "[zones]") {
+    SECTION("Grows zones over the connection graph") {
+        auto map = buildTwoFloors();
+        ZonePartition zones(*map, 4);
+
+        REQUIRE(zones.zoneCount() == 2);
+        CHECK(zones.zoneOf(0) == zones.zoneOf(3));
+        CHECK(zones.zoneOf(4) == zones.zoneOf(7));
+        CHECK(zones.zoneOf(3) != zones.zoneOf(4));
+        CHECK(zones.getRoomsInZone(zones.zoneOf(0)).size() == 4);
+
+        auto border = zones.getBorderRooms(zones.zoneOf(0));
+        REQUIRE(border.size() == 1);
+        CHECK(border[0]->getRoomId() == 3);
+    }
+
+    SECTION("Keeps zones declared on the map") {
+        auto map = buildTwoFloors();
+        map->setRoomZone(0, 5);
+        map->setRoomZone(1, 5);
+        ZonePartition zones(*map);
+
+        CHECK(zones.zoneOf(0) == 5);
+        CHECK(zones.zoneOf(1) == 5);
+        CHECK(zones.zoneOf(2) == 6);
+        CHECK(zones.zoneOf(7) == 6);
+    }
+
+    SECTION("Routes across zones through border rooms") {
+        auto map = buildTwoFloors();
+        ZonePartition zones(*map, 4);
+
+        CHECK(zones.getRoute(*map->getRoomById(1), *map->getRoomById(6)) ==
+              std::vector<int>{1, 2, 3, 4, 5, 6});
+        CHECK(zones.getRoute(*map->getRoomById(5), *map->getRoomById(7)) == std::vector<int>{5, 6, 7});
+    }
+
+    SECTION("Each zone gets its own scheduler shard") {
+        auto map = buildTwoFloors();
+        auto zones = std::make_shared<ZonePartition>(*map, 4);
+        ZoneDispatcher dispatcher(map.get(), zones);
+        auto upstairs = makeRobot("Upstairs", *map, 6);
+        auto downstairs = makeRobot("Downstairs", *map, 1);
+        dispatcher.addRobot(upstairs);
+        dispatcher.addRobot(downstairs);
+
+        REQUIRE(dispatcher.shardCount() == 2);
+        CHECK(dispatcher.getShardForRobot("Upstairs") != dispatcher.getShardForRobot("Downstairs"));
+
+        auto task = std::make_shared<CleaningTask>(1, CleaningTask::MEDIUM, CleaningTask::VACUUM, map->getRoomById(7));
+        task->assignRobot(upstairs);
+        dispatcher.addTask(task);
+        dispatcher.planAllTours();
+
+        CHECK(dispatcher.getShardForRobot("Upstairs")->getAllTasks().size() == 1);
+        CHECK(dispatcher.getShardForRobot("Downstairs")->getAllTasks().empty());
+        CHECK(dispatcher.getNextTaskForRobot("Upstairs") == task);
+    }
+
+    SECTION("Robots in different zones advance together") {
+        auto map = buildTwoFloors();
+        RobotSimulator simulator(map, nullptr, nullptr, nullptr);
+        simulator.setZonePartition(std::make_shared<ZonePartition>(*map, 4));
+        simulator.getRobots().push_back(makeRobot("Upstairs", *map, 5));
+        simulator.getRobots().push_back(makeRobot("Downstairs", *map, 1));
+
+        simulator.moveRobotToRoom("Upstairs", 7);
+        simulator.moveRobotToRoom("Downstairs", 6);
+        for (int i = 0; i < 50; ++i) simulator.update(1.0);
+
+        CHECK(simulator.getRobots()[0]->getCurrentRoom()->getRoomId() == 7);
+        CHECK(simulator.getRobots()[1]->getCurrentRoom()->getRoomId() == 6);
+    }
+
+    SECTION("Queued work in another zone is taken after the zones advance") {
+        auto map = buildTwoFloors();
+        RobotSimulator simulator(map, nullptr, nullptr, nullptr);
+        simulator.setZonePartition(std::make_shared<ZonePartition>(*map, 4));
+        simulator.getRobots().push_back(makeRobot("Downstairs", *map, 1));
+        simulator.getRobots().push_back(makeRobot("Upstairs", *map, 5));
+
+        auto& queue = TaskScheduler::getInstance();
+        while (queue.hasTasks()) queue.dequeueTask();
+        queue.enqueueTask(std::make_shared<CleaningTask>(1, CleaningTask::HIGH, CleaningTask::VACUUM,
+                                                         map->getRoomById(6)));
+
+        simulator.update(1.0);
+        auto downstairs = simulator.getRobots()[0];
+        REQUIRE(downstairs->getCurrentTask());
+        CHECK(downstairs->getCurrentRoom()->getRoomId() == 6);
+        CHECK(downstairs->isCleaning());
+        CHECK_FALSE(queue.hasTasks());
+
+        for (int i = 0; i < 20 && downstairs->isCleaning(); ++i) simulator.update(1.0);
+        CHECK(map->getRoomById(6)->isClean());
+    }
+}